@@ -4,32 +4,81 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../credential_store.c \
+../door_actuator.c \
 ../door_lock_control.c \
+../eeprom_cache.c \
 ../external_eeprom.c \
+../../Door_Lock_Drivers/debug_frames.c \
+../../Door_Lock_Drivers/frame.c \
 ../i2c.c \
-../timer.c \
-../uart.c 
+../../Door_Lock_Drivers/isr_stats.c \
+../lockout.c \
+../../Door_Lock_Drivers/power.c \
+../../Door_Lock_Drivers/prof.c \
+../../Door_Lock_Drivers/scheduler.c \
+../../Door_Lock_Drivers/sha256.c \
+../../Door_Lock_Drivers/soft_timer.c \
+../../Door_Lock_Drivers/stack_monitor.c \
+../../Door_Lock_Drivers/timer.c \
+../../Door_Lock_Drivers/uart.c \
+../user_table.c 
 
 OBJS += \
+./credential_store.o \
+./door_actuator.o \
 ./door_lock_control.o \
+./eeprom_cache.o \
 ./external_eeprom.o \
+./debug_frames.o \
+./frame.o \
 ./i2c.o \
+./isr_stats.o \
+./lockout.o \
+./power.o \
+./prof.o \
+./scheduler.o \
+./sha256.o \
+./soft_timer.o \
+./stack_monitor.o \
 ./timer.o \
-./uart.o 
+./uart.o \
+./user_table.o 
 
 C_DEPS += \
+./credential_store.d \
+./door_actuator.d \
 ./door_lock_control.d \
+./eeprom_cache.d \
 ./external_eeprom.d \
+./debug_frames.d \
+./frame.d \
 ./i2c.d \
+./isr_stats.d \
+./lockout.d \
+./power.d \
+./prof.d \
+./scheduler.d \
+./sha256.d \
+./soft_timer.d \
+./stack_monitor.d \
 ./timer.d \
-./uart.d 
+./uart.d \
+./user_table.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
 %.o: ../%.c
 	@echo 'Building file: $<'
 	@echo 'Invoking: AVR Compiler'
-	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega16 -DF_CPU=1000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -c -o "$@" "$<"
+	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega16 -DF_CPU=8000000UL -I"../" -I"../../Door_Lock_Drivers" -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -c -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+%.o: ../../Door_Lock_Drivers/%.c
+	@echo 'Building file: $<'
+	@echo 'Invoking: AVR Compiler'
+	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega16 -DF_CPU=8000000UL -I"../" -I"../../Door_Lock_Drivers" -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -c -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
@@ -0,0 +1,60 @@
+ /******************************************************************************
+ *
+ * Module: 		Control ECU - Configuration
+ * File Name: 	control_config.h
+ * Description: Configuration of the Control ECU application
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef CONTROL_CONFIG_H_
+#define CONTROL_CONFIG_H_
+
+	/* UART link with HMI ECU */
+	#define CONTROL_UART_BAUD_RATE	BR9600
+
+	/* Motor Direction Pins , Enable (PWM) is PB3/OC0 */
+	#define MOTOR_PORT				D
+	#define MOTOR_PIN_A				PD6
+	#define MOTOR_PIN_B				PD7
+
+	/* Door Open / Close Time , Open Hold Time , Soft Start / Stop Time */
+	#define DOOR_MOVE_TIME_MS		10000
+	#define DOOR_HOLD_TIME_MS		3000
+	#define DOOR_RAMP_TIME_MS		1000
+
+	/* Scheduler Tasks Priorities (0 = highest) : door step , EEPROM response ,
+	 * next command frame */
+	#define DOOR_TASK_PRIORITY				0
+	#define CONTROL_EEPROM_TASK_PRIORITY	1
+	#define CONTROL_COMMAND_TASK_PRIORITY	2
+
+	/* EEPROM Credential Store , STORE_SLOTS pages from STORE_ADDRESS */
+	#define STORE_ADDRESS 			0x0100
+	#define STORE_SLOTS 			16
+
+	/* EEPROM User Table , USERS_CAPACITY entries from USERS_ADDRESS */
+	#define USERS_ADDRESS 			0x0200
+	#define USERS_CAPACITY 			192
+
+	/* Salt of the User Table , in the settings page */
+	#define USERS_SALT_ADDRESS 		0x0000
+
+	/* Wrong Password Lockout : failures to the first lock (the 3rd failure
+	 * locks) , first / max lock window , failures counter in the settings page */
+	#define LOCK_MAX_ATTEMPTS		3
+	#define LOCK_BASE_SEC			30
+	#define LOCK_MAX_SEC			3600
+	#define LOCK_COUNTER_ADDRESS 	0x0004
+
+	/* EEPROM Cache window (RAM copy) , the settings page */
+	#define CACHE_ADDRESS 			0x0000
+	#define CACHE_SIZE 				16
+
+	/* Profiling Zones IDs (prof.h) , < PROF_MAX_ZONES */
+	#define PROF_ZONE_COMMAND			0	/* Command Task , one command frame */
+	#define PROF_ZONE_CHECK_PASSWORD	1	/* CheckPassword() */
+	#define PROF_ZONE_PASSWORD_MATCH	2	/* PasswordMatch() , salted SHA-256 */
+	#define PROF_ZONE_EEPROM_READ		3	/* EEPROM_readBlock() , I2C polling */
+
+#endif /* CONTROL_CONFIG_H_ */
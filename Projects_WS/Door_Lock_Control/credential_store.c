@@ -0,0 +1,288 @@
+ /******************************************************************************
+ *
+ * Module: 		Credential Store
+ * File Name: 	credential_store.c
+ * Description: Source file for the Log-Structured Credential Store in the
+ * 				External EEPROM
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "credential_store.h"
+#include "eeprom_cache.h"
+#include "frame.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* Record Fields */
+#define STORE_SEQ_LOW		0
+#define STORE_SEQ_HIGH		1
+#define STORE_LENGTH		2
+#define STORE_DATA			3
+#define STORE_CRC			(STORE_RECORD_SIZE - 1)
+
+/* SEQUENCE + LENGTH , read by the binary search */
+#define STORE_HEADER_SIZE	3
+
+#define STORE_SLOT_ADDRESS(slot)	(STORE_ADDRESS + ((uint16)(slot) * STORE_RECORD_SIZE))
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Newest valid record (RAM copy) , FALSE => store is empty */
+static uint8 g_currentRecord[STORE_RECORD_SIZE];
+static bool g_currentValid = FALSE ;
+
+/* Slot and Sequence of the next record */
+static uint8 g_nextSlot = 0 ;
+static uint16 g_nextSequence = 0 ;
+
+/* Record of the running write , must not change until the Call Back */
+static uint8 g_writeRecord[STORE_RECORD_SIZE];
+
+/* Result of the last write and the user Call Back */
+static volatile TWI_Status g_writeStatus = TWI_SUCCESS ;
+static void (*g_writeCallBack)(void) = NULL_PTR ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description: Function returns the CRC-8 of the record fields
+ */
+static uint8 STORE_crc(const uint8 *record);
+
+/*
+ * Description: Function returns the sequence number of the record
+ */
+static uint16 STORE_sequence(const uint8 *record);
+
+/*
+ * Description: Function returns TRUE if the record is written (not erased)
+ * 				and its sequence is equal to sequence
+ */
+static bool STORE_isNext(uint8 slot, uint16 sequence, uint8 *status);
+
+/*
+ * Description: Function to read a record and check its CRC , walking back
+ * 				from slot to slot 0 until a valid record is found
+ *
+ * Return: TRUE if a valid record is found (in g_currentRecord , slot in *found)
+ */
+static bool STORE_findValid(sint16 slot, uint8 *found, uint8 *status);
+
+/*
+ * Description: Call Back of the record write (TWI ISR)
+ */
+static void STORE_writeCallBack(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to find the newest valid record (Blocking) .
+ * 	1. Slot 0 valid => binary search for the last slot k with seq[k] = seq[0] + k ,
+ * 	   then walk back over a torn record (CRC error).
+ * 	2. Slot 0 not valid => it was torn after a full round (or the store is empty) ,
+ * 	   the newest record is the last valid slot.
+ */
+uint8 STORE_init(void)
+{
+	uint8 status = SUCCESS ;
+	uint8 newest = 0 ;
+	uint16 sequence ;
+	uint8 low ;
+	uint8 high ;
+	uint8 mid ;
+
+	g_writeStatus = TWI_SUCCESS ;
+	g_currentValid = FALSE ;
+	g_nextSlot = 0 ;
+	g_nextSequence = 0 ;
+
+	if (STORE_findValid(0, &newest, &status))
+	{
+		sequence = STORE_sequence(g_currentRecord) ;
+
+		/* seq[low] = seq[0] + low is TRUE , seq[high + 1] = seq[0] + high + 1 is FALSE */
+		low = 0 ;
+		high = STORE_SLOTS - 1 ;
+		while (low < high)
+		{
+			mid = (uint8)((low + high + 1) / 2) ;
+			if (STORE_isNext(mid, (uint16)(sequence + mid), &status))
+				low = mid ;
+			else
+				high = mid - 1 ;
+		}
+
+		g_currentValid = STORE_findValid(low, &newest, &status) ;
+	}
+	else
+	{
+		g_currentValid = STORE_findValid(STORE_SLOTS - 1, &newest, &status) ;
+	}
+
+	if (g_currentValid)
+	{
+		g_nextSlot = (uint8)((newest + 1) % STORE_SLOTS) ;
+		g_nextSequence = (uint16)(STORE_sequence(g_currentRecord) + 1) ;
+	}
+	return status;
+}
+
+/*
+ * Description: Function to copy the data of the newest record to data
+ */
+uint8 STORE_read(uint8 *data)
+{
+	uint8 i;
+
+	if (!g_currentValid)
+		return 0;
+
+	for (i = 0 ; i < g_currentRecord[STORE_LENGTH] ; i++)
+	{
+		data[i] = g_currentRecord[STORE_DATA + i];
+	}
+	return g_currentRecord[STORE_LENGTH];
+}
+
+/*
+ * Description: Function to start appending a new record (Non-Blocking) .
+ * 				Record is written and read back by CACHE_write() ,
+ * 				RAM copy is changed in the Call Back only if it succeeded
+ */
+uint8 STORE_write(const uint8 *data, uint8 length, void(*a_callBack)(void))
+{
+	uint8 i;
+
+	if ((length > STORE_DATA_SIZE) || (g_writeStatus == TWI_PENDING))
+		return ERROR;
+
+	g_writeRecord[STORE_SEQ_LOW] = (uint8)g_nextSequence ;
+	g_writeRecord[STORE_SEQ_HIGH] = (uint8)(g_nextSequence >> 8) ;
+	g_writeRecord[STORE_LENGTH] = length ;
+	for (i = 0 ; i < STORE_DATA_SIZE ; i++)
+	{
+		g_writeRecord[STORE_DATA + i] = (i < length) ? data[i] : 0xFF ;
+	}
+	g_writeRecord[STORE_CRC] = STORE_crc(g_writeRecord) ;
+
+	g_writeCallBack = a_callBack ;
+	g_writeStatus = TWI_PENDING ;
+
+	if (CACHE_write(STORE_SLOT_ADDRESS(g_nextSlot), g_writeRecord,
+			STORE_RECORD_SIZE, STORE_writeCallBack) != SUCCESS)
+	{
+		g_writeStatus = TWI_ERROR ;
+		return ERROR;
+	}
+	return SUCCESS;
+}
+
+/*
+ * Description: Function returns the result of the last STORE_write()
+ */
+TWI_Status STORE_getWriteStatus(void)
+{
+	return g_writeStatus;
+}
+
+/*
+ * Description: Function returns the CRC-8 of the record fields
+ */
+static uint8 STORE_crc(const uint8 *record)
+{
+	uint8 crc = 0 ;
+	uint8 i;
+
+	for (i = 0 ; i < STORE_CRC ; i++)
+	{
+		crc = FRAME_crc8(crc, record[i]) ;
+	}
+	return crc;
+}
+
+/*
+ * Description: Function returns the sequence number of the record
+ */
+static uint16 STORE_sequence(const uint8 *record)
+{
+	return (uint16)(record[STORE_SEQ_LOW] | ((uint16)record[STORE_SEQ_HIGH] << 8)) ;
+}
+
+/*
+ * Description: Function returns TRUE if the record is written (not erased)
+ * 				and its sequence is equal to sequence , reads the header only
+ */
+static bool STORE_isNext(uint8 slot, uint16 sequence, uint8 *status)
+{
+	uint8 header[STORE_HEADER_SIZE];
+
+	if (EEPROM_readBlock(STORE_SLOT_ADDRESS(slot), header, STORE_HEADER_SIZE) != SUCCESS)
+	{
+		*status = ERROR ;
+		return FALSE;
+	}
+
+	/* Erased page => LENGTH = 0xFF */
+	return (header[STORE_LENGTH] <= STORE_DATA_SIZE) &&
+			(STORE_sequence(header) == sequence) ;
+}
+
+/*
+ * Description: Function to read a record and check its CRC , walking back
+ * 				from slot to slot 0 until a valid record is found
+ */
+static bool STORE_findValid(sint16 slot, uint8 *found, uint8 *status)
+{
+	for ( ; slot >= 0 ; slot--)
+	{
+		if (EEPROM_readBlock(STORE_SLOT_ADDRESS(slot), g_currentRecord,
+				STORE_RECORD_SIZE) != SUCCESS)
+		{
+			*status = ERROR ;
+			continue;
+		}
+
+		if ((g_currentRecord[STORE_LENGTH] <= STORE_DATA_SIZE) &&
+			(g_currentRecord[STORE_CRC] == STORE_crc(g_currentRecord)))
+		{
+			*found = (uint8)slot ;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/*
+ * Description: Call Back of the record write (TWI ISR)
+ * 				Failed write => the next record is written in the same slot
+ */
+static void STORE_writeCallBack(void)
+{
+	uint8 i;
+
+	if (CACHE_getWriteStatus() == TWI_SUCCESS)
+	{
+		for (i = 0 ; i < STORE_RECORD_SIZE ; i++)
+		{
+			g_currentRecord[i] = g_writeRecord[i];
+		}
+		g_currentValid = TRUE ;
+		g_nextSlot = (uint8)((g_nextSlot + 1) % STORE_SLOTS) ;
+		g_nextSequence++ ;
+	}
+
+	g_writeStatus = CACHE_getWriteStatus() ;
+	if (g_writeCallBack != NULL_PTR)
+	{
+		g_writeCallBack();
+	}
+}
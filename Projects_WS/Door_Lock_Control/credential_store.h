@@ -0,0 +1,99 @@
+ /******************************************************************************
+ *
+ * Module: 		Credential Store
+ * File Name: 	credential_store.h
+ * Description: Header file for the Log-Structured Credential Store in the
+ * 				External EEPROM
+ *
+ * Notes:		- The store region has STORE_SLOTS pages , one record per page :
+ * 				| SEQUENCE (2 bytes LE) | LENGTH | DATA (STORE_DATA_SIZE bytes) | CRC-8 |
+ * 				  CRC-8 (FRAME_crc8) covers SEQUENCE , LENGTH and DATA
+ *
+ * 				- Every STORE_write() appends a new record with sequence + 1 in the
+ * 				  next slot (after the last slot => slot 0) , the old record is not touched
+ * 				  so a power cut during the write leaves the old record valid
+ * 				  and the torn record fails its CRC at boot (Atomic Update)
+ *
+ * 				- Writes go round-robin over the region , every page gets
+ * 				  1 / STORE_SLOTS of the writes (Wear Leveling)
+ *
+ * 				- STORE_init() finds the newest record by a binary search on the
+ * 				  sequence numbers : slots [0 , newest] have sequences
+ * 				  seq[0] , seq[0]+1 , ... , the slots after it are older or erased
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef CREDENTIAL_STORE_H_
+#define CREDENTIAL_STORE_H_
+
+#include "std_types.h"
+#include "control_config.h"
+#include "external_eeprom.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Store region , set in control_config.h */
+#ifndef STORE_ADDRESS
+#define STORE_ADDRESS		0x0100
+#endif
+
+#ifndef STORE_SLOTS
+#define STORE_SLOTS			16
+#endif
+
+/* Record = one EEPROM page */
+#define STORE_RECORD_SIZE	EEPROM_PAGE_SIZE
+
+/* SEQUENCE + LENGTH + CRC */
+#define STORE_OVERHEAD		4
+
+#define STORE_DATA_SIZE		(STORE_RECORD_SIZE - STORE_OVERHEAD)
+
+#if ((STORE_SLOTS < 2) || (STORE_SLOTS > 128))
+#error "STORE_SLOTS must be 2 .. 128"
+#endif
+
+#if ((STORE_ADDRESS % EEPROM_PAGE_SIZE) != 0)
+#error "STORE_ADDRESS must be at the start of an EEPROM page"
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function to find the newest valid record (Blocking) .
+ * 				EEPROM_init() must be called first .
+ *
+ * Return: ERROR if the EEPROM can't be read
+ */
+uint8 STORE_init(void);
+
+/*
+ * Description: Function to copy the data of the newest record to data
+ * 				(buffer size must be at least STORE_DATA_SIZE) , RAM copy
+ *
+ * Return: length of the data , 0 if the store is empty
+ */
+uint8 STORE_read(uint8 *data);
+
+/*
+ * Description: Function to start appending a new record (Non-Blocking) .
+ * 				a_callBack is called from TWI ISR after the record is written
+ * 				and read back , result in STORE_getWriteStatus() .
+ *
+ * Return: ERROR if length > STORE_DATA_SIZE or a write is running
+ */
+uint8 STORE_write(const uint8 *data, uint8 length, void(*a_callBack)(void));
+
+/*
+ * Description: Function returns the result of the last STORE_write()
+ * 				TWI_PENDING , TWI_SUCCESS , TWI_ERROR
+ */
+TWI_Status STORE_getWriteStatus(void);
+
+#endif /* CREDENTIAL_STORE_H_ */
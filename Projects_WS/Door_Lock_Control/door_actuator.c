@@ -0,0 +1,232 @@
+ /******************************************************************************
+ *
+ * Module: 		Door Actuator
+ * File Name: 	door_actuator.c
+ * Description: Source file for the Door Motor State Machine with PWM Soft Start
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "door_actuator.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* Door Task Event , Step Timer expired */
+#define DOOR_EV_STEP		0x01
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Current State and steps done in it */
+static volatile DOOR_State g_doorState = DOOR_CLOSED ;
+static uint16 g_doorSteps = 0 ;
+
+/* Current Duty Cycle */
+static volatile uint8 g_doorDuty = 0 ;
+
+/* Direction of the current move , set on the pins with the first duty step */
+static bool g_doorOpening = TRUE ;
+
+/* Step Timer , periodic every DOOR_STEP_MS while the door is not closed */
+static SoftTimer_Type g_doorTimer;
+
+/* Door Task ID , one run every step */
+static uint8 g_doorTask = SCHED_NO_TASK ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description: Call Back of the Step Timer (TIMER1 ISR) , wakes the Door Task
+ */
+static void DOOR_tick(void);
+
+/*
+ * Description: Door Task , one state machine step
+ */
+static void DOOR_step(uint8 events);
+
+/*
+ * Description: Function returns the duty cycle of a move step (ramp up , full , ramp down)
+ */
+static uint8 DOOR_moveDuty(uint16 step);
+
+/*
+ * Description: Function to set the duty cycle , 0 => both direction pins LOW
+ */
+static void DOOR_setDuty(uint8 duty);
+
+/*
+ * Description: Function to set the direction of the next move , opening or closing
+ */
+static void DOOR_setDirection(bool opening);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to initialize the Motor pins and TIMER0 PWM (duty 0)
+ * 				and add the Door Task to the Scheduler .
+ */
+void DOOR_init(void)
+{
+	/* TIMER0 Fast PWM on OC0 (PB3) , started when the door moves */
+	TIMER_ConfigType PWM_Config = {.clock = F_CPU_8 , .mode = PWM ,
+			.OCRValue = 0 , .OC = NON_INVERTING };
+
+	/* Set Pins O/P and LOW */
+	pinMode(MOTOR_PORT,MOTOR_PIN_A,OUTPUT);
+	pinMode(MOTOR_PORT,MOTOR_PIN_B,OUTPUT);
+	pinWrite(MOTOR_PORT,MOTOR_PIN_A,LOW);
+	pinWrite(MOTOR_PORT,MOTOR_PIN_B,LOW);
+
+	Timer0_Init(&PWM_Config);
+	Timer0_stopTimer();
+
+	g_doorState = DOOR_CLOSED ;
+	g_doorDuty = 0 ;
+
+	g_doorTask = SCHED_addTask(DOOR_step, DOOR_TASK_PRIORITY);
+}
+
+/*
+ * Description: Function to start opening the door (Non-Blocking)
+ */
+bool DOOR_open(void)
+{
+	if(g_doorState != DOOR_CLOSED)
+		return FALSE;
+
+	g_doorSteps = 0 ;
+	g_doorState = DOOR_OPENING ;
+	DOOR_setDirection(TRUE);
+	Timer0_restartTimer();
+	SoftTimer_start(&g_doorTimer, DOOR_STEP_MS, DOOR_STEP_MS, DOOR_tick);
+	return TRUE;
+}
+
+/*
+ * Description: Function returns the current state
+ */
+DOOR_State DOOR_getState(void)
+{
+	return g_doorState;
+}
+
+/*
+ * Description: Function returns the current duty cycle (OCR0)
+ */
+uint8 DOOR_getDuty(void)
+{
+	return g_doorDuty;
+}
+
+/*
+ * Description: Call Back of the Step Timer (TIMER1 ISR) , wakes the Door Task
+ */
+static void DOOR_tick(void)
+{
+	SCHED_setEvent(g_doorTask, DOOR_EV_STEP);
+}
+
+/*
+ * Description: Door Task , one state machine step
+ * 				events are flags , two ticks before one run => one step
+ * 				(the move is a bit longer , never faster)
+ */
+static void DOOR_step(uint8 events)
+{
+	g_doorSteps++ ;
+
+	switch(g_doorState)
+	{
+		case DOOR_OPENING:
+		case DOOR_CLOSING:
+			DOOR_setDuty(DOOR_moveDuty(g_doorSteps));
+			if(g_doorSteps < DOOR_MOVE_STEPS)
+				break;
+
+			/* Move finished , duty = 0 */
+			g_doorSteps = 0 ;
+			if(g_doorState == DOOR_OPENING)
+			{
+				g_doorState = DOOR_OPEN_HOLD ;
+			}
+			else
+			{
+				g_doorState = DOOR_CLOSED ;
+				SoftTimer_stop(&g_doorTimer);
+				Timer0_stopTimer();
+			}
+			break;
+
+		case DOOR_OPEN_HOLD:
+			if(g_doorSteps >= DOOR_HOLD_STEPS)
+			{
+				g_doorSteps = 0 ;
+				g_doorState = DOOR_CLOSING ;
+				DOOR_setDirection(FALSE);
+			}
+			break;
+
+		default:
+			SoftTimer_stop(&g_doorTimer);
+			break;
+	}
+}
+
+/*
+ * Description: Function returns the duty cycle of a move step (ramp up , full , ramp down)
+ */
+static uint8 DOOR_moveDuty(uint16 step)
+{
+	if(step >= DOOR_MOVE_STEPS)
+		return 0;
+
+	if(step < DOOR_RAMP_STEPS)
+		return (uint8)(((uint32)DOOR_PWM_MAX * step) / DOOR_RAMP_STEPS) ;
+
+	if(step > (DOOR_MOVE_STEPS - DOOR_RAMP_STEPS))
+		return (uint8)(((uint32)DOOR_PWM_MAX * (DOOR_MOVE_STEPS - step)) / DOOR_RAMP_STEPS) ;
+
+	return DOOR_PWM_MAX;
+}
+
+/*
+ * Description: Function to set the duty cycle , 0 => both direction pins LOW
+ * 				(Fast PWM with OCR0 = 0 still gives a one cycle pulse on OC0
+ * 				every period , the motor is driven only while a pin is HIGH)
+ * 				first step of a move => OCR0 then the direction pins
+ */
+static void DOOR_setDuty(uint8 duty)
+{
+	uint8 last = g_doorDuty ;
+
+	g_doorDuty = duty ;
+	Timer0_Ticks(duty);
+	if(duty == 0)
+	{
+		pinWrite(MOTOR_PORT,MOTOR_PIN_A,LOW);
+		pinWrite(MOTOR_PORT,MOTOR_PIN_B,LOW);
+	}
+	else if(last == 0)
+	{
+		pinWrite(MOTOR_PORT,MOTOR_PIN_A,g_doorOpening ? HIGH : LOW);
+		pinWrite(MOTOR_PORT,MOTOR_PIN_B,g_doorOpening ? LOW : HIGH);
+	}
+}
+
+/*
+ * Description: Function to set the direction of the next move , opening or closing
+ * 				duty cycle = 0 and both pins LOW until the first step of the move
+ */
+static void DOOR_setDirection(bool opening)
+{
+	DOOR_setDuty(0);
+	g_doorOpening = opening ;
+}
@@ -0,0 +1,118 @@
+ /******************************************************************************
+ *
+ * Module: 		Door Actuator
+ * File Name: 	door_actuator.h
+ * Description: Header file for the Door Motor State Machine with PWM Soft Start
+ *
+ * Notes:		- H-Bridge : Direction MOTOR_PIN_A / MOTOR_PIN_B ,
+ * 				  Enable PB3/OC0 (TIMER0 Fast PWM , F_CPU/8 => ~3.9 KHz)
+ *
+ * 				- States : CLOSED -> OPENING -> OPEN_HOLD -> CLOSING -> CLOSED
+ * 				  every DOOR_STEP_MS a Software Timer wakes the Door Task
+ * 				  (Scheduler) that moves the state machine ,
+ * 				  UART commands are served while the door moves
+ *
+ * 				- OPENING / CLOSING duty cycle (DOOR_MOVE_TIME_MS) :
+ *
+ * 				  DOOR_PWM_MAX     ________________
+ * 				                  /                \
+ * 				  0  ____________/                  \____________
+ * 				                 |RAMP|          |RAMP|
+ *
+ * 				  both direction pins are LOW while the duty cycle is 0 (OC0
+ * 				  still pulses once every period at OCR0 = 0) , the direction
+ * 				  is set on the pins with the first nonzero duty step
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef DOOR_ACTUATOR_H_
+#define DOOR_ACTUATOR_H_
+
+#include "std_types.h"
+#include "control_config.h"
+#include "timer.h"
+#include "soft_timer.h"
+#include "scheduler.h"
+#include "gpio.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Motion timing , set in control_config.h */
+#ifndef DOOR_MOVE_TIME_MS
+#define DOOR_MOVE_TIME_MS	10000
+#endif
+
+#ifndef DOOR_HOLD_TIME_MS
+#define DOOR_HOLD_TIME_MS	3000
+#endif
+
+#ifndef DOOR_RAMP_TIME_MS
+#define DOOR_RAMP_TIME_MS	1000
+#endif
+
+/* State machine step (duty cycle update) period */
+#ifndef DOOR_STEP_MS
+#define DOOR_STEP_MS		20
+#endif
+
+/* Full speed duty cycle (OCR0) */
+#ifndef DOOR_PWM_MAX
+#define DOOR_PWM_MAX		255
+#endif
+
+/* Door Task priority in the Scheduler , set in control_config.h */
+#ifndef DOOR_TASK_PRIORITY
+#define DOOR_TASK_PRIORITY	0
+#endif
+
+#define DOOR_MOVE_STEPS		(DOOR_MOVE_TIME_MS / DOOR_STEP_MS)
+#define DOOR_HOLD_STEPS		(DOOR_HOLD_TIME_MS / DOOR_STEP_MS)
+#define DOOR_RAMP_STEPS		(DOOR_RAMP_TIME_MS / DOOR_STEP_MS)
+
+#if ((DOOR_RAMP_STEPS == 0) || ((2 * DOOR_RAMP_STEPS) > DOOR_MOVE_STEPS))
+#error "DOOR_RAMP_TIME_MS must be DOOR_STEP_MS .. DOOR_MOVE_TIME_MS / 2"
+#endif
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef enum
+{
+	DOOR_CLOSED, DOOR_OPENING, DOOR_OPEN_HOLD, DOOR_CLOSING
+}DOOR_State;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function to initialize the Motor pins and TIMER0 PWM (duty 0)
+ * 				and add the Door Task to the Scheduler .
+ * 				SoftTimer_init() and SCHED_init() must be called first .
+ */
+void DOOR_init(void);
+
+/*
+ * Description: Function to start opening the door (Non-Blocking) ,
+ * 				the door closes by itself after DOOR_HOLD_TIME_MS
+ *
+ * Return: FALSE if the door is not closed
+ */
+bool DOOR_open(void);
+
+/*
+ * Description: Function returns the current state
+ */
+DOOR_State DOOR_getState(void);
+
+/*
+ * Description: Function returns the current duty cycle (OCR0)
+ */
+uint8 DOOR_getDuty(void);
+
+#endif /* DOOR_ACTUATOR_H_ */
@@ -2,7 +2,7 @@
  *
  * Description: Smart Door Lock System
  * File Name:	door_lock_control.c
- * Connections: - Motor PD6:PD7
+ * Connections: - Motor Direction PD6:PD7 , Motor Enable (PWM) PB3/OC0
  * 				- External EEPROM PC0(SCL):PC1(SDA)
  * 				- Connect UART Lines Rx->Tx
  *
@@ -22,18 +22,33 @@
 /* Save The Password */
 uint8 g_password[PASS_SIZE] = {0} ;
 
+/* Password Record (Salt + Hash) of the running CHANGE_PASSWORD write */
+uint8 g_passRecord[PASS_RECORD_SIZE] = {0} ;
 
-/* Data Received from UART */
-uint8 Data;
+/* Root Password , to reset the password
+ * saved as SHA-256(ROOT_SALT + Root Password) , not the Root Password itself */
+static const uint8 ROOT_SALT[PASS_SALT_SIZE] = {0x5A,0x3C,0x96,0xE1} ;
+static const uint8 ROOT_HASH[PASS_HASH_SIZE] = {0xE6,0xDB,0xA9,0x27,0xBB,0xB3,0x8E,0x35} ;
 
-/* Save Received Password from EEPROM */
-uint8 g_EEPassword[PASS_SIZE] = {0} ;
 
-/* Global Counter For Password Array */
-uint8 count = 0 ;
+/* Frame Decoder , holds the last command frame received from HMI ECU */
+FRAME_DecoderType g_rxFrame;
 
-/* Global Delay Flag => flag is set when Timer callback function is called */
-bool g_delayFlag = FALSE ;
+/* Save Received Password Record from the Credential Store */
+uint8 g_EEPassword[STORE_DATA_SIZE] = {0} ;
+
+/* Scheduler Tasks IDs */
+uint8 g_commandTask = SCHED_NO_TASK ;
+uint8 g_eepromTask = SCHED_NO_TASK ;
+
+/* Result of the EEPROM write of the current command */
+TWI_Status g_eepromStatus = TWI_SUCCESS ;
+
+/* Command waiting its EEPROM Transaction to send the response */
+uint8 g_pendingCommand = NO_COMMAND ;
+
+/* Password check result of the pending command (MATCH , DONT_MATCH) */
+uint8 g_checkResult = DONT_MATCH ;
 
 
 /*******************************************************************************
@@ -45,119 +60,427 @@ int main(void)
 	sei();
 
 	/* Initialize UART */
-	UART_ConfigType UART_Config = {.s_BaudRate = BR9600 , .s_NULL_Terminator = '#' };
+	/* RX / DRE Interrupts Enabled => Bytes are buffered in RX/TX Ring Buffers */
+	UART_ConfigType UART_Config = {.s_RxInterruptEnable = ENABLE_INT ,
+			.s_DataRegEmptyInterruptEnable = ENABLE_INT ,
+			.s_BaudRate = CONTROL_UART_BAUD_RATE , .s_NULL_Terminator = '#' };
 	UART_init(&UART_Config);
 
 
 	/* Initialize External EEPROM */
 	EEPROM_init();
 
-	/* Initialize Timer1*/
-	/* F_CPU = 8Mhz		Timer1 COMP Mode 	1 Sec. */
-	TIMER_ConfigType Timer1_Config = {.clock = F_CPU_1024, .mode = COMP, .OCRValue = 8000 };
-	Timer1_Init(&Timer1_Config);
-	Timer1_stopTimer();
-	Timer1_setCallBack(Timer1_CallBack);
+	/* Load the settings page into RAM */
+	CACHE_init();
+
+	/* Find the newest Password record , Password checks don't use I2C */
+	STORE_init();
+
+	/* Load the User Table Salt */
+	USERS_init();
+
+	/* Initialize Software Timers Service on Timer1 , 1 ms tick */
+	SoftTimer_init();
+
+	/* Profiling Zones , measure the probe overhead (PROF_ENABLE) */
+	PROF_INIT();
+
+	/* ISR latency / duration histograms (ISR_STATS_ENABLE) */
+	ISR_STATS_INIT();
+
+	/* Tasks are added by DOOR_init() and below */
+	SCHED_init();
+
+	/* Idle Sleep Mode when no task is ready */
+	POWER_init();
+	SCHED_setIdleHook(POWER_idle);
+
+	/* Load the wrong passwords counter , locked again after a reset */
+	LOCK_init();
 
 	/* Motor Initialize */
-	/* Set Pins O/P and LOW */
-	pinMode(D,PD6,OUTPUT);
-	pinMode(D,PD7,OUTPUT);
+	/* Direction Pins O/P and LOW , TIMER0 PWM on the Enable Pin */
+	DOOR_init();
+
+	FRAME_decoderInit(&g_rxFrame);
+
+	/* Door step first , a response frees the next command */
+	g_eepromTask = SCHED_addTask(EEPROM_task, CONTROL_EEPROM_TASK_PRIORITY);
+	g_commandTask = SCHED_addTask(Command_task, CONTROL_COMMAND_TASK_PRIORITY);
+	UART_RXC_setCallBack(UART_CallBack);
+
+	/* Bytes received before the Call Back was set */
+	SCHED_setEvent(g_commandTask, EV_RX_BYTE);
+
+	SCHED_run();
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
 
-	/* check if there is password in EEPROM */
-	while (UART_receiveByte() != READY);
-	EEPROM_CheckPassword();
+/*
+ * Description: Command Task , reads one command frame from HMI ECU and runs it
+ * 				every command has one response frame , next command is read
+ * 				after the response of the current command (EEPROM Task wakes it)
+ */
+void Command_task(uint8 events)
+{
+	if((g_pendingCommand != NO_COMMAND) || !FRAME_poll(&g_rxFrame))
+		return ;
 
-	while(1)
+	PROF_BEGIN(PROF_ZONE_COMMAND);
+	switch(g_rxFrame.s_Frame.s_Command)
 	{
-		while (UART_receiveByte() != READY);
-		UART_sendByte(READY) ;
-		Data = UART_receiveByte();
-		if(Data == CHECK_PASSWORD)
+		case READY:
+			/* HMI ECU started , check if there is password in EEPROM */
+			EEPROM_CheckPassword();
+			break;
+		case CHECK_PASSWORD:
+			PROF_BEGIN(PROF_ZONE_CHECK_PASSWORD);
 			CheckPassword();
-		else if (Data == CHANGE_PASSWORD)
+			PROF_END(PROF_ZONE_CHECK_PASSWORD);
+			break;
+		case CHECK_USER:
+			CheckUser();
+			break;
+		case CHECK_ROOT:
+			CheckRoot();
+			break;
+		case ADD_USER:
+		case REVOKE_USER:
+			UserCommand(g_rxFrame.s_Frame.s_Command);
+			break;
+		case CHANGE_PASSWORD:
 			SetPassword();
-		else if (Data == OPEN_DOOR)
+			break;
+		case OPEN_DOOR:
+			FRAME_send(READY, NULL_PTR, 0);
 			MotorOn();
-
+			break;
+		default:
+			/* SCHED_STATS , POWER_STATS , PROF_STATS , ISR_STATS ,
+			 * STACK_STATS , debug replies are dropped */
+			DEBUG_answer(&g_rxFrame.s_Frame);
+			break;
 	}
+	PROF_END(PROF_ZONE_COMMAND);
+
+	/* One frame per run , the next frame may be in the RX Buffer already */
+	if(UART_available() != 0)
+		SCHED_setEvent(g_commandTask, EV_RX_BYTE);
 }
 
-/*******************************************************************************
- *                      Functions Definitions                                  *
- *******************************************************************************/
+/*
+ * Description: EEPROM Task , sends the response of the pending command
+ * 				after its EEPROM Transaction is finished
+ */
+void EEPROM_task(uint8 events)
+{
+	EEPROM_Response();
+
+	/* Frames received while waiting */
+	SCHED_setEvent(g_commandTask, EV_RX_BYTE);
+}
+
+/*
+ * Description: Call Back Function of UART RX ISR => wake the Command Task
+ */
+void UART_CallBack(void)
+{
+	SCHED_setEvent(g_commandTask, EV_RX_BYTE);
+}
 
 /*
  * Description: Function to Set New Password in EEPROM .
+ * 				The payload of the received CHANGE_PASSWORD frame is the
+ * 				Old Password or the Root Password + the New Password
  */
 void SetPassword(void)
 {
-	for (count = 0 ; count < PASS_SIZE ; count++)
+	bool password ;
+	bool root ;
+
+	if(g_rxFrame.s_Frame.s_Length != (2 * PASS_SIZE))
 	{
-		/* wait until UART receive a READY byte from HMI ECU*/
-		while (UART_receiveByte() != READY);
+		FRAME_send(DONT_MATCH, NULL_PTR, 0);
+		return ;
+	}
 
-		/* UART Ready To receive Data */
-		UART_sendByte(READY);
+	/* First start (no saved Password) => no Old Password .
+	 * Else a wrong Old / Root Password is counted in the Lockout like
+	 * CHECK_PASSWORD , both are checked every time (same latency) */
+	if(STORE_read(g_EEPassword) == PASS_RECORD_SIZE)
+	{
+		if(CheckLocked())
+			return ;
 
-		/* UART Receive Data */
-		g_password[count] = UART_receiveByte();
+		password = PasswordMatch(g_rxFrame.s_Frame.s_Payload) ;
+		root = RootMatch(g_rxFrame.s_Frame.s_Payload) ;
+		if(!(password | root))
+		{
+			CheckResult(CHANGE_PASSWORD, FALSE);
+			return ;
+		}
 
-		/* Write Password in External EEPROM */
-		EEPROM_writeByte((PASS_ADDRESS + count ) , g_password[count]);
-		T1_delay_msec(10);
+		/* Right Password clears the Lockout , the Password write waits it */
+		if(LOCK_getFailCount() != 0)
+		{
+			LOCK_reset(NULL_PTR);
+		}
 	}
-
+	g_checkResult = MATCH ;
+
+	/* Password is saved as a new Salt + SHA-256(Salt + Password) */
+	NewSalt(g_passRecord);
+	SHA256_saltedHash(g_passRecord, PASS_SALT_SIZE, &g_rxFrame.s_Frame.s_Payload[PASS_SIZE],
+			PASS_SIZE, &g_passRecord[PASS_SALT_SIZE], PASS_HASH_SIZE);
+
+	/* Append a Password record in the Credential Store , one page write + read back
+	 * the old record stays valid until it succeeds
+	 * response is sent by EEPROM_Response() */
+	EEPROM_request(CHANGE_PASSWORD,
+		STORE_write(g_passRecord, PASS_RECORD_SIZE, EEPROM_CallBack));
 }
 
 /*
- * Description: Function to Open Door For 10 Sec then Close Door for 10 Sec .
+ * Description: Function to Open the Door , Hold it Open then Close it .
+ * 				Returns immediately , the Door Actuator moves the Motor
+ * 				with Soft Start / Stop while the main loop serves UART frames
  */
 void MotorOn(void)
 {
-	/* Open Door For 10 Sec */
-	pinWrite(D,PD6,HIGH);
-	pinWrite(D,PD7,LOW);
-	T1_delay_sec(10);
-
-	/* Close Door For 10 Sec */
-	pinWrite(D,PD6,LOW);
-	pinWrite(D,PD7,HIGH);
-	T1_delay_sec(10);
-
-	/* Stop Motor at Closed Mode */
-	pinWrite(D,PD6,LOW);
-	pinWrite(D,PD7,LOW);
+	/* Door is already moving => ignored */
+	DOOR_open();
 }
 
 /*
  * Description: Function to check if the received password is equal to
  * 				the old password that saved in EEPROM .
+ * 				The Password is the payload of the received CHECK_PASSWORD frame
  */
 void CheckPassword(void)
 {
-	for (count = 0 ; count < PASS_SIZE ; count++)
+	if(CheckLocked())
+		return ;
+
+	if(g_rxFrame.s_Frame.s_Length != PASS_SIZE)
 	{
-		/* UART Ready To receive Data */
-		UART_sendByte(READY);
+		FRAME_send(DONT_MATCH, NULL_PTR, 0);
+		return ;
+	}
 
-		/* UART Receive Data */
-		g_password[count] = UART_receiveByte();
+	CheckResult(CHECK_PASSWORD, PasswordMatch(g_rxFrame.s_Frame.s_Payload));
+}
 
-		/* Read Password from External EEPROM */
-		EEPROM_readByte((PASS_ADDRESS + count ) , &g_EEPassword[count]);
-		T1_delay_msec(10);
+/*
+ * Description: Function to check if the received password is the Root Password ,
+ * 				the HMI ECU asks it before the New Password is entered .
+ * 				The Password is the payload of the received CHECK_ROOT frame
+ */
+void CheckRoot(void)
+{
+	if(CheckLocked())
+		return ;
 
+	if(g_rxFrame.s_Frame.s_Length != PASS_SIZE)
+	{
+		FRAME_send(DONT_MATCH, NULL_PTR, 0);
+		return ;
 	}
-	for (count = 0 ; count < PASS_SIZE ; count++)
+
+	CheckResult(CHECK_ROOT, RootMatch(g_rxFrame.s_Frame.s_Payload));
+}
+
+/*
+ * Description: Function to check if the received PIN is the password or
+ * 				an active user in the User Table .
+ * 				The PIN is the payload of the received CHECK_USER frame
+ */
+void CheckUser(void)
+{
+	bool password ;
+	bool user ;
+
+	if(CheckLocked())
+		return ;
+
+	if(g_rxFrame.s_Frame.s_Length != PASS_SIZE)
 	{
-		if(g_password[count] != g_EEPassword[count])
-		{
-			UART_sendByte(DONT_MATCH);
-			return ;
-		}
+		FRAME_send(DONT_MATCH, NULL_PTR, 0);
+		return ;
 	}
-	UART_sendByte(MATCH);
+
+	/* Password from RAM copy and User Table lookup (usually one page read) ,
+	 * both every time => the Password is not answered faster than a User */
+	password = PasswordMatch(g_rxFrame.s_Frame.s_Payload) ;
+	user = USERS_find(g_rxFrame.s_Frame.s_Payload) ;
+	CheckResult(CHECK_USER, password | user);
+}
+
+/*
+ * Description: Function to add / revoke a user (ADD_USER , REVOKE_USER) .
+ * 				The payload is the password + the user PIN
+ */
+void UserCommand(uint8 command)
+{
+	uint8 i ;
+
+	if(CheckLocked())
+		return ;
+
+	if(g_rxFrame.s_Frame.s_Length != (2 * PASS_SIZE))
+	{
+		FRAME_send(DONT_MATCH, NULL_PTR, 0);
+		return ;
+	}
+
+	/* Wrong Password is counted in the Lockout like CHECK_PASSWORD */
+	if(!PasswordMatch(g_rxFrame.s_Frame.s_Payload))
+	{
+		CheckResult(command, FALSE);
+		return ;
+	}
+	g_checkResult = MATCH ;
+
+	/* Right Password clears the Lockout , the User Entry write waits it */
+	if(LOCK_getFailCount() != 0)
+	{
+		LOCK_reset(NULL_PTR);
+	}
+
+	for (i = 0 ; i < PASS_SIZE ; i++)
+	{
+		g_password[i] = g_rxFrame.s_Frame.s_Payload[PASS_SIZE + i];
+	}
+
+	/* First user => write the User Table Salt */
+	if(!USERS_isSalted())
+	{
+		NewSalt(g_passRecord);
+		USERS_setSalt(g_passRecord);
+	}
+
+	/* Write the User Entry , response is sent by EEPROM_Response() */
+	if(command == ADD_USER)
+		EEPROM_request(command, USERS_add(g_password, EEPROM_CallBack));
+	else
+		EEPROM_request(command, USERS_revoke(g_password, EEPROM_CallBack));
+}
+
+/*
+ * Description: Function to count the result of a password check in the Lockout ,
+ * 				response is sent by EEPROM_Response() after the counter is written
+ * 				Wrong => counter + 1 , Right => counter = 0 (no write if already 0)
+ */
+void CheckResult(uint8 command, bool match)
+{
+	g_checkResult = match ? MATCH : DONT_MATCH ;
+
+	if(!match)
+	{
+		EEPROM_request(command, LOCK_fail(EEPROM_CallBack));
+	}
+	else if(LOCK_getFailCount() != 0)
+	{
+		EEPROM_request(command, LOCK_reset(EEPROM_CallBack));
+	}
+	else
+	{
+		FRAME_send(MATCH, NULL_PTR, 0);
+	}
+}
+
+/*
+ * Description: Function to send LOCKED response if the checks are locked
+ */
+bool CheckLocked(void)
+{
+	if(!LOCK_isLocked())
+		return FALSE ;
+
+	LockResponse();
+	return TRUE ;
+}
+
+/*
+ * Description: Function to send the response of a wrong password ,
+ * 				LOCKED with the seconds left or DONT_MATCH
+ */
+void LockResponse(void)
+{
+	uint16 seconds = LOCK_getRemainingSeconds() ;
+	uint8 payload[2];
+
+	if(seconds == 0)
+	{
+		FRAME_send(DONT_MATCH, NULL_PTR, 0);
+		return ;
+	}
+
+	payload[0] = (uint8)seconds ;
+	payload[1] = (uint8)(seconds >> 8) ;
+	FRAME_send(LOCKED, payload, 2);
+}
+
+/*
+ * Description: Function returns TRUE if pass is the password saved in EEPROM
+ * 				SHA-256(saved Salt + pass) is compared in constant time
+ */
+bool PasswordMatch(const uint8 *pass)
+{
+	uint8 hash[PASS_HASH_SIZE];
+	bool match ;
+
+	/* Read Password Record from the Credential Store (RAM copy) */
+	if(STORE_read(g_EEPassword) != PASS_RECORD_SIZE)
+		return FALSE ;
+
+	PROF_BEGIN(PROF_ZONE_PASSWORD_MATCH);
+	SHA256_saltedHash(g_EEPassword, PASS_SALT_SIZE, pass, PASS_SIZE,
+			hash, PASS_HASH_SIZE);
+	match = SHA256_compare(hash, &g_EEPassword[PASS_SALT_SIZE], PASS_HASH_SIZE) ;
+	PROF_END(PROF_ZONE_PASSWORD_MATCH);
+	return match ;
+}
+
+/*
+ * Description: Function returns TRUE if pass is the Root Password
+ * 				SHA-256(ROOT_SALT + pass) is compared in constant time
+ */
+bool RootMatch(const uint8 *pass)
+{
+	uint8 hash[PASS_HASH_SIZE];
+
+	SHA256_saltedHash(ROOT_SALT, PASS_SALT_SIZE, pass, PASS_SIZE,
+			hash, PASS_HASH_SIZE);
+	return SHA256_compare(hash, ROOT_HASH, PASS_HASH_SIZE) ;
+}
+
+/*
+ * Description: Function to make a new salt from the time of the request
+ * 				(Timer1 counter , millis()) and the saved Password record .
+ * 				Salt is not secret , it must only be different for every Password
+ */
+void NewSalt(uint8 *salt)
+{
+	SHA256_ContextType context ;
+	uint8 seed[6];
+	uint16 ticks = HAL_READ16(TCNT1) ;
+	uint32 now = millis() ;
+	uint8 i ;
+
+	seed[0] = (uint8)ticks ;
+	seed[1] = (uint8)(ticks >> 8) ;
+	for (i = 0 ; i < 4 ; i++)
+	{
+		seed[2 + i] = (uint8)(now >> (8 * i)) ;
+	}
+
+	SHA256_init(&context);
+	SHA256_update(&context, seed, sizeof(seed));
+	SHA256_update(&context, g_EEPassword, STORE_read(g_EEPassword));
+	SHA256_final(&context, salt, PASS_SALT_SIZE);
 }
 
 /*
@@ -166,50 +489,86 @@ void CheckPassword(void)
  */
 void EEPROM_CheckPassword(void)
 {
-	for (count = 0 ; count < PASS_SIZE ; count++)
+	/* check if there is a valid Password record (RAM copy) */
+	if(STORE_read(g_EEPassword) == PASS_RECORD_SIZE)
 	{
-		/* check if there is Password in External EEPROM */
-		EEPROM_readByte((PASS_ADDRESS + count ) , &g_EEPassword[count]);
-		T1_delay_msec(10);
-
-		/* Initial Value of EEPROM = 0xFF, So if its not equal to 0xFF
-		 * there is password saved there */
-		if(g_EEPassword[count] != 0xFF)
-		{
-			UART_sendByte(PASS_FOUND);
-			return;
-		}
+		FRAME_send(PASS_FOUND, NULL_PTR, 0);
+		return;
 	}
 
-	/* If Password not Found -> set New Password  */
-	UART_sendByte(PASS_NOT_FOUND);
-
-	/* Set New Password*/
-	SetPassword();
+	/* If Password not Found -> HMI ECU sends a CHANGE_PASSWORD frame
+	 * with the New Password */
+	FRAME_send(PASS_NOT_FOUND, NULL_PTR, 0);
+}
 
+/*
+ * Description: Function to save the command waiting an EEPROM Transaction
+ * 				started = ERROR => transaction not started , finish it now
+ */
+void EEPROM_request(uint8 command, uint8 started)
+{
+	g_pendingCommand = command ;
+	if(started != SUCCESS)
+	{
+		g_eepromStatus = TWI_ERROR ;
+		SCHED_setEvent(g_eepromTask, EV_EEPROM_DONE);
+	}
 }
 
 /*
- * Description: Function to delay in msec using Timer1
- * 				 Maximun value for msec 8000
+ * Description: Function to send the response of the pending command after
+ * 				its EEPROM Transaction is finished .
  */
-void T1_delay_msec(uint16 msec)
+void EEPROM_Response(void)
 {
-	/* 8000 => Timer1 Ticks for getting 1 sec.
-	 * F_CPU = 8Mhz		Prescaler = 1024	ticks = 8000 for 1 sec*/
-	Timer1_Ticks((msec * 8 ),0);
+	uint8 command = g_pendingCommand ;
 
-	/* Reset Timer1 to Zero */
-	Timer1_resetTimer();
+	g_pendingCommand = NO_COMMAND ;
 
-	/* Start Timer1*/
-	Timer1_restartTimer();
+	switch(command)
+	{
+		case CHECK_PASSWORD:
+		case CHECK_USER:
+		case CHECK_ROOT:
+			/* Lockout counter Saved */
+			if(g_checkResult == MATCH)
+				FRAME_send(MATCH, NULL_PTR, 0);
+			else
+				LockResponse();
+			break;
+		case ADD_USER:
+		case REVOKE_USER:
+		case CHANGE_PASSWORD:
+			/* Wrong Password , Lockout counter Saved */
+			if(g_checkResult != MATCH)
+			{
+				LockResponse();
+				break;
+			}
+			/* Password / User Entry Saved and Read Back */
+			FRAME_send((g_eepromStatus == TWI_SUCCESS) ? READY : DONT_MATCH,
+					NULL_PTR, 0);
+			break;
+	}
+}
 
-	/* wait until Timer1 ISR Fired and set g_delayFlag = TRUE */
-	while(!g_delayFlag);
+/*
+ * Description: Call Back Function of the EEPROM write (TWI ISR)
+ * 				Credential Store and User Table write through the EEPROM Cache
+ */
+void EEPROM_CallBack(void)
+{
+	g_eepromStatus = CACHE_getWriteStatus() ;
+	SCHED_setEvent(g_eepromTask, EV_EEPROM_DONE);
+}
 
-	/* clear delay flag */
-	g_delayFlag = FALSE ;
+/*
+ * Description: Function to delay in msec using the Software Timers Service
+ * 				 Timer1 keeps running , so software timers still fire
+ */
+void T1_delay_msec(uint16 msec)
+{
+	SoftTimer_delay(msec);
 }
 
 /*
@@ -226,17 +585,3 @@ void T1_delay_sec(uint16 sec)
 	}
 }
 
-/*
- * Description: Call Back Function of Timer1 ISR => Set delay flag
- */
-void Timer1_CallBack(void)
-{
-	g_delayFlag = TRUE ;
-
-	/* Stop Timer1 */
-	Timer1_stopTimer();
-
-	/* Reset Timer1 to Zero */
-	Timer1_resetTimer();
-}
-
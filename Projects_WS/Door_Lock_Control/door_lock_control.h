@@ -2,7 +2,7 @@
  *
  * Description: Smart Door Lock System
  * File Name:	door_lock_control.h
- * Connections: - Motor PD6:PD7
+ * Connections: - Motor Direction PD6:PD7 , Motor Enable (PWM) PB3/OC0
  * 				- External EEPROM PC0(SCL):PC1(SDA)
  * 				- Connect UART Lines Rx->Tx
  *
@@ -18,52 +18,141 @@
  *                    	  Libraries Include                                    *
  *******************************************************************************/
 
+#include "control_config.h"
 #include "uart.h"
+#include "frame.h"
+#include "door_lock_protocol.h"
 #include "external_eeprom.h"
+#include "eeprom_cache.h"
+#include "credential_store.h"
+#include "user_table.h"
+#include "door_actuator.h"
+#include "lockout.h"
+#include "sha256.h"
 #include "timer.h"
+#include "soft_timer.h"
+#include "scheduler.h"
+#include "power.h"
+#include "prof.h"
+#include "isr_stats.h"
+#include "debug_frames.h"
 #include "gpio.h"
 
 /*******************************************************************************
- *                   	   Macros Definition                                   *
+ *                      Preprocessor Macros                                    *
  *******************************************************************************/
 
-/* For UART confirmation */
-#define READY				 	0x01
-#define CHECK_PASSWORD		 	0x02
-#define MATCH					0x03
-#define DONT_MATCH				0x04
-#define CHANGE_PASSWORD			0x05
-#define OPEN_DOOR				0x06
-#define PASS_FOUND				0x07
-#define PASS_NOT_FOUND			0x08
+/* No command is waiting an EEPROM Transaction */
+#define NO_COMMAND		0x00
 
-/* Password Size */
-#define PASS_SIZE 5
+/* Tasks Events */
+#define EV_RX_BYTE		0x01	/* Command Task : UART byte received */
+#define EV_EEPROM_DONE	0x01	/* EEPROM Task : EEPROM Transaction finished */
 
-/* EEPROM MACROS */
-#define PASS_ADDRESS 0x0100
+/* Password Record in the Credential Store = Salt + Hash */
+#define PASS_RECORD_SIZE	(PASS_SALT_SIZE + PASS_HASH_SIZE)
 
+#if (PASS_RECORD_SIZE > STORE_DATA_SIZE)
+#error "Password Record is bigger than the Credential Store record"
+#endif
 
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 
+/*
+ * Description: Command Task , reads one command frame from HMI ECU
+ * 				and runs it
+ */
+void Command_task(uint8 events);
+
+/*
+ * Description: EEPROM Task , sends the response of the pending command
+ * 				after its EEPROM Transaction is finished
+ */
+void EEPROM_task(uint8 events);
+
+/*
+ * Description: Call Back Function of UART RX ISR => wake the Command Task
+ */
+void UART_CallBack(void);
+
 /*
  * Description: Function to Set New Password in EEPROM .
+ * 				The payload of the received CHANGE_PASSWORD frame is the
+ * 				Old Password or the Root Password + the New Password
  */
 void SetPassword(void);
 
 /*
- * Description: Function to Open Door For 10 Sec then Close Door for 10 Sec .
+ * Description: Function to Open the Door , Hold it Open then Close it .
+ * 				Returns immediately , the Door Actuator moves the Motor
  */
 void MotorOn(void);
 
 /*
  * Description: Function to check if the received password is equal to
  * 				the old password that saved in EEPROM .
+ * 				The Password is the payload of the received CHECK_PASSWORD frame
  */
 void CheckPassword(void);
 
+/*
+ * Description: Function to check if the received password is the Root Password .
+ * 				The Password is the payload of the received CHECK_ROOT frame
+ */
+void CheckRoot(void);
+
+/*
+ * Description: Function to check if the received PIN is the password or
+ * 				an active user in the User Table .
+ * 				The PIN is the payload of the received CHECK_USER frame
+ */
+void CheckUser(void);
+
+/*
+ * Description: Function to add / revoke a user (ADD_USER , REVOKE_USER) .
+ * 				The payload is the password + the user PIN
+ */
+void UserCommand(uint8 command);
+
+/*
+ * Description: Function to count the result of a password check in the Lockout ,
+ * 				response is sent by EEPROM_Response() after the counter is written
+ */
+void CheckResult(uint8 command, bool match);
+
+/*
+ * Description: Function to send LOCKED response if the checks are locked
+ *
+ * Return: TRUE if LOCKED is sent
+ */
+bool CheckLocked(void);
+
+/*
+ * Description: Function to send the response of a wrong password ,
+ * 				LOCKED with the seconds left or DONT_MATCH
+ */
+void LockResponse(void);
+
+/*
+ * Description: Function returns TRUE if pass is the password saved in EEPROM
+ * 				SHA-256(saved Salt + pass) is compared in constant time
+ */
+bool PasswordMatch(const uint8 *pass);
+
+/*
+ * Description: Function returns TRUE if pass is the Root Password
+ * 				SHA-256(ROOT_SALT + pass) is compared in constant time
+ */
+bool RootMatch(const uint8 *pass);
+
+/*
+ * Description: Function to make a new salt from the time of the request
+ * 				(Timer1 counter , millis()) and the saved Password record
+ */
+void NewSalt(uint8 *salt);
+
 /*
  * Description: Function to check if there is any saved password in EEPROM
  * 				before.
@@ -71,20 +160,33 @@ void CheckPassword(void);
 void EEPROM_CheckPassword(void);
 
 /*
- * Description: Function to delay in msec using Timer1
- * 				 Maximun value for msec 8000
+ * Description: Function to save the command waiting an EEPROM Transaction
+ * 				started = ERROR => transaction not started , finish it now
  */
-void T1_delay_msec(uint16 msec);
+void EEPROM_request(uint8 command, uint8 started);
 
 /*
- * Description: Function To Delay in sec by calling delay_ms function with 1000 ms.
+ * Description: Function to send the response of the pending command after
+ * 				its EEPROM Transaction is finished .
  */
-void T1_delay_sec(uint16 sec);
+void EEPROM_Response(void);
+
+/*
+ * Description: Call Back Function of the EEPROM write (TWI ISR)
+ * 				Credential Store and User Table write through the EEPROM Cache
+ */
+void EEPROM_CallBack(void);
 
 /*
- * Description: Call Back Function of Timer1 ISR => Set delay flag
+ * Description: Function to delay in msec using the Software Timers Service
+ * 				 Timer1 keeps running , so software timers still fire
  */
-void Timer1_CallBack(void);
+void T1_delay_msec(uint16 msec);
+
+/*
+ * Description: Function To Delay in sec by calling delay_ms function with 1000 ms.
+ */
+void T1_delay_sec(uint16 sec);
 
 
 #endif /* DOOR_LOCK_CONTROL_H_ */
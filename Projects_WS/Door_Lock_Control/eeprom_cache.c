@@ -0,0 +1,232 @@
+ /******************************************************************************
+ *
+ * Module: 		EEPROM Cache
+ * File Name: 	eeprom_cache.c
+ * Description: Source file for the RAM Write-Through Cache of the
+ * 				External EEPROM
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "eeprom_cache.h"
+#include "power.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* RAM copy of the region */
+static uint8 g_cacheData[CACHE_SIZE];
+
+/* TRUE while the RAM copy is equal to the EEPROM region */
+static volatile bool g_cacheValid = FALSE ;
+
+/* Hit / Miss Counters */
+static uint16 g_cacheHits = 0 ;
+static uint16 g_cacheMisses = 0 ;
+
+/* Write Transaction and its Read-Back Transaction */
+static TWI_TransactionType g_writeTransaction;
+static TWI_TransactionType g_verifyTransaction;
+
+/* Bytes of the running write */
+static uint16 g_writeAddress ;
+static const uint8 *g_writeData ;
+static uint8 g_writeLength ;
+static uint8 g_verifyData[EEPROM_PAGE_SIZE];
+
+/* Result of the last write and the user Call Back */
+static volatile TWI_Status g_writeStatus = TWI_SUCCESS ;
+static void (*g_writeCallBack)(void) = NULL_PTR ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description: Call Back of the write transaction => start the read-back
+ */
+static void CACHE_writeCallBack(void);
+
+/*
+ * Description: Call Back of the read-back transaction => compare , update RAM copy
+ */
+static void CACHE_verifyCallBack(void);
+
+/*
+ * Description: Function to finish the write and call the user Call Back
+ */
+static void CACHE_writeEnd(TWI_Status a_status);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to load the cached region from EEPROM (Blocking) .
+ */
+uint8 CACHE_init(void)
+{
+	g_cacheHits = 0 ;
+	g_cacheMisses = 0 ;
+	g_cacheValid = (EEPROM_readBlock(CACHE_ADDRESS, g_cacheData, CACHE_SIZE) == SUCCESS) ;
+	return g_cacheValid ? SUCCESS : ERROR ;
+}
+
+/*
+ * Description: Function to read length bytes from address (16-bit) .
+ * 				Inside the loaded region => RAM copy , else EEPROM_readBlock() .
+ */
+uint8 CACHE_read(uint16 u16addr, uint8 *data, uint8 length)
+{
+	uint8 i;
+
+	/* Outside the region => EEPROM */
+	/* address below the region wraps to a big offset */
+	if (((uint16)(u16addr - CACHE_ADDRESS) + length) > CACHE_SIZE)
+	{
+		g_cacheMisses++ ;
+		return EEPROM_readBlock(u16addr, data, length);
+	}
+
+	if (g_cacheValid)
+	{
+		g_cacheHits++ ;
+	}
+	else
+	{
+		/* RAM copy not loaded (or last write failed) => load the region again */
+		g_cacheMisses++ ;
+		g_cacheValid = (EEPROM_readBlock(CACHE_ADDRESS, g_cacheData, CACHE_SIZE) == SUCCESS) ;
+		if (!g_cacheValid)
+			return ERROR;
+	}
+
+	for (i = 0 ; i < length ; i++)
+	{
+		data[i] = g_cacheData[u16addr - CACHE_ADDRESS + i];
+	}
+	return SUCCESS;
+}
+
+/*
+ * Description: Function to start writing length bytes into one EEPROM page (Non-Blocking) .
+ * 	1. Write the page (TWI transaction).
+ * 	2. Read the bytes back (TWI transaction , waits the write cycle by ACK Polling).
+ * 	3. Compare , update the RAM copy , call a_callBack.
+ */
+uint8 CACHE_write(uint16 u16addr, const uint8 *data, uint8 length, void(*a_callBack)(void))
+{
+	/* One write at a time , the next write waits the running one
+	 * (TWI interrupt wakes the CPU) */
+	while (g_writeStatus == TWI_PENDING)
+	{
+		POWER_sleep();
+	}
+
+	g_writeAddress = u16addr ;
+	g_writeData = data ;
+	g_writeLength = length ;
+	g_writeCallBack = a_callBack ;
+	g_writeStatus = TWI_PENDING ;
+
+	if (EEPROM_writePageAsync(&g_writeTransaction, u16addr, data, length,
+			CACHE_writeCallBack) != SUCCESS)
+	{
+		g_writeStatus = TWI_ERROR ;
+		return ERROR;
+	}
+	return SUCCESS;
+}
+
+/*
+ * Description: Function returns the result of the last CACHE_write()
+ */
+TWI_Status CACHE_getWriteStatus(void)
+{
+	return g_writeStatus;
+}
+
+/*
+ * Description: Function returns the number of reads served from RAM
+ */
+uint16 CACHE_getHitCount(void)
+{
+	return g_cacheHits;
+}
+
+/*
+ * Description: Function returns the number of reads served from EEPROM
+ */
+uint16 CACHE_getMissCount(void)
+{
+	return g_cacheMisses;
+}
+
+/*
+ * Description: Call Back of the write transaction => start the read-back
+ */
+static void CACHE_writeCallBack(void)
+{
+	if (g_writeTransaction.s_Status != TWI_SUCCESS)
+	{
+		CACHE_writeEnd(TWI_ERROR);
+		return;
+	}
+
+	/* queued after the write transaction , starts after its Stop */
+	EEPROM_readBlockAsync(&g_verifyTransaction, g_writeAddress, g_verifyData,
+			g_writeLength, CACHE_verifyCallBack);
+}
+
+/*
+ * Description: Call Back of the read-back transaction => compare , update RAM copy
+ */
+static void CACHE_verifyCallBack(void)
+{
+	uint8 i;
+
+	if (g_verifyTransaction.s_Status != TWI_SUCCESS)
+	{
+		CACHE_writeEnd(TWI_ERROR);
+		return;
+	}
+
+	for (i = 0 ; i < g_writeLength ; i++)
+	{
+		if (g_verifyData[i] != g_writeData[i])
+		{
+			CACHE_writeEnd(TWI_ERROR);
+			return;
+		}
+	}
+
+	/* EEPROM has the new bytes => update the RAM copy */
+	for (i = 0 ; i < g_writeLength ; i++)
+	{
+		if ((g_writeAddress + i >= CACHE_ADDRESS) &&
+			(g_writeAddress + i < CACHE_ADDRESS + CACHE_SIZE))
+		{
+			g_cacheData[g_writeAddress + i - CACHE_ADDRESS] = g_writeData[i];
+		}
+	}
+	CACHE_writeEnd(TWI_SUCCESS);
+}
+
+/*
+ * Description: Function to finish the write and call the user Call Back
+ * 				Failed write => EEPROM bytes are unknown , the next CACHE_read()
+ * 				loads the region again
+ */
+static void CACHE_writeEnd(TWI_Status a_status)
+{
+	if (a_status != TWI_SUCCESS)
+	{
+		g_cacheValid = FALSE ;
+	}
+	g_writeStatus = a_status ;
+	if (g_writeCallBack != NULL_PTR)
+	{
+		g_writeCallBack();
+	}
+}
@@ -0,0 +1,84 @@
+ /******************************************************************************
+ *
+ * Module: 		EEPROM Cache
+ * File Name: 	eeprom_cache.h
+ * Description: Header file for the RAM Write-Through Cache of the
+ * 				External EEPROM
+ *
+ * Notes:		- CACHE_init() reads the region [CACHE_ADDRESS , CACHE_ADDRESS + CACHE_SIZE)
+ * 				  once at boot , CACHE_read() inside the region is a RAM copy (hit)
+ * 				  outside the region or after a failed write it reads the EEPROM (miss)
+ * 				  a failed write makes the next read inside the region load it again
+ *
+ * 				- CACHE_write() writes the EEPROM first , then reads the bytes back
+ * 				  and compares them , RAM copy is updated only if they match
+ * 				  (Write-Through with validation) , runs on TWI ISR transactions
+ *
+ * 				- CACHE_write() while a write is running waits it (Blocking) ,
+ * 				  so no write is dropped . Not from a Call Back of a write
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef EEPROM_CACHE_H_
+#define EEPROM_CACHE_H_
+
+#include "std_types.h"
+#include "control_config.h"
+#include "external_eeprom.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Cached region , set in control_config.h */
+#ifndef CACHE_ADDRESS
+#define CACHE_ADDRESS		0x0000
+#endif
+
+#ifndef CACHE_SIZE
+#define CACHE_SIZE			EEPROM_PAGE_SIZE
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function to load the cached region from EEPROM (Blocking) .
+ * 				EEPROM_init() must be called first .
+ */
+uint8 CACHE_init(void);
+
+/*
+ * Description: Function to read length bytes from address (16-bit) .
+ * 				Inside the region => RAM copy , else EEPROM_readBlock() .
+ */
+uint8 CACHE_read(uint16 u16addr, uint8 *data, uint8 length);
+
+/*
+ * Description: Function to start writing length bytes into one EEPROM page (Non-Blocking) ,
+ * 				waits the running write first if there is one .
+ * 				a_callBack is called from TWI ISR after the read-back compare ,
+ * 				result in CACHE_getWriteStatus() . data must not change until then .
+ */
+uint8 CACHE_write(uint16 u16addr, const uint8 *data, uint8 length, void(*a_callBack)(void));
+
+/*
+ * Description: Function returns the result of the last CACHE_write()
+ * 				TWI_PENDING , TWI_SUCCESS , TWI_ERROR (write failed or read-back differs)
+ */
+TWI_Status CACHE_getWriteStatus(void);
+
+/*
+ * Description: Function returns the number of reads served from RAM
+ */
+uint16 CACHE_getHitCount(void);
+
+/*
+ * Description: Function returns the number of reads served from EEPROM
+ */
+uint16 CACHE_getMissCount(void);
+
+#endif /* EEPROM_CACHE_H_ */
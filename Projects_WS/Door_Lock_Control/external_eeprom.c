@@ -9,6 +9,33 @@
  *******************************************************************************/
 #include "i2c.h"
 #include "external_eeprom.h"
+#include "power.h"
+#include "control_config.h"
+#include "prof.h"
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description: Function to start a transfer and send the memory address .
+ */
+static uint8 EEPROM_select(uint16 u16addr);
+
+/*
+ * Description: Function to fill the common fields of an EEPROM transaction .
+ */
+static void EEPROM_prepare(TWI_TransactionType *a_transaction, uint16 u16addr,
+		void(*a_callBack)(void));
+
+/*
+ * Description: Function to Read length bytes (Sequential Read) , length > 0 .
+ */
+static uint8 EEPROM_sequentialRead(uint16 u16addr, uint8 *data, uint16 length);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
 
 /*
  * Description: Function to Initialize External EEPROM .
@@ -16,85 +43,248 @@
 void EEPROM_init(void)
 {
 	/* Create configuration structure for I2C driver */
-	I2C_ConfigType I2C_Config = {.s_SlaveAddress = 0x01 , .s_Clock = F_400K} ;
+	/* Interrupt Enabled for the TWI transactions engine */
+	I2C_ConfigType I2C_Config = {.s_SlaveAddress = 0x01 , .s_Clock = F_400K ,
+			.s_Interrupt = I2C_ENABLE} ;
 
 	/* initialize I2C(TWI) module inside the MC */
 	TWI_init(&I2C_Config);
 }
 
+/*
+ * Description: Function to start a transfer and send the memory address .
+ * 	1. Send Start Bit + device address with R/W=0 (write).
+ * 	2. If the EEPROM doesn't ACK , it is busy in an internal write cycle
+ * 	   => Stop and try again (ACK Polling) , up to EEPROM_ACK_POLLS times.
+ * 	3. Send the required memory location address A0:A7.
+ * 	The bus is not released on SUCCESS , caller continues the transfer.
+ */
+static uint8 EEPROM_select(uint16 u16addr)
+{
+	uint16 polls = 0;
+
+	/* Wait the queued TWI transactions , the bus is used by TWI ISR ,
+	 * TWI interrupt wakes the CPU */
+	while(TWI_isBusy())
+	{
+		POWER_sleep();
+	}
+
+	while(1)
+	{
+		/* Send the Start Bit */
+		TWI_start();
+		if (TWI_getStatus() != TW_START)
+		{
+			TWI_stop();
+			return ERROR;
+		}
+
+		/* Send the device address, we need to get A8 A9 A10 address bits from the
+		 * memory location address and R/W=0 (write) */
+		TWI_write((uint8)((EEPROM_FIXED_ADDRESS) | ((u16addr & 0x0700)>>7)));
+		if (TWI_getStatus() == TW_MT_SLA_W_ACK)
+			break;
+
+		/* No ACK => write cycle is not finished yet (or no EEPROM) */
+		TWI_stop();
+		polls++;
+		if (polls >= EEPROM_ACK_POLLS)
+			return ERROR;
+	}
+
+	/* Send the required memory location address
+	 * only Least 8 bits A0:A7 */
+	TWI_write((uint8)(u16addr));
+	if (TWI_getStatus() != TW_MT_DATA_ACK)
+	{
+		TWI_stop();
+		return ERROR;
+	}
+	return SUCCESS;
+}
+
 /*
  * Description: Function to write Data(8-bits) into EEPROM in address (16-bit) .
+ * 				Returns after the Stop Bit , the next access waits the
+ * 				write cycle by ACK Polling .
  */
 uint8 EEPROM_writeByte(uint16 u16addr, uint8 u8data)
 {
-	/* Send the Start Bit */
-    TWI_start();
-    if (TWI_getStatus() != TW_START)
-        return ERROR;
-		
-    /* Send the device address, we need to get A8 A9 A10 address bits from the
-     * memory location address and R/W=0 (write) */
-    TWI_write((uint8)((EEPROM_FIXED_ADDRESS) | ((u16addr & 0x0700)>>7)));
-    if (TWI_getStatus() != TW_MT_SLA_W_ACK)
-        return ERROR; 
-		 
-    /* Send the required memory location address
-     * only Least 8 bits A0:A7 */
-    TWI_write((uint8)(u16addr));
-    if (TWI_getStatus() != TW_MT_DATA_ACK)
-        return ERROR;
-		
-    /* write byte to eeprom */
-    TWI_write(u8data);
-    if (TWI_getStatus() != TW_MT_DATA_ACK)
-        return ERROR;
-
-    /* Send the Stop Bit */
-    TWI_stop();
-	
-    return SUCCESS;
+	return EEPROM_writePage(u16addr, &u8data, 1);
 }
 
+/*
+ * Description: Function to write length bytes into EEPROM from address (16-bit) .
+ * 				Data is split at EEPROM_PAGE_SIZE boundaries , one write cycle
+ * 				per page instead of one per byte .
+ */
+uint8 EEPROM_writePage(uint16 u16addr, const uint8 *data, uint16 length)
+{
+	uint8 pageBytes;
+
+	while (length > 0)
+	{
+		/* Bytes until the end of this page , the EEPROM page address counter
+		 * rolls over inside the page */
+		pageBytes = EEPROM_PAGE_SIZE - (u16addr & (EEPROM_PAGE_SIZE - 1));
+		if (pageBytes > length)
+			pageBytes = (uint8)length;
+
+		if (EEPROM_select(u16addr) != SUCCESS)
+			return ERROR;
+
+		length -= pageBytes;
+		u16addr += pageBytes;
+
+		/* write bytes to eeprom page buffer */
+		while (pageBytes > 0)
+		{
+			TWI_write(*data);
+			if (TWI_getStatus() != TW_MT_DATA_ACK)
+			{
+				TWI_stop();
+				return ERROR;
+			}
+			data++;
+			pageBytes--;
+		}
+
+		/* Send the Stop Bit => EEPROM starts the write cycle */
+		TWI_stop();
+	}
+	return SUCCESS;
+}
 
 /*
  * Description: Function to Read Data(8-bits) From EEPROM address (16-bit) .
  */
 uint8 EEPROM_readByte(uint16 u16addr, uint8 *u8data)
 {
-	/* Send the Start Bit */
-    TWI_start();
-    if (TWI_getStatus() != TW_START)
-        return ERROR;
-		
-    /* Send the device address, we need to get A8 A9 A10 address bits from the
-     * memory location address and R/W=0 (write) */
-    TWI_write((uint8)((EEPROM_FIXED_ADDRESS) | ((u16addr & 0x0700)>>7)));
-    if (TWI_getStatus() != TW_MT_SLA_W_ACK)
-        return ERROR;
-		
-    /* Send the required memory location address
-     * only Least 8 bits A0:A7 */
-    TWI_write((uint8)(u16addr));
-    if (TWI_getStatus() != TW_MT_DATA_ACK)
-        return ERROR;
-		
+	return EEPROM_readBlock(u16addr, u8data, 1);
+}
+
+/*
+ * Description: Function to Read length bytes From EEPROM address (16-bit) .
+ * 				Profiling Zone PROF_ZONE_EEPROM_READ .
+ */
+uint8 EEPROM_readBlock(uint16 u16addr, uint8 *data, uint16 length)
+{
+	uint8 status ;
+
+	if (length == 0)
+		return SUCCESS;
+
+	PROF_BEGIN(PROF_ZONE_EEPROM_READ);
+	status = EEPROM_sequentialRead(u16addr, data, length);
+	PROF_END(PROF_ZONE_EEPROM_READ);
+	return status;
+}
+
+/*
+ * Description: Function to Read length bytes From EEPROM address (16-bit) .
+ * 				Sequential Read , master sends ACK after every byte except
+ * 				the last one .
+ */
+static uint8 EEPROM_sequentialRead(uint16 u16addr, uint8 *data, uint16 length)
+{
+	if (EEPROM_select(u16addr) != SUCCESS)
+		return ERROR;
+
     /* Send the Repeated Start Bit */
     TWI_start();
     if (TWI_getStatus() != TW_REP_START)
+    {
+        TWI_stop();
         return ERROR;
-		
+    }
+
     /* Send the device address, we need to get A8 A9 A10 address bits from the
      * memory location address and R/W=1 (Read) */
     TWI_write((uint8)((EEPROM_FIXED_ADDRESS) | ((u16addr & 0x0700)>>7) | 1 /* R/W bit */));
     if (TWI_getStatus() != TW_MT_SLA_R_ACK)
+    {
+        TWI_stop();
         return ERROR;
+    }
+
+    /* Read Bytes from Memory with ACK , EEPROM increments the address */
+    while (length > 1)
+    {
+        *data = TWI_readWithACK();
+        if (TWI_getStatus() != TW_MR_DATA_ACK)
+        {
+            TWI_stop();
+            return ERROR;
+        }
+        data++;
+        length--;
+    }
 
-    /* Read Byte from Memory without send ACK */
-    *u8data = TWI_readWithNACK();
+    /* Read Last Byte from Memory without send ACK */
+    *data = TWI_readWithNACK();
     if (TWI_getStatus() != TW_MR_DATA_NACK)
+    {
+        TWI_stop();
         return ERROR;
+    }
 
     /* Send the Stop Bit */
     TWI_stop();
     return SUCCESS;
 }
+
+/*
+ * Description: Function to fill the common fields of an EEPROM transaction .
+ * 				Device address has A8:A10 , header is the address A0:A7 .
+ */
+static void EEPROM_prepare(TWI_TransactionType *a_transaction, uint16 u16addr,
+		void(*a_callBack)(void))
+{
+	a_transaction->s_SlaveAddress = (uint8)((EEPROM_FIXED_ADDRESS) | ((u16addr & 0x0700)>>7));
+	a_transaction->s_Header[0] = (uint8)(u16addr);
+	a_transaction->s_HeaderLength = 1;
+	a_transaction->s_TxBuffer = NULL_PTR;
+	a_transaction->s_TxLength = 0;
+	a_transaction->s_RxBuffer = NULL_PTR;
+	a_transaction->s_RxLength = 0;
+	a_transaction->s_Polls = EEPROM_ACK_POLLS;
+	a_transaction->s_callBack = a_callBack;
+}
+
+/*
+ * Description: Function to start writing length bytes into one EEPROM page (Non-Blocking) .
+ * 				a_callBack is called from TWI ISR when the page is sent ,
+ * 				data must not change until then .
+ * 				Returns ERROR if the bytes cross the page boundary .
+ */
+uint8 EEPROM_writePageAsync(TWI_TransactionType *a_transaction, uint16 u16addr,
+		const uint8 *data, uint8 length, void(*a_callBack)(void))
+{
+	if ((length == 0) ||
+		(((u16addr & (EEPROM_PAGE_SIZE - 1)) + length) > EEPROM_PAGE_SIZE))
+		return ERROR;
+
+	EEPROM_prepare(a_transaction, u16addr, a_callBack);
+	a_transaction->s_TxBuffer = data;
+	a_transaction->s_TxLength = length;
+	TWI_submit(a_transaction);
+	return SUCCESS;
+}
+
+/*
+ * Description: Function to start reading length bytes From EEPROM address (Non-Blocking) .
+ * 				a_callBack is called from TWI ISR when data is received .
+ */
+uint8 EEPROM_readBlockAsync(TWI_TransactionType *a_transaction, uint16 u16addr,
+		uint8 *data, uint8 length, void(*a_callBack)(void))
+{
+	if (length == 0)
+		return ERROR;
+
+	EEPROM_prepare(a_transaction, u16addr, a_callBack);
+	a_transaction->s_RxBuffer = data;
+	a_transaction->s_RxLength = length;
+	TWI_submit(a_transaction);
+	return SUCCESS;
+}
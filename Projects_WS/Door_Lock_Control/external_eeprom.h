@@ -12,6 +12,7 @@
 #define EXTERNAL_EEPROM_H_
 
 #include "std_types.h"
+#include "i2c.h"
 
 /*******************************************************************************
  *                      Preprocessor Macros                                    *
@@ -20,6 +21,16 @@
 #define SUCCESS 1
 #define EEPROM_FIXED_ADDRESS 0xA0
 
+/* 24C16 Size (16 Kbit) */
+#define EEPROM_SIZE 2048
+
+/* 24C16 Page Size , bytes of one page write */
+#define EEPROM_PAGE_SIZE 16
+
+/* Max. Start + Address tries while the EEPROM is in a write cycle
+ * 1 try ~ 25 us @ 400Khz => 400 tries > 5 ms write cycle time */
+#define EEPROM_ACK_POLLS 400
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
@@ -31,6 +42,7 @@ void EEPROM_init(void);
 
 /*
  * Description: Function to write Data(8-bits) into EEPROM address (16-bit) .
+ * 				Write cycle completion is detected by ACK Polling in the next access .
  */
 uint8 EEPROM_writeByte(uint16 u16addr,uint8 u8data);
 
@@ -38,5 +50,33 @@ uint8 EEPROM_writeByte(uint16 u16addr,uint8 u8data);
  * Description: Function to Read Data(8-bits) From EEPROM address (16-bit) .
  */
 uint8 EEPROM_readByte(uint16 u16addr,uint8 *u8data);
+
+/*
+ * Description: Function to write length bytes into EEPROM from address (16-bit) .
+ * 				One write cycle per EEPROM_PAGE_SIZE page .
+ */
+uint8 EEPROM_writePage(uint16 u16addr,const uint8 *data,uint16 length);
+
+/*
+ * Description: Function to Read length bytes From EEPROM address (16-bit) .
+ * 				One Sequential Read transfer .
+ */
+uint8 EEPROM_readBlock(uint16 u16addr,uint8 *data,uint16 length);
+
+/*
+ * Description: Function to start writing length bytes into one EEPROM page (Non-Blocking) .
+ * 				a_callBack is called from TWI ISR when finished ,
+ * 				result in a_transaction->s_Status .
+ */
+uint8 EEPROM_writePageAsync(TWI_TransactionType *a_transaction, uint16 u16addr,
+		const uint8 *data, uint8 length, void(*a_callBack)(void));
+
+/*
+ * Description: Function to start reading length bytes From EEPROM address (Non-Blocking) .
+ * 				a_callBack is called from TWI ISR when finished ,
+ * 				result in a_transaction->s_Status .
+ */
+uint8 EEPROM_readBlockAsync(TWI_TransactionType *a_transaction, uint16 u16addr,
+		uint8 *data, uint8 length, void(*a_callBack)(void));
  
 #endif /* EXTERNAL_EEPROM_H_ */
@@ -8,6 +8,7 @@
  *******************************************************************************/
  
 #include "i2c.h"
+#include "isr_stats.h"
 
 /*******************************************************************************
  *                          Global Variables                                   *
@@ -22,19 +23,52 @@ volatile uint8 g_i2cData;
 /* g_I2C_callBack_ptr Global Pointer to function to store I2C Call Back Function */
 static void (*g_I2C_callBack_ptr)(void) = NULL_PTR ;
 
+/* Transactions Queue , g_twiHead is the running transaction */
+static TWI_TransactionType * volatile g_twiHead = NULL_PTR ;
+static TWI_TransactionType * volatile g_twiTail = NULL_PTR ;
+
+/* Running transaction progress */
+static uint8 g_twiIndex ;		/* next byte of header / TX data / RX data */
+static uint16 g_twiPolls ;		/* SLA+W tries left */
+static bool g_twiReading ;		/* TRUE after Repeated Start */
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description: Function to run one step of the running transaction (TWI ISR)
+ */
+static void TWI_transactionStep(void);
+
+/*
+ * Description: Function to finish the running transaction and start the next one
+ */
+static void TWI_transactionEnd(TWI_Status a_status);
+
 /*******************************************************************************
  *                          ISR's Definitions                                  *
  *******************************************************************************/
 
 ISR(TWI_vect)
 {
-
-	g_i2cData = TWDR ;
-	if(g_I2C_callBack_ptr != NULL_PTR)
+	/* No event time stamp */
+	ISR_STATS_ENTER(ISR_STATS_TWI, ISR_STATS_NO_LATENCY);
+	if(g_twiHead != NULL_PTR)
+	{
+		/* Transaction running => next step of the frame */
+		TWI_transactionStep();
+	}
+	else
 	{
-		/* Call the Call Back function in the application after the I2C finished */
-		(*g_I2C_callBack_ptr)();
+		g_i2cData = HAL_READ(TWDR) ;
+		if(g_I2C_callBack_ptr != NULL_PTR)
+		{
+			/* Call the Call Back function in the application after the I2C finished */
+			(*g_I2C_callBack_ptr)();
+		}
 	}
+	ISR_STATS_EXIT(ISR_STATS_TWI);
 }
 
 
@@ -61,26 +95,26 @@ void TWI_init(I2C_ConfigType *a_Config_ptr)
 
     if(a_Config_ptr->s_Clock == F_400K && F_CPU >= 8000000)
     {
-    	TWBR = ((uint8)(((F_CPU/400000) -16) / 2)) ;		/* TWBR = 2 for F_CPU=8Mhz */
-    	TWSR = 0x00;
+    	HAL_WRITE(TWBR, ((uint8)(((F_CPU/400000) -16) / 2)));		/* TWBR = 2 for F_CPU=8Mhz */
+    	HAL_WRITE(TWSR, 0x00);
     }
     else if(a_Config_ptr->s_Clock == F_100K && F_CPU >= 8000000)
     {
-    	TWBR = ((uint8)(((F_CPU/100000) -16) / 2)) ;		/* TWBR = 32 for F_CPU=8Mhz */
-    	TWSR = 0x00;
+    	HAL_WRITE(TWBR, ((uint8)(((F_CPU/100000) -16) / 2)));		/* TWBR = 32 for F_CPU=8Mhz */
+    	HAL_WRITE(TWSR, 0x00);
     }
 	
 	 /* Two Wire Bus address my address if any master device want to call me: s_SlaveAddress
 	  * (used in case this MC is a slave device)
 	  * General Call Recognition: s_GCRecognition_Enable */
-	TWAR = ((TWAR & (0x01)) | ((a_Config_ptr->s_SlaveAddress) << TWA0 ));
-	TWAR = ((TWAR & (0xFE)) | ((a_Config_ptr->s_GCRecognition_Enable) << TWGCE ));
+	HAL_WRITE(TWAR, ((HAL_READ(TWAR) & (0x01)) | ((a_Config_ptr->s_SlaveAddress) << TWA0 )));
+	HAL_WRITE(TWAR, ((HAL_READ(TWAR) & (0xFE)) | ((a_Config_ptr->s_GCRecognition_Enable) << TWGCE )));
 	
 	/* Set Interrupt */
-	TWCR = (TWCR & ~(1<<TWIE)) | ((a_Config_ptr->s_Interrupt) << TWIE);
+	HAL_WRITE(TWCR, (HAL_READ(TWCR) & ~(1<<TWIE)) | ((a_Config_ptr->s_Interrupt) << TWIE));
 
 	/* Enable TWI Module */
-    TWCR |= (1<<TWEN);
+    HAL_OR(TWCR, (1<<TWEN));
 }
 
 /*
@@ -93,10 +127,10 @@ void TWI_start(void)
 	 * send the start bit by TWSTA=1
 	 * Enable TWI Module TWEN=1 
 	 */
-    TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
+    HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWSTA) | (1 << TWEN));
     
     /* Wait for TWINT flag set in TWCR Register (start bit is send successfully) */
-    while(BIT_IS_CLEAR(TWCR,TWINT));
+    while(HAL_BIT_IS_CLEAR(TWCR,TWINT));
 }
 
 /*
@@ -109,7 +143,7 @@ void TWI_stop(void)
 	 * send the stop bit by TWSTO=1
 	 * Enable TWI Module TWEN=1 
 	 */
-    TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWEN);
+    HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWSTO) | (1 << TWEN));
 }
 
 /*
@@ -120,26 +154,26 @@ void TWI_write(uint8 data)
 	if(g_i2cInterrupt)
 	{
 	    /* Put data On TWI data Register */
-	    TWDR = data;
+	    HAL_WRITE(TWDR, data);
 	    /*
 		 * Clear the TWINT flag before sending the data TWINT=1
 		 * Enable TWI Module TWEN=1
 		 */
-	    TWCR = (1 << TWINT) | (1 << TWEN);
+	    HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWEN));
 	    /* Wait for TWINT flag set in TWCR Register(data is send successfully) */
-	    while(BIT_IS_CLEAR(TWCR,TWINT));
+	    while(HAL_BIT_IS_CLEAR(TWCR,TWINT));
 	}
 	else
 	{
 	    /* Put data On TWI data Register */
-	    TWDR = data;
+	    HAL_WRITE(TWDR, data);
 	    /*
 		 * Clear the TWINT flag before sending the data TWINT=1
 		 * Enable TWI Module TWEN=1
 		 */
-	    TWCR = (1 << TWINT) | (1 << TWEN);
+	    HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWEN));
 	    /* Wait for TWINT flag set in TWCR Register(data is send successfully) */
-	    while(BIT_IS_CLEAR(TWCR,TWINT));
+	    while(HAL_BIT_IS_CLEAR(TWCR,TWINT));
 	}
 
 }
@@ -156,11 +190,11 @@ uint8 TWI_readWithACK(void)
 		 * Enable sending ACK after reading or receiving data TWEA=1
 		 * Enable TWI Module TWEN=1
 		 */
-	    TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWEA);
+	    HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWEN) | (1 << TWEA));
 	    /* Wait for TWINT flag set in TWCR Register (data received successfully) */
-	    while(BIT_IS_CLEAR(TWCR,TWINT));
+	    while(HAL_BIT_IS_CLEAR(TWCR,TWINT));
 	    /* Read Data */
-	    return TWDR;
+	    return HAL_READ(TWDR);
 	}
 	else
 	{
@@ -169,11 +203,11 @@ uint8 TWI_readWithACK(void)
 		 * Enable sending ACK after reading or receiving data TWEA=1
 		 * Enable TWI Module TWEN=1
 		 */
-	    TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWEA);
+	    HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWEN) | (1 << TWEA));
 	    /* Wait for TWINT flag set in TWCR Register (data received successfully) */
-	    while(BIT_IS_CLEAR(TWCR,TWINT));
+	    while(HAL_BIT_IS_CLEAR(TWCR,TWINT));
 	    /* Read Data */
-	    return TWDR;
+	    return HAL_READ(TWDR);
 	}
 }
 
@@ -188,11 +222,11 @@ uint8 TWI_readWithNACK(void)
 		 * Clear the TWINT flag before reading the data TWINT=1
 		 * Enable TWI Module TWEN=1
 		 */
-		TWCR = (1 << TWINT) | (1 << TWEN);
+		HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWEN));
 		/* Wait for TWINT flag set in TWCR Register (data received successfully) */
-		while(BIT_IS_CLEAR(TWCR,TWINT));
+		while(HAL_BIT_IS_CLEAR(TWCR,TWINT));
 		/* Read Data */
-		return TWDR;
+		return HAL_READ(TWDR);
 	}
 	else
 	{
@@ -200,11 +234,11 @@ uint8 TWI_readWithNACK(void)
 		 * Clear the TWINT flag before reading the data TWINT=1
 		 * Enable TWI Module TWEN=1
 		 */
-	    TWCR = (1 << TWINT) | (1 << TWEN);
+	    HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWEN));
 	    /* Wait for TWINT flag set in TWCR Register (data received successfully) */
-	    while(BIT_IS_CLEAR(TWCR,TWINT));
+	    while(HAL_BIT_IS_CLEAR(TWCR,TWINT));
 	    /* Read Data */
-	    return TWDR;
+	    return HAL_READ(TWDR);
 	}
 
 }
@@ -225,7 +259,7 @@ uint8 TWI_getStatus(void)
 {
     uint8 status;
     /* masking to eliminate first 3 bits and get the last 5 bits (status bits) */
-    status = TWSR & 0xF8;
+    status = HAL_READ(TWSR) & 0xF8;
     return status;
 }
 
@@ -238,3 +272,161 @@ void I2C_setCallBack(void(*a_ptr)(void))
 	g_I2C_callBack_ptr = a_ptr ;
 
 }
+
+/*
+ * Description: Function to add a transaction to the queue (Non-Blocking)
+ * 				The transaction starts now if the bus is idle
+ */
+void TWI_submit(TWI_TransactionType *a_transaction)
+{
+	uint8 sreg = SREG ;
+
+	a_transaction->s_next = NULL_PTR ;
+	a_transaction->s_Status = TWI_PENDING ;
+
+	cli();
+	if(g_twiHead == NULL_PTR)
+	{
+		/* Bus idle => start now */
+		g_twiHead = g_twiTail = a_transaction ;
+		g_twiIndex = 0 ;
+		g_twiPolls = a_transaction->s_Polls ;
+		g_twiReading = FALSE ;
+		HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE));
+	}
+	else
+	{
+		g_twiTail->s_next = a_transaction ;
+		g_twiTail = a_transaction ;
+	}
+	SREG = sreg ;
+}
+
+/*
+ * Description: Function returns TRUE while transactions are queued or running
+ */
+bool TWI_isBusy(void)
+{
+	return (g_twiHead != NULL_PTR) ;
+}
+
+/*
+ * Description: Function to run one step of the running transaction (TWI ISR)
+ * 	every TWINT , the status code selects the next bus action :
+ * 	START / REP_START 		=> send SLA+W / SLA+R
+ * 	SLA_W_ACK / DATA_ACK 	=> send next header / TX byte , then
+ * 							   Repeated Start if there is RX data , else Stop
+ * 	SLA_W_NACK 				=> Stop + Start again (ACK Polling)
+ * 	SLA_R_ACK / DATA_ACK	=> receive next byte , NACK for the last byte
+ * 	MR_DATA_NACK 			=> last byte received , Stop
+ * 	others					=> Stop , TWI_ERROR
+ */
+static void TWI_transactionStep(void)
+{
+	TWI_TransactionType *t = g_twiHead ;
+
+	switch(TWI_getStatus())
+	{
+	case TW_START:
+	case TW_REP_START:
+		HAL_WRITE(TWDR, g_twiReading ? (t->s_SlaveAddress | 1) : t->s_SlaveAddress);
+		HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWEN) | (1 << TWIE));
+		break;
+
+	case TW_MT_SLA_W_NACK:
+		/* Slave busy (EEPROM write cycle) => try again */
+		if(g_twiPolls > 1)
+		{
+			g_twiPolls-- ;
+			HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWSTO) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE));
+		}
+		else
+		{
+			TWI_transactionEnd(TWI_ERROR);
+		}
+		break;
+
+	case TW_MT_SLA_W_ACK:
+	case TW_MT_DATA_ACK:
+		if(g_twiIndex < t->s_HeaderLength)
+		{
+			HAL_WRITE(TWDR, t->s_Header[g_twiIndex]);
+		}
+		else if(g_twiIndex < (t->s_HeaderLength + t->s_TxLength))
+		{
+			HAL_WRITE(TWDR, t->s_TxBuffer[g_twiIndex - t->s_HeaderLength]);
+		}
+		else if(t->s_RxLength != 0)
+		{
+			/* Write part finished => Repeated Start to read */
+			g_twiIndex = 0 ;
+			g_twiReading = TRUE ;
+			HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE));
+			break;
+		}
+		else
+		{
+			TWI_transactionEnd(TWI_SUCCESS);
+			break;
+		}
+		g_twiIndex++ ;
+		HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWEN) | (1 << TWIE));
+		break;
+
+	case TW_MR_DATA_ACK:
+		t->s_RxBuffer[g_twiIndex++] = HAL_READ(TWDR) ;
+		/* fall through - ACK / NACK for the next byte */
+	case TW_MT_SLA_R_ACK:
+		if((g_twiIndex + 1) < t->s_RxLength)
+		{
+			HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWEN) | (1 << TWIE) | (1 << TWEA));
+		}
+		else
+		{
+			/* Last byte => Master sends NACK */
+			HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWEN) | (1 << TWIE));
+		}
+		break;
+
+	case TW_MR_DATA_NACK:
+		t->s_RxBuffer[g_twiIndex] = HAL_READ(TWDR) ;
+		TWI_transactionEnd(TWI_SUCCESS);
+		break;
+
+	default:
+		/* DATA NACK , SLA+R NACK , Arbitration Lost , Bus Error */
+		TWI_transactionEnd(TWI_ERROR);
+		break;
+	}
+}
+
+/*
+ * Description: Function to finish the running transaction and start the next one
+ * 	1. Call the transaction Call Back , it can submit another transaction
+ * 	   (queued after this one , so it doesn't write TWCR now).
+ * 	2. Stop + Start together if another transaction is queued , else Stop.
+ */
+static void TWI_transactionEnd(TWI_Status a_status)
+{
+	TWI_TransactionType *t = g_twiHead ;
+
+	t->s_Status = a_status ;
+	if(t->s_callBack != NULL_PTR)
+	{
+		t->s_callBack();
+	}
+
+	g_twiHead = t->s_next ;
+	if(g_twiHead != NULL_PTR)
+	{
+		g_twiIndex = 0 ;
+		g_twiPolls = g_twiHead->s_Polls ;
+		g_twiReading = FALSE ;
+		HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWSTO) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE));
+	}
+	else
+	{
+		g_twiTail = NULL_PTR ;
+		HAL_WRITE(TWCR, (1 << TWINT) | (1 << TWSTO) | (1 << TWEN));
+	}
+}
@@ -25,6 +25,17 @@
  * 					 TWI_start() to send repeated start bit , and Read Mode bit
  * 					 				-> TWI_getStatus() == TW_REP_START
  *
+ * Transactions (s_Interrupt = I2C_ENABLE) :
+ * 				- Fill a TWI_TransactionType descriptor and call TWI_submit() ,
+ * 				  TWI ISR runs the whole frame :
+ * 				  Start , SLA+W , Header , TX Data , [Repeated Start , SLA+R , RX Data] , Stop
+ * 				- Descriptors are queued , s_callBack is called from TWI ISR
+ * 				  when the transaction is finished , s_Status => TWI_SUCCESS / TWI_ERROR
+ * 				- s_callBack can submit another descriptor (not the same one)
+ * 				- SLA+W NACK => Stop + Start again up to s_Polls times
+ * 				  (ACK Polling of EEPROM write cycle)
+ * 				- Don't call TWI_start/TWI_write/TWI_read.. while TWI_isBusy()
+ *
  * Author: Mohsen Moawad
  *
  *******************************************************************************/
@@ -41,13 +52,17 @@
  *                         Types Declaration                                   *
  *******************************************************************************/
 typedef enum{
-	DISABLE,ENABLE
+	I2C_DISABLE,I2C_ENABLE
 }I2C_bool;
 
 typedef enum{
 	F_400K,F_100K
 }I2C_clock;
 
+typedef enum{
+	TWI_PENDING,TWI_SUCCESS,TWI_ERROR
+}TWI_Status;
+
 /*
  * Initialization:
  * { SlaveAddress, ClockRate, GCRecognition_Enable, Interrupt}
@@ -62,13 +77,48 @@ typedef struct{
 	I2C_clock s_Clock ;						/* (F_400K,F_100K) */
 
 	/* Set General Call Recognition  */
-	I2C_bool s_GCRecognition_Enable ;		/* (DISABLE,ENABLE) */
+	I2C_bool s_GCRecognition_Enable ;		/* (I2C_DISABLE,I2C_ENABLE) */
 
-	I2C_bool s_Interrupt ;					/* (DISABLE,ENABLE) */
+	I2C_bool s_Interrupt ;					/* (I2C_DISABLE,I2C_ENABLE) */
 
 
 }I2C_ConfigType;
 
+/*
+ * Transaction Descriptor :
+ * owned by the TWI driver from TWI_submit() until s_Status != TWI_PENDING
+ */
+typedef struct TWI_TransactionType{
+
+	/* Next descriptor in the queue (used by the driver) */
+	struct TWI_TransactionType *s_next ;
+
+	/* Slave address byte with R/W=0 , ex: EEPROM 0xA0 | A8:A10 */
+	uint8 s_SlaveAddress ;
+
+	/* Bytes sent first after SLA+W , ex: memory address */
+	uint8 s_Header[2] ;
+	uint8 s_HeaderLength ;					/* (0:2) */
+
+	/* Bytes sent after the header */
+	const uint8 *s_TxBuffer ;
+	uint8 s_TxLength ;
+
+	/* Bytes read after Repeated Start + SLA+R , 0 => no read */
+	uint8 *s_RxBuffer ;
+	uint8 s_RxLength ;
+
+	/* Max. SLA+W tries if the slave doesn't ACK (busy) */
+	uint16 s_Polls ;
+
+	/* Result , TWI_PENDING while the transaction is queued or running */
+	volatile TWI_Status s_Status ;
+
+	/* Called from TWI ISR when the transaction is finished */
+	void (*s_callBack)(void) ;
+
+}TWI_TransactionType;
+
 
 /*******************************************************************************
  *                       External Variables                                    *
@@ -87,8 +137,11 @@ extern volatile uint8 g_i2cData;
 #define TW_REP_START    	0x10 /* repeated start */
 
 #define TW_MT_SLA_W_ACK  	0x18 /* Master transmit ( slave address + Write request ) to slave + Ack received from slave */
+#define TW_MT_SLA_W_NACK 	0x20 /* Master transmit ( slave address + Write request ) to slave + NAck received from slave */
 #define TW_MT_SLA_R_ACK  	0x40 /* Master transmit ( slave address + Read request ) to slave + Ack received from slave */
 #define TW_MT_DATA_ACK   	0x28 /* Master transmit ( data ) and ACK has been received from Slave. */
+#define TW_MT_DATA_NACK  	0x30 /* Master transmit ( data ) and NAck has been received from Slave. */
+#define TW_MT_SLA_R_NACK 	0x48 /* Master transmit ( slave address + Read request ) to slave + NAck received from slave */
 
 #define TW_MR_DATA_ACK   	0x50 /* Master received ( data ) and send ACK to slave */
 #define TW_MR_DATA_NACK  	0x58 /* Master received ( data ) but doesn't send ACK to slave */
@@ -147,9 +200,22 @@ uint8 TWI_getStatus(void);
 
 /*
  * Description: Function to set the Call Back function address.
+ * 				Called from TWI ISR when no transaction is running
  */
 void I2C_setCallBack(void(*a_ptr)(void));
 
+/*
+ * Description: Function to add a transaction to the queue (Non-Blocking)
+ * 				The transaction starts now if the bus is idle
+ * 				TWI_init() must be called with s_Interrupt = I2C_ENABLE
+ */
+void TWI_submit(TWI_TransactionType *a_transaction);
+
+/*
+ * Description: Function returns TRUE while transactions are queued or running
+ */
+bool TWI_isBusy(void);
+
 
 
 #endif /* I2C_H_ */
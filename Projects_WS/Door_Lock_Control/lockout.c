@@ -0,0 +1,135 @@
+ /******************************************************************************
+ *
+ * Module: 		Lockout
+ * File Name: 	lockout.c
+ * Description: Source file for the Wrong Password Lockout with Exponential Backoff
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "lockout.h"
+#include "eeprom_cache.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Failures since the last right password , written in the settings page */
+static uint8 g_lockCount = 0 ;
+
+/* Lock window : start (millis) and length in ms , 0 => not locked */
+static uint32 g_lockStart = 0 ;
+static uint32 g_lockWindow = 0 ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description: Function to start the lock window of g_lockCount failures
+ */
+static void LOCK_startWindow(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to load the failures counter (EEPROM Cache) and
+ * 				start its lock window . Erased EEPROM (0xFF) => 0 failures
+ */
+void LOCK_init(void)
+{
+	if ((CACHE_read(LOCK_COUNTER_ADDRESS, &g_lockCount, 1) != SUCCESS) ||
+		(g_lockCount == 0xFF))
+	{
+		g_lockCount = 0 ;
+	}
+	LOCK_startWindow();
+}
+
+/*
+ * Description: Function returns TRUE while a lock window is running
+ */
+bool LOCK_isLocked(void)
+{
+	if (g_lockWindow == 0)
+		return FALSE;
+
+	if ((uint32)(millis() - g_lockStart) >= g_lockWindow)
+	{
+		/* window finished */
+		g_lockWindow = 0 ;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/*
+ * Description: Function returns the seconds left in the lock window , 0 if not locked
+ */
+uint16 LOCK_getRemainingSeconds(void)
+{
+	if (!LOCK_isLocked())
+		return 0;
+
+	return (uint16)((g_lockWindow - (uint32)(millis() - g_lockStart) + 999UL) / 1000UL) ;
+}
+
+/*
+ * Description: Function returns the number of failures since the last success
+ */
+uint8 LOCK_getFailCount(void)
+{
+	return g_lockCount;
+}
+
+/*
+ * Description: Function to count a wrong password (Non-Blocking) ,
+ * 				RAM counter and window change now , even if the write fails
+ */
+uint8 LOCK_fail(void(*a_callBack)(void))
+{
+	if (g_lockCount < 0xFE)
+		g_lockCount++ ;
+
+	LOCK_startWindow();
+	return CACHE_write(LOCK_COUNTER_ADDRESS, &g_lockCount, 1, a_callBack);
+}
+
+/*
+ * Description: Function to clear the failures counter after a right password (Non-Blocking)
+ */
+uint8 LOCK_reset(void(*a_callBack)(void))
+{
+	g_lockCount = 0 ;
+	g_lockWindow = 0 ;
+	return CACHE_write(LOCK_COUNTER_ADDRESS, &g_lockCount, 1, a_callBack);
+}
+
+/*
+ * Description: Function to start the lock window of g_lockCount failures
+ * 				window = LOCK_BASE_SEC * 2^(failures - LOCK_MAX_ATTEMPTS) , max LOCK_MAX_SEC
+ * 				the LOCK_MAX_ATTEMPTS-th failure starts the first window
+ */
+static void LOCK_startWindow(void)
+{
+	uint32 seconds = LOCK_BASE_SEC ;
+	uint8 i;
+
+	if (g_lockCount < LOCK_MAX_ATTEMPTS)
+	{
+		g_lockWindow = 0 ;
+		return ;
+	}
+
+	for (i = LOCK_MAX_ATTEMPTS ; (i < g_lockCount) && (seconds < LOCK_MAX_SEC) ; i++)
+	{
+		seconds *= 2 ;
+	}
+	if (seconds > LOCK_MAX_SEC)
+		seconds = LOCK_MAX_SEC ;
+
+	g_lockStart = millis() ;
+	g_lockWindow = seconds * 1000UL ;
+}
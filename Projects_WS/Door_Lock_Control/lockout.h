@@ -0,0 +1,105 @@
+ /******************************************************************************
+ *
+ * Module: 		Lockout
+ * File Name: 	lockout.h
+ * Description: Header file for the Wrong Password Lockout with Exponential Backoff
+ *
+ * Notes:		- The failures counter is saved in the settings page
+ * 				  (LOCK_COUNTER_ADDRESS) , a reset doesn't clear it
+ *
+ * 				- The LOCK_MAX_ATTEMPTS-th failure (3rd) and every next one
+ * 				  lock the checks for a window : LOCK_BASE_SEC ,
+ * 				  2 * LOCK_BASE_SEC , 4 * LOCK_BASE_SEC , ... up to LOCK_MAX_SEC ,
+ * 				  only the first LOCK_MAX_ATTEMPTS - 1 failures are free
+ *
+ * 				- Wrong Passwords of CHECK_PASSWORD , CHECK_USER , CHECK_ROOT ,
+ * 				  CHANGE_PASSWORD (Old / Root Password) , ADD_USER and
+ * 				  REVOKE_USER are counted
+ *
+ * 				- The window is measured by millis() , after a reset the
+ * 				  window of the saved counter starts again
+ *
+ * 				- LOCK_fail() writes the counter before the response is sent ,
+ * 				  power off after a wrong password can't skip the counter ,
+ * 				  a running EEPROM Cache write delays it (CACHE_write() waits)
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef LOCKOUT_H_
+#define LOCKOUT_H_
+
+#include "std_types.h"
+#include "control_config.h"
+#include "external_eeprom.h"
+#include "soft_timer.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Lockout Policy , set in control_config.h */
+#ifndef LOCK_MAX_ATTEMPTS
+#define LOCK_MAX_ATTEMPTS		3
+#endif
+
+#ifndef LOCK_BASE_SEC
+#define LOCK_BASE_SEC			30
+#endif
+
+#ifndef LOCK_MAX_SEC
+#define LOCK_MAX_SEC			3600
+#endif
+
+#ifndef LOCK_COUNTER_ADDRESS
+#define LOCK_COUNTER_ADDRESS	0x0004
+#endif
+
+#if (LOCK_MAX_ATTEMPTS == 0)
+#error "LOCK_MAX_ATTEMPTS must be 1 .. 255"
+#endif
+
+#if ((LOCK_BASE_SEC == 0) || (LOCK_MAX_SEC < LOCK_BASE_SEC) || (LOCK_MAX_SEC > 65535))
+#error "LOCK_BASE_SEC must be 1 .. LOCK_MAX_SEC , LOCK_MAX_SEC <= 65535"
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function to load the failures counter (EEPROM Cache) and
+ * 				start its lock window . CACHE_init() and SoftTimer_init() must be called first .
+ */
+void LOCK_init(void);
+
+/*
+ * Description: Function returns TRUE while a lock window is running
+ */
+bool LOCK_isLocked(void);
+
+/*
+ * Description: Function returns the seconds left in the lock window , 0 if not locked
+ */
+uint16 LOCK_getRemainingSeconds(void);
+
+/*
+ * Description: Function returns the number of failures since the last success
+ */
+uint8 LOCK_getFailCount(void);
+
+/*
+ * Description: Function to count a wrong password (Non-Blocking) ,
+ * 				starts the lock window , a_callBack is called from TWI ISR
+ * 				after the counter is written , result in CACHE_getWriteStatus() .
+ */
+uint8 LOCK_fail(void(*a_callBack)(void));
+
+/*
+ * Description: Function to clear the failures counter after a right password (Non-Blocking) ,
+ * 				a_callBack is called from TWI ISR after the counter is written .
+ */
+uint8 LOCK_reset(void(*a_callBack)(void));
+
+#endif /* LOCKOUT_H_ */
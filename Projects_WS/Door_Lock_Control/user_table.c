@@ -0,0 +1,241 @@
+ /******************************************************************************
+ *
+ * Module: 		User Table
+ * File Name: 	user_table.c
+ * Description: Source file for the Users PINs Table in the External EEPROM
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "user_table.h"
+#include "eeprom_cache.h"
+#include "power.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+#define USERS_PAGE_ENTRIES			(EEPROM_PAGE_SIZE / USERS_ENTRY_SIZE)
+
+#define USERS_ENTRY_ADDRESS(index)	(USERS_ADDRESS + ((uint16)(index) * USERS_ENTRY_SIZE))
+
+/* Entry Fields */
+#define USERS_STATE					0
+#define USERS_KEY					1
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Entries of the last page read by the probe */
+static uint8 g_usersPage[EEPROM_PAGE_SIZE];
+
+/* Entry of the running write , must not change until the Call Back */
+static uint8 g_usersEntry[USERS_ENTRY_SIZE];
+
+/* Table Salt , FALSE => not written , table is empty */
+static uint8 g_usersSalt[PASS_SALT_SIZE];
+static bool g_usersSalted = FALSE ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description: Function to compute the KEY of the PIN
+ */
+static void USERS_makeKey(const uint8 *pin, uint8 *key);
+
+/*
+ * Description: Function to walk the probe chain of the key
+ * 				*found = index of the active entry of the key
+ * 				*free  = index of the first revoked / empty entry
+ * 				(USERS_CAPACITY => not found)
+ */
+static uint8 USERS_probe(const uint8 *key, uint16 *found, uint16 *free);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to load the Table Salt (EEPROM Cache) .
+ * 				Erased EEPROM (all 0xFF) => not written
+ */
+void USERS_init(void)
+{
+	uint8 i;
+
+	g_usersSalted = FALSE ;
+	if (CACHE_read(USERS_SALT_ADDRESS, g_usersSalt, PASS_SALT_SIZE) != SUCCESS)
+		return ;
+
+	for (i = 0 ; i < PASS_SALT_SIZE ; i++)
+	{
+		if (g_usersSalt[i] != 0xFF)
+			g_usersSalted = TRUE ;
+	}
+}
+
+/*
+ * Description: Function returns TRUE if the Table Salt is written
+ */
+bool USERS_isSalted(void)
+{
+	return g_usersSalted;
+}
+
+/*
+ * Description: Function to write the Table Salt (Blocking) , only once ,
+ * 				before the first USERS_add() . Waits the write + read back
+ */
+uint8 USERS_setSalt(const uint8 *salt)
+{
+	uint8 i;
+
+	if (g_usersSalted)
+		return ERROR;
+
+	for (i = 0 ; i < PASS_SALT_SIZE ; i++)
+	{
+		g_usersSalt[i] = salt[i] ;
+	}
+	if (CACHE_write(USERS_SALT_ADDRESS, g_usersSalt, PASS_SALT_SIZE, NULL_PTR) != SUCCESS)
+		return ERROR;
+
+	while (CACHE_getWriteStatus() == TWI_PENDING)
+	{
+		POWER_sleep();
+	}
+
+	g_usersSalted = (CACHE_getWriteStatus() == TWI_SUCCESS) ;
+	return g_usersSalted ? SUCCESS : ERROR ;
+}
+
+/*
+ * Description: Function to check if the PIN (PASS_SIZE digits) is an active user (Blocking)
+ */
+bool USERS_find(const uint8 *pin)
+{
+	uint8 key[USERS_KEY_SIZE];
+	uint16 found ;
+	uint16 free ;
+
+	if (!g_usersSalted)
+		return FALSE;
+
+	USERS_makeKey(pin, key);
+	if (USERS_probe(key, &found, &free) != SUCCESS)
+		return FALSE;
+
+	return (found != USERS_CAPACITY) ;
+}
+
+/*
+ * Description: Function to start adding the PIN to the table (Non-Blocking) .
+ */
+uint8 USERS_add(const uint8 *pin, void(*a_callBack)(void))
+{
+	uint16 found ;
+	uint16 free ;
+
+	if (!g_usersSalted)
+		return ERROR;
+
+	g_usersEntry[USERS_STATE] = USERS_ACTIVE ;
+	USERS_makeKey(pin, &g_usersEntry[USERS_KEY]);
+
+	if ((USERS_probe(&g_usersEntry[USERS_KEY], &found, &free) != SUCCESS) ||
+		(found != USERS_CAPACITY) || (free == USERS_CAPACITY))
+		return ERROR;
+
+	/* one entry never crosses a page */
+	return CACHE_write(USERS_ENTRY_ADDRESS(free), g_usersEntry,
+			USERS_ENTRY_SIZE, a_callBack);
+}
+
+/*
+ * Description: Function to start revoking the PIN (Non-Blocking) .
+ * 				Only the STATE byte is written
+ */
+uint8 USERS_revoke(const uint8 *pin, void(*a_callBack)(void))
+{
+	uint8 key[USERS_KEY_SIZE];
+	uint16 found ;
+	uint16 free ;
+
+	if (!g_usersSalted)
+		return ERROR;
+
+	USERS_makeKey(pin, key);
+	if ((USERS_probe(key, &found, &free) != SUCCESS) || (found == USERS_CAPACITY))
+		return ERROR;
+
+	g_usersEntry[USERS_STATE] = USERS_REVOKED ;
+	return CACHE_write(USERS_ENTRY_ADDRESS(found), g_usersEntry, 1, a_callBack);
+}
+
+/*
+ * Description: Function to compute the KEY of the PIN
+ */
+static void USERS_makeKey(const uint8 *pin, uint8 *key)
+{
+	SHA256_saltedHash(g_usersSalt, PASS_SALT_SIZE, pin, PASS_SIZE, key, USERS_KEY_SIZE);
+}
+
+/*
+ * Description: Function to walk the probe chain of the key ,
+ * 				reads a new page only when the probe enters it
+ */
+static uint8 USERS_probe(const uint8 *key, uint16 *found, uint16 *free)
+{
+	/* KEY is a hash , its first 2 bytes are the table index */
+	uint16 index = (uint16)(((uint16)key[0] << 8) | key[1]) % USERS_CAPACITY ;
+	uint16 visited ;
+	uint16 first ;
+	uint16 length ;
+	uint8 *entry ;
+
+	*found = USERS_CAPACITY ;
+	*free = USERS_CAPACITY ;
+
+	for (visited = 0 ; visited < USERS_CAPACITY ; visited++)
+	{
+		if ((visited == 0) || ((index % USERS_PAGE_ENTRIES) == 0))
+		{
+			/* page of the entry , the last page may be a part of a page */
+			first = index - (index % USERS_PAGE_ENTRIES) ;
+			length = (USERS_CAPACITY - first) * USERS_ENTRY_SIZE ;
+			if (length > EEPROM_PAGE_SIZE)
+				length = EEPROM_PAGE_SIZE ;
+			if (EEPROM_readBlock(USERS_ENTRY_ADDRESS(first), g_usersPage, length) != SUCCESS)
+				return ERROR;
+		}
+
+		entry = &g_usersPage[(index % USERS_PAGE_ENTRIES) * USERS_ENTRY_SIZE] ;
+
+		if (entry[USERS_STATE] == USERS_EMPTY)
+		{
+			/* end of the chain */
+			if (*free == USERS_CAPACITY)
+				*free = index ;
+			return SUCCESS;
+		}
+		else if (entry[USERS_STATE] == USERS_REVOKED)
+		{
+			if (*free == USERS_CAPACITY)
+				*free = index ;
+		}
+		else if ((entry[USERS_STATE] == USERS_ACTIVE) &&
+				SHA256_compare(&entry[USERS_KEY], key, USERS_KEY_SIZE))
+		{
+			*found = index ;
+			return SUCCESS;
+		}
+
+		index++ ;
+		if (index == USERS_CAPACITY)
+			index = 0 ;
+	}
+	return SUCCESS;
+}
@@ -0,0 +1,126 @@
+ /******************************************************************************
+ *
+ * Module: 		User Table
+ * File Name: 	user_table.h
+ * Description: Header file for the Users PINs Table in the External EEPROM
+ *
+ * Notes:		- Hash Table with Linear Probing , USERS_CAPACITY entries from
+ * 				  USERS_ADDRESS , one entry :
+ * 				| STATE | KEY (USERS_KEY_SIZE bytes) |
+ * 				  STATE : 0xFF Empty (erased EEPROM) , USERS_ACTIVE , USERS_REVOKED
+ * 				  KEY   : SHA-256(Table Salt + PIN) , first USERS_KEY_SIZE bytes
+ *
+ * 				- Table Salt is written once at the first USERS_add() in the
+ * 				  settings page (USERS_SALT_ADDRESS) , an unsalted table is empty
+ *
+ * 				- Lookup starts at entry (KEY % USERS_CAPACITY) and stops at
+ * 				  the first Empty entry , entries are read one EEPROM page at a time
+ * 				  so a lookup is usually one or two I2C reads up to about half
+ * 				  of USERS_CAPACITY users . Near a full table the probe chains
+ * 				  get long , a wrong PIN in a full table reads every page
+ * 				  (host_test_user_table)
+ *
+ * 				- A revoked entry keeps its KEY so the probe chains after it
+ * 				  are not broken , USERS_add() writes in the first revoked or
+ * 				  empty entry of the chain
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef USER_TABLE_H_
+#define USER_TABLE_H_
+
+#include "std_types.h"
+#include "control_config.h"
+#include "door_lock_protocol.h"
+#include "external_eeprom.h"
+#include "sha256.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Table region , set in control_config.h */
+#ifndef USERS_ADDRESS
+#define USERS_ADDRESS		0x0200
+#endif
+
+#ifndef USERS_CAPACITY
+#define USERS_CAPACITY		192
+#endif
+
+#ifndef USERS_SALT_ADDRESS
+#define USERS_SALT_ADDRESS	0x0000
+#endif
+
+/* Entry = STATE + KEY , 56 bits KEY => a wrong PIN matches an entry
+ * by chance once in 2^56 / USERS_CAPACITY guesses */
+#define USERS_KEY_SIZE		7
+#define USERS_ENTRY_SIZE	(USERS_KEY_SIZE + 1)
+
+/* Entry States */
+#define USERS_EMPTY			0xFF
+#define USERS_ACTIVE		0x01
+#define USERS_REVOKED		0x00
+
+#if ((EEPROM_PAGE_SIZE % USERS_ENTRY_SIZE) != 0)
+#error "USERS_ENTRY_SIZE must divide EEPROM_PAGE_SIZE"
+#endif
+
+#if ((USERS_ADDRESS % EEPROM_PAGE_SIZE) != 0)
+#error "USERS_ADDRESS must be at the start of an EEPROM page"
+#endif
+
+#if ((USERS_ADDRESS + (USERS_CAPACITY * USERS_ENTRY_SIZE)) > EEPROM_SIZE)
+#error "User Table is bigger than the EEPROM"
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function to load the Table Salt (EEPROM Cache) .
+ * 				CACHE_init() must be called first .
+ */
+void USERS_init(void);
+
+/*
+ * Description: Function returns TRUE if the Table Salt is written
+ */
+bool USERS_isSalted(void);
+
+/*
+ * Description: Function to write the Table Salt (Blocking) , only once ,
+ * 				before the first USERS_add()
+ */
+uint8 USERS_setSalt(const uint8 *salt);
+
+/*
+ * Description: Function to check if the PIN (PASS_SIZE digits) is an active user (Blocking)
+ *
+ * Return: TRUE if found
+ */
+bool USERS_find(const uint8 *pin);
+
+/*
+ * Description: Function to start adding the PIN to the table (Non-Blocking) .
+ * 				a_callBack is called from TWI ISR after the entry is written
+ * 				and read back , result in CACHE_getWriteStatus() .
+ *
+ * Return: ERROR if the PIN is already a user , the table is full ,
+ * 		   the Table Salt is not written or the EEPROM can't be read
+ */
+uint8 USERS_add(const uint8 *pin, void(*a_callBack)(void));
+
+/*
+ * Description: Function to start revoking the PIN (Non-Blocking) .
+ * 				a_callBack is called from TWI ISR after the entry is written
+ * 				and read back , result in CACHE_getWriteStatus() .
+ *
+ * Return: ERROR if the PIN is not a user or the EEPROM can't be read
+ */
+uint8 USERS_revoke(const uint8 *pin, void(*a_callBack)(void));
+
+#endif /* USER_TABLE_H_ */
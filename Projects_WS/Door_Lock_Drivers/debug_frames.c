@@ -0,0 +1,259 @@
+ /******************************************************************************
+ *
+ * Module: 		Debug Frames
+ * File Name: 	debug_frames.c
+ * Description: Source file for the debug command frames answered by both ECUs
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "debug_frames.h"
+#include "door_lock_protocol.h"
+#include "prof.h"
+#include "isr_stats.h"
+#include "stack_monitor.h"
+#include "scheduler.h"
+#include "power.h"
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description: Function to send the Scheduler statistics of the task in
+ * 				the payload of the SCHED_STATS frame
+ */
+static void DEBUG_schedStats(const FRAME_Type *frame);
+
+/*
+ * Description: Function to send the sleep / active time statistics
+ * 				(POWER_STATS frame)
+ */
+static void DEBUG_powerStats(void);
+
+/*
+ * Description: Function to send the Profiling Zone in the payload of the
+ * 				PROF_STATS frame , or the number of zones and the probe
+ * 				overhead if there is no payload
+ */
+static void DEBUG_profStats(const FRAME_Type *frame);
+
+/*
+ * Description: Function to send a page of the ISR histogram in the payload
+ * 				of the ISR_STATS frame , or the number of vectors , buckets
+ * 				and the USART overruns if there is no payload
+ */
+static void DEBUG_isrStats(const FRAME_Type *frame);
+
+/*
+ * Description: Function to send the stack high-water mark and the size of
+ * 				the painted region (STACK_STATS)
+ */
+static void DEBUG_stackStats(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to answer a debug request frame , a reply frame
+ * 				is dropped (answering it would loop between the ECUs)
+ */
+bool DEBUG_answer(const FRAME_Type *frame)
+{
+	if(frame->s_Command & DEBUG_REPLY)
+		return TRUE ;
+
+	switch(frame->s_Command)
+	{
+		case SCHED_STATS:
+			DEBUG_schedStats(frame);
+			return TRUE ;
+		case POWER_STATS:
+			DEBUG_powerStats();
+			return TRUE ;
+		case PROF_STATS:
+			DEBUG_profStats(frame);
+			return TRUE ;
+		case ISR_STATS:
+			DEBUG_isrStats(frame);
+			return TRUE ;
+		case STACK_STATS:
+			DEBUG_stackStats();
+			return TRUE ;
+		default:
+			return FALSE ;
+	}
+}
+
+/*
+ * Description: Function to send the Scheduler statistics of the task in
+ * 				the payload of the SCHED_STATS frame
+ */
+static void DEBUG_schedStats(const FRAME_Type *frame)
+{
+	SCHED_StatsType stats ;
+	uint8 payload[SCHED_STATS_SIZE];
+	uint32 values[3];
+	uint8 i ;
+
+	if((frame->s_Length != 1) || !SCHED_getStats(frame->s_Payload[0], &stats))
+	{
+		FRAME_send(SCHED_STATS | DEBUG_REPLY, NULL_PTR, 0);
+		return ;
+	}
+
+	payload[0] = frame->s_Payload[0] ;
+	payload[1] = (uint8)stats.s_Runs ;
+	payload[2] = (uint8)(stats.s_Runs >> 8) ;
+
+	values[0] = stats.s_RunTime ;
+	values[1] = stats.s_MaxRunTime ;
+	values[2] = stats.s_MaxLatency ;
+	for (i = 0 ; i < 12 ; i++)
+	{
+		payload[3 + i] = (uint8)(values[i / 4] >> (8 * (i % 4))) ;
+	}
+
+	FRAME_send(SCHED_STATS | DEBUG_REPLY, payload, SCHED_STATS_SIZE);
+}
+
+/*
+ * Description: Function to send the sleep / active time statistics
+ * 				(POWER_STATS frame)
+ */
+static void DEBUG_powerStats(void)
+{
+	POWER_StatsType stats ;
+	uint8 payload[POWER_STATS_SIZE];
+	uint32 values[3];
+	uint8 i ;
+
+	POWER_getStats(&stats);
+	values[0] = stats.s_ElapsedMs ;
+	values[1] = stats.s_SleepMs ;
+	values[2] = stats.s_Wakeups ;
+	for (i = 0 ; i < POWER_STATS_SIZE ; i++)
+	{
+		payload[i] = (uint8)(values[i / 4] >> (8 * (i % 4))) ;
+	}
+
+	FRAME_send(POWER_STATS | DEBUG_REPLY, payload, POWER_STATS_SIZE);
+}
+
+/*
+ * Description: Function to send the Profiling Zone in the payload of the
+ * 				PROF_STATS frame , or the number of zones and the probe
+ * 				overhead if there is no payload
+ */
+static void DEBUG_profStats(const FRAME_Type *frame)
+{
+#if (PROF_ENABLE == TRUE)
+	PROF_StatsType stats ;
+	uint8 payload[PROF_STATS_SIZE];
+	uint32 values[3];
+	uint8 i ;
+
+	if(frame->s_Length == 0)
+	{
+		payload[0] = PROF_MAX_ZONES ;
+		payload[1] = (uint8)PROF_getOverhead() ;
+		payload[2] = (uint8)(PROF_getOverhead() >> 8) ;
+		FRAME_send(PROF_STATS | DEBUG_REPLY, payload, PROF_INFO_SIZE);
+		return ;
+	}
+
+	if((frame->s_Length != 1) || !PROF_getStats(frame->s_Payload[0], &stats))
+	{
+		FRAME_send(PROF_STATS | DEBUG_REPLY, NULL_PTR, 0);
+		return ;
+	}
+
+	payload[0] = frame->s_Payload[0] ;
+	payload[1] = (uint8)stats.s_Count ;
+	payload[2] = (uint8)(stats.s_Count >> 8) ;
+
+	values[0] = stats.s_MinCycles ;
+	values[1] = stats.s_MaxCycles ;
+	values[2] = stats.s_TotalCycles ;
+	for (i = 0 ; i < 12 ; i++)
+	{
+		payload[3 + i] = (uint8)(values[i / 4] >> (8 * (i % 4))) ;
+	}
+
+	FRAME_send(PROF_STATS | DEBUG_REPLY, payload, PROF_STATS_SIZE);
+#else
+	/* Probes disabled */
+	FRAME_send(PROF_STATS | DEBUG_REPLY, NULL_PTR, 0);
+#endif
+}
+
+/*
+ * Description: Function to send a page of the ISR histogram in the payload
+ * 				of the ISR_STATS frame , or the number of vectors , buckets
+ * 				and the USART overruns if there is no payload
+ */
+static void DEBUG_isrStats(const FRAME_Type *frame)
+{
+#if (ISR_STATS_ENABLE == TRUE)
+	ISR_StatsHistogramType stats ;
+	uint8 payload[ISR_STATS_SIZE];
+	uint8 length = 5 ;
+	uint8 bucket , i ;
+	uint16 overruns ;
+
+	if(frame->s_Length == 0)
+	{
+		overruns = ISR_STATS_getOverruns();
+		payload[0] = ISR_STATS_VECTORS ;
+		payload[1] = ISR_STATS_BUCKETS ;
+		payload[2] = (uint8)overruns ;
+		payload[3] = (uint8)(overruns >> 8) ;
+		FRAME_send(ISR_STATS | DEBUG_REPLY, payload, ISR_INFO_SIZE);
+		return ;
+	}
+
+	if((frame->s_Length != 3) || (frame->s_Payload[2] >= ISR_STATS_BUCKETS) ||
+		!ISR_STATS_getHistogram(frame->s_Payload[0], frame->s_Payload[1], &stats))
+	{
+		FRAME_send(ISR_STATS | DEBUG_REPLY, NULL_PTR, 0);
+		return ;
+	}
+
+	for (i = 0 ; i < 3 ; i++)
+	{
+		payload[i] = frame->s_Payload[i] ;
+	}
+	payload[3] = (uint8)stats.s_Max ;
+	payload[4] = (uint8)(stats.s_Max >> 8) ;
+
+	for (bucket = payload[2] ; (bucket < ISR_STATS_BUCKETS) && (length < ISR_STATS_SIZE) ; bucket++)
+	{
+		payload[length++] = (uint8)stats.s_Buckets[bucket] ;
+		payload[length++] = (uint8)(stats.s_Buckets[bucket] >> 8) ;
+	}
+
+	FRAME_send(ISR_STATS | DEBUG_REPLY, payload, length);
+#else
+	/* Histograms disabled */
+	FRAME_send(ISR_STATS | DEBUG_REPLY, NULL_PTR, 0);
+#endif
+}
+
+/*
+ * Description: Function to send the stack high-water mark and the size of
+ * 				the painted region (STACK_STATS)
+ */
+static void DEBUG_stackStats(void)
+{
+	uint8 payload[STACK_STATS_SIZE];
+	uint16 highWater = STACK_getHighWater();
+	uint16 size = STACK_getSize();
+
+	payload[0] = (uint8)highWater ;
+	payload[1] = (uint8)(highWater >> 8) ;
+	payload[2] = (uint8)size ;
+	payload[3] = (uint8)(size >> 8) ;
+
+	FRAME_send(STACK_STATS | DEBUG_REPLY, payload, STACK_STATS_SIZE);
+}
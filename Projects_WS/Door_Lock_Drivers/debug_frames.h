@@ -0,0 +1,37 @@
+ /******************************************************************************
+ *
+ * Module: 		Debug Frames
+ * File Name: 	debug_frames.h
+ * Description: Header file for the debug command frames answered by both ECUs
+ *
+ * Notes:		- The ECU calls DEBUG_answer() with every received frame
+ * 				  (HMI Frame Task , Control Command Task) , the response is
+ * 				  sent by FRAME_send() . Payloads in door_lock_protocol.h
+ *
+ * 				- A reply has its own code (request | DEBUG_REPLY) , the
+ * 				  requests come from a debug tool only , an ECU never sends
+ * 				  one to the other ECU
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef DEBUG_FRAMES_H_
+#define DEBUG_FRAMES_H_
+
+#include "std_types.h"
+#include "frame.h"
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function to answer a debug request frame , a debug reply
+ * 				(command | DEBUG_REPLY) is never answered
+ *
+ * Return: FALSE if the frame isn't a debug request of both ECUs or a reply
+ */
+bool DEBUG_answer(const FRAME_Type *frame);
+
+#endif /* DEBUG_FRAMES_H_ */
@@ -0,0 +1,102 @@
+ /******************************************************************************
+ *
+ * Module: 		Door Lock Protocol
+ * File Name: 	door_lock_protocol.h
+ * Description: Commands / Responses exchanged between HMI ECU and Control ECU
+ * 				in the UART Frames (frame.h)
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef DOOR_LOCK_PROTOCOL_H_
+#define DOOR_LOCK_PROTOCOL_H_
+
+/*******************************************************************************
+ *                   	   Macros Definition                                   *
+ *******************************************************************************/
+
+/* Commands / Responses of the UART Frames */
+#define READY				 	0x01
+#define CHECK_PASSWORD		 	0x02
+#define MATCH					0x03
+#define DONT_MATCH				0x04
+#define CHANGE_PASSWORD			0x05
+#define OPEN_DOOR				0x06
+#define PASS_FOUND				0x07
+#define PASS_NOT_FOUND			0x08
+
+/* Users Commands
+ * CHECK_USER  payload = PIN , response MATCH if PIN is the Password or a User
+ * ADD_USER    payload = Password + PIN , response READY / DONT_MATCH
+ * REVOKE_USER payload = Password + PIN , response READY / DONT_MATCH */
+#define CHECK_USER				0x09
+#define ADD_USER				0x0A
+#define REVOKE_USER				0x0B
+
+/* Password Commands
+ * CHANGE_PASSWORD payload = Old Password or Root Password + New Password , the
+ *                 old one is ignored if no Password is saved (first start) ,
+ *                 response READY / DONT_MATCH
+ * CHECK_ROOT      payload = Root Password , response MATCH / DONT_MATCH */
+#define CHECK_ROOT				0x12
+
+/* Response of CHECK_PASSWORD , CHECK_USER , CHECK_ROOT , CHANGE_PASSWORD ,
+ * ADD_USER , REVOKE_USER while the checks are locked after wrong passwords ,
+ * payload = seconds left (2 bytes , low byte first) */
+#define LOCKED					0x0C
+
+/* Reply of a Debug Command = command | DEBUG_REPLY , a reply is never
+ * answered . The debug requests come from a tool on the link of one ECU ,
+ * the ECUs send replies only (no request) => a reply can't loop between them */
+#define DEBUG_REPLY				0x80
+
+/* Debug Command , Scheduler statistics (scheduler.h) of the ECU that receives it ,
+ * payload = task ID , reply SCHED_STATS with payload =
+ * task ID , runs (2 bytes) , total / max run time , max latency (4 bytes each , us)
+ * low byte first , or empty payload if there is no task with this ID */
+#define SCHED_STATS				0x0D
+#define SCHED_STATS_SIZE		15
+
+/* Debug Command , Sleep statistics (power.h) of the ECU that receives it , no payload
+ * reply POWER_STATS with payload = elapsed ms , sleep ms , wake ups
+ * (4 bytes each , low byte first) */
+#define POWER_STATS				0x0E
+#define POWER_STATS_SIZE		12
+
+/* Debug Command , Profiling Zones (prof.h) of the ECU that receives it ,
+ * payload = zone ID , reply PROF_STATS with payload = zone ID ,
+ * count (2 bytes) , min / max / total (4 bytes each , CPU cycles)
+ * low byte first , or empty payload if there is no zone with this ID .
+ * No payload => reply payload = number of zones , probe overhead
+ * (2 bytes , CPU cycles) . Empty reply if the probes are disabled */
+#define PROF_STATS				0x0F
+#define PROF_STATS_SIZE			15
+#define PROF_INFO_SIZE			3
+
+/* Debug Command , ISR latency / duration histograms (isr_stats.h) of the ECU
+ * that receives it , payload = vector ID , histogram (0 latency , 1 duration) ,
+ * first bucket , reply ISR_STATS with payload = the 3 request bytes ,
+ * max (2 bytes , cycles) , counts of up to ISR_STATS_PAGE buckets from the
+ * first one (2 bytes each) low byte first , or empty payload if there is no
+ * such histogram / bucket . No payload => reply payload = number of
+ * vectors , number of buckets , USART data overruns (2 bytes) .
+ * Empty reply if the histograms are disabled */
+#define ISR_STATS				0x10
+#define ISR_STATS_PAGE			5
+#define ISR_STATS_SIZE			(5 + (2 * ISR_STATS_PAGE))
+#define ISR_INFO_SIZE			4
+
+/* Debug Command , stack of the ECU that receives it (stack_monitor.h) ,
+ * no payload , reply STACK_STATS with payload = high-water mark ,
+ * painted region size (2 bytes each , bytes) low byte first */
+#define STACK_STATS				0x11
+#define STACK_STATS_SIZE		4
+
+/* Password Size */
+#define PASS_SIZE 5
+
+/* Saved Password = SHA-256(Salt + Password) , first PASS_HASH_SIZE bytes */
+#define PASS_SALT_SIZE 4
+#define PASS_HASH_SIZE 8
+
+#endif /* DOOR_LOCK_PROTOCOL_H_ */
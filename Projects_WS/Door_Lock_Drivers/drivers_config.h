@@ -0,0 +1,61 @@
+ /******************************************************************************
+ *
+ * Module: 		Drivers - Configuration
+ * File Name: 	drivers_config.h
+ * Description: Configuration of the shared drivers library (libdoorlock_drivers)
+ * 				Both ECUs are ATmega16 @ 8Mhz , So the library is built once
+ * 				with these values and linked in both firmware images.
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef DRIVERS_CONFIG_H_
+#define DRIVERS_CONFIG_H_
+
+	/* CPU Clock of both ECUs */
+	#ifndef F_CPU
+	#define F_CPU 8000000UL //8MHz Clock frequency
+	#endif
+
+	/* UART Ring Buffers Size , must be power of two */
+	#ifndef UART_RX_BUFFER_SIZE
+	#define UART_RX_BUFFER_SIZE 32
+	#endif
+
+	#ifndef UART_TX_BUFFER_SIZE
+	#define UART_TX_BUFFER_SIZE 32
+	#endif
+
+	/* Software Timers timing wheel slots , must be power of two */
+	#ifndef SOFT_TIMER_WHEEL_SIZE
+	#define SOFT_TIMER_WHEEL_SIZE 16
+	#endif
+
+	/* Scheduler tasks table size */
+	#ifndef SCHED_MAX_TASKS
+	#define SCHED_MAX_TASKS 8
+	#endif
+
+	/* Profiling Zones (prof.h) , FALSE => no probes , make PROF=1 to enable */
+	#ifndef PROF_ENABLE
+	#define PROF_ENABLE FALSE
+	#endif
+
+	/* Profiling Zones table size */
+	#ifndef PROF_MAX_ZONES
+	#define PROF_MAX_ZONES 8
+	#endif
+
+	/* ISR latency / duration histograms (isr_stats.h) , FALSE => no code ,
+	 * make ISR_STATS=1 to enable */
+	#ifndef ISR_STATS_ENABLE
+	#define ISR_STATS_ENABLE FALSE
+	#endif
+
+	/* log2 buckets per histogram , the last one >= 2^(ISR_STATS_BUCKETS+1)
+	 * cycles (8192 = ~1 UART frame @ 9600) */
+	#ifndef ISR_STATS_BUCKETS
+	#define ISR_STATS_BUCKETS 12
+	#endif
+
+#endif /* DRIVERS_CONFIG_H_ */
@@ -0,0 +1,173 @@
+ /******************************************************************************
+ *
+ * Module: 		FRAME
+ * File Name: 	frame.c
+ * Description: Source file for the Framed Messages Protocol over UART
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "frame.h"
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to update CRC-8 value with one byte
+ */
+uint8 FRAME_crc8(uint8 crc, uint8 data)
+{
+	uint8 bit ;
+
+	crc ^= data ;
+	for(bit = 0 ; bit < 8 ; bit++)
+	{
+		if(crc & 0x80)
+			crc = (uint8)((crc << 1) ^ FRAME_CRC_POLYNOMIAL) ;
+		else
+			crc = (uint8)(crc << 1) ;
+	}
+	return crc ;
+}
+
+/*
+ * Description: Function to build a frame in a buffer
+ * 				buffer size must be at least (length + FRAME_OVERHEAD)
+ *
+ * Return: number of bytes in the frame , 0 if length is greater than
+ * 		   FRAME_MAX_PAYLOAD
+ */
+uint8 FRAME_encode(uint8 command, const uint8 *payload, uint8 length, uint8 *buffer)
+{
+	uint8 i ;
+	uint8 crc ;
+
+	if(length > FRAME_MAX_PAYLOAD)
+		return 0 ;
+
+	buffer[0] = FRAME_START_BYTE ;
+	buffer[1] = command ;
+	buffer[2] = length ;
+	crc = FRAME_crc8(0, command) ;
+	crc = FRAME_crc8(crc, length) ;
+
+	for(i = 0 ; i < length ; i++)
+	{
+		buffer[3 + i] = payload[i] ;
+		crc = FRAME_crc8(crc, payload[i]) ;
+	}
+	buffer[3 + length] = crc ;
+
+	return (uint8)(length + FRAME_OVERHEAD) ;
+}
+
+/*
+ * Description: Function to send a frame over UART
+ */
+void FRAME_send(uint8 command, const uint8 *payload, uint8 length)
+{
+	uint8 buffer[FRAME_MAX_PAYLOAD + FRAME_OVERHEAD] ;
+	uint8 size ;
+	uint8 i ;
+
+	size = FRAME_encode(command, payload, length, buffer) ;
+
+	/* Bytes are queued in UART TX Buffer and sent by the UDRE ISR */
+	for(i = 0 ; i < size ; i++)
+	{
+		UART_sendByte(buffer[i]);
+	}
+}
+
+/*
+ * Description: Function to reset the frame decoder to wait a new frame
+ */
+void FRAME_decoderInit(FRAME_DecoderType *decoder)
+{
+	decoder->s_State = FRAME_WAIT_START ;
+	decoder->s_Index = 0 ;
+	decoder->s_Crc = 0 ;
+}
+
+/*
+ * Description: Function to pass one received byte to the frame decoder
+ *
+ * Return: TRUE when a complete frame with valid CRC is received
+ * 		   the frame is stored in decoder->s_Frame
+ */
+bool FRAME_decodeByte(FRAME_DecoderType *decoder, uint8 data)
+{
+	switch(decoder->s_State)
+	{
+		case FRAME_WAIT_START:
+			/* Ignore any byte until start byte received */
+			if(data == FRAME_START_BYTE)
+			{
+				decoder->s_Crc = 0 ;
+				decoder->s_Index = 0 ;
+				decoder->s_State = FRAME_WAIT_COMMAND ;
+			}
+			break;
+
+		case FRAME_WAIT_COMMAND:
+			decoder->s_Frame.s_Command = data ;
+			decoder->s_Crc = FRAME_crc8(decoder->s_Crc, data) ;
+			decoder->s_State = FRAME_WAIT_LENGTH ;
+			break;
+
+		case FRAME_WAIT_LENGTH:
+			if(data > FRAME_MAX_PAYLOAD)
+			{
+				/* Invalid Length , Drop the frame */
+				decoder->s_State = FRAME_WAIT_START ;
+				break;
+			}
+			decoder->s_Frame.s_Length = data ;
+			decoder->s_Crc = FRAME_crc8(decoder->s_Crc, data) ;
+			decoder->s_State = (data == 0) ? FRAME_WAIT_CRC : FRAME_WAIT_PAYLOAD ;
+			break;
+
+		case FRAME_WAIT_PAYLOAD:
+			decoder->s_Frame.s_Payload[decoder->s_Index] = data ;
+			decoder->s_Crc = FRAME_crc8(decoder->s_Crc, data) ;
+			decoder->s_Index++ ;
+			if(decoder->s_Index == decoder->s_Frame.s_Length)
+				decoder->s_State = FRAME_WAIT_CRC ;
+			break;
+
+		case FRAME_WAIT_CRC:
+			decoder->s_State = FRAME_WAIT_START ;
+			/* Frame is complete only if CRC is correct */
+			if(data == decoder->s_Crc)
+				return TRUE ;
+			break;
+	}
+	return FALSE ;
+}
+
+/*
+ * Description: Non-Blocking Function to decode all bytes waiting in UART
+ *
+ * Return: TRUE when a complete frame is received
+ */
+bool FRAME_poll(FRAME_DecoderType *decoder)
+{
+	uint8 data ;
+
+	while(UART_read(&data))
+	{
+		/* Stop at the end of the frame , next bytes belong to the next frame */
+		if(FRAME_decodeByte(decoder, data))
+			return TRUE ;
+	}
+	return FALSE ;
+}
+
+/*
+ * Description: Function to wait until a complete frame is received
+ */
+void FRAME_receive(FRAME_DecoderType *decoder)
+{
+	while(!FRAME_decodeByte(decoder, UART_receiveByte())){}
+}
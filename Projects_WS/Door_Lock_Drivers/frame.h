@@ -0,0 +1,124 @@
+ /******************************************************************************
+ *
+ * Module: 		FRAME
+ * File Name: 	frame.h
+ * Description: Header file for the Framed Messages Protocol over UART
+ *
+ * Frame Format :
+ * 				| START | COMMAND | LENGTH | PAYLOAD (LENGTH bytes) | CRC-8 |
+ *
+ * 				- START   => FRAME_START_BYTE (0x7E)
+ * 				- LENGTH  => number of payload bytes (0 : FRAME_MAX_PAYLOAD)
+ * 				- CRC-8   => polynomial 0x07 , initial value 0x00
+ * 							 calculated over COMMAND , LENGTH and PAYLOAD
+ *
+ * Example :	- Send Check Password Command with the password digits
+ * 					FRAME_send(CHECK_PASSWORD, g_password, PASS_SIZE);
+ * 				- Wait the response frame
+ * 					FRAME_receive(&g_rxFrame);
+ * 					if(g_rxFrame.s_Frame.s_Command == MATCH) ...
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef FRAME_H_
+#define FRAME_H_
+
+#include "std_types.h"
+#include "uart.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* First byte of every frame */
+#define FRAME_START_BYTE		0x7E
+
+/* Maximum number of payload bytes in one frame */
+#define FRAME_MAX_PAYLOAD		16
+
+/* START + COMMAND + LENGTH + CRC */
+#define FRAME_OVERHEAD			4
+
+/* CRC-8 Polynomial x^8 + x^2 + x + 1 */
+#define FRAME_CRC_POLYNOMIAL	0x07
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef enum
+{
+	FRAME_WAIT_START, FRAME_WAIT_COMMAND, FRAME_WAIT_LENGTH,
+	FRAME_WAIT_PAYLOAD, FRAME_WAIT_CRC
+}FRAME_State;
+
+typedef struct
+{
+	uint8 s_Command ;
+	uint8 s_Length ;
+	uint8 s_Payload[FRAME_MAX_PAYLOAD] ;
+}FRAME_Type;
+
+typedef struct
+{
+	/* Decoder state , which part of the frame is expected next */
+	FRAME_State s_State ;
+	/* Index of the next payload byte */
+	uint8 s_Index ;
+	/* Running CRC of the received bytes */
+	uint8 s_Crc ;
+	/* Last complete frame , valid after FRAME_decodeByte returns TRUE */
+	FRAME_Type s_Frame ;
+}FRAME_DecoderType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function to update CRC-8 value with one byte
+ */
+uint8 FRAME_crc8(uint8 crc, uint8 data);
+
+/*
+ * Description: Function to build a frame in a buffer
+ * 				buffer size must be at least (length + FRAME_OVERHEAD)
+ *
+ * Return: number of bytes in the frame , 0 if length is greater than
+ * 		   FRAME_MAX_PAYLOAD
+ */
+uint8 FRAME_encode(uint8 command, const uint8 *payload, uint8 length, uint8 *buffer);
+
+/*
+ * Description: Function to send a frame over UART
+ */
+void FRAME_send(uint8 command, const uint8 *payload, uint8 length);
+
+/*
+ * Description: Function to reset the frame decoder to wait a new frame
+ */
+void FRAME_decoderInit(FRAME_DecoderType *decoder);
+
+/*
+ * Description: Function to pass one received byte to the frame decoder
+ *
+ * Return: TRUE when a complete frame with valid CRC is received
+ * 		   the frame is stored in decoder->s_Frame
+ */
+bool FRAME_decodeByte(FRAME_DecoderType *decoder, uint8 data);
+
+/*
+ * Description: Non-Blocking Function to decode all bytes waiting in UART
+ *
+ * Return: TRUE when a complete frame is received
+ */
+bool FRAME_poll(FRAME_DecoderType *decoder);
+
+/*
+ * Description: Function to wait until a complete frame is received
+ */
+void FRAME_receive(FRAME_DecoderType *decoder);
+
+#endif /* FRAME_H_ */
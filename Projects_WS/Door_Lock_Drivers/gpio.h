@@ -44,20 +44,8 @@
 #ifndef GPIO_H_
 #define GPIO_H_
 
-	#ifndef	SET_BIT
-		/* Set a certain bit in any register */
-		#define SET_BIT(REG,BIT) (REG|=(1<<BIT))
-	#endif
-
-	#ifndef CLEAR_BIT
-		/* Clear a certain bit in any register */
-		#define CLEAR_BIT(REG,BIT) (REG&=(~(1<<BIT)))
-	#endif
-
-	#ifndef BIT_IS_SET
-		/* Check if a specific bit is set in any register and return true if yes */
-		#define BIT_IS_SET(REG,BIT) ( REG & (1<<BIT) )
-	#endif
+	/* Register access (HAL_SET_BIT , HAL_CLEAR_BIT , HAL_BIT_IS_SET) */
+	#include "micro_config.h"
 
 	#ifndef OUTPUT
 		#define OUTPUT 	(1u)
@@ -82,24 +70,24 @@
 	 * Example:		pinMode(A, PA0, OUTPUT);
 	 */
 	#define pinMode(ABCD,pin,mode) (((mode) == (OUTPUT)) ? \
-			(SET_BIT(__DDR(ABCD),(pin))),\
+			(HAL_SET_BIT(__DDR(ABCD),(pin))),\
 			(pinWrite(ABCD,pin,LOW))\
-			: (CLEAR_BIT(__DDR(ABCD),(pin))))
+			: (HAL_CLEAR_BIT(__DDR(ABCD),(pin))))
 
 	/*
 	 * Description: Macro to set pin Output value
 	 * Example:		pinWrite(A, PA0, HIGH);
 	 */
 	#define pinWrite(ABCD,pin,value) (((value) == (HIGH)) ? \
-			(SET_BIT(__PORT(ABCD),(pin))) \
-			: (CLEAR_BIT(__PORT(ABCD),(pin))))
+			(HAL_SET_BIT(__PORT(ABCD),(pin))) \
+			: (HAL_CLEAR_BIT(__PORT(ABCD),(pin))))
 
 	/*
 	 * Description: Macro to read pin input state
 	 * Example:		state = pinRead(A, PA0);
 	 */
 	#define pinRead(ABCD,pin) \
-	((BIT_IS_SET(__PIN(ABCD),(pin))) ? (HIGH) : (LOW))
+	((HAL_BIT_IS_SET(__PIN(ABCD),(pin))) ? (HIGH) : (LOW))
 
 
 #endif /* GPIO_H_ */
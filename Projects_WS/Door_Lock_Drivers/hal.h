@@ -0,0 +1,71 @@
+ /******************************************************************************
+ *
+ * Module: 		HAL - Register Access
+ * File Name: 	hal.h
+ * Description: Register access Macros used by all drivers
+ *
+ * Notes:		- The drivers never read or write an I/O register directly ,
+ * 				  every access is done by these Macros :
+ * 				  	AVR  (default)    => plain access to the register (same code
+ * 				  	                     as before , SBI / CBI / IN / OUT)
+ * 				  	HOST (HOST_BUILD) => a call to the Linux model of the
+ * 				  	                     ATmega16 (Door_Lock_Host/host_mcu.c) that
+ * 				  	                     advances the virtual clock , runs the
+ * 				  	                     timers / USART / TWI and the ISRs
+ *
+ * 				- A plain variable is not a register , the common_macros.h
+ * 				  Macros are still used for them
+ *
+ * 				- TCNT1 , OCR1A , OCR1B and ICR1 are 16 bit registers ,
+ * 				  HAL_READ16() / HAL_WRITE16() keep the TEMP register order
+ *
+ * Example :	- TIMSK |= (1<<OCIE1A)		=> HAL_OR(TIMSK, (1<<OCIE1A));
+ * 				- SET_BIT(DDRB, PB3)		=> HAL_SET_BIT(DDRB, PB3);
+ * 				- while(BIT_IS_CLEAR(UCSRA,RXC)){}
+ * 											=> while(HAL_BIT_IS_CLEAR(UCSRA,RXC)){}
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef HAL_H_
+#define HAL_H_
+
+#include "std_types.h"
+
+#ifdef HOST_BUILD
+
+	/* Linux model , the register names are I/O addresses */
+	#include "hal_host.h"
+
+#else
+
+	/* Read a register */
+	#define HAL_READ(REG) 				(REG)
+
+	/* Write a register */
+	#define HAL_WRITE(REG,VALUE) 		((REG) = (VALUE))
+
+	/* Read / Write a 16 bit register */
+	#define HAL_READ16(REG) 			(REG)
+	#define HAL_WRITE16(REG,VALUE) 		((REG) = (VALUE))
+
+	/* Set / Clear the bits of a mask in a register (read-modify-write) */
+	#define HAL_OR(REG,MASK) 			((REG) |= (MASK))
+	#define HAL_AND(REG,MASK) 			((REG) &= (MASK))
+
+#endif
+
+	/* Set a certain bit in a register */
+	#define HAL_SET_BIT(REG,BIT) 		HAL_OR(REG,(1<<(BIT)))
+
+	/* Clear a certain bit in a register */
+	#define HAL_CLEAR_BIT(REG,BIT) 		HAL_AND(REG,(uint8)(~(1<<(BIT))))
+
+	/* Check if a specific bit is set in a register and return true if yes */
+	#define HAL_BIT_IS_SET(REG,BIT) 	( HAL_READ(REG) & (1<<(BIT)) )
+
+	/* Check if a specific bit is cleared in a register and return true if yes */
+	#define HAL_BIT_IS_CLEAR(REG,BIT) 	( !(HAL_READ(REG) & (1<<(BIT))) )
+
+#endif /* HAL_H_ */
@@ -0,0 +1,234 @@
+ /******************************************************************************
+ *
+ * Module: 		ISR Statistics
+ * File Name: 	isr_stats.c
+ * Description: Source file for the ISR latency / duration histograms
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "isr_stats.h"
+#include "soft_timer.h"
+
+#if (ISR_STATS_ENABLE == TRUE)
+
+#ifdef HOST_BUILD
+#include <stdio.h>
+#endif
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* Time Stamp , the model clock on the host , else TIMER1 counter (F_CPU clock) */
+#ifdef HOST_BUILD
+#define ISR_STATS_NOW()			((uint32)HOST_cycles())
+#else
+#define ISR_STATS_NOW()			((uint32)HAL_READ16(TCNT1))
+#endif
+
+/* Bar of the host histograms */
+#define ISR_STATS_BAR_SIZE		40
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static ISR_StatsHistogramType g_histograms[ISR_STATS_VECTORS][ISR_STATS_HISTOGRAMS] ;
+
+/* Time Stamp of ISR_STATS_ENTER of each vector */
+static uint32 g_start[ISR_STATS_VECTORS] ;
+
+/* USART Data OverRuns */
+static volatile uint16 g_overruns = 0 ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description: Function to count a value in a histogram
+ */
+static void ISR_STATS_count(ISR_StatsHistogramType *histogram, uint32 cycles);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to clear the histograms
+ */
+void ISR_STATS_init(void)
+{
+	uint8 sreg = SREG ;
+	uint8 vector , histogram , bucket ;
+
+	cli();
+	for(vector = 0 ; vector < ISR_STATS_VECTORS ; vector++)
+	{
+		for(histogram = 0 ; histogram < ISR_STATS_HISTOGRAMS ; histogram++)
+		{
+			g_histograms[vector][histogram].s_Max = 0 ;
+			for(bucket = 0 ; bucket < ISR_STATS_BUCKETS ; bucket++)
+				g_histograms[vector][histogram].s_Buckets[bucket] = 0 ;
+		}
+	}
+	g_overruns = 0 ;
+	SREG = sreg ;
+
+#ifdef HOST_BUILD
+	HOST_addReportHook(ISR_STATS_hostReport);
+#endif
+}
+
+/*
+ * Description: Function to count the entry latency and start the duration ,
+ * 				the time stamp is the last action (not counted in the duration)
+ */
+void ISR_STATS_enter(uint8 vector, uint16 latency)
+{
+#ifdef HOST_BUILD
+	/* Event time of every vector is known by the model */
+	ISR_STATS_count(&g_histograms[vector][ISR_STATS_LATENCY], HOST_isrLatency());
+#else
+	if(latency != ISR_STATS_NO_LATENCY)
+		ISR_STATS_count(&g_histograms[vector][ISR_STATS_LATENCY], latency);
+#endif
+	g_start[vector] = ISR_STATS_NOW() ;
+}
+
+/*
+ * Description: Function to count the duration , the time stamp is the
+ * 				first action . On the AVR TCNT1 restarts every 1 ms
+ */
+void ISR_STATS_exit(uint8 vector)
+{
+	uint32 end = ISR_STATS_NOW() ;
+
+#ifndef HOST_BUILD
+	if(end < g_start[vector])
+		end += SOFT_TIMER_TICK_CYCLES ;
+#endif
+	ISR_STATS_count(&g_histograms[vector][ISR_STATS_DURATION], end - g_start[vector]);
+}
+
+/*
+ * Description: Function to count a USART Data OverRun
+ */
+void ISR_STATS_overrun(void)
+{
+	if(g_overruns < 0xFFFF)
+		g_overruns++ ;
+}
+
+/*
+ * Description: Function to copy a histogram
+ */
+bool ISR_STATS_getHistogram(uint8 vector, uint8 histogram, ISR_StatsHistogramType *stats)
+{
+	uint8 sreg = SREG ;
+
+	if((vector >= ISR_STATS_VECTORS) || (histogram >= ISR_STATS_HISTOGRAMS))
+		return FALSE ;
+
+	cli();
+	*stats = g_histograms[vector][histogram] ;
+	SREG = sreg ;
+	return TRUE ;
+}
+
+/*
+ * Description: Function returns the number of USART Data OverRuns
+ */
+uint16 ISR_STATS_getOverruns(void)
+{
+	uint8 sreg = SREG ;
+	uint16 overruns ;
+
+	cli();
+	overruns = g_overruns ;
+	SREG = sreg ;
+	return overruns ;
+}
+
+#ifdef HOST_BUILD
+/*
+ * Description: Function to print the histograms of the vectors that ran
+ * 				(stderr) , one bar per bucket from the first to the last used
+ */
+void ISR_STATS_hostReport(const char *name)
+{
+	static const char *const vectors[ISR_STATS_VECTORS] =
+	{
+		"TIMER1_COMPA", "TIMER2", "USART_RXC", "TWI"
+	};
+	static const char *const histograms[ISR_STATS_HISTOGRAMS] = {"latency", "duration"};
+	ISR_StatsHistogramType stats ;
+	uint32 total , peak ;
+	uint8 vector , histogram , bucket , first , last ;
+
+	fprintf(stderr, "ISR[%s]: USART data overruns %u\n", name, ISR_STATS_getOverruns());
+	for(vector = 0 ; vector < ISR_STATS_VECTORS ; vector++)
+	{
+		for(histogram = 0 ; histogram < ISR_STATS_HISTOGRAMS ; histogram++)
+		{
+			ISR_STATS_getHistogram(vector, histogram, &stats);
+			total = 0 ;
+			peak = 0 ;
+			first = ISR_STATS_BUCKETS ;
+			last = 0 ;
+			for(bucket = 0 ; bucket < ISR_STATS_BUCKETS ; bucket++)
+			{
+				if(stats.s_Buckets[bucket] == 0)
+					continue;
+				total += stats.s_Buckets[bucket] ;
+				if(stats.s_Buckets[bucket] > peak)
+					peak = stats.s_Buckets[bucket] ;
+				if(first == ISR_STATS_BUCKETS)
+					first = bucket ;
+				last = bucket ;
+			}
+			if(total == 0)
+				continue;
+
+			fprintf(stderr, "ISR[%s]: %s %s (cycles) , %lu runs , max %u\n", name,
+					vectors[vector], histograms[histogram], (unsigned long)total, stats.s_Max);
+			for(bucket = first ; bucket <= last ; bucket++)
+			{
+				if(bucket == 0)
+					fprintf(stderr, "ISR[%s]: %13s", name, "< 8");
+				else if(bucket == (ISR_STATS_BUCKETS - 1))
+					fprintf(stderr, "ISR[%s]: %6lu ..      ", name, 1UL << (bucket + 2));
+				else
+					fprintf(stderr, "ISR[%s]: %6lu .. %5lu", name, 1UL << (bucket + 2),
+							(1UL << (bucket + 3)) - 1);
+				fprintf(stderr, " %6u |%.*s\n", stats.s_Buckets[bucket],
+						(int)((stats.s_Buckets[bucket] * ISR_STATS_BAR_SIZE + peak - 1) / peak),
+						"########################################");
+			}
+		}
+	}
+}
+#endif
+
+/*
+ * Description: Function to count a value in its log2 bucket
+ */
+static void ISR_STATS_count(ISR_StatsHistogramType *histogram, uint32 cycles)
+{
+	uint32 value = cycles >> ISR_STATS_MIN_SHIFT ;
+	uint8 bucket = 0 ;
+
+	while((value != 0) && (bucket < (ISR_STATS_BUCKETS - 1)))
+	{
+		value >>= 1 ;
+		bucket++ ;
+	}
+
+	if(histogram->s_Buckets[bucket] < 0xFFFF)
+		histogram->s_Buckets[bucket]++ ;
+	if(cycles > histogram->s_Max)
+		histogram->s_Max = (cycles < 0xFFFF) ? (uint16)cycles : 0xFFFF ;
+}
+
+#endif /* ISR_STATS_ENABLE */
@@ -0,0 +1,133 @@
+ /******************************************************************************
+ *
+ * Module: 		ISR Statistics
+ * File Name: 	isr_stats.h
+ * Description: Header file for the ISR latency / duration histograms
+ *
+ * Notes:		- ISR_STATS_ENTER(vector, latency) first in the ISR ,
+ * 				  ISR_STATS_EXIT(vector) last , every vector has two log2
+ * 				  histograms in CPU cycles : entry latency (hardware event =>
+ * 				  ISR_STATS_ENTER) and duration (ENTER => EXIT)
+ *
+ * 				- Bucket 0 = 0 .. 7 cycles , bucket n = 2^(n+2) .. 2^(n+3)-1 ,
+ * 				  the last bucket = all longer values . Counts saturate at
+ * 				  0xFFFF , the max. of each histogram saturates at 0xFFFF
+ *
+ * 				- Latency source on the AVR : the timer counter restarted by
+ * 				  the event (TCNT1 / TCNT2 * prescaler) . USART RXC and TWI
+ * 				  have no event time stamp => ISR_STATS_NO_LATENCY , their
+ * 				  latency histogram is only filled on the host . USART RXC
+ * 				  counts the Data OverRuns (DOR) instead : the 2 bytes UDR
+ * 				  FIFO was full => an RXC latency > 2 frames
+ *
+ * 				- Duration : TCNT1 (F_CPU clock , 1 ms period) difference ,
+ * 				  an ISR must take less than 1 ms
+ *
+ * 				- ISR_STATS_ENABLE = FALSE (drivers_config.h , make ISR_STATS=1
+ * 				  to enable) => the macros are empty , no code and no RAM
+ *
+ * 				- HOST_BUILD => latency of all vectors from the model
+ * 				  (HOST_isrLatency()) , durations in virtual cycles , the
+ * 				  histograms are printed with the model report (HOST_report())
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef ISR_STATS_H_
+#define ISR_STATS_H_
+
+#include "std_types.h"
+#include "micro_config.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Vectors IDs */
+#define ISR_STATS_TIMER1		0	/* TIMER1_COMPA_vect */
+#define ISR_STATS_TIMER2		1	/* TIMER2_COMP_vect , TIMER2_OVF_vect */
+#define ISR_STATS_USART_RXC		2	/* USART_RXC_vect */
+#define ISR_STATS_TWI			3	/* TWI_vect */
+#define ISR_STATS_VECTORS		4
+
+/* Histograms */
+#define ISR_STATS_LATENCY		0
+#define ISR_STATS_DURATION		1
+#define ISR_STATS_HISTOGRAMS	2
+
+/* Bucket 0 upper limit = 2^ISR_STATS_MIN_SHIFT cycles */
+#define ISR_STATS_MIN_SHIFT		3
+
+/* Latency argument of the vectors without an event time stamp */
+#define ISR_STATS_NO_LATENCY	0xFFFF
+
+#if (ISR_STATS_ENABLE == TRUE)
+	#define ISR_STATS_INIT()					ISR_STATS_init()
+	#define ISR_STATS_ENTER(vector, latency)	ISR_STATS_enter((vector), (latency))
+	#define ISR_STATS_EXIT(vector)				ISR_STATS_exit(vector)
+#else
+	#define ISR_STATS_INIT()					((void)0)
+	#define ISR_STATS_ENTER(vector, latency)	((void)0)
+	#define ISR_STATS_EXIT(vector)				((void)0)
+#endif
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	/* Longest value (cycles) , saturates at 0xFFFF */
+	uint16 s_Max ;
+
+	/* Values per log2 bucket */
+	uint16 s_Buckets[ISR_STATS_BUCKETS] ;
+}ISR_StatsHistogramType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function to clear the histograms
+ */
+void ISR_STATS_init(void);
+
+/*
+ * Description: Function to count the entry latency and start the duration
+ * 				(ISR_STATS_ENTER) , called with the interrupts disabled
+ */
+void ISR_STATS_enter(uint8 vector, uint16 latency);
+
+/*
+ * Description: Function to count the duration (ISR_STATS_EXIT)
+ */
+void ISR_STATS_exit(uint8 vector);
+
+/*
+ * Description: Function to count a USART Data OverRun (USART RXC ISR)
+ */
+void ISR_STATS_overrun(void);
+
+/*
+ * Description: Function to copy a histogram (ISR_STATS_LATENCY , ISR_STATS_DURATION)
+ *
+ * Return: FALSE if the vector or the histogram doesn't exist
+ */
+bool ISR_STATS_getHistogram(uint8 vector, uint8 histogram, ISR_StatsHistogramType *stats);
+
+/*
+ * Description: Function returns the number of USART Data OverRuns
+ */
+uint16 ISR_STATS_getOverruns(void);
+
+#ifdef HOST_BUILD
+/*
+ * Description: Function to print the histograms (stderr) , Report Hook of
+ * 				the model set by ISR_STATS_init()
+ */
+void ISR_STATS_hostReport(const char *name);
+#endif
+
+#endif /* ISR_STATS_H_ */
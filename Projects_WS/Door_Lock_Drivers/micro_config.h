@@ -10,12 +10,14 @@
 #ifndef MICRO_CONFIG_H_
 #define MICRO_CONFIG_H_
 
-	#ifndef F_CPU
-	#define F_CPU 8000000UL //8MHz Clock frequency
-	#endif
+	/* F_CPU and shared drivers configuration */
+	#include "drivers_config.h"
 
 	#include <avr/io.h>
 	#include <avr/interrupt.h>
 	#include <util/delay.h>
 
+	/* Register access of the drivers (AVR / Linux model) */
+	#include "hal.h"
+
 #endif /* MICRO_CONFIG_H_ */
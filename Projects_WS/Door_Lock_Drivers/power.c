@@ -0,0 +1,136 @@
+ /******************************************************************************
+ *
+ * Module: 		Power
+ * File Name: 	power.c
+ * Description: Source file for the Idle Sleep Mode and Sleep Time Accounting
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "power.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* millis() of the last POWER_resetStats() */
+static uint32 g_statsStart = 0 ;
+
+/* Sleep time = g_sleepMs ms + g_sleepUs us (< 1000) */
+static uint32 g_sleepMs = 0 ;
+static uint16 g_sleepUs = 0 ;
+
+static uint32 g_wakeups = 0 ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description: Function to sleep until the next interrupt ,
+ * 				called with the Global Interrupt disabled
+ */
+static void POWER_enter(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to select Idle Sleep Mode , disable the Analog Comparator
+ * 				and clear the statistics .
+ */
+void POWER_init(void)
+{
+	set_sleep_mode(SLEEP_MODE_IDLE);
+
+	/* Analog Comparator draws current in Idle Mode , not used */
+	HAL_OR(ACSR, (1<<ACD));
+
+	POWER_resetStats();
+}
+
+/*
+ * Description: Scheduler Idle Hook , sleep until the next interrupt
+ * 				if no task is ready
+ * 				An ISR between the check and the sleep would set an event and
+ * 				the CPU would sleep anyway , so the check is done with the
+ * 				interrupts disabled , POWER_enter() enables them just before SLEEP
+ */
+void POWER_idle(void)
+{
+	cli();
+	if(SCHED_isReady())
+	{
+		sei();
+		return ;
+	}
+	POWER_enter();
+}
+
+/*
+ * Description: Function to sleep until the next interrupt , for busy waits
+ */
+void POWER_sleep(void)
+{
+	if(BIT_IS_CLEAR(SREG,SREG_I))
+		return ;
+
+	cli();
+	POWER_enter();
+}
+
+/*
+ * Description: Function to copy the sleep / active time statistics
+ */
+void POWER_getStats(POWER_StatsType *stats)
+{
+	stats->s_ElapsedMs = millis() - g_statsStart ;
+	stats->s_SleepMs = g_sleepMs ;
+	stats->s_Wakeups = g_wakeups ;
+}
+
+/*
+ * Description: Function to clear the statistics
+ */
+void POWER_resetStats(void)
+{
+	g_statsStart = millis() ;
+	g_sleepMs = 0 ;
+	g_sleepUs = 0 ;
+	g_wakeups = 0 ;
+}
+
+/*
+ * Description: Function to sleep until the next interrupt ,
+ * 				called with the Global Interrupt disabled
+ * 				The instruction after SEI is always executed before any
+ * 				interrupt , so no interrupt is lost before SLEEP
+ */
+static void POWER_enter(void)
+{
+	uint32 start = micros() ;
+	uint32 time ;
+
+	sleep_enable();
+	sei();
+	sleep_cpu();
+	sleep_disable();
+
+	/* Woken up , the ISR is already served */
+	time = micros() - start ;
+	g_wakeups++ ;
+
+	/* Usually < 1 ms (TIMER1 tick wakes the CPU) , no division */
+	while(time >= 1000UL)
+	{
+		time -= 1000UL ;
+		g_sleepMs++ ;
+	}
+	g_sleepUs += (uint16)time ;
+	if(g_sleepUs >= 1000)
+	{
+		g_sleepUs -= 1000 ;
+		g_sleepMs++ ;
+	}
+}
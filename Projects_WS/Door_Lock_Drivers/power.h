@@ -0,0 +1,86 @@
+ /******************************************************************************
+ *
+ * Module: 		Power
+ * File Name: 	power.h
+ * Description: Header file for the Idle Sleep Mode and Sleep Time Accounting
+ *
+ * Notes:		- The CPU sleeps in Idle Mode when no task is ready
+ * 				  (Scheduler Idle Hook) and in the blocking waits of the drivers ,
+ * 				  any enabled interrupt wakes it :
+ * 				  	USART RXC   => UART_init() with RX Interrupt
+ * 				  	TIMER1 COMP => SoftTimer_init() , 1 ms tick , also the
+ * 				  	               keypad scan (no Pin Change Interrupt on ATmega16 ,
+ * 				  	               the keypad rows are not on INT0/1/2)
+ * 				  	TIMER0 COMP => LCD queue , TWI => EEPROM transactions
+ *
+ * 				- Power-save Mode is not used : it stops TIMER1 and the USART ,
+ * 				  so millis() , the software timers and the frames from the
+ * 				  other ECU would be lost
+ *
+ * 				- Sleep time is measured by micros() around every sleep ,
+ * 				  the ISR that wakes the CPU is counted as sleep time
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include "std_types.h"
+#include "common_macros.h"
+#include "micro_config.h"
+#include "soft_timer.h"
+#include "scheduler.h"
+#include <avr/sleep.h>
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	/* ms since POWER_init() / POWER_resetStats() */
+	uint32 s_ElapsedMs ;
+
+	/* ms spent in sleep mode , active time = s_ElapsedMs - s_SleepMs */
+	uint32 s_SleepMs ;
+
+	/* Number of sleeps (= wake ups) */
+	uint32 s_Wakeups ;
+}POWER_StatsType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function to select Idle Sleep Mode , disable the Analog Comparator
+ * 				(enabled after reset , not used) and clear the statistics .
+ * 				SoftTimer_init() must be called first .
+ */
+void POWER_init(void);
+
+/*
+ * Description: Scheduler Idle Hook , sleep until the next interrupt
+ * 				if no task is ready
+ */
+void POWER_idle(void);
+
+/*
+ * Description: Function to sleep until the next interrupt , for busy waits
+ * 				No sleep if the Global Interrupt is disabled (nothing could wake the CPU)
+ */
+void POWER_sleep(void);
+
+/*
+ * Description: Function to copy the sleep / active time statistics
+ */
+void POWER_getStats(POWER_StatsType *stats);
+
+/*
+ * Description: Function to clear the statistics
+ */
+void POWER_resetStats(void);
+
+#endif /* POWER_H_ */
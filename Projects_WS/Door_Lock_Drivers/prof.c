@@ -0,0 +1,200 @@
+ /******************************************************************************
+ *
+ * Module: 		Profiler
+ * File Name: 	prof.c
+ * Description: Source file for the Profiling Zones (CPU cycles per zone)
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "prof.h"
+
+#if (PROF_ENABLE == TRUE)
+
+#ifdef HOST_BUILD
+#include <stdio.h>
+#endif
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* Time Stamp , the model clock on the host (exact , no TIMER1 reading) */
+#ifdef HOST_BUILD
+#define PROF_NOW()				((uint32)HOST_cycles())
+#else
+#define PROF_NOW()				SoftTimer_cycles()
+#endif
+
+/* Empty zone runs to measure the probe overhead , the fastest one is kept */
+#define PROF_CALIBRATION_RUNS	4
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint32 s_start ;
+	PROF_StatsType s_stats ;
+}PROF_ZoneType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static PROF_ZoneType g_zones[PROF_MAX_ZONES] ;
+
+/* Cycles of PROF_BEGIN + PROF_END , subtracted from every run */
+static uint16 g_overhead = 0 ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description: Function to clear the statistics of all zones
+ */
+static void PROF_clear(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to clear the zones and measure the probe overhead
+ * 				with empty runs of zone 0 , interrupts disabled
+ */
+void PROF_init(void)
+{
+	uint8 sreg = SREG ;
+	uint8 run ;
+
+	PROF_clear();
+	g_overhead = 0 ;
+
+	cli();
+	for(run = 0 ; run < PROF_CALIBRATION_RUNS ; run++)
+	{
+		PROF_begin(0);
+		PROF_end(0);
+	}
+	SREG = sreg ;
+
+	g_overhead = (uint16)g_zones[0].s_stats.s_MinCycles ;
+	PROF_clear();
+
+#ifdef HOST_BUILD
+	HOST_addReportHook(PROF_hostReport);
+#endif
+}
+
+/*
+ * Description: Function to start a run of the zone , the time stamp is the
+ * 				last action (not counted in the zone)
+ */
+void PROF_begin(uint8 zone)
+{
+	if(zone < PROF_MAX_ZONES)
+		g_zones[zone].s_start = PROF_NOW() ;
+}
+
+/*
+ * Description: Function to finish the run of the zone , the time stamp is the
+ * 				first action , the table update is done with the interrupts
+ * 				disabled (zones of the ISRs)
+ */
+void PROF_end(uint8 zone)
+{
+	uint32 cycles = PROF_NOW() ;
+	PROF_StatsType *stats ;
+	uint8 sreg ;
+
+	if(zone >= PROF_MAX_ZONES)
+		return ;
+
+	stats = &g_zones[zone].s_stats ;
+	cycles -= g_zones[zone].s_start ;
+	cycles = (cycles > g_overhead) ? (cycles - g_overhead) : 0 ;
+
+	sreg = SREG ;
+	cli();
+	if(stats->s_Count < 0xFFFF)
+		stats->s_Count++ ;
+	if(cycles < stats->s_MinCycles)
+		stats->s_MinCycles = cycles ;
+	if(cycles > stats->s_MaxCycles)
+		stats->s_MaxCycles = cycles ;
+	stats->s_TotalCycles += cycles ;
+	SREG = sreg ;
+}
+
+/*
+ * Description: Function to copy the statistics of a zone
+ */
+bool PROF_getStats(uint8 zone, PROF_StatsType *stats)
+{
+	uint8 sreg = SREG ;
+
+	if(zone >= PROF_MAX_ZONES)
+		return FALSE ;
+
+	cli();
+	*stats = g_zones[zone].s_stats ;
+	SREG = sreg ;
+
+	/* No run => min = 0 */
+	if(stats->s_Count == 0)
+		stats->s_MinCycles = 0 ;
+	return TRUE ;
+}
+
+/*
+ * Description: Function returns the probe overhead in CPU cycles
+ */
+uint16 PROF_getOverhead(void)
+{
+	return g_overhead ;
+}
+
+#ifdef HOST_BUILD
+/*
+ * Description: Function to print the zones that ran (stderr) , the zone
+ * 				names are in the ECU configuration
+ */
+void PROF_hostReport(const char *name)
+{
+	PROF_StatsType stats ;
+	uint8 zone ;
+
+	fprintf(stderr, "PROF[%s]: zone %7s %10s %10s %10s %12s (cycles , overhead %u)\n",
+			name, "count", "min", "avg", "max", "total", g_overhead);
+	for(zone = 0 ; PROF_getStats(zone, &stats) ; zone++)
+	{
+		if(stats.s_Count == 0)
+			continue ;
+		fprintf(stderr, "PROF[%s]: %4u %7u %10lu %10lu %10lu %12lu\n", name, zone, stats.s_Count,
+				(unsigned long)stats.s_MinCycles,
+				(unsigned long)((stats.s_Count != 0) ? (stats.s_TotalCycles / stats.s_Count) : 0),
+				(unsigned long)stats.s_MaxCycles, (unsigned long)stats.s_TotalCycles);
+	}
+}
+#endif
+
+/*
+ * Description: Function to clear the statistics of all zones
+ */
+static void PROF_clear(void)
+{
+	uint8 zone ;
+
+	for(zone = 0 ; zone < PROF_MAX_ZONES ; zone++)
+	{
+		g_zones[zone].s_stats.s_Count = 0 ;
+		g_zones[zone].s_stats.s_MinCycles = 0xFFFFFFFFUL ;
+		g_zones[zone].s_stats.s_MaxCycles = 0 ;
+		g_zones[zone].s_stats.s_TotalCycles = 0 ;
+	}
+}
+
+#endif /* PROF_ENABLE */
@@ -0,0 +1,115 @@
+ /******************************************************************************
+ *
+ * Module: 		Profiler
+ * File Name: 	prof.h
+ * Description: Header file for the Profiling Zones (CPU cycles per zone)
+ *
+ * Notes:		- PROF_BEGIN(zone) / PROF_END(zone) around the code to measure ,
+ * 				  the time stamps are SoftTimer_cycles() (TIMER1 @ F_CPU , 1 ms
+ * 				  Compare tick) => 1 CPU cycle resolution , zones up to ~536 Sec.
+ *
+ * 				- Every zone has count , min / max / total cycles in a fixed
+ * 				  table of PROF_MAX_ZONES entries (drivers_config.h) ,
+ * 				  zone IDs are set by each ECU (hmi_config.h , control_config.h)
+ *
+ * 				- Probe overhead (PROF_BEGIN + PROF_END with nothing between)
+ * 				  is measured by PROF_init() and subtracted from every zone
+ *
+ * 				- The interrupts served inside a zone are counted in it ,
+ * 				  a zone must not be entered again before its PROF_END
+ * 				  (no recursion , not in an ISR and in the code it interrupts)
+ *
+ * 				- PROF_ENABLE = FALSE (drivers_config.h , make PROF=1 to
+ * 				  enable) => PROF_INIT / PROF_BEGIN / PROF_END are empty ,
+ * 				  no code and no RAM
+ *
+ * 				- HOST_BUILD => the time stamps are the virtual cycles of the
+ * 				  model (register accesses , delays , I/O waits , the C code
+ * 				  takes no virtual time) and the table is printed with the
+ * 				  model report (HOST_report())
+ *
+ * Example :	- PROF_BEGIN(PROF_ZONE_CHECK_PASSWORD);
+ * 				  match = PasswordMatch(g_password);
+ * 				  PROF_END(PROF_ZONE_CHECK_PASSWORD);
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef PROF_H_
+#define PROF_H_
+
+#include "std_types.h"
+#include "micro_config.h"
+#include "soft_timer.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+#if (PROF_ENABLE == TRUE)
+	#define PROF_INIT()				PROF_init()
+	#define PROF_BEGIN(zone)		PROF_begin(zone)
+	#define PROF_END(zone)			PROF_end(zone)
+#else
+	#define PROF_INIT()				((void)0)
+	#define PROF_BEGIN(zone)		((void)0)
+	#define PROF_END(zone)			((void)0)
+#endif
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	/* Completed runs , saturates at 0xFFFF */
+	uint16 s_Count ;
+
+	/* CPU cycles of one run (probe overhead subtracted) and of all runs */
+	uint32 s_MinCycles ;
+	uint32 s_MaxCycles ;
+	uint32 s_TotalCycles ;
+}PROF_StatsType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function to clear the zones and measure the probe overhead .
+ * 				SoftTimer_init() must be called first .
+ */
+void PROF_init(void);
+
+/*
+ * Description: Function to start a run of the zone (PROF_BEGIN)
+ */
+void PROF_begin(uint8 zone);
+
+/*
+ * Description: Function to finish the run of the zone and count it (PROF_END)
+ */
+void PROF_end(uint8 zone);
+
+/*
+ * Description: Function to copy the statistics of a zone
+ *
+ * Return: FALSE if the zone is out of the table
+ */
+bool PROF_getStats(uint8 zone, PROF_StatsType *stats);
+
+/*
+ * Description: Function returns the probe overhead in CPU cycles
+ */
+uint16 PROF_getOverhead(void);
+
+#ifdef HOST_BUILD
+/*
+ * Description: Function to print the zones (stderr) , Report Hook of the
+ * 				model set by PROF_init()
+ */
+void PROF_hostReport(const char *name);
+#endif
+
+#endif /* PROF_H_ */
@@ -0,0 +1,222 @@
+ /******************************************************************************
+ *
+ * Module: 		Scheduler
+ * File Name: 	scheduler.c
+ * Description: Source file for the Cooperative Run-To-Completion Scheduler
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "scheduler.h"
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct
+{
+	SCHED_TaskFunction s_task ;
+	uint8 s_priority ;
+
+	/* Event flags , set from ISRs */
+	volatile uint8 s_events ;
+
+	/* micros() when s_events changed from 0 */
+	uint32 s_readyTime ;
+
+	SCHED_StatsType s_stats ;
+}SCHED_TaskType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static SCHED_TaskType g_tasks[SCHED_MAX_TASKS] ;
+static uint8 g_tasksNum = 0 ;
+
+/* Called when no task is ready */
+static void (*g_idleHook)(void) = NULL_PTR ;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to clear the tasks table and the Idle Hook .
+ */
+void SCHED_init(void)
+{
+	uint8 sreg = SREG ;
+
+	cli();
+	g_tasksNum = 0 ;
+	g_idleHook = NULL_PTR ;
+	SREG = sreg ;
+}
+
+/*
+ * Description: Function to add a task , priority 0 is the highest
+ * 				tasks with the same priority run in the order they are added
+ */
+uint8 SCHED_addTask(SCHED_TaskFunction a_task, uint8 priority)
+{
+	SCHED_TaskType *task ;
+	uint8 sreg = SREG ;
+
+	if(g_tasksNum >= SCHED_MAX_TASKS)
+		return SCHED_NO_TASK ;
+
+	task = &g_tasks[g_tasksNum] ;
+	task->s_task = a_task ;
+	task->s_priority = priority ;
+	task->s_events = 0 ;
+	task->s_readyTime = 0 ;
+	task->s_stats.s_Runs = 0 ;
+	task->s_stats.s_RunTime = 0 ;
+	task->s_stats.s_MaxRunTime = 0 ;
+	task->s_stats.s_MaxLatency = 0 ;
+
+	/* ISRs can set events as soon as the ID is returned */
+	cli();
+	g_tasksNum++ ;
+	SREG = sreg ;
+
+	return (uint8)(g_tasksNum - 1) ;
+}
+
+/*
+ * Description: Function to set event flags of a task (ISR safe)
+ */
+void SCHED_setEvent(uint8 task, uint8 events)
+{
+	uint8 sreg = SREG ;
+
+	if((task >= g_tasksNum) || (events == 0))
+		return ;
+
+	cli();
+	if(g_tasks[task].s_events == 0)
+	{
+		/* Task becomes ready , latency starts now */
+		g_tasks[task].s_readyTime = micros() ;
+	}
+	g_tasks[task].s_events |= events ;
+	SREG = sreg ;
+}
+
+/*
+ * Description: Function to set the Idle Hook , called when no task is ready
+ */
+void SCHED_setIdleHook(void(*a_ptr)(void))
+{
+	g_idleHook = a_ptr ;
+}
+
+/*
+ * Description: Function returns TRUE if a task has events
+ */
+bool SCHED_isReady(void)
+{
+	uint8 i;
+
+	for(i = 0 ; i < g_tasksNum ; i++)
+	{
+		if(g_tasks[i].s_events != 0)
+			return TRUE ;
+	}
+	return FALSE ;
+}
+
+/*
+ * Description: Function to run the highest priority ready task once ,
+ * 				or the Idle Hook if no task is ready
+ * 				the table is small , a linear scan is cheaper than a ready queue
+ */
+bool SCHED_runOnce(void)
+{
+	SCHED_TaskType *task = NULL_PTR ;
+	uint32 readyTime ;
+	uint32 start ;
+	uint32 time ;
+	uint8 events ;
+	uint8 sreg ;
+	uint8 i;
+
+	for(i = 0 ; i < g_tasksNum ; i++)
+	{
+		if((g_tasks[i].s_events != 0) &&
+			((task == NULL_PTR) || (g_tasks[i].s_priority < task->s_priority)))
+		{
+			task = &g_tasks[i] ;
+		}
+	}
+
+	if(task == NULL_PTR)
+	{
+		if(g_idleHook != NULL_PTR)
+			(*g_idleHook)();
+		return FALSE ;
+	}
+
+	/* Take the events , new events from now on are for the next run */
+	sreg = SREG ;
+	cli();
+	events = task->s_events ;
+	task->s_events = 0 ;
+	readyTime = task->s_readyTime ;
+	SREG = sreg ;
+
+	start = micros() ;
+	time = start - readyTime ;
+	if(time > task->s_stats.s_MaxLatency)
+		task->s_stats.s_MaxLatency = time ;
+
+	(*task->s_task)(events);
+
+	time = micros() - start ;
+	task->s_stats.s_Runs++ ;
+	task->s_stats.s_RunTime += time ;
+	if(time > task->s_stats.s_MaxRunTime)
+		task->s_stats.s_MaxRunTime = time ;
+
+	return TRUE ;
+}
+
+/*
+ * Description: Function to run the tasks forever
+ */
+void SCHED_run(void)
+{
+	while(1)
+	{
+		SCHED_runOnce();
+	}
+}
+
+/*
+ * Description: Function to copy the run time statistics of a task
+ */
+bool SCHED_getStats(uint8 task, SCHED_StatsType *stats)
+{
+	if(task >= g_tasksNum)
+		return FALSE ;
+
+	*stats = g_tasks[task].s_stats ;
+	return TRUE ;
+}
+
+/*
+ * Description: Function to clear the run time statistics of all tasks
+ */
+void SCHED_resetStats(void)
+{
+	uint8 i;
+
+	for(i = 0 ; i < g_tasksNum ; i++)
+	{
+		g_tasks[i].s_stats.s_Runs = 0 ;
+		g_tasks[i].s_stats.s_RunTime = 0 ;
+		g_tasks[i].s_stats.s_MaxRunTime = 0 ;
+		g_tasks[i].s_stats.s_MaxLatency = 0 ;
+	}
+}
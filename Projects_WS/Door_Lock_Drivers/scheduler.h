@@ -0,0 +1,140 @@
+ /******************************************************************************
+ *
+ * Module: 		Scheduler
+ * File Name: 	scheduler.h
+ * Description: Header file for the Cooperative Run-To-Completion Scheduler
+ *
+ * Notes:		- Tasks are added at startup in a static table of
+ * 				  SCHED_MAX_TASKS entries , a task is a function and a priority
+ * 				  (0 = highest)
+ *
+ * 				- Every task has 8 event flags , ISRs and other tasks set them
+ * 				  by SCHED_setEvent() . The scheduler runs the ready task with the
+ * 				  highest priority and passes it the events set since its last
+ * 				  run , the events are cleared before the call
+ *
+ * 				- Tasks run to completion , a task never waits : it returns and
+ * 				  sets its own event if it has more work
+ *
+ * 				- No task is ready => the Idle Hook is called
+ *
+ * 				- Every run is measured by micros() (1 us = 8 CPU cycles @ 8Mhz) :
+ * 				  runs , total / max run time and max latency
+ * 				  (first event set -> task start)
+ *
+ * Example :	- UART RX ISR wakes the command task
+ * 					g_commandTask = SCHED_addTask(Command_task, 1);
+ * 					UART_RXC_setCallBack(Command_notify);
+ * 					...
+ * 					void Command_notify(void) { SCHED_setEvent(g_commandTask, EV_RX); }
+ * 				- Run the tasks forever
+ * 					SCHED_run();
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include "std_types.h"
+#include "micro_config.h"
+#include "soft_timer.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Size of the tasks table , set in drivers_config.h */
+#ifndef SCHED_MAX_TASKS
+#define SCHED_MAX_TASKS			8
+#endif
+
+#if ((SCHED_MAX_TASKS == 0) || (SCHED_MAX_TASKS > 254))
+#error "SCHED_MAX_TASKS must be 1 .. 254"
+#endif
+
+/* Returned by SCHED_addTask() when the table is full */
+#define SCHED_NO_TASK			0xFF
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* Task Function , events = flags set since the last run */
+typedef void (*SCHED_TaskFunction)(uint8 events);
+
+typedef struct
+{
+	/* Number of runs */
+	uint16 s_Runs ;
+
+	/* Run time in us , total and longest run */
+	uint32 s_RunTime ;
+	uint32 s_MaxRunTime ;
+
+	/* Longest time in us from the first event set to the task start */
+	uint32 s_MaxLatency ;
+}SCHED_StatsType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function to clear the tasks table and the Idle Hook .
+ * 				SoftTimer_init() must be called before SCHED_run() (micros()) .
+ */
+void SCHED_init(void);
+
+/*
+ * Description: Function to add a task , priority 0 is the highest
+ * 				tasks with the same priority run in the order they are added
+ *
+ * Return: Task ID or SCHED_NO_TASK if the table is full
+ */
+uint8 SCHED_addTask(SCHED_TaskFunction a_task, uint8 priority);
+
+/*
+ * Description: Function to set event flags of a task (ISR safe)
+ */
+void SCHED_setEvent(uint8 task, uint8 events);
+
+/*
+ * Description: Function to set the Idle Hook , called when no task is ready
+ * 				with the interrupts enabled
+ */
+void SCHED_setIdleHook(void(*a_ptr)(void));
+
+/*
+ * Description: Function returns TRUE if a task has events ,
+ * 				call it with the interrupts disabled to sleep after it
+ */
+bool SCHED_isReady(void);
+
+/*
+ * Description: Function to run the highest priority ready task once ,
+ * 				or the Idle Hook if no task is ready
+ *
+ * Return: TRUE if a task was run
+ */
+bool SCHED_runOnce(void);
+
+/*
+ * Description: Function to run the tasks forever
+ */
+void SCHED_run(void);
+
+/*
+ * Description: Function to copy the run time statistics of a task
+ *
+ * Return: FALSE if there is no task with this ID
+ */
+bool SCHED_getStats(uint8 task, SCHED_StatsType *stats);
+
+/*
+ * Description: Function to clear the run time statistics of all tasks
+ */
+void SCHED_resetStats(void);
+
+#endif /* SCHEDULER_H_ */
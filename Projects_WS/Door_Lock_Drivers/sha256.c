@@ -0,0 +1,218 @@
+ /******************************************************************************
+ *
+ * Module: 		SHA-256
+ * File Name: 	sha256.c
+ * Description: Source file for the SHA-256 Hash (FIPS 180-4)
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "sha256.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* 32-bit mask , keeps the results in 32 bits if uint32 is wider */
+#define SHA256_MASK				0xFFFFFFFFUL
+
+#define SHA256_ROTR(x,n)		((((x) >> (n)) | ((x) << (32 - (n)))) & SHA256_MASK)
+
+#define SHA256_CH(x,y,z)		(((x) & (y)) ^ (~(x) & (z)))
+#define SHA256_MAJ(x,y,z)		(((x) & (y)) | ((z) & ((x) | (y))))
+#define SHA256_SIGMA0(x)		(SHA256_ROTR(x,2) ^ SHA256_ROTR(x,13) ^ SHA256_ROTR(x,22))
+#define SHA256_SIGMA1(x)		(SHA256_ROTR(x,6) ^ SHA256_ROTR(x,11) ^ SHA256_ROTR(x,25))
+#define SHA256_GAMMA0(x)		(SHA256_ROTR(x,7) ^ SHA256_ROTR(x,18) ^ ((x) >> 3))
+#define SHA256_GAMMA1(x)		(SHA256_ROTR(x,17) ^ SHA256_ROTR(x,19) ^ ((x) >> 10))
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Round Constants , in flash */
+static const uint32 g_sha256K[64] PROGMEM =
+{
+	0x428a2f98UL, 0x71374491UL, 0xb5c0fbcfUL, 0xe9b5dba5UL,
+	0x3956c25bUL, 0x59f111f1UL, 0x923f82a4UL, 0xab1c5ed5UL,
+	0xd807aa98UL, 0x12835b01UL, 0x243185beUL, 0x550c7dc3UL,
+	0x72be5d74UL, 0x80deb1feUL, 0x9bdc06a7UL, 0xc19bf174UL,
+	0xe49b69c1UL, 0xefbe4786UL, 0x0fc19dc6UL, 0x240ca1ccUL,
+	0x2de92c6fUL, 0x4a7484aaUL, 0x5cb0a9dcUL, 0x76f988daUL,
+	0x983e5152UL, 0xa831c66dUL, 0xb00327c8UL, 0xbf597fc7UL,
+	0xc6e00bf3UL, 0xd5a79147UL, 0x06ca6351UL, 0x14292967UL,
+	0x27b70a85UL, 0x2e1b2138UL, 0x4d2c6dfcUL, 0x53380d13UL,
+	0x650a7354UL, 0x766a0abbUL, 0x81c2c92eUL, 0x92722c85UL,
+	0xa2bfe8a1UL, 0xa81a664bUL, 0xc24b8b70UL, 0xc76c51a3UL,
+	0xd192e819UL, 0xd6990624UL, 0xf40e3585UL, 0x106aa070UL,
+	0x19a4c116UL, 0x1e376c08UL, 0x2748774cUL, 0x34b0bcb5UL,
+	0x391c0cb3UL, 0x4ed8aa4aUL, 0x5b9cca4fUL, 0x682e6ff3UL,
+	0x748f82eeUL, 0x78a5636fUL, 0x84c87814UL, 0x8cc70208UL,
+	0x90befffaUL, 0xa4506cebUL, 0xbef9a3f7UL, 0xc67178f2UL
+};
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description: Function to process one block from s_Buffer
+ */
+static void SHA256_compress(SHA256_ContextType *a_context);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to start a new hash
+ */
+void SHA256_init(SHA256_ContextType *a_context)
+{
+	a_context->s_State[0] = 0x6a09e667UL ;
+	a_context->s_State[1] = 0xbb67ae85UL ;
+	a_context->s_State[2] = 0x3c6ef372UL ;
+	a_context->s_State[3] = 0xa54ff53aUL ;
+	a_context->s_State[4] = 0x510e527fUL ;
+	a_context->s_State[5] = 0x9b05688cUL ;
+	a_context->s_State[6] = 0x1f83d9abUL ;
+	a_context->s_State[7] = 0x5be0cd19UL ;
+	a_context->s_Fill = 0 ;
+	a_context->s_Length = 0 ;
+}
+
+/*
+ * Description: Function to add length bytes of the message
+ */
+void SHA256_update(SHA256_ContextType *a_context, const uint8 *data, uint16 length)
+{
+	while (length--)
+	{
+		a_context->s_Buffer[a_context->s_Fill++] = *data++ ;
+		a_context->s_Length++ ;
+		if (a_context->s_Fill == SHA256_BLOCK_SIZE)
+		{
+			SHA256_compress(a_context);
+			a_context->s_Fill = 0 ;
+		}
+	}
+}
+
+/*
+ * Description: Function to finish the hash and write the first length bytes
+ * 				of the digest
+ * 				Padding = 0x80 , zeros , message length in bits (64-bit big endian)
+ */
+void SHA256_final(SHA256_ContextType *a_context, uint8 *digest, uint8 length)
+{
+	uint32 bits = (a_context->s_Length << 3) & SHA256_MASK ;
+	uint8 i;
+
+	a_context->s_Buffer[a_context->s_Fill++] = 0x80 ;
+	if (a_context->s_Fill > (SHA256_BLOCK_SIZE - 8))
+	{
+		while (a_context->s_Fill < SHA256_BLOCK_SIZE)
+			a_context->s_Buffer[a_context->s_Fill++] = 0 ;
+		SHA256_compress(a_context);
+		a_context->s_Fill = 0 ;
+	}
+	while (a_context->s_Fill < (SHA256_BLOCK_SIZE - 4))
+		a_context->s_Buffer[a_context->s_Fill++] = 0 ;
+
+	/* message length < 512 MB => high 32 bits of the length are 0 */
+	for (i = 0 ; i < 4 ; i++)
+	{
+		a_context->s_Buffer[SHA256_BLOCK_SIZE - 1 - i] = (uint8)(bits >> (8 * i)) ;
+	}
+	SHA256_compress(a_context);
+
+	for (i = 0 ; (i < length) && (i < SHA256_DIGEST_SIZE) ; i++)
+	{
+		digest[i] = (uint8)(a_context->s_State[i / 4] >> (24 - (8 * (i % 4)))) ;
+	}
+}
+
+/*
+ * Description: Function to hash salt + data and write the first length bytes
+ * 				of the digest
+ */
+void SHA256_saltedHash(const uint8 *salt, uint8 saltLength,
+		const uint8 *data, uint8 dataLength, uint8 *digest, uint8 length)
+{
+	SHA256_ContextType context ;
+
+	SHA256_init(&context);
+	SHA256_update(&context, salt, saltLength);
+	SHA256_update(&context, data, dataLength);
+	SHA256_final(&context, digest, length);
+}
+
+/*
+ * Description: Function to compare length bytes in constant time ,
+ * 				all bytes are compared , differences are ORed
+ */
+bool SHA256_compare(const uint8 *a, const uint8 *b, uint8 length)
+{
+	uint8 difference = 0 ;
+	uint8 i;
+
+	for (i = 0 ; i < length ; i++)
+	{
+		difference |= (uint8)(a[i] ^ b[i]) ;
+	}
+	return (difference == 0) ;
+}
+
+/*
+ * Description: Function to process one block from s_Buffer
+ * 				W[t] is kept in a 16 words circular schedule :
+ * 				W[t & 15] = gamma1(W[t-2]) + W[t-7] + gamma0(W[t-15]) + W[t-16]
+ */
+static void SHA256_compress(SHA256_ContextType *a_context)
+{
+	uint32 w[16];
+	uint32 v[8];
+	uint32 t1 ;
+	uint32 t2 ;
+	uint8 t;
+	uint8 i;
+
+	for (i = 0 ; i < 16 ; i++)
+	{
+		w[i] = ((uint32)a_context->s_Buffer[4 * i] << 24) |
+				((uint32)a_context->s_Buffer[(4 * i) + 1] << 16) |
+				((uint32)a_context->s_Buffer[(4 * i) + 2] << 8) |
+				(uint32)a_context->s_Buffer[(4 * i) + 3] ;
+	}
+
+	for (i = 0 ; i < 8 ; i++)
+	{
+		v[i] = a_context->s_State[i] ;
+	}
+
+	for (t = 0 ; t < 64 ; t++)
+	{
+		if (t >= 16)
+		{
+			w[t & 15] = (SHA256_GAMMA1(w[(t - 2) & 15]) + w[(t - 7) & 15] +
+					SHA256_GAMMA0(w[(t - 15) & 15]) + w[t & 15]) & SHA256_MASK ;
+		}
+
+		t1 = (v[7] + SHA256_SIGMA1(v[4]) + (SHA256_CH(v[4], v[5], v[6]) & SHA256_MASK) +
+				pgm_read_dword(&g_sha256K[t]) + w[t & 15]) & SHA256_MASK ;
+		t2 = (SHA256_SIGMA0(v[0]) + SHA256_MAJ(v[0], v[1], v[2])) & SHA256_MASK ;
+
+		/* h = g , g = f , ... , b = a */
+		for (i = 7 ; i > 0 ; i--)
+		{
+			v[i] = v[i - 1] ;
+		}
+		v[4] = (v[4] + t1) & SHA256_MASK ;
+		v[0] = (t1 + t2) & SHA256_MASK ;
+	}
+
+	for (i = 0 ; i < 8 ; i++)
+	{
+		a_context->s_State[i] = (a_context->s_State[i] + v[i]) & SHA256_MASK ;
+	}
+}
@@ -0,0 +1,80 @@
+ /******************************************************************************
+ *
+ * Module: 		SHA-256
+ * File Name: 	sha256.h
+ * Description: Header file for the SHA-256 Hash (FIPS 180-4) used to store
+ * 				the passwords as salted hashes
+ *
+ * Notes:		- 8-bit friendly kernel : the message schedule is 16 words
+ * 				  computed in place (64 bytes RAM instead of 256) and the
+ * 				  round constants are read from the flash (PROGMEM)
+ *
+ * 				- A PIN hash is one compression (salt + PIN < 56 bytes)
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef SHA256_H_
+#define SHA256_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+#define SHA256_DIGEST_SIZE		32
+#define SHA256_BLOCK_SIZE		64
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	/* Hash value H0:H7 */
+	uint32 s_State[8] ;
+	/* Bytes waiting a full block */
+	uint8 s_Buffer[SHA256_BLOCK_SIZE] ;
+	uint8 s_Fill ;
+	/* Message length in bytes */
+	uint32 s_Length ;
+}SHA256_ContextType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function to start a new hash
+ */
+void SHA256_init(SHA256_ContextType *a_context);
+
+/*
+ * Description: Function to add length bytes of the message
+ */
+void SHA256_update(SHA256_ContextType *a_context, const uint8 *data, uint16 length);
+
+/*
+ * Description: Function to finish the hash and write the first length bytes
+ * 				of the digest (length <= SHA256_DIGEST_SIZE)
+ */
+void SHA256_final(SHA256_ContextType *a_context, uint8 *digest, uint8 length);
+
+/*
+ * Description: Function to hash salt + data and write the first length bytes
+ * 				of the digest
+ */
+void SHA256_saltedHash(const uint8 *salt, uint8 saltLength,
+		const uint8 *data, uint8 dataLength, uint8 *digest, uint8 length);
+
+/*
+ * Description: Function to compare length bytes in constant time ,
+ * 				time doesn't depend on the position of the first difference
+ *
+ * Return: TRUE if equal
+ */
+bool SHA256_compare(const uint8 *a, const uint8 *b, uint8 length);
+
+#endif /* SHA256_H_ */
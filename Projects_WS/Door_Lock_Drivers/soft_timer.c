@@ -0,0 +1,265 @@
+ /******************************************************************************
+ *
+ * Module: 		Software Timers Service
+ * File Name: 	soft_timer.c
+ * Description: Source file for the Software Timers Service on TIMER1
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "soft_timer.h"
+#include "power.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Monotonic ms counter , incremented by TIMER1 ISR */
+static volatile uint32 g_ticks = 0 ;
+
+/* Timing wheel , each slot is a doubly linked list of running timers */
+static SoftTimer_Type *g_wheel[SOFT_TIMER_WHEEL_SIZE] ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description: Function to add a timer in the slot of its expiry tick
+ */
+static void SoftTimer_insert(SoftTimer_Type *timer);
+
+/*
+ * Description: Function to remove a timer from its slot
+ */
+static void SoftTimer_remove(SoftTimer_Type *timer);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to initialize the Software Timers Service
+ * 	1. Initialize TIMER1 in Compare Mode with 1 ms tick.
+ * 	2. Set TIMER1 Call Back function to the service tick.
+ * 	3. Clear the timing wheel.
+ */
+void SoftTimer_init(void)
+{
+	uint8 slot ;
+
+	/* F_CPU = 8Mhz		Timer1 COMP Mode 	1 ms. , 1 count = 1 CPU cycle */
+	TIMER_ConfigType Timer1_Config = {.clock = F_CPU_CLOCK, .mode = COMP, .OCRValue = SOFT_TIMER_TICK_OCR };
+
+	for(slot = 0 ; slot < SOFT_TIMER_WHEEL_SIZE ; slot++)
+	{
+		g_wheel[slot] = NULL_PTR ;
+	}
+	g_ticks = 0 ;
+
+	Timer1_setCallBack(SoftTimer_tick);
+	Timer1_Init(&Timer1_Config);
+}
+
+/*
+ * Description: Function to start (or restart) a timer
+ * 				delay  => ms until first expiry (0 is treated as 1)
+ * 				period => ms between next expiries , 0 for One-shot timer
+ */
+void SoftTimer_start(SoftTimer_Type *timer, uint32 delay, uint32 period, void(*a_ptr)(void))
+{
+	uint8 sreg = SREG ;
+
+	if(delay == 0)
+		delay = 1 ;
+
+	/* Wheel is also changed by TIMER1 ISR */
+	cli();
+	if(timer->s_state == SOFT_TIMER_RUNNING)
+		SoftTimer_remove(timer);
+
+	timer->s_expiry = g_ticks + delay ;
+	timer->s_period = period ;
+	timer->s_callBack = a_ptr ;
+	SoftTimer_insert(timer);
+	SREG = sreg ;
+}
+
+/*
+ * Description: Function to stop a timer , no effect if timer is not running
+ */
+void SoftTimer_stop(SoftTimer_Type *timer)
+{
+	uint8 sreg = SREG ;
+
+	cli();
+	if(timer->s_state == SOFT_TIMER_RUNNING)
+		SoftTimer_remove(timer);
+	SREG = sreg ;
+}
+
+/*
+ * Description: Function returns TRUE if the timer is running
+ */
+bool SoftTimer_isRunning(const SoftTimer_Type *timer)
+{
+	return (timer->s_state == SOFT_TIMER_RUNNING) ;
+}
+
+/*
+ * Description: Function returns the number of ms since SoftTimer_init()
+ */
+uint32 millis(void)
+{
+	uint32 ticks ;
+	uint8 sreg = SREG ;
+
+	/* 32-bit read is not atomic on AVR */
+	cli();
+	ticks = g_ticks ;
+	SREG = sreg ;
+
+	return ticks ;
+}
+
+/*
+ * Description: Function returns the number of us since SoftTimer_init()
+ * 				(millis() * 1000 + TIMER1 counter) , wraps after ~71 minutes
+ */
+uint32 micros(void)
+{
+	uint32 ticks ;
+	uint16 count ;
+	uint8 sreg = SREG ;
+
+	cli();
+	ticks = g_ticks ;
+	count = HAL_READ16(TCNT1) ;
+	/* Compare Match not served yet (interrupts are disabled) =>
+	 * TCNT1 restarted from 0 , the ms is not in g_ticks */
+	if(HAL_READ(TIFR) & (1<<OCF1A))
+	{
+		ticks++ ;
+		count = HAL_READ16(TCNT1) ;
+	}
+	SREG = sreg ;
+
+#if ((F_CPU % 1000000UL) == 0)
+	/* whole Mhz => 16 bit division by a constant (a shift @ 8Mhz , called from ISRs) */
+	return (ticks * 1000UL) + (count / (uint16)(F_CPU / 1000000UL)) ;
+#else
+	return (ticks * 1000UL) + (((uint32)count * 1000UL) / SOFT_TIMER_TICK_CYCLES) ;
+#endif
+}
+
+/*
+ * Description: Function returns the number of CPU cycles since SoftTimer_init()
+ * 				(profiling time stamps , same reading as micros())
+ */
+uint32 SoftTimer_cycles(void)
+{
+	uint32 ticks ;
+	uint16 count ;
+	uint8 sreg = SREG ;
+
+	cli();
+	ticks = g_ticks ;
+	count = HAL_READ16(TCNT1) ;
+	if(HAL_READ(TIFR) & (1<<OCF1A))
+	{
+		ticks++ ;
+		count = HAL_READ16(TCNT1) ;
+	}
+	SREG = sreg ;
+
+	return (ticks * SOFT_TIMER_TICK_CYCLES) + count ;
+}
+
+/*
+ * Description: Function to wait msec using millis() counter
+ * 				Timers and other interrupts are still served while waiting
+ */
+void SoftTimer_delay(uint32 msec)
+{
+	uint32 start = millis() ;
+
+	/* TIMER1 tick wakes the CPU every ms */
+	while((millis() - start) < msec)
+	{
+		POWER_sleep();
+	}
+}
+
+/*
+ * Description: Call Back Function of TIMER1 ISR => Service Tick (1 ms)
+ * 				Fire all timers in the current slot that reached their expiry
+ */
+void SoftTimer_tick(void)
+{
+	SoftTimer_Type *timer ;
+	uint32 now = ++g_ticks ;
+
+	/* Call Back functions may start / stop any timer , so the slot list is
+	 * searched again from its head after every expired timer */
+	do
+	{
+		timer = g_wheel[now & SOFT_TIMER_WHEEL_MASK] ;
+
+		/* timers in the slot with later expiry are skipped (later wheel rounds) */
+		while((timer != NULL_PTR) && ((sint32)(now - timer->s_expiry) < 0))
+		{
+			timer = timer->s_next ;
+		}
+
+		if(timer != NULL_PTR)
+		{
+			SoftTimer_remove(timer);
+
+			/* Periodic timer , add it again with next expiry */
+			if(timer->s_period != 0)
+			{
+				timer->s_expiry += timer->s_period ;
+				SoftTimer_insert(timer);
+			}
+
+			if(timer->s_callBack != NULL_PTR)
+			{
+				(*timer->s_callBack)();
+			}
+		}
+	}while(timer != NULL_PTR);
+}
+
+/*
+ * Description: Function to add a timer in the slot of its expiry tick
+ */
+static void SoftTimer_insert(SoftTimer_Type *timer)
+{
+	SoftTimer_Type **head = &g_wheel[timer->s_expiry & SOFT_TIMER_WHEEL_MASK] ;
+
+	timer->s_prev = NULL_PTR ;
+	timer->s_next = *head ;
+	if(*head != NULL_PTR)
+		(*head)->s_prev = timer ;
+	*head = timer ;
+
+	timer->s_state = SOFT_TIMER_RUNNING ;
+}
+
+/*
+ * Description: Function to remove a timer from its slot
+ */
+static void SoftTimer_remove(SoftTimer_Type *timer)
+{
+	if(timer->s_prev != NULL_PTR)
+		timer->s_prev->s_next = timer->s_next ;
+	else
+		g_wheel[timer->s_expiry & SOFT_TIMER_WHEEL_MASK] = timer->s_next ;
+
+	if(timer->s_next != NULL_PTR)
+		timer->s_next->s_prev = timer->s_prev ;
+
+	timer->s_next = NULL_PTR ;
+	timer->s_prev = NULL_PTR ;
+	timer->s_state = SOFT_TIMER_IDLE ;
+}
@@ -0,0 +1,141 @@
+ /******************************************************************************
+ *
+ * Module: 		Software Timers Service
+ * File Name: 	soft_timer.h
+ * Description: Header file for the Software Timers Service on TIMER1
+ *
+ * Notes:		- TIMER1 runs in Compare Mode with 1 ms tick
+ * 				  F_CPU = 8Mhz , Prescaler = 1 => 1 count = 1 CPU cycle
+ * 				  OCR1A = 7999 => Compare Match every 8000 cycles (1 ms)
+ * 				  SoftTimer_cycles() is a cycle counter (profiling) ,
+ * 				  micros() = millis() * 1000 + TCNT1 / 8
+ *
+ * 				- Timers are stored in a hashed timing wheel of
+ * 				  SOFT_TIMER_WHEEL_SIZE slots , the slot of a timer is
+ * 				  (expiry tick & SOFT_TIMER_WHEEL_MASK)
+ * 				  	start / stop => O(1) (insert / remove from slot list)
+ * 				  	tick 		 => visit only the timers in current slot
+ *
+ * 				- Call Back functions are called from TIMER1 ISR ,
+ * 				  keep them short (set a flag , change a pin , restart a timer)
+ *
+ * Example :	- One-shot timer fires after 10 Sec.
+ * 					static SoftTimer_Type g_doorTimer;
+ * 					SoftTimer_start(&g_doorTimer, 10000, 0, Door_CallBack);
+ * 				- Periodic timer every 5 ms
+ * 					SoftTimer_start(&g_scanTimer, 5, 5, Scan_CallBack);
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef SOFT_TIMER_H_
+#define SOFT_TIMER_H_
+
+#include "std_types.h"
+#include "micro_config.h"
+#include "timer.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Number of slots in the timing wheel , set in drivers_config.h
+ * Must be power of two */
+#if ((SOFT_TIMER_WHEEL_SIZE & (SOFT_TIMER_WHEEL_SIZE - 1)) != 0)
+#error "SOFT_TIMER_WHEEL_SIZE must be power of two"
+#endif
+
+#define SOFT_TIMER_WHEEL_MASK	(SOFT_TIMER_WHEEL_SIZE - 1)
+
+/* TIMER1 counts per 1 ms tick with F_CPU clock , and its Compare Value */
+#define SOFT_TIMER_TICK_CYCLES	(F_CPU / 1000UL)
+#define SOFT_TIMER_TICK_OCR		((uint16)(SOFT_TIMER_TICK_CYCLES - 1))
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef enum
+{
+	SOFT_TIMER_IDLE, SOFT_TIMER_RUNNING
+}SoftTimer_State;
+
+typedef struct SoftTimer_Type
+{
+	/* Links in the wheel slot list */
+	struct SoftTimer_Type *s_next ;
+	struct SoftTimer_Type *s_prev ;
+
+	/* Tick (millis) when the timer expires */
+	uint32 s_expiry ;
+
+	/* Period in ms , 0 => One-shot timer */
+	uint32 s_period ;
+
+	/* Call Back function , called from TIMER1 ISR when the timer expires */
+	void (*s_callBack)(void) ;
+
+	/* IDLE , RUNNING */
+	SoftTimer_State s_state ;
+}SoftTimer_Type;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function to initialize the Software Timers Service
+ * 	1. Initialize TIMER1 in Compare Mode with 1 ms tick.
+ * 	2. Set TIMER1 Call Back function to the service tick.
+ * 	3. Clear the timing wheel.
+ */
+void SoftTimer_init(void);
+
+/*
+ * Description: Function to start (or restart) a timer
+ * 				delay  => ms until first expiry (0 is treated as 1)
+ * 				period => ms between next expiries , 0 for One-shot timer
+ */
+void SoftTimer_start(SoftTimer_Type *timer, uint32 delay, uint32 period, void(*a_ptr)(void));
+
+/*
+ * Description: Function to stop a timer , no effect if timer is not running
+ */
+void SoftTimer_stop(SoftTimer_Type *timer);
+
+/*
+ * Description: Function returns TRUE if the timer is running
+ */
+bool SoftTimer_isRunning(const SoftTimer_Type *timer);
+
+/*
+ * Description: Function returns the number of ms since SoftTimer_init()
+ */
+uint32 millis(void);
+
+/*
+ * Description: Function returns the number of us since SoftTimer_init() ,
+ * 				use differences only (wraps after ~71 minutes)
+ */
+uint32 micros(void);
+
+/*
+ * Description: Function returns the number of CPU cycles since SoftTimer_init()
+ * 				(millis() * SOFT_TIMER_TICK_CYCLES + TIMER1 counter) ,
+ * 				wraps after ~536 Sec. @ 8Mhz
+ */
+uint32 SoftTimer_cycles(void);
+
+/*
+ * Description: Function to wait msec using millis() counter
+ * 				Timers and other interrupts are still served while waiting
+ */
+void SoftTimer_delay(uint32 msec);
+
+/*
+ * Description: Call Back Function of TIMER1 ISR => Service Tick (1 ms)
+ */
+void SoftTimer_tick(void);
+
+#endif /* SOFT_TIMER_H_ */
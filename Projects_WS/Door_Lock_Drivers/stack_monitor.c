@@ -0,0 +1,100 @@
+ /******************************************************************************
+ *
+ * Module: 		Stack Monitor
+ * File Name: 	stack_monitor.c
+ * Description: Source file for the stack painting and the stack high-water mark
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "stack_monitor.h"
+
+#ifndef HOST_BUILD
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Linker symbols : first byte after .bss/.noinit , RAMEND */
+extern uint8 __heap_start ;
+extern uint8 __stack ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description: Function to paint the free RAM , runs from .init1 before
+ * 				the stack pointer and __zero_reg__ are set up (.init2)
+ */
+void STACK_paint(void) __attribute__ ((naked, used, section (".init1")));
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to paint __heap_start .. __stack with STACK_CANARY ,
+ * 				assembly only : no stack and no __zero_reg__ yet
+ */
+void STACK_paint(void)
+{
+	__asm__ __volatile__ (
+		"	ldi r30, lo8(__heap_start)	\n"
+		"	ldi r31, hi8(__heap_start)	\n"
+		"	ldi r24, %0					\n"
+		"	ldi r25, hi8(__stack)		\n"
+		"	rjmp 2f						\n"
+		"1:	st Z+, r24					\n"
+		"2:	cpi r30, lo8(__stack)		\n"
+		"	cpc r31, r25				\n"
+		"	brlo 1b						\n"
+		"	breq 1b						\n"
+		: : "i" (STACK_CANARY));
+}
+
+/*
+ * Description: Function returns the size of the painted region
+ */
+uint16 STACK_getSize(void)
+{
+	return (uint16)(&__stack - &__heap_start) + 1 ;
+}
+
+/*
+ * Description: Function returns the max. stack used since reset ,
+ * 				the painting is counted from its bottom (__heap_start) up
+ */
+uint16 STACK_getHighWater(void)
+{
+	const uint8 *byte = &__heap_start ;
+	uint16 unused = 0 ;
+
+	while((byte <= &__stack) && (*byte == STACK_CANARY))
+	{
+		byte++ ;
+		unused++ ;
+	}
+
+	return STACK_getSize() - unused ;
+}
+
+#else
+
+/*
+ * Description: Host stack , no painting
+ */
+uint16 STACK_getSize(void)
+{
+	return 0 ;
+}
+
+/*
+ * Description: Host stack , no painting
+ */
+uint16 STACK_getHighWater(void)
+{
+	return 0 ;
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,56 @@
+ /******************************************************************************
+ *
+ * Module: 		Stack Monitor
+ * File Name: 	stack_monitor.h
+ * Description: Header file for the stack painting and the stack high-water mark
+ *
+ * Notes:		- The free RAM between the end of .bss/.noinit (__heap_start ,
+ * 				  no heap is used) and RAMEND (__stack) is painted with
+ * 				  STACK_CANARY before main() (.init1 , the stack is empty) ,
+ * 				  the stack grows down from RAMEND over the painting
+ *
+ * 				- High-water mark = bytes from RAMEND down to the lowest byte
+ * 				  that isn't STACK_CANARY any more , a pushed byte equal to
+ * 				  STACK_CANARY at the deepest point hides it (a few bytes less)
+ *
+ * 				- The static worst case of each call tree is checked by the
+ * 				  build (make stack-check , tools/stack_check.sh)
+ *
+ * 				- HOST_BUILD => the firmware runs on the host stack ,
+ * 				  no painting and both functions return 0
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef STACK_MONITOR_H_
+#define STACK_MONITOR_H_
+
+#include "std_types.h"
+#include "micro_config.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Paint byte of the free RAM */
+#define STACK_CANARY		0xC5
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function returns the size of the painted region
+ * 				(bytes from the end of .bss/.noinit to RAMEND)
+ */
+uint16 STACK_getSize(void);
+
+/*
+ * Description: Function returns the max. stack used since reset (bytes) ,
+ * 				STACK_getSize() => the painting is gone , the stack may have
+ * 				overwritten .bss
+ */
+uint16 STACK_getHighWater(void);
+
+#endif /* STACK_MONITOR_H_ */
@@ -32,6 +32,19 @@
 	/* Types Define */
 	/* u -> unsigned  #  s -> singed  # 8 -> 8bits  # 16 -> 16 bits */
 
+#ifdef HOST_BUILD
+	/* Linux build (Door_Lock_Host) , long is 64 bits on the host */
+	#include <stdint.h>
+
+	typedef uint8_t               uint8;
+	typedef int8_t                sint8;
+	typedef uint16_t              uint16;
+	typedef int16_t               sint16;
+	typedef uint32_t              uint32;
+	typedef int32_t               sint32;
+	typedef uint64_t              uint64;
+	typedef int64_t               sint64;
+#else
 	typedef unsigned char         uint8;          /*           0 .. 255             */
 	typedef signed char           sint8;          /*        -128 .. +127            */
 	typedef unsigned short        uint16;         /*           0 .. 65535           */
@@ -40,6 +53,7 @@
 	typedef signed long           sint32;         /* -2147483648 .. +2147483647     */
 	typedef unsigned long long    uint64;         /*       0..18446744073709551615  */
 	typedef signed long long      sint64;
+#endif
 	typedef float                 float32;
 	typedef double                float64;
 
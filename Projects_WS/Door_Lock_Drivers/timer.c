@@ -39,6 +39,7 @@
  *******************************************************************************/
 
 #include "timer.h"
+#include "isr_stats.h"
 
 /*******************************************************************************
  *                           Global Variables                                  *
@@ -49,6 +50,22 @@ static void (*g_TIMER2_callBackPtr)(void) = NULL_PTR;
 static void (*g_TIMER1_callBackPtr)(void) = NULL_PTR;
 static uint8 g_T0clock, g_T1clock, g_T2clock ;
 
+#if (ISR_STATS_ENABLE == TRUE)
+/* Prescaler of each TIMER_Clock , the counter restarts at the interrupt event
+ * => ISR entry latency = counter * prescaler */
+static const uint16 g_prescalers[] = {0, 1, 8, 64, 256, 1024, 32, 128};
+
+/*
+ * Description: Function returns the cycles since the timer event
+ */
+static uint16 TIMER_eventCycles(uint16 a_count, uint8 a_clock)
+{
+	uint32 cycles = (uint32)a_count * g_prescalers[a_clock] ;
+
+	return (cycles < ISR_STATS_NO_LATENCY) ? (uint16)cycles : (ISR_STATS_NO_LATENCY - 1) ;
+}
+#endif
+
 /*******************************************************************************
  *                       Interrupt Service Routines                            *
  *******************************************************************************/
@@ -82,11 +99,13 @@ ISR(TIMER0_OVF_vect)
  */
 ISR(TIMER2_COMP_vect)
 {
+	ISR_STATS_ENTER(ISR_STATS_TIMER2, TIMER_eventCycles(HAL_READ(TCNT2), g_T2clock));
 	if(g_TIMER2_callBackPtr != NULL_PTR)
 	{
 		/* Call The Call Back function in the application after the timer value = OCR0 Value*/
 		(*g_TIMER2_callBackPtr)() ;
 	}
+	ISR_STATS_EXIT(ISR_STATS_TIMER2);
 }
 
 /*
@@ -94,11 +113,13 @@ ISR(TIMER2_COMP_vect)
  */
 ISR(TIMER2_OVF_vect)
 {
+	ISR_STATS_ENTER(ISR_STATS_TIMER2, TIMER_eventCycles(HAL_READ(TCNT2), g_T2clock));
 	if(g_TIMER2_callBackPtr != NULL_PTR)
 	{
 		/* Call The Call Back function in the application after the timer value = 1023 */
 		(*g_TIMER2_callBackPtr)() ;
 	}
+	ISR_STATS_EXIT(ISR_STATS_TIMER2);
 }
 
 /*
@@ -106,11 +127,13 @@ ISR(TIMER2_OVF_vect)
  */
 ISR(TIMER1_COMPA_vect)
 {
+	ISR_STATS_ENTER(ISR_STATS_TIMER1, TIMER_eventCycles(HAL_READ16(TCNT1), g_T1clock));
 	if(g_TIMER1_callBackPtr != NULL_PTR)
 	{
 		/* Call The Call Back function in the application after the timer value = OCR1A Value*/
 		(*g_TIMER1_callBackPtr)() ;
 	}
+	ISR_STATS_EXIT(ISR_STATS_TIMER1);
 }
 
 /*
@@ -153,10 +176,10 @@ void Timer0_Init(TIMER_ConfigType *Config_ptr)
 	if (Config_ptr->mode == NORMAL)
 	{
 		/* Set Timer initial value to 0 */
-		TCNT0 = 0;
+		HAL_WRITE(TCNT0, 0);
 
 		/*  Enable Timer0 Overflow Interrupt */
-		TIMSK |= (1<<TOIE0);
+		HAL_OR(TIMSK, (1<<TOIE0));
 
 		/* Configure the timer control register
 		 * 1. Non PWM mode	=> FOC0=1
@@ -165,20 +188,20 @@ void Timer0_Init(TIMER_ConfigType *Config_ptr)
 		 * 4. clock 		=> CS00 & CS01 & CS02
 		 * TCCR0 => FOC0 WGM00 COM01 COM00 WGM01 CS02 CS01 CS00
 		 */
-		TCCR0 = (1<<FOC0) | ((Config_ptr->clock) << CS00);
+		HAL_WRITE(TCCR0, (1<<FOC0) | ((Config_ptr->clock) << CS00));
 	}
 
 	/* Set Timer0 In Compare Mode with OCR0 Value */
 	else if (Config_ptr->mode == COMP)
 	{
 		/* Set Timer initial value to 0 */
-		TCNT0 = 0 ;
+		HAL_WRITE(TCNT0, 0);
 
 		/* Compare Value */
-		OCR0 = (uint8)Config_ptr->OCRValue ;
+		HAL_WRITE(OCR0, (uint8)Config_ptr->OCRValue);
 
 		/* Interrupt Enable/Disable */
-		TIMSK |= (1 << OCIE0 ) ;
+		HAL_OR(TIMSK, (1 << OCIE0 ));
 
 		/* Configure the timer control register
 		 * 1. Non PWM mode	=> FOC0=1
@@ -187,20 +210,20 @@ void Timer0_Init(TIMER_ConfigType *Config_ptr)
 		 * 4. clock 		=> CS00 & CS01 & CS02
 		 * TCCR0 => FOC0 WGM00 COM01 COM00 WGM01 CS02 CS01 CS00
 		 */
-		TCCR0  = (1<<FOC0) | (1<<WGM01) | ((Config_ptr->clock) << CS00) ;
+		HAL_WRITE(TCCR0, (1<<FOC0) | (1<<WGM01) | ((Config_ptr->clock) << CS00));
 	}
 
 	/* Set Timer0 In CTC Square Wave Mode */
 	else if (Config_ptr->mode == CTC)
 	{
 		/* Configure PB3/OC0 Pin as output pin */
-		SET_BIT(DDRB, PB3);
+		HAL_SET_BIT(DDRB, PB3);
 
 		/* Initial Value of The Timer TCNT*/
-		TCNT0 = 0 ;
+		HAL_WRITE(TCNT0, 0);
 
 		/* Compare Value */
-		OCR0 = (uint8)Config_ptr->OCRValue ;
+		HAL_WRITE(OCR0, (uint8)Config_ptr->OCRValue);
 
 		/* If OC0 Disconnected Mode in CTC !
 		 * Make it Toggle
@@ -216,21 +239,21 @@ void Timer0_Init(TIMER_ConfigType *Config_ptr)
 		 * TCCR0 => FOC0 WGM00 COM01 COM00 WGM01 CS02 CS01 CS00
 		 */
 
-		TCCR0  = (1<<FOC0) | (1<<WGM01) | ((Config_ptr->OC) << COM00)
-			   | ((Config_ptr->clock) << CS00) ;
+		HAL_WRITE(TCCR0, (1<<FOC0) | (1<<WGM01) | ((Config_ptr->OC) << COM00)
+			   | ((Config_ptr->clock) << CS00));
 	}
 
 	/* Set Timer0 In PWM Mode with Duty Cycle */
 	else if (Config_ptr->mode == PWM)
 	{
 		/* Configure PB3/OC0 Pin as output pin */
-		SET_BIT(DDRB, PB3);
+		HAL_SET_BIT(DDRB, PB3);
 
 		/* Initial Value of The Timer TCNT*/
-		TCNT0 = 0 ;
+		HAL_WRITE(TCNT0, 0);
 
 		/* Duty Cycle Value */
-		OCR0 = (uint8)Config_ptr->OCRValue ;
+		HAL_WRITE(OCR0, (uint8)Config_ptr->OCRValue);
 
 		/* If OC0 Disconnected Mode in PWM !
 		 * Make it non inverted mode
@@ -246,8 +269,8 @@ void Timer0_Init(TIMER_ConfigType *Config_ptr)
 		 * TCCR0 => FOC0 WGM00 COM01 COM00 WGM01 CS02 CS01 CS00
 		 */
 
-		TCCR0  = (1<<WGM00) | (1<<WGM01) | ((Config_ptr->OC) << COM00)
-			   | ((Config_ptr->clock) << CS00) ;
+		HAL_WRITE(TCCR0, (1<<WGM00) | (1<<WGM01) | ((Config_ptr->OC) << COM00)
+			   | ((Config_ptr->clock) << CS00));
 	}
 }
 
@@ -256,7 +279,7 @@ void Timer0_Init(TIMER_ConfigType *Config_ptr)
  */
 void Timer0_resetTimer(void)
 {
-	TCNT0 = 0;
+	HAL_WRITE(TCNT0, 0);
 }
 
 /*
@@ -267,7 +290,7 @@ void Timer0_resetTimer(void)
 void Timer0_stopTimer(void)
 {
 	/* Clear Clock Bits */
-	TCCR0 &= 0xF8 ;
+	HAL_AND(TCCR0, 0xF8);
 }
 
 /*
@@ -278,10 +301,10 @@ void Timer0_stopTimer(void)
 void Timer0_restartTimer(void)
 {
 	/* Clear Clock Bits */
-	TCCR0 &= 0xF8 ;
+	HAL_AND(TCCR0, 0xF8);
 
 	/* Set Clock Bits */
-	TCCR0 |= ( g_T0clock << CS00 ) ;
+	HAL_OR(TCCR0, ( g_T0clock << CS00 ));
 }
 
 /*
@@ -290,7 +313,7 @@ void Timer0_restartTimer(void)
  */
 void Timer0_Ticks(const uint8 Ticks)
 {
-	OCR0 = Ticks;
+	HAL_WRITE(OCR0, Ticks);
 }
 
 /*
@@ -331,10 +354,10 @@ void Timer2_Init(TIMER_ConfigType *Config_ptr)
 	if (Config_ptr->mode == NORMAL)
 	{
 		/* Set Timer initial value to 0 */
-		TCNT2 = 0;
+		HAL_WRITE(TCNT2, 0);
 
 		/*  Enable Timer2 Overflow Interrupt */
-		TIMSK |= (1<<TOIE2);
+		HAL_OR(TIMSK, (1<<TOIE2));
 
 		/* Configure the timer control register
 		 * 1. Non PWM mode	=> FOC2=1
@@ -344,20 +367,20 @@ void Timer2_Init(TIMER_ConfigType *Config_ptr)
 		 * TCCR2 => FOC2 WGM20 COM21 COM20 WGM21 CS22 CS21 CS20
 		 */
 		/* AdjustTimer2Clock(Config_ptr->clock) to adjust clock values */
-		TCCR2 = (1<<FOC2) | ((AdjustTimer2Clock(Config_ptr->clock)) << CS20);
+		HAL_WRITE(TCCR2, (1<<FOC2) | ((AdjustTimer2Clock(Config_ptr->clock)) << CS20));
 	}
 
 	/* Set Timer0 In Compare Mode with OCR0 Value */
 	else if (Config_ptr->mode == COMP)
 	{
 		/* Set Timer initial value to 0 */
-		TCNT2 = 0 ;
+		HAL_WRITE(TCNT2, 0);
 
 		/* Compare Value */
-		OCR2 = (uint8)Config_ptr->OCRValue ;
+		HAL_WRITE(OCR2, (uint8)Config_ptr->OCRValue);
 
 		/* Interrupt Enable/Disable */
-		TIMSK |= (1 << OCIE2 ) ;
+		HAL_OR(TIMSK, (1 << OCIE2 ));
 
 		/* Configure the timer control register
 		 * 1. Non PWM mode	=> FOC2=1
@@ -367,20 +390,20 @@ void Timer2_Init(TIMER_ConfigType *Config_ptr)
 		 * TCCR2 => FOC2 WGM20 COM21 COM20 WGM21 CS22 CS21 CS20
 		 */
 		/* AdjustTimer2Clock(Config_ptr->clock) to adjust clock values */
-		TCCR2  = (1<<FOC2) | (1<<WGM21) | ((AdjustTimer2Clock(Config_ptr->clock)) << CS20) ;
+		HAL_WRITE(TCCR2, (1<<FOC2) | (1<<WGM21) | ((AdjustTimer2Clock(Config_ptr->clock)) << CS20));
 	}
 
 	/* Set Timer2 In CTC Square Wave Mode */
 	else if (Config_ptr->mode == CTC)
 	{
 		/* Configure PD7/OC2 Pin as output pin */
-		SET_BIT(DDRD, PD7);
+		HAL_SET_BIT(DDRD, PD7);
 
 		/* Initial Value of The Timer TCNT*/
-		TCNT2 = 0 ;
+		HAL_WRITE(TCNT2, 0);
 
 		/* Compare Value */
-		OCR2 = (uint8)Config_ptr->OCRValue ;
+		HAL_WRITE(OCR2, (uint8)Config_ptr->OCRValue);
 
 		/* If OC2 Disconnected Mode in CTC !
 		 * Make it Toggle
@@ -396,21 +419,21 @@ void Timer2_Init(TIMER_ConfigType *Config_ptr)
 		 * TCCR2 => FOC2 WGM20 COM21 COM20 WGM21 CS22 CS21 CS20
 		 */
 		/* AdjustTimer2Clock(Config_ptr->clock) to adjust clock values */
-		TCCR2  = (1<<FOC2) | (1<<WGM21) | ((Config_ptr->OC) << COM20)
-			   | ((AdjustTimer2Clock(Config_ptr->clock)) << CS20) ;
+		HAL_WRITE(TCCR2, (1<<FOC2) | (1<<WGM21) | ((Config_ptr->OC) << COM20)
+			   | ((AdjustTimer2Clock(Config_ptr->clock)) << CS20));
 	}
 
 	/* Set Timer2 In PWM Mode with Duty Cycle */
 	else if (Config_ptr->mode == PWM)
 	{
 		/* Configure PD7/OC2 Pin as output pin */
-		SET_BIT(DDRD, PD7);
+		HAL_SET_BIT(DDRD, PD7);
 
 		/* Initial Value of The Timer TCNT*/
-		TCNT2 = 0 ;
+		HAL_WRITE(TCNT2, 0);
 
 		/* Duty Cycle Value */
-		OCR2 = (uint8)Config_ptr->OCRValue ;
+		HAL_WRITE(OCR2, (uint8)Config_ptr->OCRValue);
 
 		/* If OC2 Disconnected Mode in PWM !
 		 * Make it non inverted mode
@@ -426,8 +449,8 @@ void Timer2_Init(TIMER_ConfigType *Config_ptr)
 		 * TCCR2 => FOC2 WGM20 COM21 COM20 WGM21 CS22 CS21 CS20
 		 */
 		/* AdjustTimer2Clock(Config_ptr->clock) to adjust clock values */
-		TCCR2  = (1<<WGM20) | (1<<WGM21) | ((Config_ptr->OC) << COM20)
-			   | ((AdjustTimer2Clock(Config_ptr->clock)) << CS20) ;
+		HAL_WRITE(TCCR2, (1<<WGM20) | (1<<WGM21) | ((Config_ptr->OC) << COM20)
+			   | ((AdjustTimer2Clock(Config_ptr->clock)) << CS20));
 	}
 }
 
@@ -468,7 +491,7 @@ uint8 AdjustTimer2Clock(TIMER_Clock clk)
  */
 void Timer2_resetTimer(void)
 {
-	TCNT2 = 0;
+	HAL_WRITE(TCNT2, 0);
 }
 
 /*
@@ -479,7 +502,7 @@ void Timer2_resetTimer(void)
 void Timer2_stopTimer(void)
 {
 	/* Clear Clock Bits */
-	TCCR2 &= 0xF8 ;
+	HAL_AND(TCCR2, 0xF8);
 }
 
 /*
@@ -490,10 +513,10 @@ void Timer2_stopTimer(void)
 void Timer2_restartTimer(void)
 {
 	/* Clear Clock Bits */
-	TCCR2 &= 0xF8 ;
+	HAL_AND(TCCR2, 0xF8);
 
 	/* Set Clock Bits */
-	TCCR2 |= ( (AdjustTimer2Clock(g_T2clock)) << CS00 ) ;
+	HAL_OR(TCCR2, ( (AdjustTimer2Clock(g_T2clock)) << CS00 ));
 }
 
 /*
@@ -502,7 +525,7 @@ void Timer2_restartTimer(void)
  */
 void Timer2_Ticks(const uint8 Ticks)
 {
-	OCR2 = Ticks;
+	HAL_WRITE(OCR2, Ticks);
 }
 
 /*
@@ -543,10 +566,10 @@ void Timer1_Init(TIMER_ConfigType *Config_ptr)
 	if (Config_ptr->mode == NORMAL)
 	{
 		/* Set Timer initial value to 0 */
-		TCNT1 = 0;
+		HAL_WRITE16(TCNT1, 0);
 
 		/*  Enable Timer1 Overflow Interrupt */
-		TIMSK |= (1<<TOIE1);
+		HAL_OR(TIMSK, (1<<TOIE1));
 
 		/* Configure the timer control register
 		 * 1. Non PWM mode	=> FOC1A=1 & FOC1B=1
@@ -557,21 +580,21 @@ void Timer1_Init(TIMER_ConfigType *Config_ptr)
 		 * TCCR1B => ICNC1 ICES1  WGM13 WGM12 CS12 CS11 CS10
 		 */
 
-		TCCR1A = (1<<FOC1A) | (1<<FOC1B) ;
-		TCCR1B = ((Config_ptr->clock) << CS10) ;
+		HAL_WRITE(TCCR1A, (1<<FOC1A) | (1<<FOC1B));
+		HAL_WRITE(TCCR1B, ((Config_ptr->clock) << CS10));
 	}
 
 	/* Set Timer1 In Compare Mode with OCR1A Value */
 	else if (Config_ptr->mode == COMP)
 	{
 		/* Set Timer initial value to 0 */
-		TCNT1 = 0 ;
+		HAL_WRITE16(TCNT1, 0);
 
 		/* Compare Value */
-		OCR1A = Config_ptr->OCRValue ;
+		HAL_WRITE16(OCR1A, Config_ptr->OCRValue);
 
 		/* Enable Timer1 Compare Mode Interrupt */
-		TIMSK |= (1 << OCIE1A ) ;
+		HAL_OR(TIMSK, (1 << OCIE1A ));
 
 		/* Configure the timer control register
 		 * 1. Non PWM mode	=> FOC1A=1 & FOC1B=1
@@ -582,26 +605,26 @@ void Timer1_Init(TIMER_ConfigType *Config_ptr)
 		 * TCCR1B => ICNC1 ICES1  WGM13 WGM12 CS12 CS11 CS10
 		 */
 
-		TCCR1A = (1<<FOC1A) | (1<<FOC1B) ;
-		TCCR1B = (1<<WGM12) | ((Config_ptr->clock) << CS10) ;
+		HAL_WRITE(TCCR1A, (1<<FOC1A) | (1<<FOC1B));
+		HAL_WRITE(TCCR1B, (1<<WGM12) | ((Config_ptr->clock) << CS10));
 	}
 
 	/* Set Timer1 In CTC Square Wave Mode */
 	else if (Config_ptr->mode == CTC)
 	{
 		/* Configure PD5/OC1A Pin as output pin */
-		SET_BIT(DDRD, PD5);
+		HAL_SET_BIT(DDRD, PD5);
 		/* Configure PD4/OC1B Pin as output pin */
-		SET_BIT(DDRD, PD4);
+		HAL_SET_BIT(DDRD, PD4);
 
 		/* Initial Value of The Timer TCNT*/
-		TCNT1 = 0 ;
+		HAL_WRITE16(TCNT1, 0);
 
 		/* Compare Value for Channel A */
-		OCR1A = Config_ptr->OCRValue ;
+		HAL_WRITE16(OCR1A, Config_ptr->OCRValue);
 
 		/* Compare Value for Channel B */
-		OCR1B = Config_ptr->OCR1BValue ;
+		HAL_WRITE16(OCR1B, Config_ptr->OCR1BValue);
 
 		/* If OC1A/B Disconnected Mode in CTC !
 		 * Make it Toggle
@@ -619,26 +642,26 @@ void Timer1_Init(TIMER_ConfigType *Config_ptr)
 		 * TCCR1A => COM1A1 COM1A0 COM1B1 COM1B0 FOC1A FOC1B WGM11 WGM10
 		 * TCCR1B => ICNC1 ICES1  WGM13 WGM12 CS12 CS11 CS10
 		 */
-		TCCR1A = (1<<FOC1A) | (1<<FOC1B) | ((Config_ptr->OC) << COM1A0)
-			   | ((Config_ptr->OC1B) << COM1B0);
-		TCCR1B = (1<<WGM12) | ((Config_ptr->clock) << CS10) ;
+		HAL_WRITE(TCCR1A, (1<<FOC1A) | (1<<FOC1B) | ((Config_ptr->OC) << COM1A0)
+			   | ((Config_ptr->OC1B) << COM1B0));
+		HAL_WRITE(TCCR1B, (1<<WGM12) | ((Config_ptr->clock) << CS10));
 	}
 
 	/* Set Timer1 In PWM Mode with Duty Cycle */
 	else if (Config_ptr->mode == PWM)
 	{
 		/* Configure PD5/OC1A Pin as output pin */
-		SET_BIT(DDRD, PD5);
+		HAL_SET_BIT(DDRD, PD5);
 
 		/* Initial Value of The Timer TCNT*/
-		TCNT1 = 0 ;
+		HAL_WRITE16(TCNT1, 0);
 
 		/* Duty Cycle Value for Channel A */
-		OCR1A = Config_ptr->OCRValue ;
+		HAL_WRITE16(OCR1A, Config_ptr->OCRValue);
 
 		/* using ICR1 as Top Value for Duty Cycle for Channel A
 		 * Duty Cycle for PWM Mode (Mode14) = OCR1A/ICR1 */
-		ICR1 = Config_ptr->OCR1BValue ;
+		HAL_WRITE16(ICR1, Config_ptr->OCR1BValue);
 
 		/* If OC1A/B Disconnected Mode in CTC !
 		 * Make it Toggle
@@ -654,8 +677,8 @@ void Timer1_Init(TIMER_ConfigType *Config_ptr)
 		 * TCCR1A => COM1A1 COM1A0 COM1B1 COM1B0 FOC1A FOC1B WGM11 WGM10
 		 * TCCR1B => ICNC1 ICES1  WGM13 WGM12 CS12 CS11 CS10
 		 */
-		TCCR1A = ((Config_ptr->OC) << COM1A0) | (1<<WGM11)  ;
-		TCCR1B = (1<<WGM13) | (1<<WGM12) | ((Config_ptr->clock) << CS10) ;
+		HAL_WRITE(TCCR1A, ((Config_ptr->OC) << COM1A0) | (1<<WGM11));
+		HAL_WRITE(TCCR1B, (1<<WGM13) | (1<<WGM12) | ((Config_ptr->clock) << CS10));
 	}
 }
 
@@ -664,7 +687,7 @@ void Timer1_Init(TIMER_ConfigType *Config_ptr)
  */
 void Timer1_resetTimer(void)
 {
-	TCNT1 = 0;
+	HAL_WRITE16(TCNT1, 0);
 }
 
 /*
@@ -675,7 +698,7 @@ void Timer1_resetTimer(void)
 void Timer1_stopTimer(void)
 {
 	/* Clear Clock Bits */
-	TCCR1B &= 0xF8 ;
+	HAL_AND(TCCR1B, 0xF8);
 }
 
 /*
@@ -686,10 +709,10 @@ void Timer1_stopTimer(void)
 void Timer1_restartTimer(void)
 {
 	/* Clear Clock Bits */
-	TCCR1B &= 0xF8 ;
+	HAL_AND(TCCR1B, 0xF8);
 
 	/* Set Clock Bits */
-	TCCR1B |= ( g_T1clock << CS10) ;
+	HAL_OR(TCCR1B, ( g_T1clock << CS10));
 }
 
 /*
@@ -698,8 +721,8 @@ void Timer1_restartTimer(void)
  */
 void Timer1_Ticks(const uint16 Ticks1A, const uint16 Ticks1B)
 {
-	OCR1A = Ticks1A;
-	OCR1B = Ticks1B;
+	HAL_WRITE16(OCR1A, Ticks1A);
+	HAL_WRITE16(OCR1B, Ticks1B);
 }
 
 /*
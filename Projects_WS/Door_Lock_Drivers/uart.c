@@ -0,0 +1,434 @@
+ /******************************************************************************
+ *
+ * Module: 		UART
+ * File Name: 	uart.c
+ * Description: Source file for the AVR UART driver
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "uart.h"
+#include "power.h"
+#include "isr_stats.h"
+
+/*******************************************************************************
+ *                          Global Variables                                   *
+ *******************************************************************************/
+/* g_uartData Global Variable to store UART Data and use it in Any Project */
+volatile uint16 g_uartData = 0;
+
+/* RX Ring Buffer , filled by RXC ISR
+ * Head => written by ISR , Tail => read by Application */
+static volatile uint8 g_rxBuffer[UART_RX_BUFFER_SIZE];
+static volatile uint8 g_rxHead = 0 ;
+static volatile uint8 g_rxTail = 0 ;
+
+/* Number of Received bytes dropped because RX Buffer is full */
+static volatile uint16 g_rxDropCount = 0 ;
+
+/* TX Ring Buffer , drained by UDRE ISR
+ * Head => written by Application , Tail => read by ISR */
+static volatile uint8 g_txBuffer[UART_TX_BUFFER_SIZE];
+static volatile uint8 g_txHead = 0 ;
+static volatile uint8 g_txTail = 0 ;
+
+/* TRUE if RX / TX Ring Buffers are used (RX / DRE Interrupt Enabled) */
+static bool g_rxBuffered = FALSE ;
+static bool g_txBuffered = FALSE ;
+
+static void (*g_UART_RXC_callBack_ptr)(void) = NULL_PTR ;
+static void (*g_UART_TXC_callBack_ptr)(void) = NULL_PTR ;
+static void (*g_UART_UDRE_callBack_ptr)(void) = NULL_PTR ;
+
+static uint8 g_NULL_Terminator = '#' ;
+
+/*******************************************************************************
+ *                          ISR's Definitions                                  *
+ *******************************************************************************/
+
+ISR(USART_TXC_vect)
+{
+
+	if(g_UART_TXC_callBack_ptr != NULL_PTR)
+	{
+		/* Call the Call Back function in the application after the UART Tx Complete */
+		(*g_UART_TXC_callBack_ptr)();
+	}
+}
+
+ISR(USART_RXC_vect)
+{
+	uint8 head = g_rxHead ;
+
+	/* No event time stamp , DOR (valid until UDR is read) => FIFO was full */
+	ISR_STATS_ENTER(ISR_STATS_USART_RXC, ISR_STATS_NO_LATENCY);
+#if (ISR_STATS_ENABLE == TRUE)
+	if(HAL_BIT_IS_SET(UCSRA, DOR))
+		ISR_STATS_overrun();
+#endif
+
+	g_uartData = HAL_READ(UDR) ;
+
+	/* Store the byte in RX Buffer if there is a free place
+	 * indices are free running , (head - tail) = number of stored bytes */
+	if((uint8)(head - g_rxTail) < UART_RX_BUFFER_SIZE)
+	{
+		g_rxBuffer[head & UART_RX_BUFFER_MASK] = (uint8)g_uartData ;
+		g_rxHead = head + 1 ;
+	}
+	else
+	{
+		g_rxDropCount++ ;
+	}
+
+	if(g_UART_RXC_callBack_ptr != NULL_PTR)
+	{
+		/* Call the Call Back function in the application after the UART Rx Complete */
+		(*g_UART_RXC_callBack_ptr)();
+	}
+	ISR_STATS_EXIT(ISR_STATS_USART_RXC);
+}
+
+ISR(USART_UDRE_vect)
+{
+	uint8 tail = g_txTail ;
+
+	if(tail != g_txHead)
+	{
+		/* Send the next byte from TX Buffer */
+		HAL_WRITE(UDR, g_txBuffer[tail & UART_TX_BUFFER_MASK]);
+		g_txTail = tail + 1 ;
+	}
+	else
+	{
+		/* TX Buffer is empty , Disable DRE Interrupt until new data queued */
+		HAL_AND(UCSRB, (~(1<<UDRIE)));
+
+		if(g_UART_UDRE_callBack_ptr != NULL_PTR)
+		{
+			/* Call the Call Back function in the application when Data Register Empty */
+			(*g_UART_UDRE_callBack_ptr)();
+		}
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 	Function to initialize the UART driver
+ * 		1. Enables the Interrupts .
+ * 		2. Set the Parity Mode.
+ *	 	3. Set The Number of Stop Bit.
+ * 		4. Select Baud Rate
+ * 		5. Set Custom NULL Terminator
+ */
+void UART_init(const UART_ConfigType * Config_ptr)
+{
+	/* U2X = 1 for double transmission speed */
+	HAL_WRITE(UCSRA, (1<<U2X));
+
+	/************************** UCSRB Description **************************
+	 * RXCIE = USART RX Complete Interrupt Enable
+	 * TXCIE = USART Tx Complete Interrupt Enable
+	 * UDRIE = USART Data Register Empty Interrupt Enable
+	 * RXEN  = 1 Receiver Enable
+	 * RXEN  = 1 Transmitter Enable
+	 * UCSZ2 = 0 For 8-bit data mode
+	 * RXB8 & TXB8 not used for 8-bit data mode
+	 ***********************************************************************/ 
+	/* UDRIE is enabled later by UART_write() only when TX Buffer has data */
+	HAL_WRITE(UCSRB, (HAL_READ(UCSRB) & 0x1F) |  (1<<RXEN) | (1<<TXEN)
+			| (Config_ptr->s_RxInterruptEnable << RXCIE)
+			| (Config_ptr->s_TxInterruptEnable << TXCIE));
+
+	/* Reset Ring Buffers */
+	g_rxHead = g_rxTail = 0 ;
+	g_txHead = g_txTail = 0 ;
+	g_rxDropCount = 0 ;
+	g_rxBuffered = (Config_ptr->s_RxInterruptEnable == ENABLE_INT) ;
+	g_txBuffered = (Config_ptr->s_DataRegEmptyInterruptEnable == ENABLE_INT) ;
+	
+
+	/************************** UCSRC Description **************************
+	 * URSEL   = 1 The URSEL must be one when writing the UCSRC
+	 * UMSEL   = 0 Asynchronous Operation
+	 * UPM1:0  = parity bit
+	 * USBS    = stop bit
+	 * UCSZ1:0 = 11 For 8-bit data mode
+	 * UCPOL   = 0 Used with the Synchronous operation only
+	 ***********************************************************************/ 	
+	HAL_WRITE(UCSRC, ( HAL_READ(UCSRC) & 0xC7 ) | (1<<URSEL) | (1<<UCSZ0) | (1<<UCSZ1)
+			| (Config_ptr->s_Parity << UPM0)
+			| (Config_ptr->s_Stop << USBS));
+	
+	/* First 8 bits from the BAUD_PRESCALE inside UBRRL and last 4 bits in UBRRH*/
+	HAL_WRITE(UBRRH, (((F_CPU / (Config_ptr->s_BaudRate * 8UL)) - 1) >> 8 ));
+	HAL_WRITE(UBRRL, ((F_CPU / (Config_ptr->s_BaudRate * 8UL)) - 1));
+
+	/**************** Set NULL Terminator Character  *******************/
+	if (Config_ptr->s_NULL_Terminator != 0 )
+		g_NULL_Terminator = Config_ptr->s_NULL_Terminator ;
+
+}
+
+/*
+ * Description:
+ * Function responsible for Sending Byte
+ * if DRE Interrupt Enabled , wait only until there is a free place in the
+ * TX Ring Buffer .
+ *
+ * Arguments:
+ * uint8 Data
+ */
+void UART_sendByte(const uint8 data)
+{
+	if(g_txBuffered)
+	{
+		/* wait until there is a free place in TX Buffer , UDRE wakes the CPU */
+		while(!UART_write(data))
+		{
+			POWER_sleep();
+		}
+	}
+	else
+	{
+		/* UDRE flag is set when the Tx buffer (UDR) is empty and ready for
+		 * transmitting a new byte so wait until this flag is set to one */
+		while(HAL_BIT_IS_CLEAR(UCSRA,UDRE)){}
+		/* Put the required data in the UDR register and it also clear the UDRE flag as
+		 * the UDR register is not empty now */
+		HAL_WRITE(UDR, data);
+		/************************* Another Method *************************
+		UDR = data;
+		while(BIT_IS_CLEAR(UCSRA,TXC)){} // Wait until the transmission is complete TXC = 1
+		SET_BIT(UCSRA,TXC); // Clear the TXC flag
+		*******************************************************************/
+	}
+}
+
+/*
+ * Description:
+ * Function responsible for Receiving Byte
+ * if RX Interrupt Enabled , wait until there is a byte in the RX Ring Buffer .
+ *
+ * Return:
+ * uint8 Data
+ */
+uint8 UART_receiveByte(void)
+{
+	uint8 data ;
+	if(g_rxBuffered)
+	{
+		/* wait until RX ISR stores a byte in RX Buffer , RXC wakes the CPU */
+		while(!UART_read(&data))
+		{
+			POWER_sleep();
+		}
+		return data ;
+	}
+	else
+	{
+		/* RXC flag is set when the UART receive data so wait until this
+		 * flag is set to one */
+		while(HAL_BIT_IS_CLEAR(UCSRA,RXC)){}
+		/* Read the received data from the Rx buffer (UDR) and the RXC flag
+		   will be cleared after read this data */
+		return HAL_READ(UDR);
+	}
+}
+
+/*
+ * Description:
+ * Non-Blocking Function to queue a Byte for Sending
+ *
+ * Arguments:
+ * uint8 Data
+ *
+ * Return:
+ * TRUE if the byte is queued , FALSE if TX Buffer (or UDR) is full
+ */
+bool UART_write(const uint8 data)
+{
+	uint8 head = g_txHead ;
+
+	if(!g_txBuffered)
+	{
+		/* No TX Buffer , send directly only if UDR is empty */
+		if(HAL_BIT_IS_CLEAR(UCSRA,UDRE))
+			return FALSE ;
+		HAL_WRITE(UDR, data);
+		return TRUE ;
+	}
+
+	/* TX Buffer is full */
+	if((uint8)(head - g_txTail) >= UART_TX_BUFFER_SIZE)
+		return FALSE ;
+
+	g_txBuffer[head & UART_TX_BUFFER_MASK] = data ;
+	g_txHead = head + 1 ;
+
+	/* Enable DRE Interrupt , UDRE ISR sends the queued bytes */
+	HAL_OR(UCSRB, (1<<UDRIE));
+	return TRUE ;
+}
+
+/*
+ * Description:
+ * Non-Blocking Function to read a Byte
+ *
+ * Arguments:
+ * 	address to Store The Data
+ *
+ * Return:
+ * TRUE if a byte is read , FALSE if there is no received data
+ */
+bool UART_read(uint8 *data)
+{
+	uint8 tail = g_rxTail ;
+
+	if(!g_rxBuffered)
+	{
+		/* No RX Buffer , read directly only if there is received data */
+		if(HAL_BIT_IS_CLEAR(UCSRA,RXC))
+			return FALSE ;
+		*data = HAL_READ(UDR) ;
+		return TRUE ;
+	}
+
+	/* RX Buffer is empty */
+	if(tail == g_rxHead)
+		return FALSE ;
+
+	*data = g_rxBuffer[tail & UART_RX_BUFFER_MASK] ;
+	g_rxTail = tail + 1 ;
+	return TRUE ;
+}
+
+/*
+ * Description:
+ * Function returns the number of received bytes waiting to be read
+ */
+uint8 UART_available(void)
+{
+	if(!g_rxBuffered)
+		return HAL_BIT_IS_SET(UCSRA,RXC) ? 1 : 0 ;
+
+	return (uint8)(g_rxHead - g_rxTail) ;
+}
+
+/*
+ * Description:
+ * Function returns the number of received bytes dropped because
+ * the RX Ring Buffer was full
+ */
+uint16 UART_getRxDropCount(void)
+{
+	uint16 count ;
+
+	/* 16-bit read , disable RX Interrupt to read it atomically */
+	HAL_AND(UCSRB, (~(1<<RXCIE)));
+	count = g_rxDropCount ;
+	if(g_rxBuffered)
+		HAL_OR(UCSRB, (1<<RXCIE));
+
+	return count ;
+}
+
+/*
+ * Description:
+ * Function responsible for Sending String Over UART
+ *
+ * Arguments:
+ * address of the Array which will be sent
+ *
+ * Note:
+ * 		- Send the NULL Terminator '#' at the end of The String
+ * 		  in UART_sendString Function. */
+void UART_sendString(const uint8 *Str)
+{
+	uint8 i = 0;
+	/* if TX Interrupt Is Enabled */
+	if(InterruptIsEnbale(TxInterrupt))
+	{
+		/* Disable TX Interrupt to avoid calling the callback function repeatedly */
+		HAL_AND(UCSRB, (~(1<<TXCIE)));
+		while(Str[i] != '\0')
+		{
+			if(Str[i+1] == '\0')
+			{
+				/* Enable TX Interrupt , To call the callback function
+				 * after sending last character next loop */
+				HAL_OR(UCSRB, (1<<TXCIE));
+			}
+			UART_sendByte(Str[i]);
+			i++;
+		}
+	}
+	/* else if TX Interrupt Is Disable  */
+	else
+	{
+		while(Str[i] != '\0')
+		{
+			UART_sendByte(Str[i]);
+			i++;
+		}
+	}
+}
+
+/*
+ * Description:
+ * Function responsible for Receiving String Over UART
+ * Receive until NULL Terminator '#'
+ *
+ * Arguments:
+ * 	Array address to Store The Data
+ */
+void UART_receiveString(uint8 *Str)
+{
+	uint8 i = 0;
+
+	/* Bytes are read from RX Buffer if RX Interrupt Enabled
+	 * Or directly from UDR if RX Interrupt Disabled */
+	Str[i] = UART_receiveByte();
+	while(Str[i] != g_NULL_Terminator )
+	{
+		i++;
+		Str[i] = UART_receiveByte();
+	}
+	Str[i] = '\0';
+}
+
+
+/*
+ * Description:
+ * Function to set the Call Back function address For RX ISR.
+ */
+void UART_RXC_setCallBack(void(*a_ptr)(void))
+{
+	/* Save the address of the Call back function in a global variable */
+	g_UART_RXC_callBack_ptr = a_ptr;
+}
+
+/*
+ * Description:
+ * Function to set the Call Back function address For TX ISR.
+ */
+void UART_TXC_setCallBack(void(*a_ptr)(void))
+{
+	/* Save the address of the Call back function in a global variable */
+	g_UART_TXC_callBack_ptr = a_ptr;
+}
+
+/*
+ * Description:
+ * Function to set the Call Back function address DRE ISR.
+ */
+void UART_UDRE_setCallBack(void(*a_ptr)(void))
+{
+	/* Save the address of the Call back function in a global variable */
+	g_UART_UDRE_callBack_ptr = a_ptr;
+}
+
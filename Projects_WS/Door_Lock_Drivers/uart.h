@@ -41,11 +41,14 @@ typedef enum
 typedef struct
 {
 	/****************** Bits For UCSRB Register ************************/
-	/* RX Complete Interrupt Enable */
+	/* RX Complete Interrupt Enable
+	 * ENABLE => Received bytes are stored in the RX Ring Buffer */
 	UART_Interrupt s_RxInterruptEnable;				/* DISABLE , ENABLE */
 	/* TX Complete Interrupt Enable */
 	UART_Interrupt s_TxInterruptEnable;				/* DISABLE , ENABLE */
-	/* USART Data Register Empty Interrupt Enable */
+	/* USART Data Register Empty Interrupt Enable
+	 * ENABLE => Sent bytes are queued in the TX Ring Buffer and drained
+	 * 			 by the UDRE ISR */
 	UART_Interrupt s_DataRegEmptyInterruptEnable;	/* DISABLE , ENABLE */
 
 	/****************** Bits For UCSRC Register ************************/
@@ -59,10 +62,7 @@ typedef struct
 	UART_BaudRate s_BaudRate;	/* BR2400 , BR4800 , BR9600 , BR115200 */
 
 	/************* Choose NULL Terminator Character  *******************/
-	/* Choose NULL Terminator for Receiving String Function.
-	 * Send the NULL Terminator'#' twice at the end of The String in
-	 * UART_sendString Function if RX Interrupt Enabled .
-	 * Or send it Once if RX Interrupt Disabled. */
+	/* Choose NULL Terminator for Receiving String Function. */
 
 	uint8 s_NULL_Terminator ;	/* ( '#' , '%' , '&' , ... ) */
 
@@ -73,17 +73,31 @@ typedef struct
  *                      Preprocessor Macros                                    *
  *******************************************************************************/
 
-#define InterruptIsEnbale(BIT) ( UCSRB & (1<<BIT) )
+#define InterruptIsEnbale(BIT) HAL_BIT_IS_SET(UCSRB,BIT)
 #define RxInterrupt RXCIE
 #define TxInterrupt TXCIE
 #define DREInterrupt UDRIE
 
+/* Size of the RX/TX Ring Buffers used when RX / DRE Interrupts Enabled
+ * set in drivers_config.h , Must be power of two ( 2 , 4 , 8 , ... , 128 ) */
+#if ((UART_RX_BUFFER_SIZE & (UART_RX_BUFFER_SIZE - 1)) != 0) || (UART_RX_BUFFER_SIZE > 128)
+#error "UART_RX_BUFFER_SIZE must be power of two and not greater than 128"
+#endif
+
+#if ((UART_TX_BUFFER_SIZE & (UART_TX_BUFFER_SIZE - 1)) != 0) || (UART_TX_BUFFER_SIZE > 128)
+#error "UART_TX_BUFFER_SIZE must be power of two and not greater than 128"
+#endif
+
+#define UART_RX_BUFFER_MASK (UART_RX_BUFFER_SIZE - 1)
+#define UART_TX_BUFFER_MASK (UART_TX_BUFFER_SIZE - 1)
+
 /*******************************************************************************
  *                       External Variables                                    *
  *******************************************************************************/
 
 /* Extern Public global variables to be used by other modules */
 
+/* Last Byte received by the RX ISR */
 extern volatile uint16 g_uartData ;
 
 /*******************************************************************************
@@ -103,6 +117,8 @@ void UART_init(const UART_ConfigType * Config_ptr);
 /*
  * Description:
  * Function responsible for Sending Byte
+ * if DRE Interrupt Enabled , wait only until there is a free place in the
+ * TX Ring Buffer .
  *
  * Arguments:
  * uint8 Data
@@ -112,12 +128,50 @@ void UART_sendByte(const uint8 data);
 /*
  * Description:
  * Function responsible for Receiving Byte
+ * if RX Interrupt Enabled , wait until there is a byte in the RX Ring Buffer .
  *
  * Return:
  * uint8 Data
  */
 uint8 UART_receiveByte(void);
 
+/*
+ * Description:
+ * Non-Blocking Function to queue a Byte for Sending
+ *
+ * Arguments:
+ * uint8 Data
+ *
+ * Return:
+ * TRUE if the byte is queued , FALSE if TX Buffer (or UDR) is full
+ */
+bool UART_write(const uint8 data);
+
+/*
+ * Description:
+ * Non-Blocking Function to read a Byte
+ *
+ * Arguments:
+ * 	address to Store The Data
+ *
+ * Return:
+ * TRUE if a byte is read , FALSE if there is no received data
+ */
+bool UART_read(uint8 *data);
+
+/*
+ * Description:
+ * Function returns the number of received bytes waiting to be read
+ */
+uint8 UART_available(void);
+
+/*
+ * Description:
+ * Function returns the number of received bytes dropped because
+ * the RX Ring Buffer was full
+ */
+uint16 UART_getRxDropCount(void);
+
 /*
  * Description:
  * Function responsible for Sending String Over UART
@@ -126,11 +180,8 @@ uint8 UART_receiveByte(void);
  * address of the Array which will be sent
  *
  * Note:
- * 		- if RX Interrupt Enabled
- * Send the NULL Terminator '#' twice at the end of The String in
- * UART_sendString Function.
- *
- * 		- Or send it Once if RX Interrupt Disabled. */
+ * 		- Send the NULL Terminator '#' at the end of The String
+ * 		  in UART_sendString Function. */
 void UART_sendString(const uint8 *Str);
 
 /*
@@ -5,22 +5,49 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
 ../door_lock_hmi.c \
+../../Door_Lock_Drivers/debug_frames.c \
+../../Door_Lock_Drivers/frame.c \
+../../Door_Lock_Drivers/isr_stats.c \
 ../keypad.c \
 ../lcd.c \
-../timer.c \
-../uart.c 
+../../Door_Lock_Drivers/power.c \
+../../Door_Lock_Drivers/prof.c \
+../../Door_Lock_Drivers/scheduler.c \
+../../Door_Lock_Drivers/sha256.c \
+../../Door_Lock_Drivers/soft_timer.c \
+../../Door_Lock_Drivers/stack_monitor.c \
+../../Door_Lock_Drivers/timer.c \
+../../Door_Lock_Drivers/uart.c 
 
 OBJS += \
 ./door_lock_hmi.o \
+./debug_frames.o \
+./frame.o \
+./isr_stats.o \
 ./keypad.o \
 ./lcd.o \
+./power.o \
+./prof.o \
+./scheduler.o \
+./sha256.o \
+./soft_timer.o \
+./stack_monitor.o \
 ./timer.o \
 ./uart.o 
 
 C_DEPS += \
 ./door_lock_hmi.d \
+./debug_frames.d \
+./frame.d \
+./isr_stats.d \
 ./keypad.d \
 ./lcd.d \
+./power.d \
+./prof.d \
+./scheduler.d \
+./sha256.d \
+./soft_timer.d \
+./stack_monitor.d \
 ./timer.d \
 ./uart.d 
 
@@ -29,7 +56,14 @@ C_DEPS += \
 %.o: ../%.c
 	@echo 'Building file: $<'
 	@echo 'Invoking: AVR Compiler'
-	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega16 -DF_CPU=1000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -c -o "$@" "$<"
+	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega16 -DF_CPU=8000000UL -I"../" -I"../../Door_Lock_Drivers" -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -c -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+%.o: ../../Door_Lock_Drivers/%.c
+	@echo 'Building file: $<'
+	@echo 'Invoking: AVR Compiler'
+	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega16 -DF_CPU=8000000UL -I"../" -I"../../Door_Lock_Drivers" -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -c -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
@@ -15,7 +15,51 @@
  *******************************************************************************/
 
 #include "door_lock_hmi.h"
-#define F_CPU 8000000UL
+
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/* Entry actions */
+static void Startup_enter(void);
+static void RootPass_enter(void);
+static void NewPass_enter(void);
+static void RePass_enter(void);
+static void NotMatched_enter(void);
+static void Confirmed_enter(void);
+static void OldPass_enter(void);
+static void OpenPass_enter(void);
+static void Verify_enter(void);
+static void DoorOpen_enter(void);
+static void DoorClose_enter(void);
+static void AdminPass_enter(void);
+static void UserPin_enter(void);
+static void UserResult_enter(void);
+
+/* Event handlers */
+static HMI_State Startup_handle(const HMI_Event *event);
+static HMI_State Main_handle(const HMI_Event *event);
+static HMI_State RootPass_handle(const HMI_Event *event);
+static HMI_State NewPass_handle(const HMI_Event *event);
+static HMI_State RePass_handle(const HMI_Event *event);
+static HMI_State Message_handle(const HMI_Event *event);
+static HMI_State OldPass_handle(const HMI_Event *event);
+static HMI_State OpenPass_handle(const HMI_Event *event);
+static HMI_State Verify_handle(const HMI_Event *event);
+static HMI_State DoorOpen_handle(const HMI_Event *event);
+static HMI_State DoorClose_handle(const HMI_Event *event);
+static HMI_State Blocked_handle(const HMI_Event *event);
+static HMI_State AdminPass_handle(const HMI_Event *event);
+static HMI_State UserPin_handle(const HMI_Event *event);
+static HMI_State UserResult_handle(const HMI_Event *event);
+
+/* Password entry helpers , title in the flash */
+static void EnterPass_start(const char *title);
+static bool EnterPass_key(uint8 *buffer, uint8 key);
+
+/* LOCKED response => HMI_BLOCKED */
+static HMI_State Locked_response(void);
 
 
 /*******************************************************************************
@@ -28,17 +72,83 @@ uint8 g_password[PASS_SIZE];
 /* Global variable to store the re-entered password from keypad */
 uint8 g_rePassword[PASS_SIZE];
 
-/* Global Counter For Password Array */
-uint8 count = 0 ;
-
-/* Root Password , to reset the password */
-uint8 ROOT_PASS[PASS_SIZE] = {2,6,4,9,5} ;
+/* Global variable to store the old / root password , checked again by
+ * Control ECU with the new password (CHANGE_PASSWORD) */
+uint8 g_oldPassword[PASS_SIZE];
 
-/* Global Delay Flag => flag is set when Timer callback function is called */
-bool g_delayFlag = FALSE ;
+/* Password Entry Index , owned by EnterPass_start / EnterPass_key */
+uint8 count = 0 ;
 
-/* Global variable contain the ticks count of Timer2 */
-uint16 g_T2_tick = 0 ;
+/* LCD Strings , in the flash (LCD_*_P functions) : string literals would be
+ * copied to RAM (.data) at startup */
+static const char STR_CHANGE_PASS[] PROGMEM = "+ : Change PASS" ;
+static const char STR_OPEN_DOOR[] PROGMEM = "- : Open Door" ;
+static const char STR_BLOCKED[] PROGMEM = "System Blocked" ;
+static const char STR_WAIT[] PROGMEM = "Wait 00:00" ;
+static const char STR_ROOT_PASS[] PROGMEM = "Enter Root PASS" ;
+static const char STR_NEW_PASS[] PROGMEM = "Enter New PASS" ;
+static const char STR_RE_PASS[] PROGMEM = "ReEnter PASS" ;
+static const char STR_NOT_MATCHED[] PROGMEM = "PASS not matched" ;
+static const char STR_CONFIRMED[] PROGMEM = "Confirmed" ;
+static const char STR_OLD_PASS[] PROGMEM = "Enter Old PASS" ;
+static const char STR_ENTER_PASS[] PROGMEM = "Enter  PASS" ;
+static const char STR_DOOR_OPEN[] PROGMEM = "Door Open" ;
+static const char STR_DOOR_CLOSE[] PROGMEM = "Door Close" ;
+static const char STR_ADMIN_PASS[] PROGMEM = "Enter Admin PASS" ;
+static const char STR_ADD_USER[] PROGMEM = "Add User PIN" ;
+static const char STR_REVOKE_USER[] PROGMEM = "Revoke User PIN" ;
+static const char STR_DONE[] PROGMEM = "Done" ;
+static const char STR_FAILED[] PROGMEM = "Failed" ;
+
+/* Frame Decoder , holds the last response frame received from Control ECU */
+FRAME_DecoderType g_rxFrame;
+
+/* State Timer , for Software TimeOut and messages display time */
+SoftTimer_Type g_stateTimer;
+
+/* Global Timeout Flag => flag is set when State Timer callback function is called */
+volatile bool g_timeoutFlag = FALSE ;
+
+/* Scheduler Tasks IDs */
+uint8 g_keypadTask = SCHED_NO_TASK ;
+uint8 g_frameTask = SCHED_NO_TASK ;
+uint8 g_timeoutTask = SCHED_NO_TASK ;
+uint8 g_lcdTask = SCHED_NO_TASK ;
+
+/* Current State */
+HMI_State g_state = HMI_STARTUP ;
+
+/* State to return to after CHECK_PASSWORD / CHECK_ROOT / CHECK_USER response
+ * (HMI_OLD_PASS , HMI_ROOT_PASS , HMI_OPEN_PASS) */
+HMI_State g_verifyFor = HMI_OPEN_PASS ;
+
+/* Lockout seconds left (LOCKED response) , Buzzer seconds left */
+uint16 g_blockSeconds = 0 ;
+uint8 g_alarmSeconds = 0 ;
+
+/* User Command of HMI_ADMIN_PASS (ADD_USER , REVOKE_USER) */
+uint8 g_userCommand = ADD_USER ;
+
+/* States Table , indexed by HMI_State */
+static const HMI_StateType g_stateTable[HMI_STATES_NUM] =
+{
+	[HMI_STARTUP]		= { Startup_enter,		Startup_handle		},
+	[HMI_MAIN]			= { MainScreen,			Main_handle			},
+	[HMI_ROOT_PASS]		= { RootPass_enter,		RootPass_handle		},
+	[HMI_NEW_PASS]		= { NewPass_enter,		NewPass_handle		},
+	[HMI_RE_PASS]		= { RePass_enter,		RePass_handle		},
+	[HMI_NOT_MATCHED]	= { NotMatched_enter,	Message_handle		},
+	[HMI_CONFIRMED]		= { Confirmed_enter,	Message_handle		},
+	[HMI_OLD_PASS]		= { OldPass_enter,		OldPass_handle		},
+	[HMI_OPEN_PASS]		= { OpenPass_enter,		OpenPass_handle		},
+	[HMI_VERIFY]		= { Verify_enter,		Verify_handle		},
+	[HMI_DOOR_OPEN]		= { DoorOpen_enter,		DoorOpen_handle		},
+	[HMI_DOOR_CLOSE]	= { DoorClose_enter,	DoorClose_handle	},
+	[HMI_BLOCKED]		= { BlockSystem,		Blocked_handle		},
+	[HMI_ADMIN_PASS]	= { AdminPass_enter,	AdminPass_handle	},
+	[HMI_USER_PIN]		= { UserPin_enter,		UserPin_handle		},
+	[HMI_USER_RESULT]	= { UserResult_enter,	UserResult_handle	},
+};
 
 /*******************************************************************************
  *                    		   Main Function                                   *
@@ -54,35 +164,48 @@ int main(void)
 	LCD_clearScreen();
 
 	/* Initialize UART */
-	UART_ConfigType UART_Config = {.s_BaudRate = BR9600 , .s_NULL_Terminator = '#' };
+	/* RX / DRE Interrupts Enabled => Bytes are buffered in RX/TX Ring Buffers */
+	UART_ConfigType UART_Config = {.s_RxInterruptEnable = ENABLE_INT ,
+			.s_DataRegEmptyInterruptEnable = ENABLE_INT ,
+			.s_BaudRate = HMI_UART_BAUD_RATE , .s_NULL_Terminator = '#' };
 	UART_init(&UART_Config);
 
-	/* Initialize Timer1*/
-	/* F_CPU = 8Mhz		Timer1 COMP Mode 	1 Sec. */
-	 TIMER_ConfigType Timer1_Config = {.clock = F_CPU_1024, .mode = COMP, .OCRValue = 8000 };
-	 Timer1_Init(&Timer1_Config);
-	 Timer1_stopTimer();
-	 Timer1_setCallBack(Timer1_CallBack);
-
-	/* Initialize Timer2*/
-	/* F_CPU = 8Mhz		Timer2 Normal Mode 	32 Milli/OVF.
-	 * Used For Software TimeOut
-	 */
-	 TIMER_ConfigType Timer2_Config = {.clock = F_CPU_1024, .mode = NORMAL};
-	 Timer2_Init(&Timer2_Config);
-	 Timer2_stopTimer();
-	 Timer2_setCallBack(Timer2_CallBack);
-
-	UART_sendByte(READY) ;
-	if(UART_receiveByte() == PASS_NOT_FOUND)
-		EnterNewPass();
-	LCD_clearScreen();
+	/* Initialize Software Timers Service on Timer1 , 1 ms tick */
+	SoftTimer_init();
 
-	while(1)
-	{
-		MainScreen();
-	}
+	/* Profiling Zones , measure the probe overhead (PROF_ENABLE) */
+	PROF_INIT();
+
+	/* ISR latency / duration histograms (ISR_STATS_ENABLE) */
+	ISR_STATS_INIT();
+
+	/* Start Keypad Scanner , debounced key events every 5 ms scan */
+	KeyPad_init();
+
+	FRAME_decoderInit(&g_rxFrame);
+
+	/* Event sources wake their tasks , LCD is flushed after them
+	 * Idle Sleep Mode when no task is ready */
+	SCHED_init();
+	POWER_init();
+	SCHED_setIdleHook(POWER_idle);
+	g_keypadTask = SCHED_addTask(Keypad_task, HMI_KEYPAD_TASK_PRIORITY);
+	g_frameTask = SCHED_addTask(Frame_task, HMI_FRAME_TASK_PRIORITY);
+	g_timeoutTask = SCHED_addTask(Timeout_task, HMI_TIMEOUT_TASK_PRIORITY);
+	g_lcdTask = SCHED_addTask(Lcd_task, HMI_LCD_TASK_PRIORITY);
+	KeyPad_setCallBack(Keypad_CallBack);
+	UART_RXC_setCallBack(UART_CallBack);
 
+	/* Enter the first state */
+	g_state = HMI_STARTUP ;
+	g_stateTable[g_state].s_enter();
+
+	/* Events before the Call Backs were set , first screen */
+	SCHED_setEvent(g_keypadTask, HMI_EV_KEYPAD);
+	SCHED_setEvent(g_frameTask, HMI_EV_RX_BYTE);
+	SCHED_setEvent(g_lcdTask, HMI_EV_FLUSH);
+
+	SCHED_run();
 }
 
 
@@ -92,318 +215,653 @@ int main(void)
  *******************************************************************************/
 
 /*
- * Description: Function to Display The Main Screen and get operation from User.
+ * Description: Function to pass one event to the current state and
+ * 				move to the next state.
  */
-void MainScreen(void)
+void HMI_dispatch(const HMI_Event *event)
 {
-	LCD_displayStringRowColumn(0,0,"+ : Change PASS");
-	LCD_displayStringRowColumn(1,0,"- : Open Door");
-
-	/* Press + To change Password */
-	if(KeyPad_getPressedKey() == '+')
-		ChangePass();
-
-	/* Press - To Open Door */
-	else if (KeyPad_getPressedKey() == '-')
-		OpenDoor();
+	HMI_State next ;
 
+	PROF_BEGIN(PROF_ZONE_DISPATCH);
+	next = g_stateTable[g_state].s_handle(event);
 
-	/* Hidden Option to Access Root Password
-	 * Press = for 3 sec. To Reset Password using Root Password */
-	else if (KeyPad_getPressedKey() == '=')
+	if(next != g_state)
 	{
-		T1_delay_sec(3);
-		if (KeyPad_getPressedKey() == '=')
-		{
-			LCD_clearScreen();
-			LCD_displayStringRowColumn(0,0,"Enter Root PASS");
-			T1_delay_msec(500);
-			for (count=0 ; count < PASS_SIZE ; count++)
-			{
-				Timer2_restartTimer();	/* For Software TimeOut , 10 Sec. */
-				g_password[count] = KeyPad_getPressedKey();
-				Timer2_stopTimer();		/* Stop Timer2 if 10 Sec. Doesn't Passed */
-				g_T2_tick = 0 ;			/* Reset ticks counter of Timer2 */
-				T1_delay_msec(500);
-				LCD_displayStringRowColumn(1,count,"*");
-				if (g_password[count] != ROOT_PASS[count] )
-					MainScreen();
-			}
-			/* Reset Password if Password = Root Password */
-			UART_sendByte(READY) ;
-			while(UART_receiveByte() != READY);
-			UART_sendByte(CHANGE_PASSWORD);
-			EnterNewPass();
-		}
+		/* Timer of the old state must not fire in the new state */
+		SoftTimer_stop(&g_stateTimer);
+		g_timeoutFlag = FALSE ;
+
+		g_state = next ;
+		g_stateTable[g_state].s_enter();
 	}
+
+	/* Handlers and entry actions change the LCD buffer */
+	SCHED_setEvent(g_lcdTask, HMI_EV_FLUSH);
+	PROF_END(PROF_ZONE_DISPATCH);
 }
 
 /*
- * Description: Function to Enter New Password and send the password to Control ECU
- * 				To Store the password in EEPROM.
+ * Description: Keypad Task => debounced press / release / long press events
  */
-void EnterNewPass(void)
+void Keypad_task(uint8 events)
 {
-	LCD_clearScreen();
-	LCD_displayStringRowColumn(0,0,"Enter New PASS");
-	for (count=0 ; count < PASS_SIZE ; count++)
-	{
-		Timer2_restartTimer();	/* For Software TimeOut , 10 Sec. */
-		g_password[count] = KeyPad_getPressedKey();
-		Timer2_stopTimer();		/* Stop Timer2 if 10 Sec. Doesn't Passed */
-		g_T2_tick = 0 ;			/* Reset ticks counter of Timer2 */
-		T1_delay_msec(500);
-		LCD_displayStringRowColumn(1,count,"*");
-	}
-	/* ReEnter Password to be sure from password */
-	LCD_clearScreen();
-	LCD_displayStringRowColumn(0,0,"ReEnter PASS");
-	for (count=0 ; count < PASS_SIZE ; count++)
+	HMI_Event event;
+	KeyPad_Event keyEvent;
+
+	while(KeyPad_poll(&keyEvent))
 	{
-		Timer2_restartTimer();	/* For Software TimeOut , 10 Sec. */
-		g_rePassword[count] = KeyPad_getPressedKey();
-		Timer2_stopTimer();		/* Stop Timer2 if 10 Sec. Doesn't Passed */
-		g_T2_tick = 0 ;			/* Reset ticks counter of Timer2 */
-		T1_delay_msec(500);
-		LCD_displayStringRowColumn(1,count,"*");
+		if(keyEvent.s_Type == KEYPAD_PRESS)
+			event.s_Type = EV_KEY ;
+		else if(keyEvent.s_Type == KEYPAD_RELEASE)
+			event.s_Type = EV_KEY_RELEASE ;
+		else
+			event.s_Type = EV_KEY_LONG ;
+		event.s_Data = keyEvent.s_Key ;
+		HMI_dispatch(&event);
 	}
+}
+
+/*
+ * Description: Frame Task => Response frames from Control ECU ,
+ * 				SCHED_STATS / POWER_STATS / PROF_STATS / ISR_STATS / STACK_STATS
+ * 				requests of a debug tool are answered here , debug replies are dropped
+ */
+void Frame_task(uint8 events)
+{
+	HMI_Event event;
 
-	/* check if the two password matched or not */
-	for (count=0 ; count < PASS_SIZE ; count++)
+	while(FRAME_poll(&g_rxFrame))
 	{
-		if( g_password[count] != g_rePassword[count] )
+		/* Control ECU sends debug replies only , never answered */
+		if(DEBUG_answer(&g_rxFrame.s_Frame))
 		{
-			/* Passwords Entered are not matched */
-			LCD_clearScreen();
-			LCD_displayStringRowColumn(0,0,"PASS not matched");
-			T1_delay_sec(2);
-
-			/* Go To EnterNewPass() Function Again to Enter The Password */
-			EnterNewPass();
+			continue;
 		}
+		event.s_Type = EV_RESPONSE ;
+		event.s_Data = g_rxFrame.s_Frame.s_Command ;
+		HMI_dispatch(&event);
 	}
+}
 
-	/* Passwords Entered are matched */
-	LCD_clearScreen();
-	LCD_displayStringRowColumn(0,0,"Confirmed");
+/*
+ * Description: Timeout Task => State Timer expired
+ * 				the flag is cleared if the state changed after the timer fired
+ */
+void Timeout_task(uint8 events)
+{
+	HMI_Event event;
 
-	/* Send The Password To Contol ECU To store it in EEPROM */
-	for (count=0 ; count < PASS_SIZE ; count++)
+	if(g_timeoutFlag)
 	{
-		UART_sendByte(READY) ;
-		while(UART_receiveByte() != READY);
-		UART_sendByte(g_password[count]);
+		g_timeoutFlag = FALSE ;
+		event.s_Type = EV_TIMEOUT ;
+		event.s_Data = 0 ;
+		HMI_dispatch(&event);
 	}
-	T1_delay_msec(1000);
 }
 
 /*
- * Description: Function to change the old password and Set New Password .
+ * Description: LCD Task => send the changed LCD cells only
  */
-void ChangePass(void)
+void Lcd_task(uint8 events)
 {
-	T1_delay_msec(500);
-	LCD_clearScreen();
-	LCD_displayStringRowColumn(0,0,"Enter Old PASS");
-	for (count=0 ; count < PASS_SIZE ; count++)
+	PROF_BEGIN(PROF_ZONE_LCD_FLUSH);
+	LCD_flush();
+	PROF_END(PROF_ZONE_LCD_FLUSH);
+}
+
+/*
+ * Description: Call Back Function of Keypad (TIMER1 ISR) => wake the Keypad Task
+ */
+void Keypad_CallBack(void)
+{
+	SCHED_setEvent(g_keypadTask, HMI_EV_KEYPAD);
+}
+
+/*
+ * Description: Call Back Function of UART RX ISR => wake the Frame Task
+ */
+void UART_CallBack(void)
+{
+	SCHED_setEvent(g_frameTask, HMI_EV_RX_BYTE);
+}
+
+/*
+ * Description: Function to Display The Main Screen .
+ */
+void MainScreen(void)
+{
+	LCD_bufferClear();
+	LCD_bufferStringRowColumn_P(0,0,STR_CHANGE_PASS);
+	LCD_bufferStringRowColumn_P(1,0,STR_OPEN_DOOR);
+}
+
+/*
+ * Description: Function to Display the Lockout count down and Start the Buzzer ,
+ * 				g_blockSeconds is received in the LOCKED response .
+ */
+void BlockSystem(void)
+{
+	LCD_bufferClear();
+	LCD_bufferStringRowColumn_P(0,0,STR_BLOCKED);
+	BlockCountdown();
+
+	/* Buzzer Start , stopped after HMI_ALARM_SEC */
+	pinMode(BUZZER_PORT,BUZZER_PIN,OUTPUT);
+	pinWrite(BUZZER_PORT,BUZZER_PIN,HIGH);
+	g_alarmSeconds = HMI_ALARM_SEC ;
+
+	/* one State Timer event every second */
+	StateTimer_start(1000);
+}
+
+/*
+ * Description: Function to Display the seconds left in the Lockout (mm:ss)
+ */
+void BlockCountdown(void)
+{
+	uint16 minutes = g_blockSeconds / 60 ;
+	uint8 seconds = (uint8)(g_blockSeconds % 60) ;
+
+	/* max 99:59 */
+	if(minutes > 99)
+		minutes = 99 ;
+
+	/* "Wait mm:ss" , the digits are drawn over the flash template */
+	LCD_bufferStringRowColumn_P(1,0,STR_WAIT);
+	LCD_bufferCharacter(1,5,(uint8)('0' + (minutes / 10)));
+	LCD_bufferCharacter(1,6,(uint8)('0' + (minutes % 10)));
+	LCD_bufferCharacter(1,8,(uint8)('0' + (seconds / 10)));
+	LCD_bufferCharacter(1,9,(uint8)('0' + (seconds % 10)));
+}
+
+/*
+ * Description: Function to send a command frame to Control ECU ,
+ * 				the response is received later as EV_RESPONSE event.
+ */
+void ControlRequest(uint8 command, const uint8 *payload, uint8 length)
+{
+	FRAME_send(command, payload, length);
+}
+
+/*
+ * Description: Function to start the State Timer , EV_TIMEOUT event after msec
+ */
+void StateTimer_start(uint32 msec)
+{
+	g_timeoutFlag = FALSE ;
+	SoftTimer_start(&g_stateTimer, msec, 0, StateTimer_CallBack);
+}
+
+/*
+ * Description: Call Back Function of the State Timer => Set timeout flag ,
+ * 				wake the Timeout Task
+ */
+void StateTimer_CallBack(void)
+{
+	g_timeoutFlag = TRUE ;
+	SCHED_setEvent(g_timeoutTask, HMI_EV_TIMEOUT);
+}
+
+/*******************************************************************************
+ *                      States Definitions                                     *
+ *******************************************************************************/
+
+/*
+ * HMI_STARTUP : Ask Control ECU if there is a saved password
+ */
+static void Startup_enter(void)
+{
+	ControlRequest(READY, NULL_PTR, 0);
+	StateTimer_start(HMI_RESPONSE_TIMEOUT_MS);
+}
+
+static HMI_State Startup_handle(const HMI_Event *event)
+{
+	if(event->s_Type == EV_RESPONSE)
 	{
-		Timer2_restartTimer();	/* For Software TimeOut , 10 Sec. */
-		g_password[count] = KeyPad_getPressedKey();
-		Timer2_stopTimer();		/* Stop Timer2 if 10 Sec. Doesn't Passed */
-		g_T2_tick = 0 ;			/* Reset ticks counter of Timer2 */
-		T1_delay_msec(350);
-		LCD_displayStringRowColumn(1,count,"*");
+		if(event->s_Data == PASS_NOT_FOUND)
+			return HMI_NEW_PASS ;
+		else if(event->s_Data == PASS_FOUND)
+			return HMI_MAIN ;
 	}
-	UART_sendByte(READY) ;
-	while(UART_receiveByte() != READY);
-	UART_sendByte(CHECK_PASSWORD);
+	else if(event->s_Type == EV_TIMEOUT)
+	{
+		/* Control ECU not ready yet , ask again */
+		Startup_enter();
+	}
+	return HMI_STARTUP ;
+}
 
+/*
+ * HMI_MAIN : get operation from User
+ */
+static HMI_State Main_handle(const HMI_Event *event)
+{
+	/* Hidden Option to Access Root Password
+	 * Press = for 3 sec. To Reset Password using Root Password */
+	if((event->s_Type == EV_KEY_LONG) && (event->s_Data == '='))
+		return HMI_ROOT_PASS ;
 
-	for (count=0 ; count < PASS_SIZE ; count++)
+	if(event->s_Type != EV_KEY)
+		return HMI_MAIN ;
+
+	/* Press + To change Password */
+	if(event->s_Data == '+')
+		return HMI_OLD_PASS ;
+
+	/* Press - To Open Door */
+	else if(event->s_Data == '-')
+		return HMI_OPEN_PASS ;
+
+	/* Press * To Add User , % To Revoke User */
+	else if(event->s_Data == '*')
+	{
+		g_userCommand = ADD_USER ;
+		return HMI_ADMIN_PASS ;
+	}
+	else if(event->s_Data == '/')
 	{
-		while(UART_receiveByte() != READY);
-		UART_sendByte(g_password[count]);
+		g_userCommand = REVOKE_USER ;
+		return HMI_ADMIN_PASS ;
 	}
 
-	/* Password Matched the Old Password */
-	if(UART_receiveByte() == MATCH)
+	return HMI_MAIN ;
+}
+
+/*
+ * HMI_ROOT_PASS : Enter Root Password , then Set New Password
+ */
+static void RootPass_enter(void)
+{
+	EnterPass_start(STR_ROOT_PASS);
+}
+
+static HMI_State RootPass_handle(const HMI_Event *event)
+{
+	if(event->s_Type == EV_TIMEOUT)
+		return HMI_MAIN ;
+
+	/* Root Password is checked in Control ECU , wrong ones are counted in its Lockout */
+	if((event->s_Type == EV_KEY) && EnterPass_key(g_oldPassword, event->s_Data))
 	{
-		UART_sendByte(READY) ;
-		while(UART_receiveByte() != READY);
-		UART_sendByte(CHANGE_PASSWORD);
-		EnterNewPass();
+		g_verifyFor = HMI_ROOT_PASS ;
+		return HMI_VERIFY ;
 	}
+	return HMI_ROOT_PASS ;
+}
 
+/*
+ * HMI_NEW_PASS : Enter New Password
+ */
+static void NewPass_enter(void)
+{
+	EnterPass_start(STR_NEW_PASS);
+}
 
-	/* Password Doesn't Match the Old Password */
-	else
+static HMI_State NewPass_handle(const HMI_Event *event)
+{
+	/* TimeOut , check again if there is a saved password */
+	if(event->s_Type == EV_TIMEOUT)
+		return HMI_STARTUP ;
+
+	if((event->s_Type == EV_KEY) && EnterPass_key(g_password, event->s_Data))
+		return HMI_RE_PASS ;
+
+	return HMI_NEW_PASS ;
+}
+
+/*
+ * HMI_RE_PASS : ReEnter Password to be sure from password
+ */
+static void RePass_enter(void)
+{
+	EnterPass_start(STR_RE_PASS);
+}
+
+static HMI_State RePass_handle(const HMI_Event *event)
+{
+	uint8 i ;
+
+	if(event->s_Type == EV_TIMEOUT)
+		return HMI_STARTUP ;
+
+	if((event->s_Type == EV_KEY) && EnterPass_key(g_rePassword, event->s_Data))
 	{
-		static int i = 0 ;
-		i++ ;
-		if(i == 3)
+		/* check if the two password matched or not */
+		for (i = 0 ; i < PASS_SIZE ; i++)
 		{
-			i=0 ;
-			BlockSystem();
+			if( g_password[i] != g_rePassword[i] )
+			{
+				/* Passwords Entered are not matched */
+				return HMI_NOT_MATCHED ;
+			}
 		}
-		ChangePass();
+		/* Passwords Entered are matched */
+		return HMI_CONFIRMED ;
 	}
+	return HMI_RE_PASS ;
+}
 
+/*
+ * HMI_NOT_MATCHED : Display message then Enter The Password Again
+ */
+static void NotMatched_enter(void)
+{
+	LCD_bufferClear();
+	LCD_bufferStringRowColumn_P(0,0,STR_NOT_MATCHED);
+	StateTimer_start(HMI_MESSAGE_MS);
 }
 
 /*
- * Description: Function to Block The System for 1 Min. if the password Entered
- * 				3 Times Wrong! .
+ * HMI_CONFIRMED : Send The Old / Root Password + The New Password To Contol ECU
+ * 				   To store it in EEPROM
  */
-void BlockSystem(void)
+static void Confirmed_enter(void)
 {
-	LCD_clearScreen();
-	LCD_displayStringRowColumn(0,0,"System Blocked");
+	uint8 payload[2 * PASS_SIZE];
+	uint8 i ;
 
-	/* Buzzer Start and Block System for 1 Min. */
-	pinMode(C,PC0,OUTPUT);
-	pinWrite(C,PC0,HIGH);
-	T1_delay_sec(60);
-	/* Buzzer Stop */
-	pinWrite(C,PC0,LOW);
+	for (i = 0 ; i < PASS_SIZE ; i++)
+	{
+		payload[i] = g_oldPassword[i] ;
+		payload[PASS_SIZE + i] = g_password[i] ;
+	}
+
+	LCD_bufferClear();
+	LCD_bufferStringRowColumn_P(0,0,STR_CONFIRMED);
+	ControlRequest(CHANGE_PASSWORD, payload, 2 * PASS_SIZE);
+	StateTimer_start(HMI_CONFIRMED_MS);
 }
 
 /*
- * Description: Function to Open Door when Password is Right .
+ * HMI_NOT_MATCHED , HMI_CONFIRMED : wait message display time ,
+ * Control ECU refused the New Password => Failed or locked
  */
-void OpenDoor(void)
+static HMI_State Message_handle(const HMI_Event *event)
 {
-	T1_delay_msec(500);
-	LCD_clearScreen();
-	LCD_displayStringRowColumn(0,0,"Enter  PASS");
-	for (count=0 ; count < PASS_SIZE ; count++)
+	if(event->s_Type == EV_TIMEOUT)
+		return (g_state == HMI_NOT_MATCHED) ? HMI_NEW_PASS : HMI_MAIN ;
+
+	if((g_state == HMI_CONFIRMED) && (event->s_Type == EV_RESPONSE))
 	{
-		Timer2_restartTimer();	/* For Software TimeOut , 10 Sec. */
-		g_password[count] = KeyPad_getPressedKey();
-		Timer2_stopTimer();		/* Stop Timer2 if 10 Sec. Doesn't Passed */
-		g_T2_tick = 0 ;			/* Reset ticks counter of Timer2 */
+		if(event->s_Data == LOCKED)
+			return Locked_response();
 
-		T1_delay_msec(350);
-		LCD_displayStringRowColumn(1,count,"*");
+		if(event->s_Data == DONT_MATCH)
+		{
+			LCD_bufferClear();
+			LCD_bufferStringRowColumn_P(0,0,STR_FAILED);
+		}
 	}
-	UART_sendByte(READY) ;
-	while(UART_receiveByte() != READY);
-	UART_sendByte(CHECK_PASSWORD);
+	return g_state ;
+}
+
+/*
+ * HMI_OLD_PASS : Enter Old Password to change it
+ */
+static void OldPass_enter(void)
+{
+	EnterPass_start(STR_OLD_PASS);
+}
+
+static HMI_State OldPass_handle(const HMI_Event *event)
+{
+	if(event->s_Type == EV_TIMEOUT)
+		return HMI_MAIN ;
 
-	for (count=0 ; count < PASS_SIZE ; count++)
+	if((event->s_Type == EV_KEY) && EnterPass_key(g_oldPassword, event->s_Data))
 	{
-		while(UART_receiveByte() != READY);
-		UART_sendByte(g_password[count]);
+		g_verifyFor = HMI_OLD_PASS ;
+		return HMI_VERIFY ;
 	}
+	return HMI_OLD_PASS ;
+}
 
-	/* Password Matched the Old Password */
-	if(UART_receiveByte() == MATCH)
+/*
+ * HMI_OPEN_PASS : Enter Password to open the door
+ */
+static void OpenPass_enter(void)
+{
+	EnterPass_start(STR_ENTER_PASS);
+}
+
+static HMI_State OpenPass_handle(const HMI_Event *event)
+{
+	if(event->s_Type == EV_TIMEOUT)
+		return HMI_MAIN ;
+
+	if((event->s_Type == EV_KEY) && EnterPass_key(g_password, event->s_Data))
 	{
-		UART_sendByte(READY) ;
-		while(UART_receiveByte() != READY);
-		UART_sendByte(OPEN_DOOR);
-
-		/* Display On LCD that Door Open/Close while Door is Open/Close */
-		LCD_clearScreen();
-		LCD_displayStringRowColumn(0,0,"Door Open");
-		T1_delay_sec(10);
-		LCD_clearScreen();
-		LCD_displayStringRowColumn(0,0,"Door Close");
-		T1_delay_sec(10);
+		g_verifyFor = HMI_OPEN_PASS ;
+		return HMI_VERIFY ;
 	}
+	return HMI_OPEN_PASS ;
+}
 
-	/* Password Doesn't Match the Old Password */
+/*
+ * HMI_VERIFY : Check the Password in Control ECU ,
+ * 				users PINs open the door but can't change the Password
+ */
+static void Verify_enter(void)
+{
+	if(g_verifyFor == HMI_OPEN_PASS)
+		ControlRequest(CHECK_USER, g_password, PASS_SIZE);
 	else
+		ControlRequest((g_verifyFor == HMI_OLD_PASS) ? CHECK_PASSWORD : CHECK_ROOT,
+				g_oldPassword, PASS_SIZE);
+	StateTimer_start(HMI_RESPONSE_TIMEOUT_MS);
+}
+
+static HMI_State Verify_handle(const HMI_Event *event)
+{
+	if(event->s_Type == EV_TIMEOUT)
+		return HMI_MAIN ;
+
+	if(event->s_Type != EV_RESPONSE)
+		return HMI_VERIFY ;
+
+	/* Password Matched the Old / Root Password */
+	if(event->s_Data == MATCH)
 	{
-		static int i = 0 ;
-		i++ ;
-		if(i == 3)
-		{
-			i=0 ;
-			BlockSystem();
-		}
-		OpenDoor();
+		if(g_verifyFor != HMI_OPEN_PASS)
+			return HMI_NEW_PASS ;
+
+		ControlRequest(OPEN_DOOR, NULL_PTR, 0);
+		return HMI_DOOR_OPEN ;
+	}
+
+	/* Password Doesn't Match the Old Password */
+	else if(event->s_Data == DONT_MATCH)
+	{
+		/* Enter The Password Again */
+		return g_verifyFor ;
+	}
+
+	/* Too many wrong Passwords , Control ECU locked the checks */
+	else if(event->s_Data == LOCKED)
+	{
+		return Locked_response();
 	}
+	return HMI_VERIFY ;
 }
 
 /*
- * Description: Function to delay in msec using Timer1
- * 				 Maximun value for msec 8000
+ * HMI_DOOR_OPEN , HMI_DOOR_CLOSE :
+ * Display On LCD that Door Open/Close while Door is Open/Close
  */
-void T1_delay_msec(uint16 msec)
+static void DoorOpen_enter(void)
 {
-	/* 8000 => Timer1 Ticks for getting 1 sec.
-	 * F_CPU = 8Mhz		Prescaler = 1024	ticks = 8000 for 1 sec*/
-	Timer1_Ticks((msec * 8 ),0);
-
-	/* Reset Timer1 to Zero */
-	Timer1_resetTimer();
+	LCD_bufferClear();
+	LCD_bufferStringRowColumn_P(0,0,STR_DOOR_OPEN);
+	StateTimer_start(HMI_DOOR_MOVE_MS + HMI_DOOR_HOLD_MS);
+}
 
-	/* Start Timer1*/
-	Timer1_restartTimer();
+static HMI_State DoorOpen_handle(const HMI_Event *event)
+{
+	return (event->s_Type == EV_TIMEOUT) ? HMI_DOOR_CLOSE : HMI_DOOR_OPEN ;
+}
 
-	/* wait until Timer1 ISR Fired and set g_delayFlag = TRUE */
-	while(!g_delayFlag);
+static void DoorClose_enter(void)
+{
+	LCD_bufferClear();
+	LCD_bufferStringRowColumn_P(0,0,STR_DOOR_CLOSE);
+	StateTimer_start(HMI_DOOR_MOVE_MS);
+}
 
-	/* clear delay flag */
-	g_delayFlag = FALSE ;
+static HMI_State DoorClose_handle(const HMI_Event *event)
+{
+	return (event->s_Type == EV_TIMEOUT) ? HMI_MAIN : HMI_DOOR_CLOSE ;
 }
 
 /*
- * Description: Function To Delay in sec by calling delay_ms function with 1000 ms.
+ * HMI_BLOCKED : count down every second , Stop the Buzzer after HMI_ALARM_SEC
+ * 				 keys are ignored , checks are locked in Control ECU
  */
-void T1_delay_sec(uint16 sec)
+static HMI_State Blocked_handle(const HMI_Event *event)
 {
-	int i;
-	/* recall delay milli function for N sec.*/
-	for(i = 0 ; i < sec ; i++)
-	{
-		/* Call Delay Milli Function by 1000 milli (1sec) */
-		T1_delay_msec(1000);
-	}
+	if(event->s_Type != EV_TIMEOUT)
+		return HMI_BLOCKED ;
+
+	if(g_alarmSeconds > 0)
+		g_alarmSeconds-- ;
+	if(g_blockSeconds > 0)
+		g_blockSeconds-- ;
+
+	/* Buzzer Stop */
+	if((g_alarmSeconds == 0) || (g_blockSeconds == 0))
+		pinWrite(BUZZER_PORT,BUZZER_PIN,LOW);
+
+	if(g_blockSeconds == 0)
+		return HMI_MAIN ;
+
+	BlockCountdown();
+	StateTimer_start(1000);
+	return HMI_BLOCKED ;
 }
 
 /*
- * Description: Call Back Function of Timer1 ISR => Set delay flag
+ * HMI_ADMIN_PASS : Enter Password to add / revoke a user
  */
-void Timer1_CallBack(void)
+static void AdminPass_enter(void)
 {
-	/* Set Delay Flag */
-	g_delayFlag = TRUE ;
+	EnterPass_start(STR_ADMIN_PASS);
+}
+
+static HMI_State AdminPass_handle(const HMI_Event *event)
+{
+	if(event->s_Type == EV_TIMEOUT)
+		return HMI_MAIN ;
 
-	/* Stop Timer1 */
-	Timer1_stopTimer();
+	if((event->s_Type == EV_KEY) && EnterPass_key(g_password, event->s_Data))
+		return HMI_USER_PIN ;
 
-	/* Reset Timer1 to Zero */
-	Timer1_resetTimer();
+	return HMI_ADMIN_PASS ;
 }
 
 /*
- * Description: Call Back Function of Timer2
- * 				Call MainScreen() Function After 10 Sec.
- * 				Software Timeout after 10 Sec.
+ * HMI_USER_PIN : Enter the user PIN
  */
-void Timer2_CallBack(void)
+static void UserPin_enter(void)
+{
+	EnterPass_start((g_userCommand == ADD_USER) ? STR_ADD_USER : STR_REVOKE_USER);
+}
+
+static HMI_State UserPin_handle(const HMI_Event *event)
 {
-	/* Timer2 1 OvF -> 32 milli
-	 * 1 sec. = 31 OvF
-	 */
+	if(event->s_Type == EV_TIMEOUT)
+		return HMI_MAIN ;
 
-	g_T2_tick++ ;
+	if((event->s_Type == EV_KEY) && EnterPass_key(g_rePassword, event->s_Data))
+		return HMI_USER_RESULT ;
+
+	return HMI_USER_PIN ;
+}
 
-	/* if Timer2 Count 10 Sec. Reset System */
-	if(g_T2_tick == 310)
+/*
+ * HMI_USER_RESULT : Send Password + PIN to Control ECU , display the result
+ */
+static void UserResult_enter(void)
+{
+	uint8 payload[2 * PASS_SIZE];
+	uint8 i ;
+
+	for (i = 0 ; i < PASS_SIZE ; i++)
 	{
-		g_T2_tick = 0 ;
+		payload[i] = g_password[i] ;
+		payload[PASS_SIZE + i] = g_rePassword[i] ;
+	}
+
+	LCD_bufferClear();
+	ControlRequest(g_userCommand, payload, 2 * PASS_SIZE);
+	StateTimer_start(HMI_RESPONSE_TIMEOUT_MS);
+}
+
+static HMI_State UserResult_handle(const HMI_Event *event)
+{
+	/* No response , or message display time finished */
+	if(event->s_Type == EV_TIMEOUT)
+		return HMI_MAIN ;
 
-		/* Enable WatchDog To Reset The System */
-		WDTCR = (1<<WDE);
+	if(event->s_Type == EV_RESPONSE)
+	{
+		if(event->s_Data == LOCKED)
+			return Locked_response();
 
-		/*
-		 * Calling MainScreen() instead of using WatchDog Causing Error!
-		 * is it Stack overflow?!
-		 */
+		LCD_bufferStringRowColumn_P(0,0,(event->s_Data == READY) ? STR_DONE : STR_FAILED);
+		StateTimer_start(HMI_MESSAGE_MS);
 	}
+	return HMI_USER_RESULT ;
+}
+
+/*******************************************************************************
+ *                      Password Entry Helpers                                 *
+ *******************************************************************************/
 
+/*
+ * Description: Function to display the password entry screen (title in the
+ * 				flash) and start the Software TimeOut , 10 Sec. for every digit
+ */
+static void EnterPass_start(const char *title)
+{
+	LCD_bufferClear();
+	LCD_bufferStringRowColumn_P(0,0,title);
+	count = 0 ;
+	StateTimer_start(HMI_ENTRY_TIMEOUT_MS);
 }
 
+/*
+ * Description: Function to store one password digit
+ * 				returns TRUE when PASS_SIZE digits are entered
+ */
+static bool EnterPass_key(uint8 *buffer, uint8 key)
+{
+	/* Only digits keys 0:9 are accepted */
+	if(key > 9)
+		return FALSE ;
+
+	buffer[count] = key ;
+	LCD_bufferCharacter(1,count,'*');
+	count++ ;
+
+	/* Restart Software TimeOut for the next digit */
+	StateTimer_start(HMI_ENTRY_TIMEOUT_MS);
+
+	return (count == PASS_SIZE) ;
+}
+
+/*
+ * Description: Function to load the seconds left from the LOCKED response
+ * 				(low byte first) , the count down is shown in HMI_BLOCKED
+ */
+static HMI_State Locked_response(void)
+{
+	if(g_rxFrame.s_Frame.s_Length != 2)
+		return HMI_MAIN ;
+
+	g_blockSeconds = (uint16)(g_rxFrame.s_Frame.s_Payload[0] |
+			((uint16)g_rxFrame.s_Frame.s_Payload[1] << 8)) ;
+
+	return (g_blockSeconds > 0) ? HMI_BLOCKED : HMI_MAIN ;
+}
 
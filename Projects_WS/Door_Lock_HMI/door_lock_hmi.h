@@ -9,6 +9,15 @@
  * 				- Connect UART Lines Rx->Tx
  * 				- Connect Buzzer PC0 with Transistor circuit
  *
+ * State Machine:
+ * 				The HMI is a table-driven state machine , every state has an
+ * 				entry action and an event handler. Scheduler tasks read the event
+ * 				sources (keypad queue , UART frames , state timer) and dispatch
+ * 				one event at a time , handlers return the next state.
+ * 				The LCD task sends the changed cells after the events.
+ * 				No function calls another screen function , so the stack
+ * 				depth is fixed and timeouts are normal state transitions.
+ *
  * Created on :	Sep 30, 2020
  * Author: 		Mohsen Moawad
  *
@@ -21,87 +30,150 @@
  *                    	  Libraries Include                                    *
  *******************************************************************************/
 
+#include "hmi_config.h"
 #include "lcd.h"
 #include "keypad.h"
 #include "uart.h"
+#include "frame.h"
+#include "door_lock_protocol.h"
 #include "timer.h"
+#include "soft_timer.h"
+#include "scheduler.h"
+#include "power.h"
+#include "prof.h"
+#include "isr_stats.h"
+#include "debug_frames.h"
 #include "gpio.h"
 
-
 /*******************************************************************************
- *                   	   Macros Definition                                   *
+ *                      Preprocessor Macros                                    *
  *******************************************************************************/
 
-/* For UART confirmation */
-#define READY				 	0x01
-#define CHECK_PASSWORD		 	0x02
-#define MATCH					0x03
-#define DONT_MATCH				0x04
-#define CHANGE_PASSWORD			0x05
-#define OPEN_DOOR				0x06
-#define PASS_FOUND				0x07
-#define PASS_NOT_FOUND			0x08
-
-/* Password Size */
-#define PASS_SIZE 5
+/* Tasks Events , ISRs wake the tasks */
+#define HMI_EV_KEYPAD		0x01	/* Keypad Task : keypad event queued */
+#define HMI_EV_RX_BYTE		0x01	/* Frame Task : UART byte received */
+#define HMI_EV_TIMEOUT		0x01	/* Timeout Task : State Timer expired */
+#define HMI_EV_FLUSH		0x01	/* LCD Task : LCD buffer changed */
 
-/* EEPROM MACROS */
-#define PASS_ADDRESS 0x0100
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
 
+typedef enum
+{
+	HMI_STARTUP,		/* Ask Control ECU if there is a saved password */
+	HMI_MAIN,			/* Main Screen , wait operation from User */
+	HMI_ROOT_PASS,		/* Enter Root Password */
+	HMI_NEW_PASS,		/* Enter New Password */
+	HMI_RE_PASS,		/* ReEnter New Password */
+	HMI_NOT_MATCHED,	/* New Passwords are not matched */
+	HMI_CONFIRMED,		/* New Password sent to Control ECU */
+	HMI_OLD_PASS,		/* Enter Old Password to change it */
+	HMI_OPEN_PASS,		/* Enter Password to open the door */
+	HMI_VERIFY,			/* Wait Control ECU response of CHECK_PASSWORD / CHECK_ROOT / CHECK_USER */
+	HMI_DOOR_OPEN,		/* Door is opening , then held open */
+	HMI_DOOR_CLOSE,		/* Door is closing */
+	HMI_BLOCKED,		/* Checks locked by Control ECU , count down */
+	HMI_ADMIN_PASS,		/* Enter Password to add / revoke a user */
+	HMI_USER_PIN,		/* Enter the user PIN */
+	HMI_USER_RESULT,	/* Wait Control ECU response of ADD_USER / REVOKE_USER */
+	HMI_STATES_NUM
+}HMI_State;
+
+typedef enum
+{
+	EV_KEY,				/* Key pressed , s_Data = key */
+	EV_KEY_RELEASE,		/* Key released , s_Data = key */
+	EV_KEY_LONG,		/* Key held for KEYPAD_LONG_PRESS_MS , s_Data = key */
+	EV_TIMEOUT,			/* State Timer expired */
+	EV_RESPONSE			/* Frame received from Control ECU , s_Data = command */
+}HMI_EventType;
+
+typedef struct
+{
+	HMI_EventType s_Type ;
+	uint8 s_Data ;
+}HMI_Event;
+
+typedef struct
+{
+	/* Entry action , called once when the state is entered */
+	void (*s_enter)(void) ;
+
+	/* Event handler , returns the next state */
+	HMI_State (*s_handle)(const HMI_Event *event) ;
+}HMI_StateType;
 
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 
 /*
- * Description: Function to Display The Main Screen and get operation from User.
+ * Description: Function to pass one event to the current state and
+ * 				move to the next state.
  */
-void MainScreen(void);
+void HMI_dispatch(const HMI_Event *event);
 
 /*
- * Description: Function to Enter New Password and send the password to Control ECU
- * 				To Store the password in EEPROM.
+ * Description: Keypad Task => debounced press / release / long press events
  */
-void EnterNewPass(void);
+void Keypad_task(uint8 events);
 
 /*
- * Description: Function to change the old password and Set New Password .
+ * Description: Frame Task => Response frames from Control ECU ,
+ * 				SCHED_STATS / POWER_STATS / PROF_STATS / ISR_STATS / STACK_STATS
+ * 				requests of a debug tool are answered here , debug replies are dropped
  */
-void ChangePass(void);
+void Frame_task(uint8 events);
 
 /*
- * Description: Function to Block The System for 1 Min. if the password Entered
- * 				3 Times Wrong! .
+ * Description: Timeout Task => State Timer expired
  */
-void BlockSystem(void);
+void Timeout_task(uint8 events);
 
 /*
- * Description: Function to Open Door when Password is Right .
+ * Description: LCD Task => send the changed LCD cells only
  */
-void OpenDoor(void);
+void Lcd_task(uint8 events);
 
 /*
- * Description: Function to delay in msec using Timer1
- * 				 Maximun value for msec 8000
+ * Description: Call Back Functions of Keypad (TIMER1 ISR) and UART RX ISR
+ * 				=> wake the Keypad / Frame Task
  */
-void T1_delay_msec(uint16 msec);
+void Keypad_CallBack(void);
+void UART_CallBack(void);
 
 /*
- * Description: Function To Delay in sec by calling delay_ms function with 1000 ms.
+ * Description: Function to Display The Main Screen .
  */
-void T1_delay_sec(uint16 sec);
+void MainScreen(void);
 
 /*
- * Description: Call Back Function of Timer1 ISR => Set delay flag
+ * Description: Function to Display the Lockout count down and Start the Buzzer ,
+ * 				g_blockSeconds is received in the LOCKED response .
  */
-void Timer1_CallBack(void);
+void BlockSystem(void);
 
 /*
- * Description: Call Back Function of Timer2
- * 				Call MainScreen() Function After 10 Sec.
- * 				Software Timeout after 10 Sec.
+ * Description: Function to Display the seconds left in the Lockout (mm:ss)
  */
-void Timer2_CallBack(void);
+void BlockCountdown(void);
 
+/*
+ * Description: Function to send a command frame to Control ECU ,
+ * 				the response is received later as EV_RESPONSE event.
+ */
+void ControlRequest(uint8 command, const uint8 *payload, uint8 length);
+
+/*
+ * Description: Function to start the State Timer , EV_TIMEOUT event after msec
+ */
+void StateTimer_start(uint32 msec);
+
+/*
+ * Description: Call Back Function of the State Timer => Set timeout flag ,
+ * 				wake the Timeout Task
+ */
+void StateTimer_CallBack(void);
 
 #endif /* DOOR_LOCK_HMI_H_ */
@@ -0,0 +1,51 @@
+ /******************************************************************************
+ *
+ * Module: 		HMI ECU - Configuration
+ * File Name: 	hmi_config.h
+ * Description: Configuration of the HMI ECU application
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef HMI_CONFIG_H_
+#define HMI_CONFIG_H_
+
+	/* UART link with Control ECU */
+	#define HMI_UART_BAUD_RATE		BR9600
+
+	/* Buzzer Pin */
+	#define BUZZER_PORT				C
+	#define BUZZER_PIN				PC0
+
+	/* Software TimeOut while entering a password */
+	#define HMI_ENTRY_TIMEOUT_MS	10000
+
+	/* Time to wait a response frame from Control ECU */
+	#define HMI_RESPONSE_TIMEOUT_MS	2000
+
+	/* Messages Display Time */
+	#define HMI_MESSAGE_MS			2000
+	#define HMI_CONFIRMED_MS		1000
+
+	/* Door Open / Close Time , Open Hold Time , same as Control ECU */
+	#define HMI_DOOR_MOVE_MS		10000
+	#define HMI_DOOR_HOLD_MS		3000
+
+	/* Buzzer Time at the start of a Lockout
+	 * (Lockout time is sent by Control ECU in the LOCKED response) */
+	#define HMI_ALARM_SEC			10
+
+	/* Scheduler Tasks Priorities (0 = highest) : keypad events , response
+	 * frames , state timeout , LCD flush (last , after all buffer changes) */
+	#define HMI_KEYPAD_TASK_PRIORITY	0
+	#define HMI_FRAME_TASK_PRIORITY		1
+	#define HMI_TIMEOUT_TASK_PRIORITY	2
+	#define HMI_LCD_TASK_PRIORITY		3
+
+	/* Profiling Zones IDs (prof.h) , < PROF_MAX_ZONES */
+	#define PROF_ZONE_DISPATCH			0	/* HMI_dispatch() , one event */
+	#define PROF_ZONE_LCD_FLUSH			1	/* LCD_flush() , changed cells */
+	#define PROF_ZONE_LCD_STRING		2	/* LCD_displayStringRowColumn() */
+	#define PROF_ZONE_KEYPAD_SCAN		3	/* KeyPad_scanTick() , TIMER1 ISR */
+
+#endif /* HMI_CONFIG_H_ */
@@ -11,118 +11,344 @@
  *******************************************************************************/
 
 #include "keypad.h"
+#include "power.h"
+#include "hmi_config.h"
+#include "prof.h"
+#include <avr/pgmspace.h>
 
 /*******************************************************************************
- *                      Functions Prototypes(Private)                          *
+ *                           Global Variables                                  *
  *******************************************************************************/
 
-#if (N_col == 3)
+/* Periodic Software Timer of the scanner */
+static SoftTimer_Type g_scanTimer;
+
+/* Events Queue , filled from TIMER1 ISR , emptied by KeyPad_poll() */
+static volatile KeyPad_Event g_queue[KEYPAD_QUEUE_SIZE];
+static volatile uint8 g_queueHead = 0 ;
+static volatile uint8 g_queueTail = 0 ;
+static volatile uint8 g_dropCount = 0 ;
+
+/* Debounced state of all keys , bit (row*N_col + col) is set while the key is pressed */
+static uint16 g_stableKeys = 0 ;
+
+/* Keys whose raw state differs from the debounced state */
+static uint16 g_bouncingKeys = 0 ;
+
+/* Number of equal samples seen for every bouncing key */
+static uint8 g_debounceCount[KEYPAD_KEYS_NUM];
+
+/* Last pressed key and its hold time in samples for long press event */
+static uint8 g_holdIndex = KEYPAD_KEYS_NUM ;
+static uint16 g_holdSamples = 0 ;
+
+/* TRUE after KeyPad_init() */
+static bool g_scannerOn = FALSE ;
+
+/* Called from TIMER1 ISR after an event is added to the queue */
+static void (*g_eventCallBack)(void) = NULL_PTR ;
+
 /*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x3 keypad
+ * Key value of every switch , indexed by (row*N_col + col) , in the flash :
+ * its functional number in the proteus keypad
  */
-static uint8 KeyPad_4x3_adjustKeyNumber(uint8 button_number);
+#if (N_col == 3)
+static const uint8 g_keyMap[KEYPAD_KEYS_NUM] PROGMEM =
+{
+	1,   2, 3,
+	4,   5, 6,
+	7,   8, 9,
+	'*', 0, '#'		/* ASCII Codes of '*' and '#' */
+};
 #elif (N_col == 4)
+static const uint8 g_keyMap[KEYPAD_KEYS_NUM] PROGMEM =
+{
+	7,  8, 9,   '/',	/* ASCII Code of '/' (%) */
+	4,  5, 6,   '*',	/* ASCII Code of '*' */
+	1,  2, 3,   '-',	/* ASCII Code of '-' */
+	13, 0, '=', '+'		/* ASCII of Enter , ASCII Codes of '=' and '+' */
+};
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
 /*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x4 keypad
+ * Function responsible for reading the whole matrix once
+ * returns bit (row*N_col + col) set for every pressed switch
  */
-static uint8 KeyPad_4x4_adjustKeyNumber(uint8 button_number);
-#endif
+static uint16 KeyPad_scanMatrix(void);
+
+/*
+ * Function responsible for detecting a ghost key in a sample : the matrix
+ * has no diodes , 3 pressed corners of a rectangle read the 4th corner as
+ * pressed too . returns TRUE if two rows share two pressed columns
+ */
+static bool KeyPad_isGhosting(uint16 keys);
+
+/*
+ * Function responsible for mapping a matrix bit index to the key value
+ * (g_keyMap in the flash)
+ */
+static uint8 KeyPad_keyOfIndex(uint8 index);
+
+/*
+ * Function responsible for adding an event to the queue (TIMER1 ISR context)
+ */
+static void KeyPad_pushEvent(KeyPad_EventType type, uint8 index);
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
+void KeyPad_init(void)
+{
+	uint8 index;
+	uint8 sreg = SREG ;
+	cli();
+	for(index=0;index<KEYPAD_KEYS_NUM;index++)
+	{
+		g_debounceCount[index] = 0 ;
+	}
+	g_stableKeys = 0 ;
+	g_bouncingKeys = 0 ;
+	g_holdIndex = KEYPAD_KEYS_NUM ;
+	g_holdSamples = 0 ;
+	g_queueHead = g_queueTail = 0 ;
+	g_dropCount = 0 ;
+	g_scannerOn = TRUE ;
+	SREG = sreg ;
+
+	SoftTimer_start(&g_scanTimer, KEYPAD_SCAN_PERIOD_MS, KEYPAD_SCAN_PERIOD_MS, KeyPad_scanTick);
+}
+
+bool KeyPad_poll(KeyPad_Event *event)
+{
+	uint8 tail = g_queueTail ;
+
+	if(tail == g_queueHead)
+	{
+		return FALSE;
+	}
+	event->s_Type = g_queue[tail & KEYPAD_QUEUE_MASK].s_Type ;
+	event->s_Key = g_queue[tail & KEYPAD_QUEUE_MASK].s_Key ;
+	g_queueTail = tail + 1 ;
+	return TRUE;
+}
+
+uint8 KeyPad_getDropCount(void)
+{
+	return g_dropCount;
+}
+
+void KeyPad_setCallBack(void(*a_ptr)(void))
+{
+	g_eventCallBack = a_ptr ;
+}
+
+void KeyPad_scanTick(void)
+{
+	uint16 keys ;
+	uint16 changed ;
+	uint16 mask = 1 ;
+	uint8 index;
+
+	PROF_BEGIN(PROF_ZONE_KEYPAD_SCAN);
+	keys = KeyPad_scanMatrix() ;
+
+	/* Ambiguous sample (ghost key) => repeat the last raw sample , the key
+	 * that closed the rectangle isn't reported until one corner is released */
+	if(KeyPad_isGhosting(keys))
+	{
+		keys = g_stableKeys ^ g_bouncingKeys ;
+	}
+	changed = keys ^ g_stableKeys ;
+
+	/* Keys that stopped bouncing before KEYPAD_DEBOUNCE_SAMPLES => restart count */
+	if(g_bouncingKeys & ~changed)
+	{
+		for(index=0;index<KEYPAD_KEYS_NUM;index++,mask<<=1)
+		{
+			if((g_bouncingKeys & mask) && !(changed & mask))
+			{
+				g_debounceCount[index] = 0 ;
+			}
+		}
+		mask = 1 ;
+	}
+	g_bouncingKeys = changed ;
+
+	/* Count equal samples of the changed keys only , a quiet keypad costs one scan */
+	for(index=0;(index<KEYPAD_KEYS_NUM) && changed;index++,mask<<=1)
+	{
+		if(!(changed & mask))
+		{
+			continue;
+		}
+		changed &= ~mask ;
+
+		if(++g_debounceCount[index] < KEYPAD_DEBOUNCE_SAMPLES)
+		{
+			continue;
+		}
+
+		/* Key state is stable => new debounced state */
+		g_debounceCount[index] = 0 ;
+		g_bouncingKeys &= ~mask ;
+		g_stableKeys ^= mask ;
+
+		if(g_stableKeys & mask)
+		{
+			KeyPad_pushEvent(KEYPAD_PRESS, index);
+			g_holdIndex = index ;
+			g_holdSamples = 0 ;
+		}
+		else
+		{
+			KeyPad_pushEvent(KEYPAD_RELEASE, index);
+			if(g_holdIndex == index)
+			{
+				g_holdIndex = KEYPAD_KEYS_NUM ;
+			}
+		}
+	}
+
+	/* Long press of the last pressed key , reported once */
+	if((g_holdIndex < KEYPAD_KEYS_NUM) && (g_holdSamples < KEYPAD_LONG_PRESS_SAMPLES))
+	{
+		g_holdSamples++ ;
+		if(g_holdSamples == KEYPAD_LONG_PRESS_SAMPLES)
+		{
+			KeyPad_pushEvent(KEYPAD_LONG_PRESS, g_holdIndex);
+		}
+	}
+	PROF_END(PROF_ZONE_KEYPAD_SCAN);
+}
+
 uint8 KeyPad_getPressedKey(void)
 {
-	uint8 col,row;
-	while(1)
+	uint8 key;
+	KeyPad_Event event;
+
+	/* Scanner running => wait a debounced press , no repeat while the key is held */
+	if(g_scannerOn)
 	{
-		for(col=0;col<N_col;col++) /* loop for columns */
+		while(1)
 		{
-			/* 
-			 * each time only one of the column pins will be output and 
-			 * the rest will be input pins include the row pins 
-			 */ 
-			KEYPAD_PORT_DIR = (0b00010000<<col); 
-			
-			/* 
-			 * clear the output pin column in this trace and enable the internal 
-			 * pull up resistors for the rows pins
-			 */ 
-			KEYPAD_PORT_OUT = (~(0b00010000<<col));
-
-			for(row=0;row<N_row;row++) /* loop for rows */
+			if(KeyPad_poll(&event) && (event.s_Type == KEYPAD_PRESS))
 			{
-				if(BIT_IS_CLEAR(KEYPAD_PORT_IN,row)) /* if the switch is press in this row */ 
-				{
-					#if (N_col == 3)
-						return KeyPad_4x3_adjustKeyNumber((row*N_col)+col+1);
-					#elif (N_col == 4)
-						return (KeyPad_4x4_adjustKeyNumber((row*N_col)+col+1));
-					#endif
-				}
+				return event.s_Key;
 			}
+			/* next scan is in TIMER1 ISR */
+			POWER_sleep();
+		}
+	}
+
+	while(1)
+	{
+		key = KeyPad_scan();
+		if(key != KEYPAD_NO_KEY)
+		{
+			return key;
 		}
 	}	
 }
 
-#if (N_col == 3) 
+uint8 KeyPad_scan(void)
+{
+	uint8 col,row;
+	for(col=0;col<N_col;col++) /* loop for columns */
+	{
+		/* 
+		 * each time only one of the column pins will be output and 
+		 * the rest will be input pins include the row pins 
+		 */ 
+		HAL_WRITE(KEYPAD_PORT_DIR, (0b00010000<<col)); 
+		
+		/* 
+		 * clear the output pin column in this trace and enable the internal 
+		 * pull up resistors for the rows pins
+		 */ 
+		HAL_WRITE(KEYPAD_PORT_OUT, (~(0b00010000<<col)));
+
+		for(row=0;row<N_row;row++) /* loop for rows */
+		{
+			if(HAL_BIT_IS_CLEAR(KEYPAD_PORT_IN,row)) /* if the switch is press in this row */ 
+			{
+				return KeyPad_keyOfIndex((row*N_col)+col);
+			}
+		}
+	}
+	return KEYPAD_NO_KEY;
+}
+
+static uint16 KeyPad_scanMatrix(void)
+{
+	uint8 col,row,rows;
+	uint16 keys = 0 ;
+	for(col=0;col<N_col;col++) /* loop for columns */
+	{
+		HAL_WRITE(KEYPAD_PORT_DIR, (0b00010000<<col));
+		HAL_WRITE(KEYPAD_PORT_OUT, (~(0b00010000<<col)));
+
+		/* pressed switches in this column read as 0 on the row pins */
+		rows = (uint8)(~HAL_READ(KEYPAD_PORT_IN)) & ((1<<N_row)-1) ;
+		for(row=0;rows;row++,rows>>=1) /* loop for pressed rows only */
+		{
+			if(rows & 1)
+			{
+				keys |= (uint16)1 << ((row*N_col)+col) ;
+			}
+		}
+	}
+	return keys;
+}
 
-static uint8 KeyPad_4x3_adjustKeyNumber(uint8 button_number)
+static bool KeyPad_isGhosting(uint16 keys)
 {
-	switch(button_number)
+	uint8 row,other,common;
+	uint16 rest = keys & (keys - 1) ;
+
+	/* Less than 3 keys => no rectangle */
+	if((rest & (rest - 1)) == 0)
 	{
-		case 10: return '*'; // ASCII Code of *
-				 break;
-		case 11: return 0;
-				 break;		
-		case 12: return '#'; // ASCII Code of #
-				 break;
-		default: return button_number;								 						
+		return FALSE;
 	}
-} 
+	for(row=0;row<N_row-1;row++)
+	{
+		for(other=row+1;other<N_row;other++)
+		{
+			common = (uint8)((keys >> (row*N_col)) & (keys >> (other*N_col))) & ((1<<N_col)-1) ;
+			if(common & (common - 1)) /* two columns or more */
+			{
+				return TRUE;
+			}
+		}
+	}
+	return FALSE;
+}
 
-#elif (N_col == 4)
- 
-static uint8 KeyPad_4x4_adjustKeyNumber(uint8 button_number)
+static uint8 KeyPad_keyOfIndex(uint8 index)
 {
-	switch(button_number)
+	return pgm_read_byte(&g_keyMap[index]);
+}
+
+static void KeyPad_pushEvent(KeyPad_EventType type, uint8 index)
+{
+	uint8 head = g_queueHead ;
+
+	if((uint8)(head - g_queueTail) >= KEYPAD_QUEUE_SIZE)
 	{
-		case 1: return 7; 
-				break;
-		case 2: return 8; 
-				break;
-		case 3: return 9; 
-				break;
-		case 4: return '/'; // ASCII Code of %
-				break;
-		case 5: return 4; 
-				break;
-		case 6: return 5;
-				break;
-		case 7: return 6; 
-				break;
-		case 8: return '*'; /* ASCII Code of '*' */
-				break;		
-		case 9: return 1; 
-				break;
-		case 10: return 2; 
-				break;
-		case 11: return 3; 
-				break;
-		case 12: return '-'; /* ASCII Code of '-' */
-				break;
-		case 13: return 13;  /* ASCII of Enter */
-				break;			
-		case 14: return 0; 
-				break;
-		case 15: return '='; /* ASCII Code of '=' */
-				break;
-		case 16: return '+'; /* ASCII Code of '+' */
-				break;
-		default: return button_number;								 						
+		/* Queue Full => drop the new event */
+		g_dropCount++ ;
+		return;
 	}
-} 
+	g_queue[head & KEYPAD_QUEUE_MASK].s_Type = type ;
+	g_queue[head & KEYPAD_QUEUE_MASK].s_Key = KeyPad_keyOfIndex(index) ;
+	g_queueHead = head + 1 ;
 
-#endif
+	if(g_eventCallBack != NULL_PTR)
+	{
+		(*g_eventCallBack)();
+	}
+}
@@ -16,6 +16,7 @@
 #include "std_types.h"
 #include "micro_config.h"
 #include "common_macros.h"
+#include "soft_timer.h"
 
 /*******************************************************************************
  *                      Preprocessor Macros                                    *
@@ -30,13 +31,101 @@
 #define KEYPAD_PORT_IN  PINA
 #define KEYPAD_PORT_DIR DDRA 
 
+/* Returned by KeyPad_scan() when no key is pressed */
+#define KEYPAD_NO_KEY 0xFF
+
+/* Matrix sampling period in ms , KeyPad_init() starts a periodic
+ * Software Timer , the scan runs from TIMER1 ISR */
+#ifndef KEYPAD_SCAN_PERIOD_MS
+#define KEYPAD_SCAN_PERIOD_MS 5
+#endif
+
+/* Number of equal samples before a key changes state
+ * 4 samples * 5 ms => 20 ms debounce time */
+#ifndef KEYPAD_DEBOUNCE_SAMPLES
+#define KEYPAD_DEBOUNCE_SAMPLES 4
+#endif
+
+/* Hold time of a key before KEYPAD_LONG_PRESS event */
+#ifndef KEYPAD_LONG_PRESS_MS
+#define KEYPAD_LONG_PRESS_MS 3000
+#endif
+
+/* Events Queue Size , must be power of two */
+#ifndef KEYPAD_QUEUE_SIZE
+#define KEYPAD_QUEUE_SIZE 8
+#endif
+
+#if ((KEYPAD_QUEUE_SIZE & (KEYPAD_QUEUE_SIZE - 1)) != 0)
+#error "KEYPAD_QUEUE_SIZE must be power of two"
+#endif
+
+#define KEYPAD_QUEUE_MASK	(KEYPAD_QUEUE_SIZE - 1)
+#define KEYPAD_KEYS_NUM		(N_col * N_row)
+#define KEYPAD_LONG_PRESS_SAMPLES	(KEYPAD_LONG_PRESS_MS / KEYPAD_SCAN_PERIOD_MS)
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef enum
+{
+	KEYPAD_PRESS,		/* Key became pressed (after debounce) */
+	KEYPAD_RELEASE,		/* Key became released (after debounce) */
+	KEYPAD_LONG_PRESS	/* Key is still pressed after KEYPAD_LONG_PRESS_MS */
+}KeyPad_EventType;
+
+typedef struct
+{
+	KeyPad_EventType s_Type ;
+	uint8 s_Key ;
+}KeyPad_Event;
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 
+/*
+ * Function responsible for starting the keypad scanner
+ * 	1. Start a periodic Software Timer every KEYPAD_SCAN_PERIOD_MS.
+ * 	2. Clear the debounce states and the events queue.
+ * SoftTimer_init() must be called first.
+ */
+void KeyPad_init(void);
+
+/*
+ * Function responsible for getting the next keypad event (Non-Blocking)
+ * returns TRUE and fills event , or FALSE if the queue is empty
+ */
+bool KeyPad_poll(KeyPad_Event *event);
+
+/*
+ * Function returns the number of events lost because the queue was full
+ */
+uint8 KeyPad_getDropCount(void);
+
+/*
+ * Function to set the Call Back function called (TIMER1 ISR) after
+ * every event added to the queue , to wake the task that polls the keypad
+ */
+void KeyPad_setCallBack(void(*a_ptr)(void));
+
+/*
+ * Call Back Function of the scanner Software Timer => one scan cycle
+ */
+void KeyPad_scanTick(void);
+
 /*
  * Function responsible for getting the pressed keypad key
+ * wait until a key is pressed
+ * If KeyPad_init() was called => waits a debounced KEYPAD_PRESS event
  */
 uint8 KeyPad_getPressedKey(void);
 
+/*
+ * Function responsible for scanning the keypad once (Non-Blocking)
+ * returns the pressed key or KEYPAD_NO_KEY , No debounce
+ */
+uint8 KeyPad_scan(void);
+
 #endif /* KEYPAD_H_ */
@@ -8,6 +8,82 @@
  *******************************************************************************/
 
 #include "lcd.h"
+#include "power.h"
+#include "hmi_config.h"
+#include "prof.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Frame Buffer , drawn by the application */
+static uint8 g_frameBuffer[LCD_ROWS][LCD_COLS];
+
+/* Copy of the cells shown on the LCD now */
+static uint8 g_lcdCells[LCD_ROWS][LCD_COLS];
+
+#if (LCD_TIMING_MODE != LCD_TIMING_FIXED_DELAY)
+/* TRUE after the Function Set command (interface data length) */
+static bool g_lcdConfigured = FALSE;
+#endif
+
+#if (LCD_ASYNC == TRUE)
+/* Commands / Characters Queue , filled by main , emptied by TIMER0 ISR */
+static volatile uint16 g_lcdQueue[LCD_QUEUE_SIZE];
+static volatile uint8 g_lcdQueueHead = 0;
+static volatile uint8 g_lcdQueueTail = 0;
+
+/* TRUE after LCD_init() , writes go to the queue */
+static bool g_lcdAsync = FALSE;
+
+/* TRUE while TIMER0 is stopped (queue empty) */
+static volatile bool g_lcdIdle = TRUE;
+
+/* TIMER0 ticks to wait before the next write (US_DELAY mode) */
+static volatile uint8 g_lcdHoldTicks = 0;
+
+/* TIMER0 ticks the Busy Flag was read as busy (BUSY_FLAG mode) */
+static uint8 g_lcdBusyTicks = 0;
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description: Function to compare the frame buffer with the LCD cells
+ * 				and send (or count) the changed cells
+ */
+static uint8 LCD_flushCells(bool a_send,bool a_cleared);
+
+/*
+ * Description: Function to out one byte on the data bus with E strobe(s)
+ */
+static void LCD_writeBus(uint8 a_data);
+
+/*
+ * Description: Function to wait until LCD can accept a new instruction
+ */
+static void LCD_waitReady(void);
+
+#if ((LCD_TIMING_MODE == LCD_TIMING_BUSY_FLAG) || (LCD_ASYNC == TRUE))
+/*
+ * Description: Function to read the Busy Flag once
+ */
+static bool LCD_isBusy(void);
+#endif
+
+/*
+ * Description: Function returns the number of free entries in the queue
+ */
+static uint8 LCD_queueFree(void);
+
+#if (LCD_ASYNC == TRUE)
+/*
+ * Description: Function to add a command / character to the queue
+ */
+static void LCD_enqueue(uint16 a_entry);
+#endif
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
@@ -19,15 +95,21 @@
 void LCD_init(void)
 {
 	/* Configure the control pins(E,RS,RW) as output pins */
-	LCD_CTRL_PORT_DIR |= (1<<E) | (1<<RS) | (1<<RW);
+	HAL_OR(LCD_CTRL_PORT_DIR, (1<<E) | (1<<RS) | (1<<RW));
+
+#if (LCD_TIMING_MODE != LCD_TIMING_FIXED_DELAY)
+	/* Busy Flag can't be read until the interface is configured */
+	g_lcdConfigured = FALSE;
+	_delay_ms(LCD_POWER_ON_MS); /* wait LCD power on reset */
+#endif
 
 #if (DATA_BITS_MODE == 4)
 	#ifdef UPPER_PORT_PINS
 		/* Configure the highest 4 bits of the data port as output pins */
-		LCD_DATA_PORT_DIR |= 0xF0 ;
+		HAL_OR(LCD_DATA_PORT_DIR, 0xF0);
 	#else
 		/* Configure the lowest 4 bits of the data port as output pins */
-		LCD_DATA_PORT_DIR |= 0x0F ;
+		HAL_OR(LCD_DATA_PORT_DIR, 0x0F);
 	#endif
 	/* to work with 4-bit Data Mode , send command Return Home */
 	LCD_sendCommand(RETURN_HOME);
@@ -35,13 +117,33 @@ void LCD_init(void)
 	LCD_sendCommand(TWO_LINE_LCD_FOUR_BIT_MODE);
 #elif (DATA_BITS_MODE == 8)
 	/* Configure the data port as output port */
-	LCD_DATA_PORT_DIR = 0xFF;
+	HAL_WRITE(LCD_DATA_PORT_DIR, 0xFF);
 	/* use 2-line LCD + 8-bit Data Mode + 5*7 dot display Mode */
 	LCD_sendCommand(TWO_LINE_LCD_Eight_BIT_MODE);
 #endif
 
+#if (LCD_TIMING_MODE != LCD_TIMING_FIXED_DELAY)
+	g_lcdConfigured = TRUE;
+#endif
+
 	LCD_sendCommand(CURSOR_OFF); /* cursor off */
-	LCD_sendCommand(CLEAR_COMMAND); /* clear LCD at the beginning */
+	LCD_clearScreen(); /* clear LCD at the beginning */
+	LCD_bufferClear();
+
+#if (LCD_ASYNC == TRUE)
+	{
+		/* TIMER0 Compare Mode every LCD_ASYNC_TICK_US , started when the queue is not empty */
+		TIMER_ConfigType Timer0_Config = {.clock = F_CPU_8, .mode = COMP,
+				.OCRValue = LCD_ASYNC_TICK_OCR };
+		g_lcdQueueHead = g_lcdQueueTail = 0;
+		g_lcdHoldTicks = 0;
+		Timer0_setCallBack(LCD_asyncTick);
+		Timer0_Init(&Timer0_Config);
+		Timer0_stopTimer();
+		g_lcdIdle = TRUE;
+		g_lcdAsync = TRUE;
+	}
+#endif
 }
 
 /*
@@ -50,137 +152,322 @@ void LCD_init(void)
  */
 void LCD_sendCommand(uint8 a_command)
 {
+#if (LCD_ASYNC == TRUE)
+	if(g_lcdAsync)
+	{
+		LCD_enqueue(a_command);
+		return;
+	}
+#endif
+
+	/* commands flow from AC Characteristics in Datasheet */
+
+	LCD_waitReady(); /* previous instruction must be finished */
+	HAL_CLEAR_BIT(LCD_CTRL_PORT,RS); /* Instruction Mode RS=0 */
+	HAL_CLEAR_BIT(LCD_CTRL_PORT,RW); /* write data to LCD so RW=0 */
+	LCD_writeBus(a_command);
+
+#if (LCD_TIMING_MODE == LCD_TIMING_US_DELAY)
+	/* No Busy Flag => wait the instruction execution time from Datasheet */
+	if((a_command & 0xFC) == 0)
+	{
+		_delay_us(LCD_CLEAR_EXEC_US); /* Clear Display / Return Home */
+	}
+	else
+	{
+		_delay_us(LCD_EXEC_US);
+	}
+#endif
+}
+
+/*
+ * Description: Function to send and display a character on LCD
+ */
+void LCD_displayCharacter(uint8 a_data)
+{
+#if (LCD_ASYNC == TRUE)
+	if(g_lcdAsync)
+	{
+		LCD_enqueue(LCD_QUEUE_RS | a_data);
+		return;
+	}
+#endif
+
 	/* commands flow from AC Characteristics in Datasheet */
 
-	CLEAR_BIT(LCD_CTRL_PORT,RS); /* Instruction Mode RS=0 */
-	CLEAR_BIT(LCD_CTRL_PORT,RW); /* write data to LCD so RW=0 */
+	LCD_waitReady(); /* previous instruction must be finished */
+	HAL_SET_BIT(LCD_CTRL_PORT,RS); /* Data Mode RS=1 */
+	HAL_CLEAR_BIT(LCD_CTRL_PORT,RW); /* write data to LCD so RW=0 */
+	LCD_writeBus(a_data);
 
-/*********************** Sending Command  ****************************/
+#if (LCD_TIMING_MODE == LCD_TIMING_US_DELAY)
+	_delay_us(LCD_EXEC_US); /* wait write data execution time */
+#endif
+}
 
-	_delay_ms(1); /* delay for processing Tas = 50ns */
-	SET_BIT(LCD_CTRL_PORT,E); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
+/*
+ * Description: Function to out one byte on the data bus with E strobe(s)
+ * 				RS , RW must be set before calling it
+ */
+static void LCD_writeBus(uint8 a_data)
+{
+/*********************** Sending Data  ****************************/
+
+	LCD_SETUP_DELAY(); /* delay for processing Tas = 50ns */
+	HAL_SET_BIT(LCD_CTRL_PORT,E); /* Enable LCD E=1 */
+	LCD_PULSE_DELAY(); /* delay for processing Tpw - Tdws = 190ns */
 
-	/* Commands flow with 4-bits Mode*/
+	/* Data flow with 4-bits Mode*/
 #if (DATA_BITS_MODE == 4)
-	/* out the highest 4 bits of the required command to the data bus D4 --> D7
+	/* out the highest 4 bits of the required data to the data bus D4 --> D7
 	 *
-	 * Ex : command 0x28 (0010 1000 )
+	 * Ex : data 0x28 (0010 1000 )
 	 * send ( 0010 ) first
 	 * */
 	#ifdef UPPER_PORT_PINS
 	/*  LCD_DATA_PORT = ( 0000 xxxx ) 		   | ( 0100 0000 )     */
-		LCD_DATA_PORT = (LCD_DATA_PORT & 0x0F) | (a_command & 0xF0) ;
+		HAL_WRITE(LCD_DATA_PORT, (HAL_READ(LCD_DATA_PORT) & 0x0F) | (a_data & 0xF0));
 	#else
 	/*  LCD_DATA_PORT = ( xxxx 0000 ) 	       | (( 0100 0000 ) >> 4) --> (0000 0100)  */
-		LCD_DATA_PORT = (LCD_DATA_PORT & 0xF0) | ((a_command & 0xF0) >> 4 ) ;
+		HAL_WRITE(LCD_DATA_PORT, (HAL_READ(LCD_DATA_PORT) & 0xF0) | ((a_data & 0xF0) >> 4 ));
 	#endif
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	CLEAR_BIT(LCD_CTRL_PORT,E); /* disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
+	LCD_SETUP_DELAY(); /* delay for processing Tdsw = 100ns */
+	HAL_CLEAR_BIT(LCD_CTRL_PORT,E); /* disable LCD E=0 */
+	LCD_HOLD_DELAY(); /* delay for processing Th = 13ns */
 
-/*********************** Sending Command DONE  ***********************/
-/*************************** Sending Command  ************************/
+/*********************** Sending Data DONE  ***********************/
+/************************* Sending Data  **************************/
 
-	SET_BIT(LCD_CTRL_PORT,E); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
+	HAL_SET_BIT(LCD_CTRL_PORT,E); /* Enable LCD E=1 */
+	LCD_PULSE_DELAY(); /* delay for processing Tpw - Tdws = 190ns */
 
-	/* out the lowest 4 bits of the required command to the data bus D4 --> D7
+	/* out the lowest 4 bits of the required data to the data bus D4 --> D7
 	 *
-	 * Ex : command 0x28 (0010 1000 )
+	 * Ex : data 0x28 (0010 1000 )
 	 * send ( 1000 )
 	 * */
 	#ifdef UPPER_PORT_PINS
 	/*  LCD_DATA_PORT = ( 0000 xxxx ) 		   | ( 0000 1000 ) << 4) --> (1000 0000)  */
-		LCD_DATA_PORT = (LCD_DATA_PORT & 0x0F) | ((a_command & 0x0F) << 4 ) ;
+		HAL_WRITE(LCD_DATA_PORT, (HAL_READ(LCD_DATA_PORT) & 0x0F) | ((a_data & 0x0F) << 4 ));
 	#else
 	/*  LCD_DATA_PORT = ( xxxx 0000 ) 	       | (( 0000 1000 ) */
-		LCD_DATA_PORT = (LCD_DATA_PORT & 0xF0) | (a_command & 0x0F) ;
+		HAL_WRITE(LCD_DATA_PORT, (HAL_READ(LCD_DATA_PORT) & 0xF0) | (a_data & 0x0F));
 	#endif
 
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	CLEAR_BIT(LCD_CTRL_PORT,E); /* disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
+	LCD_SETUP_DELAY(); /* delay for processing Tdsw = 100ns */
+	HAL_CLEAR_BIT(LCD_CTRL_PORT,E); /* disable LCD E=0 */
+	LCD_HOLD_DELAY(); /* delay for processing Th = 13ns */
 
-/*********************** Sending Command DONE  ***********************/
+/*********************** Sending Data DONE  ***********************/
 
-	/* Commands flow with 8-bits Mode*/
+	/* Data flow with 8-bits Mode*/
 #elif (DATA_BITS_MODE == 8)
 
-	LCD_DATA_PORT = a_command; /* out the required command to the data bus D0 --> D7 */
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	CLEAR_BIT(LCD_CTRL_PORT,E); /* disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
+	HAL_WRITE(LCD_DATA_PORT, a_data); /* out the required data to the data bus D0 --> D7 */
+	LCD_SETUP_DELAY(); /* delay for processing Tdsw = 100ns */
+	HAL_CLEAR_BIT(LCD_CTRL_PORT,E); /* disable LCD E=0 */
+	LCD_HOLD_DELAY(); /* delay for processing Th = 13ns */
 #endif
-
 }
 
 /*
- * Description: Function to send and display a character on LCD
+ * Description: Function to wait until LCD can accept a new instruction
+ * 	FIXED_DELAY , US_DELAY => nothing , the delays are in the write flow
+ * 	BUSY_FLAG => read Busy Flag until it is 0
+ * 				 or LCD_BUSY_MAX_POLLS reads (LCD not connected)
  */
-void LCD_displayCharacter(uint8 a_data)
+static void LCD_waitReady(void)
 {
-	/* commands flow from AC Characteristics in Datasheet */
+#if (LCD_TIMING_MODE == LCD_TIMING_BUSY_FLAG)
+	uint16 polls = 0;
 
-	SET_BIT(LCD_CTRL_PORT,RS); /* Data Mode RS=1 */
-	CLEAR_BIT(LCD_CTRL_PORT,RW); /* write data to LCD so RW=0 */
+	if(!g_lcdConfigured)
+	{
+		/* Bus width is not configured yet => Busy Flag is not valid */
+		_delay_ms(LCD_CONFIG_EXEC_MS);
+		return;
+	}
 
-/*********************** Sending Data  ****************************/
+	while(LCD_isBusy() && (polls < LCD_BUSY_MAX_POLLS))
+	{
+		polls++;
+	}
+#endif
+}
 
-	_delay_ms(1); /* delay for processing Tas = 50ns */
-	SET_BIT(LCD_CTRL_PORT,E); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
+#if ((LCD_TIMING_MODE == LCD_TIMING_BUSY_FLAG) || (LCD_ASYNC == TRUE))
+/*
+ * Description: Function to read the Busy Flag (DB7) once with RS=0 , RW=1
+ * 				returns FALSE if the LCD is ready (or not BUSY_FLAG mode)
+ */
+static bool LCD_isBusy(void)
+{
+#if (LCD_TIMING_MODE == LCD_TIMING_BUSY_FLAG)
+	uint8 status;
 
-	/* Data flow with 4-bits Mode*/
+	/* Data pins as input pins to read the Busy Flag */
 #if (DATA_BITS_MODE == 4)
-	/* out the highest 4 bits of the required data to the data bus D4 --> D7
-	 *
-	 * Ex : data 0x28 (0010 1000 )
-	 * send ( 0010 ) first
-	 * */
 	#ifdef UPPER_PORT_PINS
-	/*  LCD_DATA_PORT = ( 0000 xxxx ) 		   | ( 0100 0000 )     */
-		LCD_DATA_PORT = (LCD_DATA_PORT & 0x0F) | (a_data & 0xF0) ;
+		HAL_AND(LCD_DATA_PORT_DIR, 0x0F);
 	#else
-	/*  LCD_DATA_PORT = ( xxxx 0000 ) 	       | (( 0100 0000 ) >> 4) --> (0000 0100)  */
-		LCD_DATA_PORT = (LCD_DATA_PORT & 0xF0) | ((a_data & 0xF0) >> 4 ) ;
+		HAL_AND(LCD_DATA_PORT_DIR, 0xF0);
 	#endif
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	CLEAR_BIT(LCD_CTRL_PORT,E); /* disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
+#elif (DATA_BITS_MODE == 8)
+	HAL_WRITE(LCD_DATA_PORT_DIR, 0x00);
+#endif
 
-/*********************** Sending Data DONE  ***********************/
-/************************* Sending Data  **************************/
+	HAL_CLEAR_BIT(LCD_CTRL_PORT,RS); /* Instruction Mode RS=0 */
+	HAL_SET_BIT(LCD_CTRL_PORT,RW); /* read status from LCD so RW=1 */
 
-	SET_BIT(LCD_CTRL_PORT,E); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
+	LCD_SETUP_DELAY(); /* delay for processing Tas = 50ns */
+	HAL_SET_BIT(LCD_CTRL_PORT,E); /* Enable LCD E=1 */
+	LCD_PULSE_DELAY(); /* delay for processing Tddr = 160ns */
+	status = HAL_READ(LCD_DATA_PORT_IN);
+	HAL_CLEAR_BIT(LCD_CTRL_PORT,E); /* disable LCD E=0 */
+	LCD_HOLD_DELAY();
 
-	/* out the lowest 4 bits of the required data to the data bus D4 --> D7
-	 *
-	 * Ex : data 0x28 (0010 1000 )
-	 * send ( 1000 )
-	 * */
+#if (DATA_BITS_MODE == 4)
+	/* Busy Flag is in the first nibble , read the second nibble too */
+	HAL_SET_BIT(LCD_CTRL_PORT,E);
+	LCD_PULSE_DELAY();
+	HAL_CLEAR_BIT(LCD_CTRL_PORT,E);
+	LCD_HOLD_DELAY();
+	#ifndef UPPER_PORT_PINS
+		status <<= 4; /* DB7 is on the lowest 4 bits , move it to bit 7 */
+	#endif
+#endif
+
+	HAL_CLEAR_BIT(LCD_CTRL_PORT,RW);
+
+	/* Data pins as output pins again */
+#if (DATA_BITS_MODE == 4)
 	#ifdef UPPER_PORT_PINS
-	/*  LCD_DATA_PORT = ( 0000 xxxx ) 		   | ( 0000 1000 ) << 4) --> (1000 0000)  */
-		LCD_DATA_PORT = (LCD_DATA_PORT & 0x0F) | ((a_data & 0x0F) << 4 ) ;
+		HAL_OR(LCD_DATA_PORT_DIR, 0xF0);
 	#else
-	/*  LCD_DATA_PORT = ( xxxx 0000 ) 	       | (( 0000 1000 ) */
-		LCD_DATA_PORT = (LCD_DATA_PORT & 0xF0) | (a_data & 0x0F) ;
+		HAL_OR(LCD_DATA_PORT_DIR, 0x0F);
 	#endif
+#elif (DATA_BITS_MODE == 8)
+	HAL_WRITE(LCD_DATA_PORT_DIR, 0xFF);
+#endif
 
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	CLEAR_BIT(LCD_CTRL_PORT,E); /* disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
+	return BIT_IS_SET(status,7) ? TRUE : FALSE;
+#else
+	return FALSE;
+#endif
+}
+#endif
 
-/*********************** Sending Data DONE  ***********************/
+/*
+ * Description: Function returns the number of free entries in the queue
+ * 				(255 if LCD_ASYNC is FALSE , writes never wait the queue)
+ */
+static uint8 LCD_queueFree(void)
+{
+#if (LCD_ASYNC == TRUE)
+	if(g_lcdAsync)
+	{
+		return LCD_QUEUE_SIZE - (uint8)(g_lcdQueueHead - g_lcdQueueTail);
+	}
+#endif
+	return 0xFF;
+}
 
-	/* Commands flow with 8-bits Mode*/
-#elif (DATA_BITS_MODE == 8)
+#if (LCD_ASYNC == TRUE)
+/*
+ * Description: Function to add a command / character to the queue
+ * 				wait only if the queue is full
+ */
+static void LCD_enqueue(uint16 a_entry)
+{
+	uint8 head = g_lcdQueueHead;
+
+	/* Queue Full => wait TIMER0 ISR to write one byte */
+	while((uint8)(head - g_lcdQueueTail) >= LCD_QUEUE_SIZE)
+	{
+		POWER_sleep();
+	}
+
+	g_lcdQueue[head & LCD_QUEUE_MASK] = a_entry;
+	g_lcdQueueHead = head + 1;
 
-	LCD_DATA_PORT = a_data; /* out the required data to the data bus D0 --> D7 */
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	CLEAR_BIT(LCD_CTRL_PORT,E); /* disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
+	/* TIMER0 stopped => start it again */
+	if(g_lcdIdle)
+	{
+		g_lcdIdle = FALSE;
+		Timer0_restartTimer();
+	}
+}
+#endif
+
+/*
+ * Description: Call Back Function of TIMER0 Compare ISR => write one queued byte
+ * 	1. Wait the execution time of the previous instruction
+ * 	   (hold ticks in US_DELAY mode , Busy Flag in BUSY_FLAG mode).
+ * 	2. Write the next byte , RS from the queue entry.
+ * 	3. Queue empty => stop TIMER0.
+ */
+void LCD_asyncTick(void)
+{
+#if (LCD_ASYNC == TRUE)
+	uint8 tail = g_lcdQueueTail;
+	uint16 entry;
+
+	if(g_lcdHoldTicks != 0)
+	{
+		g_lcdHoldTicks--;
+		return;
+	}
+
+	if(tail == g_lcdQueueHead)
+	{
+		/* Nothing to write */
+		Timer0_stopTimer();
+		g_lcdIdle = TRUE;
+		return;
+	}
+
+	if(LCD_isBusy() && (g_lcdBusyTicks < LCD_ASYNC_MAX_BUSY_TICKS))
+	{
+		/* try again next tick , bounded if the LCD is not connected */
+		g_lcdBusyTicks++;
+		return;
+	}
+	g_lcdBusyTicks = 0;
+
+	entry = g_lcdQueue[tail & LCD_QUEUE_MASK];
+	g_lcdQueueTail = tail + 1;
+
+	if(entry & LCD_QUEUE_RS)
+	{
+		HAL_SET_BIT(LCD_CTRL_PORT,RS); /* Data Mode RS=1 */
+	}
+	else
+	{
+		HAL_CLEAR_BIT(LCD_CTRL_PORT,RS); /* Instruction Mode RS=0 */
+	}
+	HAL_CLEAR_BIT(LCD_CTRL_PORT,RW); /* write data to LCD so RW=0 */
+	LCD_writeBus((uint8)entry);
+
+#if (LCD_TIMING_MODE == LCD_TIMING_US_DELAY)
+	/* Clear Display / Return Home need more than one tick */
+	if((entry & (LCD_QUEUE_RS | 0xFC)) == 0)
+	{
+		g_lcdHoldTicks = LCD_CLEAR_EXEC_TICKS;
+	}
+#endif
+#endif
+}
+
+/*
+ * Description: Function returns TRUE while the queue has bytes not written
+ * 				to LCD yet (always FALSE if LCD_ASYNC is FALSE)
+ */
+bool LCD_isQueueBusy(void)
+{
+#if (LCD_ASYNC == TRUE)
+	return (g_lcdQueueHead != g_lcdQueueTail) ? TRUE : FALSE;
+#else
+	return FALSE;
 #endif
 }
 
@@ -197,6 +484,22 @@ void LCD_displayString(const char *Str_ptr)
 	}		
 }
 
+/*
+ * Description: Function to display a string stored in flash on LCD
+ */
+void LCD_displayString_P(const char *Str_ptr)
+{
+	uint8 data = pgm_read_byte(Str_ptr);
+
+	while(data != '\0')
+	{
+		/* Send String Character by Character from the flash */
+		LCD_displayCharacter(data);
+		Str_ptr++;
+		data = pgm_read_byte(Str_ptr);
+	}
+}
+
 /*
  * Description: Function to set Cursor at specific row and column
  */
@@ -219,6 +522,10 @@ void LCD_goToRowColumn(uint8 a_row,uint8 a_col)
 		case 3:
 			a_address = a_col + FORTH_ROW;
 				break;
+		default:
+			/* no such row , first row */
+			a_address = a_col + FIRST_ROW;
+				break;
 	}					
 	/* to write to a specific address in the LCD 
 	 * we need to apply the corresponding command 0b10000000+Address */
@@ -230,8 +537,22 @@ void LCD_goToRowColumn(uint8 a_row,uint8 a_col)
  */
 void LCD_displayStringRowColumn(uint8 a_row,uint8 a_col,const char *Str_ptr)
 {
+	PROF_BEGIN(PROF_ZONE_LCD_STRING);
 	LCD_goToRowColumn(a_row,a_col); /* go to to the required LCD position */
 	LCD_displayString(Str_ptr); /* display the string */
+	PROF_END(PROF_ZONE_LCD_STRING);
+}
+
+/*
+ * Description: Function to display a string stored in flash at specific
+ * 				row and column
+ */
+void LCD_displayStringRowColumn_P(uint8 a_row,uint8 a_col,const char *Str_ptr)
+{
+	PROF_BEGIN(PROF_ZONE_LCD_STRING);
+	LCD_goToRowColumn(a_row,a_col); /* go to to the required LCD position */
+	LCD_displayString_P(Str_ptr); /* display the string */
+	PROF_END(PROF_ZONE_LCD_STRING);
 }
 
 /*
@@ -249,5 +570,189 @@ void LCD_intgerToString(int a_data,int a_numberBase)
  */
 void LCD_clearScreen(void)
 {
+	uint8 row,col;
+
 	LCD_sendCommand(CLEAR_COMMAND); //clear display 
+
+	/* LCD shows spaces now */
+	for(row=0;row<LCD_ROWS;row++)
+	{
+		for(col=0;col<LCD_COLS;col++)
+		{
+			g_lcdCells[row][col] = ' ';
+		}
+	}
+}
+
+/*
+ * Description: Function to clear the frame buffer (all cells = ' ')
+ */
+void LCD_bufferClear(void)
+{
+	uint8 row,col;
+	for(row=0;row<LCD_ROWS;row++)
+	{
+		for(col=0;col<LCD_COLS;col++)
+		{
+			g_frameBuffer[row][col] = ' ';
+		}
+	}
+}
+
+/*
+ * Description: Function to draw a character in the frame buffer
+ */
+void LCD_bufferCharacter(uint8 a_row,uint8 a_col,uint8 a_data)
+{
+	if((a_row < LCD_ROWS) && (a_col < LCD_COLS))
+	{
+		g_frameBuffer[a_row][a_col] = a_data;
+	}
+}
+
+/*
+ * Description: Function to draw a string in the frame buffer at specific
+ * 				row and column , clipped at the end of the row
+ */
+void LCD_bufferStringRowColumn(uint8 a_row,uint8 a_col,const char *Str_ptr)
+{
+	if(a_row >= LCD_ROWS)
+	{
+		return;
+	}
+	while(((*Str_ptr) != '\0') && (a_col < LCD_COLS))
+	{
+		g_frameBuffer[a_row][a_col] = *Str_ptr;
+		a_col++;
+		Str_ptr++;
+	}
+}
+
+/*
+ * Description: Function to draw a string stored in flash in the frame buffer
+ * 				at specific row and column , clipped at the end of the row
+ */
+void LCD_bufferStringRowColumn_P(uint8 a_row,uint8 a_col,const char *Str_ptr)
+{
+	uint8 data;
+
+	if(a_row >= LCD_ROWS)
+	{
+		return;
+	}
+	data = pgm_read_byte(Str_ptr);
+	while((data != '\0') && (a_col < LCD_COLS))
+	{
+		g_frameBuffer[a_row][a_col] = data;
+		a_col++;
+		Str_ptr++;
+		data = pgm_read_byte(Str_ptr);
+	}
+}
+
+/*
+ * Description: Function to send the changed cells of the frame buffer to LCD
+ * 	1. Count the bus transactions of a cells diff and of CLEAR_COMMAND
+ * 	   followed by the non-space cells , use the cheaper one.
+ * 	2. Send the changed cells , see LCD_flushCells().
+ * 	   In Asynchronous Mode stop when the queue is full.
+ * 	returns number of bus transactions (commands + characters)
+ */
+uint8 LCD_flush(void)
+{
+	uint8 diffCost = LCD_flushCells(FALSE,FALSE);
+	uint8 clearCost;
+
+	if(diffCost == 0)
+	{
+		return 0;
+	}
+
+	clearCost = 1 + LCD_flushCells(FALSE,TRUE);
+	if((clearCost < diffCost) && (LCD_queueFree() >= clearCost))
+	{
+		LCD_clearScreen();
+		return 1 + LCD_flushCells(TRUE,FALSE);
+	}
+	return LCD_flushCells(TRUE,FALSE);
+}
+
+/*
+ * Description: Function to compare the frame buffer with the LCD cells
+ * 				(or with a cleared LCD if a_cleared = TRUE)
+ * 	1. Move the cursor only at the start of a run of changed cells ,
+ * 	   LCD address is incremented after every character.
+ * 	2. Gaps of LCD_FLUSH_MAX_GAP unchanged cells are rewritten to keep
+ * 	   the run , instead of a new SET_CURSOR_LOCATION command.
+ * 	a_send = FALSE => count the bus transactions only
+ * 	returns number of bus transactions (commands + characters)
+ */
+static uint8 LCD_flushCells(bool a_send,bool a_cleared)
+{
+	uint8 row,col,cell;
+	uint8 cursor; /* LCD cursor column in this row , LCD_COLS => unknown */
+	uint8 transactions = 0;
+
+	for(row=0;row<LCD_ROWS;row++)
+	{
+		cursor = LCD_COLS;
+		for(col=0;col<LCD_COLS;col++)
+		{
+			cell = a_cleared ? ' ' : g_lcdCells[row][col];
+			if(g_frameBuffer[row][col] == cell)
+			{
+				continue;
+			}
+
+			/* Queue can't take this cell => stop , cell is still changed */
+			if(a_send && (LCD_queueFree() < (LCD_FLUSH_MAX_GAP + 2)))
+			{
+				return transactions;
+			}
+
+			if((cursor < col) && ((col - cursor) <= LCD_FLUSH_MAX_GAP))
+			{
+				/* rewrite the unchanged gap cells , cheaper than moving */
+				transactions += col - cursor;
+				while(a_send && (cursor < col))
+				{
+					LCD_displayCharacter(g_lcdCells[row][cursor]);
+					cursor++;
+				}
+			}
+			else if(cursor != col)
+			{
+				if(a_send)
+				{
+					LCD_goToRowColumn(row,col);
+				}
+				transactions++;
+			}
+
+			if(a_send)
+			{
+				LCD_displayCharacter(g_frameBuffer[row][col]);
+				g_lcdCells[row][col] = g_frameBuffer[row][col];
+			}
+			cursor = col + 1;
+			transactions++;
+		}
+	}
+	return transactions;
+}
+
+/*
+ * Description: Function to force the next LCD_flush() to redraw all cells
+ */
+void LCD_invalidate(void)
+{
+	uint8 row,col;
+	for(row=0;row<LCD_ROWS;row++)
+	{
+		for(col=0;col<LCD_COLS;col++)
+		{
+			/* no printable character => every cell differs */
+			g_lcdCells[row][col] = 0xFF;
+		}
+	}
 }
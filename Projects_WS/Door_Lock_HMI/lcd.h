@@ -13,13 +13,17 @@
 #include "std_types.h"
 #include "common_macros.h"
 #include "micro_config.h"
+#include "timer.h"
+#include <avr/pgmspace.h>
 
 /*******************************************************************************
  *                 Preprocessor Macros Configuration                           *
  *******************************************************************************/
 
 /* LCD Data bits mode configuration */
+#ifndef DATA_BITS_MODE
 #define DATA_BITS_MODE 8
+#endif
 
 /* Use higher 4 bits in the data port */
 #if (DATA_BITS_MODE == 4)
@@ -34,12 +38,101 @@
 #define LCD_CTRL_PORT_DIR			 	DDRD
 #define LCD_DATA_PORT 					PORTB
 #define LCD_DATA_PORT_DIR				DDRB
+#define LCD_DATA_PORT_IN				PINB
+
+/* LCD Timing Mode :
+ * LCD_TIMING_FIXED_DELAY => 1 ms delay around every E strobe (old driver)
+ * LCD_TIMING_BUSY_FLAG   => read Busy Flag (RW pin must be connected)
+ * LCD_TIMING_US_DELAY    => us delays from Datasheet , for boards with RW tied to GND
+ */
+#define LCD_TIMING_FIXED_DELAY			0
+#define LCD_TIMING_BUSY_FLAG			1
+#define LCD_TIMING_US_DELAY				2
+
+#ifndef LCD_TIMING_MODE
+#define LCD_TIMING_MODE					LCD_TIMING_BUSY_FLAG
+#endif
+
+/* Asynchronous Mode : after LCD_init() , commands and characters are added
+ * to a queue and TIMER0 Compare ISR writes one byte every LCD_ASYNC_TICK_US
+ * So LCD functions don't wait the LCD (only if the queue is full) */
+#ifndef LCD_ASYNC
+#define LCD_ASYNC						TRUE
+#endif
+
+/* Queue Size , must be power of two */
+#ifndef LCD_QUEUE_SIZE
+#define LCD_QUEUE_SIZE					32
+#endif
+
+/* TIMER0 tick , must be > LCD_EXEC_US */
+#define LCD_ASYNC_TICK_US				100
+
+/* LCD Size , up to 4 rows * 20 columns */
+#ifndef LCD_ROWS
+#define LCD_ROWS						2
+#endif
 
+#ifndef LCD_COLS
+#define LCD_COLS						16
+#endif
+
+/* Max. unchanged cells rewritten by LCD_flush() instead of sending
+ * SET_CURSOR_LOCATION , one cell costs the same bus time as one command */
+#define LCD_FLUSH_MAX_GAP				1
+
+#if ((LCD_ROWS > 4) || (LCD_COLS > 20))
+#error "LCD Size is up to 4 rows * 20 columns"
+#endif
+
+#if ((LCD_ASYNC == TRUE) && (LCD_TIMING_MODE == LCD_TIMING_FIXED_DELAY))
+#error "LCD_ASYNC needs LCD_TIMING_BUSY_FLAG or LCD_TIMING_US_DELAY"
+#endif
+
+#if ((LCD_QUEUE_SIZE & (LCD_QUEUE_SIZE - 1)) != 0)
+#error "LCD_QUEUE_SIZE must be power of two"
+#endif
 
 /*******************************************************************************
  *                      Preprocessor Macros                                    *
  *******************************************************************************/
 
+/* LCD Timing , E strobe delays */
+#if (LCD_TIMING_MODE == LCD_TIMING_FIXED_DELAY)
+#define LCD_SETUP_DELAY()				_delay_ms(1)
+#define LCD_PULSE_DELAY()				_delay_ms(1)
+#define LCD_HOLD_DELAY()				_delay_ms(1)
+#else
+/* Tas , Tdsw , Tpw , Tddr are < 500ns => 1 us is enough @ any F_CPU */
+#define LCD_SETUP_DELAY()				_delay_us(1)
+#define LCD_PULSE_DELAY()				_delay_us(1)
+#define LCD_HOLD_DELAY()
+#endif
+
+/* LCD Timing , instructions execution time (US_DELAY mode) */
+#define LCD_EXEC_US						40
+#define LCD_CLEAR_EXEC_US				1640
+
+/* LCD Timing , power on and Function Set time (before Busy Flag is valid) */
+#define LCD_POWER_ON_MS					40
+#define LCD_CONFIG_EXEC_MS				2
+
+/* LCD Queue , entry = (RS << 8) | byte */
+#define LCD_QUEUE_MASK					(LCD_QUEUE_SIZE - 1)
+#define LCD_QUEUE_RS					0x0100
+
+/* TIMER0 Compare Value , F_CPU/8 clock => 1 count = 1 us @ 8Mhz */
+#define LCD_ASYNC_TICK_OCR				((uint8)(((F_CPU / 8UL / 1000UL) * LCD_ASYNC_TICK_US / 1000UL) - 1))
+
+/* TIMER0 ticks to wait after Clear Display / Return Home (US_DELAY mode) */
+#define LCD_CLEAR_EXEC_TICKS			((LCD_CLEAR_EXEC_US / LCD_ASYNC_TICK_US) + 1)
+
+/* Max. TIMER0 ticks waiting the Busy Flag before writing anyway (> 1.64 ms) */
+#define LCD_ASYNC_MAX_BUSY_TICKS		((LCD_CLEAR_EXEC_US / LCD_ASYNC_TICK_US) + 2)
+
+/* Max. Busy Flag reads (~3 us each) before LCD_waitReady gives up , > 1.64 ms */
+#define LCD_BUSY_MAX_POLLS				1000
+
 /* LCD Commands */
 #define CLEAR_COMMAND 					0x01
 #define TWO_LINE_LCD_Eight_BIT_MODE 	0x38
@@ -55,8 +148,8 @@
 /* LCD Addresses */
 #define FIRST_ROW						0x00
 #define SECOND_ROW						0x40
-#define THIRD_ROW						0x10
-#define FORTH_ROW						0x50
+#define THIRD_ROW						(0x00 + LCD_COLS)
+#define FORTH_ROW						(0x40 + LCD_COLS)
 
 /* Numbers Base */
 #define DECIMAL 						(10)
@@ -84,6 +177,12 @@ void LCD_displayCharacter(uint8 a_data);
  */
 void LCD_displayString(const char *Str_ptr);
 
+/*
+ * Description: Function to display a string stored in flash (PROGMEM / PSTR)
+ * 				on LCD , read byte by byte , no RAM copy
+ */
+void LCD_displayString_P(const char *Str_ptr);
+
 /*
  * Description: Function to initialize LCD after select LCD pins in lcd.h file
  */
@@ -99,6 +198,12 @@ void LCD_clearScreen(void);
  */
 void LCD_displayStringRowColumn(uint8 a_row,uint8 a_col,const char *Str_ptr);
 
+/*
+ * Description: Function to display a string stored in flash at specific
+ * 				row and column
+ */
+void LCD_displayStringRowColumn_P(uint8 a_row,uint8 a_col,const char *Str_ptr);
+
 /*
  * Description: Function to set Cursor at specific row and column
  */
@@ -109,6 +214,60 @@ void LCD_goToRowColumn(uint8 a_row,uint8 a_col);
  */
 void LCD_intgerToString(int a_data,int a_numberBase);
 
+/*
+ * Frame Buffer Functions :
+ * The application draws into a RAM copy of the screen , then LCD_flush()
+ * sends only the cells that differ from what the LCD shows now.
+ * Don't mix them with LCD_displayString / LCD_goToRowColumn on the same
+ * screen , direct writes are not known by the frame buffer.
+ */
+
+/*
+ * Description: Function to clear the frame buffer (all cells = ' ')
+ */
+void LCD_bufferClear(void);
+
+/*
+ * Description: Function to draw a character in the frame buffer
+ */
+void LCD_bufferCharacter(uint8 a_row,uint8 a_col,uint8 a_data);
+
+/*
+ * Description: Function to draw a string in the frame buffer at specific
+ * 				row and column , clipped at the end of the row
+ */
+void LCD_bufferStringRowColumn(uint8 a_row,uint8 a_col,const char *Str_ptr);
+
+/*
+ * Description: Function to draw a string stored in flash in the frame buffer
+ * 				at specific row and column , clipped at the end of the row
+ */
+void LCD_bufferStringRowColumn_P(uint8 a_row,uint8 a_col,const char *Str_ptr);
+
+/*
+ * Description: Function to send the changed cells of the frame buffer to LCD
+ * 				returns number of bus transactions (commands + characters)
+ * 				In Asynchronous Mode only the cells that fit in the queue are
+ * 				sent , the rest are sent by the next LCD_flush()
+ */
+uint8 LCD_flush(void);
+
+/*
+ * Description: Function to force the next LCD_flush() to redraw all cells
+ */
+void LCD_invalidate(void);
+
+/*
+ * Description: Function returns TRUE while the queue has bytes not written
+ * 				to LCD yet (always FALSE if LCD_ASYNC is FALSE)
+ */
+bool LCD_isQueueBusy(void);
+
+/*
+ * Description: Call Back Function of TIMER0 Compare ISR => write one queued byte
+ */
+void LCD_asyncTick(void);
+
 /*
  * Description: Function to Convert integer to ASCII from stdlib
  */
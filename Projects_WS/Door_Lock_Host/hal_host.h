@@ -0,0 +1,215 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - ATmega16 Model
+ * File Name: 	hal_host.h
+ * Description: Linux backend of the HAL (HOST_BUILD) and the interface of the
+ * 				ATmega16 model for the simulated devices
+ *
+ * Notes:		- Virtual Clock : every register access is 1 CPU cycle ,
+ * 				  _delay_us() / _delay_ms() are their avr-libc cycles , ISR entry
+ * 				  and RETI are 4 cycles each , sleep_cpu() jumps to the next
+ * 				  event . The code between two register accesses takes no
+ * 				  virtual time (the model doesn't execute AVR instructions)
+ *
+ * 				- Peripherals (host_mcu.c) :
+ * 				  	TIMER0/1/2 => Normal , CTC , Fast PWM , compare / overflow
+ * 				  	              flags and interrupts , all prescalers
+ * 				  	USART      => baud rate from UBRR / U2X , UDR buffer + shift
+ * 				  	              register , 2 bytes RX FIFO (DOR on overrun) ,
+ * 				  	              RXC / UDRE / TXC interrupts
+ * 				  	TWI        => Master Transmitter / Receiver , SCL from
+ * 				  	              TWBR / TWPS , slave devices by HOST_twiAttach()
+ * 				  	GPIO       => PINx = outputs + levels of the input pins from
+ * 				  	              the device hook (default : internal pull-ups)
+ *
+ * 				- Environment :
+ * 				  	HOST_RUN_MS = n => stop after n ms of virtual time and print
+ * 				  	                   the report (default : run forever)
+ * 				  	HOST_TRACE  = 1 => print the USART TX bytes
+ *
+ * 				- Co-simulation (host_cosim.c) : each ECU is a shared object
+ * 				  with its own model , HOST_setSyncTime() stops its clock at
+ * 				  the sync time and calls the Sync Hook , HOST_powerOn()
+ * 				  starts the clock of a reloaded ECU at the co-simulation time
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef HAL_HOST_H_
+#define HAL_HOST_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                      HAL Backend (hal.h)                                    *
+ *******************************************************************************/
+
+	#define HAL_READ(REG) 				HOST_read8(REG)
+	#define HAL_WRITE(REG,VALUE) 		HOST_write8((REG),(uint8)(VALUE))
+	#define HAL_READ16(REG) 			HOST_read16(REG)
+	#define HAL_WRITE16(REG,VALUE) 		HOST_write16((REG),(uint16)(VALUE))
+	#define HAL_OR(REG,MASK) 			HOST_write8((REG),(uint8)(HOST_read8(REG) | (MASK)))
+	#define HAL_AND(REG,MASK) 			HOST_write8((REG),(uint8)(HOST_read8(REG) & (MASK)))
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* TWI Slave Device , s_Address / s_AddressMask select the SLA bytes it answers
+ * ex: 24C16 => s_Address = 0xA0 , s_AddressMask = 0xF0 (0xA0 .. 0xAE) */
+typedef struct
+{
+	uint8 s_Address ;
+	uint8 s_AddressMask ;
+
+	/* SLA+R/W byte after (Repeated) Start , return TRUE to ACK */
+	bool (*s_start)(uint8 sla);
+
+	/* Master Transmitter : data byte , return TRUE to ACK */
+	bool (*s_write)(uint8 data);
+
+	/* Master Receiver : next data byte , ack = master ACK (TWEA) */
+	uint8 (*s_read)(bool ack);
+
+	/* Stop condition */
+	void (*s_stop)(void);
+}HOST_TwiDeviceType;
+
+/* GPIO Device Hooks , port = 'A' .. 'D' (same as gpio.h) */
+/* Levels of the input pins driven by the device (ddr = 0 bits) */
+typedef uint8 (*HOST_PinHook)(uint8 port, uint8 ddr, uint8 out);
+/* Called after every write to PORTx / DDRx */
+typedef void (*HOST_PortHook)(uint8 port, uint8 ddr, uint8 out);
+
+typedef struct
+{
+	/* Virtual time since the power on in CPU cycles */
+	uint64 s_Cycles ;
+
+	/* Cycles in sleep_cpu() and number of sleeps */
+	uint64 s_SleepCycles ;
+	uint32 s_Sleeps ;
+
+	/* Cycles in ISRs (entry + body + RETI) and ISRs served */
+	uint64 s_IsrCycles ;
+	uint32 s_Isrs ;
+
+	/* Register accesses */
+	uint64 s_IoAccesses ;
+
+	/* USART bytes and RX overruns (DOR) */
+	uint32 s_UartTx ;
+	uint32 s_UartRx ;
+	uint32 s_UartOverruns ;
+
+	/* TWI bytes (address + data) */
+	uint32 s_TwiBytes ;
+}HOST_StatsType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/* Register Access , REG = I/O address (avr/io.h) */
+uint8 HOST_read8(uint8 address);
+void HOST_write8(uint8 address, uint8 value);
+uint16 HOST_read16(uint8 address);
+void HOST_write16(uint8 address, uint16 value);
+
+/*
+ * Description: Function returns a register without side effects and
+ * 				without virtual time (devices , co-simulation)
+ */
+uint8 HOST_peek(uint8 address);
+
+/*
+ * Description: Function to advance the virtual clock (busy wait) ,
+ * 				the interrupts are served if the I-bit is set
+ */
+void HOST_delayCycles(uint64 cycles);
+
+/*
+ * Description: sleep_cpu() , jump to the next event and serve its interrupt
+ */
+void HOST_sleep(void);
+
+/*
+ * Description: Function returns the virtual time in CPU cycles
+ */
+uint64 HOST_cycles(void);
+
+/*
+ * Description: Function to copy the model statistics
+ */
+void HOST_getStats(HOST_StatsType *stats);
+
+/*
+ * Description: Function to print the statistics (stderr) , the duty cycle
+ * 				and the mean supply current of the MCU (Active / Idle)
+ */
+void HOST_report(const char *name);
+
+/*
+ * Description: Function to add a Report Hook , called at the end of
+ * 				HOST_report() to print the firmware statistics (Profiler ,
+ * 				ISR Statistics)
+ */
+void HOST_addReportHook(void (*a_hook)(const char *name));
+
+/*
+ * Description: Function returns the entry latency of the running ISR in
+ * 				cycles , from the event that raised its flag (timer match ,
+ * 				stop bit of the oldest RX byte , TWINT) to its first instruction
+ */
+uint32 HOST_isrLatency(void);
+
+/*
+ * Description: Function to set the USART TX Hook , called when a byte is
+ * 				loaded to the shift register , cycle = end of its stop bit
+ */
+void HOST_uartSetTxHook(void (*a_hook)(uint8 data, uint64 cycle));
+
+/*
+ * Description: Function to receive a byte at a virtual time (>= now) ,
+ * 				the bytes must be queued in time order
+ *
+ * Return: FALSE if the queue is full
+ */
+bool HOST_uartReceiveAt(uint8 data, uint64 cycle);
+
+/*
+ * Description: Function returns the cycles of one USART frame
+ * 				(start + data + parity + stop bits)
+ */
+uint32 HOST_uartFrameCycles(void);
+
+/*
+ * Description: Function to attach a TWI slave device (up to 4)
+ */
+void HOST_twiAttach(const HOST_TwiDeviceType *device);
+
+/*
+ * Description: Function to set the Sync Hook , called when the virtual clock
+ * 				reaches the sync time , it must set a later sync time
+ */
+void HOST_setSyncHook(void (*a_hook)(void));
+
+/*
+ * Description: Function to set the next sync time (virtual cycle)
+ */
+void HOST_setSyncTime(uint64 cycle);
+
+/*
+ * Description: Function to start the virtual clock at cycle , before
+ * 				main() (an ECU reset in the co-simulation) , the statistics
+ * 				count from the power on
+ */
+void HOST_powerOn(uint64 cycle);
+
+/*
+ * Description: Function to set the device hooks of a port
+ */
+void HOST_gpioSetHooks(uint8 port, HOST_PinHook a_pinHook, HOST_PortHook a_portHook);
+
+#endif /* HAL_HOST_H_ */
@@ -0,0 +1,433 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Co-simulation
+ * File Name: 	host_cosim.c
+ * Description: Source file of the two ECUs co-simulation , loads the HMI and
+ * 				Control firmware , runs them in lockstep and connects their
+ * 				USARTs by the virtual serial link
+ *
+ * Usage:		Door_Lock_Cosim [-v] [-p] [-d link_delay_us] [-L so_dir] [scenario ...]
+ * 				no scenario => all scenarios but the long ones (day) , each
+ * 				one in a new process (fresh firmware , models and devices) ,
+ * 				-p => model reports of both ECUs after each scenario
+ * 				(+ Profiling Zones of a PROF=1 build)
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_cosim.h"
+#include <dlfcn.h>
+#include <libgen.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+COSIM_EcuType g_cosimEcus[COSIM_ECUS_NUM] =
+{
+	{ .s_Name = "Door_Lock_HMI" },
+	{ .s_Name = "Door_Lock_Control" }
+};
+
+bool g_cosimVerbose = FALSE ;
+static bool g_report = FALSE ;
+
+static uint64 g_now = 0 ;
+static uint64 g_linkDelay = 0 ;
+static char g_soDir[PATH_MAX] ;
+
+static ucontext_t g_mainContext ;
+static COSIM_EcuType *g_running = NULL_PTR ;
+
+/* Link bytes and bytes lost by a baud rate mismatch / late delivery */
+static uint32 g_linkBytes = 0 ;
+static uint32 g_linkMismatch = 0 ;
+static uint32 g_linkLate = 0 ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void COSIM_load(COSIM_EcuType *ecu);
+static void COSIM_start(COSIM_EcuType *ecu);
+static void COSIM_entry(void);
+static void COSIM_resume(COSIM_EcuType *ecu, uint64 cycle);
+static void COSIM_syncHook(void);
+static void COSIM_txHook(uint8 data, uint64 cycle);
+static uint64 COSIM_quantum(void);
+static int COSIM_scenario(const char *name);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(int argc, char *argv[])
+{
+	char exe[PATH_MAX] ;
+	struct timespec start , end ;
+	double wallMs ;
+	uint8 failed = 0 , runs = 0 ;
+	uint8 i;
+	int opt ;
+	ssize_t length ;
+
+	/* Shared objects next to the executable by default */
+	length = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+	exe[(length > 0) ? length : 0] = '\0' ;
+	snprintf(g_soDir, sizeof(g_soDir), "%s", (length > 0) ? dirname(exe) : ".");
+
+	while((opt = getopt(argc, argv, "vpd:L:")) != -1)
+	{
+		switch(opt)
+		{
+		case 'v':	g_cosimVerbose = TRUE ;	break;
+		case 'p':	g_report = TRUE ;	break;
+		case 'd':	g_linkDelay = (uint64)atol(optarg) * (F_CPU / 1000000UL) ;	break;
+		case 'L':	snprintf(g_soDir, sizeof(g_soDir), "%s", optarg);	break;
+		default:
+			fprintf(stderr, "usage: %s [-v] [-p] [-d link_delay_us] [-L so_dir] [scenario ...]\n", argv[0]);
+			fprintf(stderr, "scenarios:");
+			for(i = 0 ; i < SCEN_count() ; i++)
+				fprintf(stderr, " %s", SCEN_name(i));
+			fprintf(stderr, "\n");
+			return 2 ;
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	if(optind < argc)
+	{
+		for( ; optind < argc ; optind++, runs++)
+			failed += (COSIM_scenario(argv[optind]) != 0) ;
+	}
+	else
+	{
+		for(i = 0 ; i < SCEN_count() ; i++)
+		{
+			if(SCEN_isLong(i))
+				continue;
+			failed += (COSIM_scenario(SCEN_name(i)) != 0) ;
+			runs++ ;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	wallMs = (double)(end.tv_sec - start.tv_sec) * 1000.0
+			+ (double)(end.tv_nsec - start.tv_nsec) / 1000000.0 ;
+	printf("COSIM: %u/%u scenarios passed in %.1f ms wall\n", runs - failed, runs, wallMs);
+	return (failed == 0) ? 0 : 1 ;
+}
+
+/*
+ * Description: Function returns the co-simulation time in ms
+ */
+double COSIM_ms(uint64 cycle)
+{
+	return (double)cycle * 1000.0 / F_CPU ;
+}
+
+/*
+ * Description: Function returns the co-simulation time in CPU cycles
+ */
+uint64 COSIM_now(void)
+{
+	return g_now ;
+}
+
+/*
+ * Description: Function to run both ECUs up to the cycle , quantum by quantum
+ */
+bool COSIM_runUntil(uint64 cycle)
+{
+	uint64 quantum ;
+	uint8 i;
+
+	while(g_now < cycle)
+	{
+		quantum = COSIM_quantum() ;
+		g_now = (cycle - g_now < quantum) ? cycle : (g_now + quantum) ;
+
+		for(i = 0 ; i < COSIM_ECUS_NUM ; i++)
+		{
+			COSIM_resume(&g_cosimEcus[i], g_now);
+			if(g_cosimEcus[i].s_Exited)
+			{
+				printf("COSIM: %s main() returned @ %.3f ms\n", g_cosimEcus[i].s_Name, COSIM_ms(g_now));
+				return FALSE ;
+			}
+		}
+		DEV_update(g_now);
+	}
+	return TRUE ;
+}
+
+/*
+ * Description: Function to reset an ECU , the suspended context of the old
+ * 				firmware is dropped , the new one starts at the next resume
+ */
+void COSIM_reset(uint8 ecu)
+{
+	COSIM_EcuType *model = &g_cosimEcus[ecu] ;
+
+	dlclose(model->s_Handle);
+	free(model->s_Stack);
+	model->s_Exited = FALSE ;
+
+	/* A copy still mapped keeps the RAM of the old firmware */
+	COSIM_load(model);
+	if((*model->s_cycles)() != 0)
+	{
+		fprintf(stderr, "COSIM: %s wasn't unloaded\n", model->s_Name);
+		_exit(2);
+	}
+	DEV_connect(ecu);
+	COSIM_start(model);
+	(*model->s_powerOn)(g_now);
+
+	if(g_cosimVerbose)
+		printf("%12.3f ms RESET  %s\n", COSIM_ms(g_now), model->s_Name);
+}
+
+/*
+ * Description: Function to send a frame to an ECU like a debug tool on its
+ * 				link , one frame time (ECU baud rate) per byte
+ */
+uint64 COSIM_sendFrame(uint8 ecu, uint8 command, const uint8 *payload, uint8 length)
+{
+	COSIM_EcuType *model = &g_cosimEcus[ecu] ;
+	uint8 buffer[FRAME_MAX_PAYLOAD + FRAME_OVERHEAD] ;
+	uint64 frame = (*model->s_uartFrameCycles)() ;
+	uint8 size = (*model->s_frameEncode)(command, payload, length, buffer) ;
+	uint8 i;
+
+	if(g_cosimVerbose)
+		printf("%12.3f ms TOOL   -> %s %02X\n", COSIM_ms(g_now), model->s_Name, command);
+
+	for(i = 0 ; i < size ; i++)
+		(*model->s_uartReceiveAt)(buffer[i], g_now + (i + 1) * frame);
+	return g_now + size * frame ;
+}
+
+/*
+ * Description: Function to run one scenario in a new process
+ *
+ * Return: exit status of the scenario process , 0 = passed
+ */
+static int COSIM_scenario(const char *name)
+{
+	struct timespec start , end ;
+	HOST_StatsType stats ;
+	double wallMs ;
+	int status ;
+	pid_t pid ;
+	uint8 i;
+
+	fflush(stdout);
+	pid = fork();
+	if(pid < 0)
+	{
+		perror("fork");
+		return 1 ;
+	}
+	if(pid > 0)
+	{
+		waitpid(pid, &status, 0);
+		return WIFEXITED(status) ? WEXITSTATUS(status) : 1 ;
+	}
+
+	for(i = 0 ; i < COSIM_ECUS_NUM ; i++)
+		COSIM_load(&g_cosimEcus[i]);
+	DEV_init();
+	for(i = 0 ; i < COSIM_ECUS_NUM ; i++)
+		COSIM_start(&g_cosimEcus[i]);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	status = SCEN_run(name) ? 0 : 1 ;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	wallMs = (double)(end.tv_sec - start.tv_sec) * 1000.0
+			+ (double)(end.tv_nsec - start.tv_nsec) / 1000000.0 ;
+	printf("COSIM: %-14s %s  %9.3f s simulated in %8.3f ms wall (x%.0f)\n",
+			name, (status == 0) ? "PASS" : "FAIL", COSIM_ms(g_now) / 1000.0, wallMs,
+			(wallMs > 0.0) ? (COSIM_ms(g_now) / wallMs) : 0.0);
+
+	if(g_cosimVerbose || (status != 0))
+	{
+		for(i = 0 ; i < COSIM_ECUS_NUM ; i++)
+		{
+			(*g_cosimEcus[i].s_getStats)(&stats);
+			printf("COSIM:   %-18s sleep %5.1f %% , ISRs %u , TX %u RX %u overruns %u , TWI %u\n",
+					g_cosimEcus[i].s_Name,
+					(stats.s_Cycles > 0) ? (100.0 * (double)stats.s_SleepCycles / (double)stats.s_Cycles) : 0.0,
+					stats.s_Isrs, stats.s_UartTx, stats.s_UartRx, stats.s_UartOverruns, stats.s_TwiBytes);
+		}
+		printf("COSIM:   link %u bytes , %u baud mismatch , %u late\n",
+				g_linkBytes, g_linkMismatch, g_linkLate);
+	}
+
+	if(g_report)
+	{
+		fflush(stdout);
+		for(i = 0 ; i < COSIM_ECUS_NUM ; i++)
+			(*g_cosimEcus[i].s_report)(g_cosimEcus[i].s_Name);
+	}
+
+	/* The ECU contexts are left suspended , exit without their cleanup */
+	fflush(stdout);
+	_exit(status);
+}
+
+/*
+ * Description: Function to load the firmware shared object of an ECU ,
+ * 				RTLD_LOCAL => its own copy of the ATmega16 model
+ */
+static void COSIM_load(COSIM_EcuType *ecu)
+{
+	char path[PATH_MAX + 64] ;
+
+	snprintf(path, sizeof(path), "%s/%s.so", g_soDir, ecu->s_Name);
+	ecu->s_Handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	if(ecu->s_Handle == NULL_PTR)
+	{
+		fprintf(stderr, "COSIM: %s\n", dlerror());
+		_exit(2);
+	}
+
+#define COSIM_SYMBOL(field, name)	\
+	*(void **)(&ecu->field) = dlsym(ecu->s_Handle, name) ;	\
+	if(ecu->field == NULL_PTR) { fprintf(stderr, "COSIM: %s: no %s\n", path, name); _exit(2); }
+
+	COSIM_SYMBOL(s_main, "main");
+	COSIM_SYMBOL(s_peek, "HOST_peek");
+	COSIM_SYMBOL(s_cycles, "HOST_cycles");
+	COSIM_SYMBOL(s_getStats, "HOST_getStats");
+	COSIM_SYMBOL(s_report, "HOST_report");
+	COSIM_SYMBOL(s_uartSetTxHook, "HOST_uartSetTxHook");
+	COSIM_SYMBOL(s_uartReceiveAt, "HOST_uartReceiveAt");
+	COSIM_SYMBOL(s_uartFrameCycles, "HOST_uartFrameCycles");
+	COSIM_SYMBOL(s_twiAttach, "HOST_twiAttach");
+	COSIM_SYMBOL(s_gpioSetHooks, "HOST_gpioSetHooks");
+	COSIM_SYMBOL(s_setSyncHook, "HOST_setSyncHook");
+	COSIM_SYMBOL(s_setSyncTime, "HOST_setSyncTime");
+	COSIM_SYMBOL(s_powerOn, "HOST_powerOn");
+	COSIM_SYMBOL(s_frameEncode, "FRAME_encode");
+	COSIM_SYMBOL(s_frameDecode, "FRAME_decodeByte");
+#undef COSIM_SYMBOL
+}
+
+/*
+ * Description: Function to create the context of an ECU , main() starts at
+ * 				the first resume
+ */
+static void COSIM_start(COSIM_EcuType *ecu)
+{
+	ecu->s_Stack = malloc(COSIM_STACK_SIZE);
+	getcontext(&ecu->s_Context);
+	ecu->s_Context.uc_stack.ss_sp = ecu->s_Stack ;
+	ecu->s_Context.uc_stack.ss_size = COSIM_STACK_SIZE ;
+	ecu->s_Context.uc_link = &g_mainContext ;
+	makecontext(&ecu->s_Context, COSIM_entry, 0);
+
+	(*ecu->s_setSyncHook)(COSIM_syncHook);
+	(*ecu->s_uartSetTxHook)(COSIM_txHook);
+	(*ecu->s_setSyncTime)(0);
+}
+
+/*
+ * Description: First function of an ECU context
+ */
+static void COSIM_entry(void)
+{
+	COSIM_EcuType *ecu = g_running ;
+
+	(*ecu->s_main)();
+	ecu->s_Exited = TRUE ;
+}
+
+/*
+ * Description: Function to run an ECU until its virtual clock reaches the cycle
+ */
+static void COSIM_resume(COSIM_EcuType *ecu, uint64 cycle)
+{
+	if(ecu->s_Exited)
+		return ;
+
+	g_running = ecu ;
+	(*ecu->s_setSyncTime)(cycle);
+	swapcontext(&g_mainContext, &ecu->s_Context);
+	g_running = NULL_PTR ;
+}
+
+/*
+ * Description: Sync Hook of both models , the running ECU reached its sync time
+ */
+static void COSIM_syncHook(void)
+{
+	swapcontext(&g_running->s_Context, &g_mainContext);
+}
+
+/*
+ * Description: TX Hook of both models , the byte arrives at the peer at the
+ * 				end of its stop bit + link delay . A frame sent at another
+ * 				baud rate (out of the receiver tolerance) is lost
+ */
+static void COSIM_txHook(uint8 data, uint64 cycle)
+{
+	COSIM_EcuType *peer = &g_cosimEcus[(g_running == &g_cosimEcus[COSIM_HMI]) ? COSIM_CONTROL : COSIM_HMI] ;
+	uint32 sent = (*g_running->s_uartFrameCycles)() ;
+	uint32 expected = (*peer->s_uartFrameCycles)() ;
+	uint64 arrival = cycle + g_linkDelay ;
+
+	g_linkBytes++ ;
+	if((*g_running->s_frameDecode)(&g_running->s_TxDecoder, data))
+	{
+		g_running->s_TxFrames++ ;
+		g_running->s_TxCommand = g_running->s_TxDecoder.s_Frame.s_Command ;
+		g_running->s_TxCycle = cycle ;
+	}
+	if(g_cosimVerbose)
+	{
+		printf("%12.3f ms LINK   %s -> %02X\n", COSIM_ms(arrival),
+				(g_running == &g_cosimEcus[COSIM_HMI]) ? "HMI    " : "Control", data);
+	}
+
+	if((uint64)100 * ((sent > expected) ? (sent - expected) : (expected - sent))
+			> (uint64)COSIM_BAUD_TOLERANCE_PCT * expected)
+	{
+		g_linkMismatch++ ;
+		return ;
+	}
+	if(arrival < (*peer->s_cycles)())
+		g_linkLate++ ;
+	(*peer->s_uartReceiveAt)(data, arrival);
+}
+
+/*
+ * Description: Function returns the next quantum , shorter than the frame of
+ * 				the enabled transmitters (UCSRB.TXEN)
+ */
+static uint64 COSIM_quantum(void)
+{
+	uint64 quantum = COSIM_MAX_QUANTUM ;
+	uint64 frame ;
+	uint8 i;
+
+	for(i = 0 ; i < COSIM_ECUS_NUM ; i++)
+	{
+		if(g_cosimEcus[i].s_Exited || !((*g_cosimEcus[i].s_peek)(UCSRB) & (1<<TXEN)))
+			continue;
+		frame = (*g_cosimEcus[i].s_uartFrameCycles)() + g_linkDelay ;
+		if(frame < quantum + COSIM_QUANTUM_MARGIN)
+			quantum = (frame > COSIM_MIN_QUANTUM + COSIM_QUANTUM_MARGIN) ?
+					(frame - COSIM_QUANTUM_MARGIN) : COSIM_MIN_QUANTUM ;
+	}
+	return quantum ;
+}
@@ -0,0 +1,226 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Co-simulation
+ * File Name: 	host_cosim.h
+ * Description: Header file of the two ECUs co-simulation , the HMI and
+ * 				Control firmware (shared objects) run together in virtual time
+ *
+ * Notes:		- Each ECU has its own ATmega16 model (host_mcu.c) , the
+ * 				  co-simulation resumes them in turn for one quantum of
+ * 				  virtual time (conservative lockstep)
+ *
+ * 				- Virtual Serial Link : a byte is given to the peer when the
+ * 				  sender loads it to its shift register , it arrives at the
+ * 				  end of its stop bit (+ link delay) . The quantum is shorter
+ * 				  than one frame => the peer never passed the arrival time
+ *
+ * 				- Devices : keypad , LCD , buzzer (HMI) , 24C16 EEPROM ,
+ * 				  door motor (Control)
+ *
+ * 				- COSIM_reset() power cycles one ECU in a scenario , the
+ * 				  shared object is closed and opened again (fresh globals)
+ *
+ * 				- The link bytes are decoded in frames (s_TxFrames) ,
+ * 				  COSIM_sendFrame() plays a debug tool on the link of an ECU
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef HOST_COSIM_H_
+#define HOST_COSIM_H_
+
+#include "hal_host.h"
+#include "frame.h"
+#include <avr/io.h>
+#include <ucontext.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+#define COSIM_MS_CYCLES				(F_CPU / 1000UL)
+
+/* Max. quantum of virtual time between two syncs */
+#define COSIM_MAX_QUANTUM			COSIM_MS_CYCLES
+
+/* Min. quantum , before the USARTs are configured */
+#define COSIM_MIN_QUANTUM			256
+
+/* Quantum margin below one frame (ISR entry / RETI after the sync time) */
+#define COSIM_QUANTUM_MARGIN		64
+
+/* Receiver baud rate error that still samples the frame right (8N1) */
+#define COSIM_BAUD_TOLERANCE_PCT	4
+
+/* Stack of each ECU context */
+#define COSIM_STACK_SIZE			(256UL * 1024UL)
+
+/* ECUs */
+#define COSIM_HMI					0
+#define COSIM_CONTROL				1
+#define COSIM_ECUS_NUM				2
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* One ECU : firmware shared object + the model API of its copy of host_mcu.c */
+typedef struct
+{
+	const char *s_Name ;
+	void *s_Handle ;
+
+	int (*s_main)(void);
+	uint8 (*s_peek)(uint8 address);
+	uint64 (*s_cycles)(void);
+	void (*s_getStats)(HOST_StatsType *stats);
+	void (*s_report)(const char *name);
+	void (*s_uartSetTxHook)(void (*a_hook)(uint8 data, uint64 cycle));
+	bool (*s_uartReceiveAt)(uint8 data, uint64 cycle);
+	uint32 (*s_uartFrameCycles)(void);
+	void (*s_twiAttach)(const HOST_TwiDeviceType *device);
+	void (*s_gpioSetHooks)(uint8 port, HOST_PinHook a_pinHook, HOST_PortHook a_portHook);
+	void (*s_setSyncHook)(void (*a_hook)(void));
+	void (*s_setSyncTime)(uint64 cycle);
+	void (*s_powerOn)(uint64 cycle);
+
+	/* Frame functions of the firmware (link monitor , debug tool) */
+	uint8 (*s_frameEncode)(uint8 command, const uint8 *payload, uint8 length, uint8 *buffer);
+	bool (*s_frameDecode)(FRAME_DecoderType *decoder, uint8 data);
+
+	ucontext_t s_Context ;
+	uint8 *s_Stack ;
+	bool s_Exited ;
+
+	/* Frames sent by the ECU on the link , the command of the last one and
+	 * the end of its stop bit */
+	FRAME_DecoderType s_TxDecoder ;
+	uint32 s_TxFrames ;
+	uint8 s_TxCommand ;
+	uint64 s_TxCycle ;
+}COSIM_EcuType;
+
+/* Door motor */
+typedef enum
+{
+	MOTOR_STOPPED, MOTOR_OPENING, MOTOR_CLOSING
+}COSIM_MotorState;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+extern COSIM_EcuType g_cosimEcus[COSIM_ECUS_NUM] ;
+
+/* Print the devices and link activity */
+extern bool g_cosimVerbose ;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function returns the co-simulation time in ms
+ */
+double COSIM_ms(uint64 cycle);
+
+/*
+ * Description: Function to reset the devices and connect them to the ECU models
+ */
+void DEV_init(void);
+
+/*
+ * Description: Function to connect the devices of an ECU to its model
+ * 				(after a reset , the devices keep their state)
+ */
+void DEV_connect(uint8 ecu);
+
+/*
+ * Description: Function to update the devices sampled at every quantum (motor)
+ */
+void DEV_update(uint64 now);
+
+/*
+ * Description: Function to press (TRUE) or release (FALSE) a key ,
+ * 				key = '0' .. '9' , '/' , '*' , '-' , '+' , '=' , 'C' (ON/C)
+ *
+ * Return: FALSE if the key isn't on the keypad
+ */
+bool DEV_keySet(char key, bool pressed);
+
+/*
+ * Description: Function returns TRUE if text is on the LCD (any row)
+ */
+bool DEV_lcdContains(const char *text);
+
+/*
+ * Description: Function to copy a LCD row (LCD_COLS chars + '\0')
+ */
+void DEV_lcdRow(uint8 row, char *text);
+
+/*
+ * Description: Function returns the buzzer state
+ */
+bool DEV_buzzerOn(void);
+
+/*
+ * Description: Functions return the motor state and the door position (0 .. 100 %)
+ */
+COSIM_MotorState DEV_motorState(void);
+double DEV_doorPosition(void);
+
+/*
+ * Description: Function returns the EEPROM byte at address (0 .. 2047)
+ */
+uint8 DEV_eepromRead(uint16 address);
+
+/*
+ * Description: Function to run a scenario , its steps resume the
+ * 				co-simulation by COSIM_runUntil()
+ *
+ * Return: TRUE if all steps passed
+ */
+bool SCEN_run(const char *name);
+
+/*
+ * Description: Functions return the number of scenarios and their names
+ */
+uint8 SCEN_count(void);
+const char *SCEN_name(uint8 index);
+
+/*
+ * Description: Function returns TRUE if the scenario is run only by its
+ * 				name (not in the run of all scenarios)
+ */
+bool SCEN_isLong(uint8 index);
+
+/*
+ * Description: Function to run both ECUs up to the cycle
+ *
+ * Return: FALSE if a firmware exited
+ */
+bool COSIM_runUntil(uint64 cycle);
+
+/*
+ * Description: Function returns the co-simulation time in CPU cycles
+ */
+uint64 COSIM_now(void);
+
+/*
+ * Description: Function to reset an ECU (power cycle) : its firmware and
+ * 				model are loaded again (RAM and registers reset) , main()
+ * 				starts at the co-simulation time , the devices keep their
+ * 				state (EEPROM memory , door position , LCD)
+ */
+void COSIM_reset(uint8 ecu);
+
+/*
+ * Description: Function to send a frame to an ECU like a debug tool on its
+ * 				link , the bytes arrive one after the other from now
+ *
+ * Return: cycle of the end of the last byte
+ */
+uint64 COSIM_sendFrame(uint8 ecu, uint8 command, const uint8 *payload, uint8 length);
+
+#endif /* HOST_COSIM_H_ */
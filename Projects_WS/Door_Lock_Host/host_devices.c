@@ -0,0 +1,451 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Co-simulation
+ * File Name: 	host_devices.c
+ * Description: Source file of the simulated devices of the co-simulation
+ *
+ * Notes:		- HMI     : 4x4 keypad (PORTA) , HD44780 2x16 LCD (data PORTB ,
+ * 				            RS / RW / E = PD5 / PD6 / PD7) , buzzer (PC0)
+ * 				- Control : 24C16 EEPROM (TWI) , door motor (PD6 / PD7 + OC0)
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_cosim.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* Keypad , index = row * 4 + column (keypad.c) , 'C' = ON/C */
+#define KEYS_LAYOUT				"789/456*123-C0=+"
+
+/* LCD , DDRAM of 2 lines * 40 chars , line 2 at 0x40 */
+#define LCD_DDRAM_SIZE			0x80
+#define LCD_LINE_2				0x40
+#define LCD_VISIBLE_COLS		16
+#define LCD_PIN_RS				5
+#define LCD_PIN_RW				6
+#define LCD_PIN_E				7
+/* Execution time of Clear Display / Return Home and of the other instructions */
+#define LCD_CLEAR_CYCLES		((uint64)(1520UL * (F_CPU / 1000000UL)))
+#define LCD_EXEC_CYCLES			((uint64)(37UL * (F_CPU / 1000000UL)))
+
+/* Buzzer */
+#define BUZZER_PIN				0
+
+/* 24C16 , 2 KB = 8 blocks of 256 bytes , 16 bytes page , 5 ms write cycle */
+#define EEPROM_SIZE				2048
+#define EEPROM_PAGE_SIZE		16
+#define EEPROM_WRITE_CYCLES		((uint64)(5UL * COSIM_MS_CYCLES))
+
+/* Door motor , direction pins PD6 / PD7 , duty = OCR0 , the door needs
+ * 9 s at full duty from closed to open (10 s move with 1 s ramps) */
+#define MOTOR_PIN_A				6
+#define MOTOR_PIN_B				7
+#define MOTOR_TRAVEL_CYCLES		((double)(9000UL * COSIM_MS_CYCLES))
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint8 s_Ddram[LCD_DDRAM_SIZE] ;
+	uint8 s_Address ;
+	bool s_Cgram ;
+	bool s_Increment ;
+	bool s_On ;
+	uint8 s_Ctrl ;
+	uint64 s_BusyUntil ;
+}DEV_LcdType;
+
+typedef struct
+{
+	uint8 s_Memory[EEPROM_SIZE] ;
+	uint16 s_Address ;
+	bool s_WordAddress ;
+	bool s_Written ;
+	uint64 s_BusyUntil ;
+}DEV_EepromType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static uint16 g_keys = 0 ;
+static DEV_LcdType g_lcd ;
+static bool g_buzzer = FALSE ;
+static DEV_EepromType g_eeprom ;
+
+static COSIM_MotorState g_motor = MOTOR_STOPPED ;
+static double g_door = 0.0 ;
+static uint64 g_motorLast = 0 ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint8 DEV_keypadPins(uint8 port, uint8 ddr, uint8 out);
+static uint8 DEV_lcdPins(uint8 port, uint8 ddr, uint8 out);
+static void DEV_lcdControl(uint8 port, uint8 ddr, uint8 out);
+static void DEV_lcdExecute(bool rs, uint8 data);
+static void DEV_lcdTrace(uint64 now);
+static void DEV_buzzerPort(uint8 port, uint8 ddr, uint8 out);
+static bool DEV_eepromStart(uint8 sla);
+static bool DEV_eepromWrite(uint8 data);
+static uint8 DEV_eepromReadByte(bool ack);
+static void DEV_eepromStop(void);
+
+static const HOST_TwiDeviceType g_eepromDevice =
+{
+	0xA0, 0xF0, DEV_eepromStart, DEV_eepromWrite, DEV_eepromReadByte, DEV_eepromStop
+};
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to reset the devices and connect them to the ECU models
+ */
+void DEV_init(void)
+{
+	memset(g_lcd.s_Ddram, ' ', LCD_DDRAM_SIZE);
+	g_lcd.s_Increment = TRUE ;
+	memset(g_eeprom.s_Memory, 0xFF, EEPROM_SIZE);
+
+	DEV_connect(COSIM_HMI);
+	DEV_connect(COSIM_CONTROL);
+}
+
+/*
+ * Description: Function to connect the devices of an ECU to its model
+ */
+void DEV_connect(uint8 ecu)
+{
+	COSIM_EcuType *model = &g_cosimEcus[ecu] ;
+
+	if(ecu == COSIM_HMI)
+	{
+		(*model->s_gpioSetHooks)('A', DEV_keypadPins, NULL_PTR);
+		(*model->s_gpioSetHooks)('B', DEV_lcdPins, NULL_PTR);
+		(*model->s_gpioSetHooks)('C', NULL_PTR, DEV_buzzerPort);
+		(*model->s_gpioSetHooks)('D', NULL_PTR, DEV_lcdControl);
+	}
+	else
+	{
+		(*model->s_twiAttach)(&g_eepromDevice);
+	}
+}
+
+/*
+ * Description: Function to update the motor and the door position ,
+ * 				direction from PD6 / PD7 , speed from OCR0 (TIMER0 running)
+ */
+void DEV_update(uint64 now)
+{
+	COSIM_EcuType *control = &g_cosimEcus[COSIM_CONTROL] ;
+	uint8 port = (*control->s_peek)(PORTD) ;
+	uint8 duty = ((*control->s_peek)(TCCR0) & 0x07) ? (*control->s_peek)(OCR0) : 0 ;
+	COSIM_MotorState state = MOTOR_STOPPED ;
+	double move ;
+
+	if((port & (1<<MOTOR_PIN_A)) && !(port & (1<<MOTOR_PIN_B)) && (duty != 0))
+		state = MOTOR_OPENING ;
+	else if(!(port & (1<<MOTOR_PIN_A)) && (port & (1<<MOTOR_PIN_B)) && (duty != 0))
+		state = MOTOR_CLOSING ;
+
+	/* Door moved with the motor state of the last quantum */
+	move = 100.0 * ((double)duty / 255.0) * (double)(now - g_motorLast) / MOTOR_TRAVEL_CYCLES ;
+	if(g_motor == MOTOR_OPENING)
+		g_door = (g_door + move > 100.0) ? 100.0 : (g_door + move) ;
+	else if(g_motor == MOTOR_CLOSING)
+		g_door = (g_door - move < 0.0) ? 0.0 : (g_door - move) ;
+	g_motorLast = now ;
+
+	if(g_cosimVerbose && (state != g_motor))
+	{
+		printf("%12.3f ms MOTOR  %s (door %.1f %%)\n", COSIM_ms(now),
+				(state == MOTOR_OPENING) ? "opening" :
+				(state == MOTOR_CLOSING) ? "closing" : "stopped", g_door);
+	}
+	g_motor = state ;
+
+	if(g_cosimVerbose)
+		DEV_lcdTrace(now);
+}
+
+/*
+ * Description: Function to press or release a key
+ */
+bool DEV_keySet(char key, bool pressed)
+{
+	const char *at = strchr(KEYS_LAYOUT, key) ;
+
+	if((key == '\0') || (at == NULL_PTR))
+		return FALSE ;
+
+	if(pressed)
+		g_keys |= (uint16)(1U << (at - KEYS_LAYOUT)) ;
+	else
+		g_keys &= (uint16)~(1U << (at - KEYS_LAYOUT)) ;
+	return TRUE ;
+}
+
+/*
+ * Description: Function returns TRUE if text is on the LCD (any row)
+ */
+bool DEV_lcdContains(const char *text)
+{
+	char row[LCD_VISIBLE_COLS + 1] ;
+	uint8 i;
+
+	if(!g_lcd.s_On)
+		return FALSE ;
+	for(i = 0 ; i < 2 ; i++)
+	{
+		DEV_lcdRow(i, row);
+		if(strstr(row, text) != NULL_PTR)
+			return TRUE ;
+	}
+	return FALSE ;
+}
+
+/*
+ * Description: Function to copy a LCD row
+ */
+void DEV_lcdRow(uint8 row, char *text)
+{
+	memcpy(text, &g_lcd.s_Ddram[row ? LCD_LINE_2 : 0], LCD_VISIBLE_COLS);
+	text[LCD_VISIBLE_COLS] = '\0' ;
+}
+
+/*
+ * Description: Function returns the buzzer state
+ */
+bool DEV_buzzerOn(void)
+{
+	return g_buzzer ;
+}
+
+/*
+ * Description: Functions return the motor state and the door position
+ */
+COSIM_MotorState DEV_motorState(void)
+{
+	return g_motor ;
+}
+
+double DEV_doorPosition(void)
+{
+	return g_door ;
+}
+
+/*
+ * Description: Function returns the EEPROM byte at address
+ */
+uint8 DEV_eepromRead(uint16 address)
+{
+	return g_eeprom.s_Memory[address % EEPROM_SIZE] ;
+}
+
+/*
+ * Description: Keypad , a column driven LOW pulls the rows of its pressed
+ * 				keys LOW , the other input pins stay on their pull-ups
+ */
+static uint8 DEV_keypadPins(uint8 port, uint8 ddr, uint8 out)
+{
+	uint8 in = out ;
+	uint8 row , col ;
+
+	for(col = 0 ; col < 4 ; col++)
+	{
+		if(!(ddr & (0x10 << col)) || (out & (0x10 << col)))
+			continue;
+		for(row = 0 ; row < 4 ; row++)
+		{
+			if(g_keys & (1U << (row * 4 + col)))
+				in &= (uint8)~(1 << row) ;
+		}
+	}
+	return in ;
+}
+
+/*
+ * Description: LCD data bus , RW = 1 and E = 1 => Busy Flag + Address Counter
+ */
+static uint8 DEV_lcdPins(uint8 port, uint8 ddr, uint8 out)
+{
+	bool busy ;
+
+	if((g_lcd.s_Ctrl & ((1<<LCD_PIN_RW) | (1<<LCD_PIN_E))) != ((1<<LCD_PIN_RW) | (1<<LCD_PIN_E)))
+		return out ;
+
+	busy = (*g_cosimEcus[COSIM_HMI].s_cycles)() < g_lcd.s_BusyUntil ;
+	return (uint8)((busy ? 0x80 : 0x00) | (g_lcd.s_Address & 0x7F)) ;
+}
+
+/*
+ * Description: LCD control pins , a write is latched on the falling edge of E
+ */
+static void DEV_lcdControl(uint8 port, uint8 ddr, uint8 out)
+{
+	uint8 ctrl = ddr & out ;
+	bool fall = (g_lcd.s_Ctrl & (1<<LCD_PIN_E)) && !(ctrl & (1<<LCD_PIN_E)) ;
+
+	g_lcd.s_Ctrl = ctrl ;
+	if(fall && !(ctrl & (1<<LCD_PIN_RW)))
+		DEV_lcdExecute((ctrl & (1<<LCD_PIN_RS)) ? TRUE : FALSE, (*g_cosimEcus[COSIM_HMI].s_peek)(PORTB));
+}
+
+/*
+ * Description: LCD instruction (rs = FALSE) or DDRAM / CGRAM data (rs = TRUE)
+ */
+static void DEV_lcdExecute(bool rs, uint8 data)
+{
+	uint64 now = (*g_cosimEcus[COSIM_HMI].s_cycles)() ;
+
+	g_lcd.s_BusyUntil = now + LCD_EXEC_CYCLES ;
+
+	if(rs)
+	{
+		if(!g_lcd.s_Cgram)
+			g_lcd.s_Ddram[g_lcd.s_Address] = data ;
+		g_lcd.s_Address = (uint8)((g_lcd.s_Address + (g_lcd.s_Increment ? 1 : LCD_DDRAM_SIZE - 1)) % LCD_DDRAM_SIZE) ;
+		return ;
+	}
+
+	if(data & 0x80)				/* Set DDRAM Address */
+	{
+		g_lcd.s_Address = data & 0x7F ;
+		g_lcd.s_Cgram = FALSE ;
+	}
+	else if(data & 0x40)		/* Set CGRAM Address */
+	{
+		g_lcd.s_Cgram = TRUE ;
+	}
+	else if(data & 0x20)		/* Function Set */
+	{
+	}
+	else if(data & 0x10)		/* Cursor / Display Shift */
+	{
+		if(!(data & 0x08))
+			g_lcd.s_Address = (uint8)((g_lcd.s_Address + ((data & 0x04) ? 1 : LCD_DDRAM_SIZE - 1)) % LCD_DDRAM_SIZE) ;
+	}
+	else if(data & 0x08)		/* Display On/Off */
+	{
+		g_lcd.s_On = (data & 0x04) ? TRUE : FALSE ;
+	}
+	else if(data & 0x04)		/* Entry Mode Set */
+	{
+		g_lcd.s_Increment = (data & 0x02) ? TRUE : FALSE ;
+	}
+	else if(data & 0x03)		/* Clear Display / Return Home */
+	{
+		if(data == 0x01)
+		{
+			memset(g_lcd.s_Ddram, ' ', LCD_DDRAM_SIZE);
+			g_lcd.s_Increment = TRUE ;
+		}
+		g_lcd.s_Address = 0 ;
+		g_lcd.s_Cgram = FALSE ;
+		g_lcd.s_BusyUntil = now + LCD_CLEAR_CYCLES ;
+	}
+}
+
+/*
+ * Description: Function to print the LCD rows when they changed
+ */
+static void DEV_lcdTrace(uint64 now)
+{
+	static char shown[2][LCD_VISIBLE_COLS + 1] ;
+	char rows[2][LCD_VISIBLE_COLS + 1] ;
+
+	DEV_lcdRow(0, rows[0]);
+	DEV_lcdRow(1, rows[1]);
+	if(memcmp(rows, shown, sizeof(rows)) == 0)
+		return ;
+
+	memcpy(shown, rows, sizeof(rows));
+	printf("%12.3f ms LCD    |%s|%s|\n", COSIM_ms(now), rows[0], rows[1]);
+}
+
+/*
+ * Description: Buzzer on PC0 (HIGH = ON)
+ */
+static void DEV_buzzerPort(uint8 port, uint8 ddr, uint8 out)
+{
+	bool on = (ddr & out & (1<<BUZZER_PIN)) ? TRUE : FALSE ;
+
+	if(g_cosimVerbose && (on != g_buzzer))
+	{
+		printf("%12.3f ms BUZZER %s\n",
+				COSIM_ms((*g_cosimEcus[COSIM_HMI].s_cycles)()), on ? "on" : "off");
+	}
+	g_buzzer = on ;
+}
+
+/*
+ * Description: 24C16 SLA+R/W , block = SLA bits 3..1 , NACK in the write cycle
+ */
+static bool DEV_eepromStart(uint8 sla)
+{
+	if((*g_cosimEcus[COSIM_CONTROL].s_cycles)() < g_eeprom.s_BusyUntil)
+		return FALSE ;
+
+	if(!(sla & 0x01))
+	{
+		/* Write => word address next , the block is from the SLA */
+		g_eeprom.s_Address = (uint16)((sla & 0x0E) << 7) ;
+		g_eeprom.s_WordAddress = TRUE ;
+		g_eeprom.s_Written = FALSE ;
+	}
+	return TRUE ;
+}
+
+/*
+ * Description: 24C16 word address , then data bytes in the page
+ * 				(the address rolls over in the page)
+ */
+static bool DEV_eepromWrite(uint8 data)
+{
+	if(g_eeprom.s_WordAddress)
+	{
+		g_eeprom.s_Address = (uint16)((g_eeprom.s_Address & 0x700) | data) ;
+		g_eeprom.s_WordAddress = FALSE ;
+		return TRUE ;
+	}
+
+	g_eeprom.s_Memory[g_eeprom.s_Address] = data ;
+	g_eeprom.s_Address = (uint16)((g_eeprom.s_Address & ~(EEPROM_PAGE_SIZE - 1))
+			| ((g_eeprom.s_Address + 1) & (EEPROM_PAGE_SIZE - 1))) ;
+	g_eeprom.s_Written = TRUE ;
+	return TRUE ;
+}
+
+/*
+ * Description: 24C16 sequential read (the address rolls over the memory)
+ */
+static uint8 DEV_eepromReadByte(bool ack)
+{
+	uint8 data = g_eeprom.s_Memory[g_eeprom.s_Address] ;
+
+	g_eeprom.s_Address = (uint16)((g_eeprom.s_Address + 1) % EEPROM_SIZE) ;
+	return data ;
+}
+
+/*
+ * Description: 24C16 Stop , data written => internal write cycle
+ */
+static void DEV_eepromStop(void)
+{
+	if(g_eeprom.s_Written)
+	{
+		g_eeprom.s_Written = FALSE ;
+		g_eeprom.s_BusyUntil = (*g_cosimEcus[COSIM_CONTROL].s_cycles)() + EEPROM_WRITE_CYCLES ;
+	}
+}
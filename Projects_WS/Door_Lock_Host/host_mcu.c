@@ -0,0 +1,1214 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - ATmega16 Model
+ * File Name: 	host_mcu.c
+ * Description: Source file for the Linux model of the ATmega16 registers ,
+ * 				peripherals , interrupts and virtual clock (HOST_BUILD)
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+/* program_invocation_short_name */
+#define _GNU_SOURCE
+
+#include "hal_host.h"
+#include "micro_config.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* Cycles of IN / OUT , ISR entry (vector jump + push PC) and RETI */
+#define HOST_IO_CYCLES			1
+#define HOST_ISR_ENTRY_CYCLES	4
+#define HOST_RETI_CYCLES		4
+
+/* Supply current of the ATmega16 at 8 MHz , 5 V (datasheet typical) , the
+ * MCU only (LCD , keypad pull-ups , motor driver aren't included) */
+#define HOST_ACTIVE_MA			12.0
+#define HOST_IDLE_MA			5.5
+
+/* Code cycles of one wake up that the model doesn't count (ISR body and
+ * scheduler pass between the register accesses) , an estimate */
+#define HOST_WAKE_CODE_CYCLES	300
+
+#define HOST_NEVER				UINT64_MAX
+
+#define HOST_TIMERS_NUM			3
+#define HOST_PORTS_NUM			4
+#define HOST_TWI_DEVICES_NUM	4
+#define HOST_RX_QUEUE_SIZE		64
+#define HOST_REPORT_HOOKS_NUM	4
+
+/* TWI Status Codes */
+#define HOST_TW_START			0x08
+#define HOST_TW_REP_START		0x10
+#define HOST_TW_MT_SLA_ACK		0x18
+#define HOST_TW_MT_SLA_NACK		0x20
+#define HOST_TW_MT_DATA_ACK		0x28
+#define HOST_TW_MT_DATA_NACK	0x30
+#define HOST_TW_MR_SLA_ACK		0x40
+#define HOST_TW_MR_SLA_NACK		0x48
+#define HOST_TW_MR_DATA_ACK		0x50
+#define HOST_TW_MR_DATA_NACK	0x58
+#define HOST_TW_NO_INFO			0xF8
+#define HOST_TW_BUS_ERROR		0x00
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct
+{
+	/* TCNT , TIMER1 is 16 bits */
+	uint16 s_count ;
+
+	/* Cycle of the last counted timer clock */
+	uint64 s_last ;
+
+	/* TIFR / TIMSK bits : compare (A) , compare B (TIMER1) , overflow */
+	uint8 s_ocfA ;
+	uint8 s_ocfB ;
+	uint8 s_tov ;
+}HOST_TimerType;
+
+typedef struct
+{
+	uint32 s_div ;
+	uint16 s_top ;
+	uint16 s_ocrA ;
+	uint16 s_ocrB ;
+	bool s_ctc ;
+}HOST_TimerConfigType;
+
+typedef enum
+{
+	TWI_IDLE, TWI_ADDRESS, TWI_TRANSMIT, TWI_RECEIVE, TWI_NACKED
+}HOST_TwiPhaseType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+volatile uint8_t HOST_sreg = 0 ;
+
+static uint64 g_now = 0 ;
+static uint64 g_powerOnAt = 0 ;
+static uint64 g_stopAt = HOST_NEVER ;
+static uint64 g_syncAt = HOST_NEVER ;
+static void (*g_syncHook)(void) = NULL_PTR ;
+static void (*g_reportHooks[HOST_REPORT_HOOKS_NUM])(const char *name) ;
+static bool g_trace = FALSE ;
+static struct timespec g_wallStart ;
+static HOST_StatsType g_stats ;
+
+/* Plain registers (DDR , PORT , TIMSK , OCR , TCCR , UBRR , TWBR , ...) */
+static uint8 g_io[HOST_IO_SIZE] ;
+static uint16 g_ocr1a , g_ocr1b , g_icr1 ;
+static uint8 g_tifr ;
+
+/* Cycle of the event that set each TIFR flag , and the entry latency of
+ * the running ISR (event => first instruction of the ISR) */
+static uint64 g_tifrAt[8] ;
+static uint32 g_isrLatency = 0 ;
+
+static HOST_TimerType g_timers[HOST_TIMERS_NUM] =
+{
+	{0, 0, (1<<OCF0), 0, (1<<TOV0)},
+	{0, 0, (1<<OCF1A), (1<<OCF1B), (1<<TOV1)},
+	{0, 0, (1<<OCF2), 0, (1<<TOV2)}
+};
+
+/* USART */
+static uint8 g_ucsra = 0 ;
+static uint8 g_ucsrc = (1<<UCSZ1) | (1<<UCSZ0) ;
+static bool g_txShiftBusy = FALSE ;
+static uint8 g_txShift ;
+static uint64 g_txDoneAt = HOST_NEVER ;
+static bool g_txBufferFull = FALSE ;
+static uint8 g_txBuffer ;
+static uint8 g_rxFifo[2] ;
+static uint64 g_rxFifoAt[2] ;
+static uint8 g_rxCount = 0 ;
+static uint8 g_rxQueue[HOST_RX_QUEUE_SIZE] ;
+static uint64 g_rxQueueAt[HOST_RX_QUEUE_SIZE] ;
+static uint8 g_rxQueueHead = 0 , g_rxQueueTail = 0 ;
+static void (*g_uartTxHook)(uint8 data, uint64 cycle) = NULL_PTR ;
+
+/* TWI */
+static uint8 g_twcr = 0 ;
+static bool g_twint = FALSE ;
+static uint8 g_twsr = HOST_TW_NO_INFO ;
+static uint8 g_twdr = 0xFF ;
+static HOST_TwiPhaseType g_twiPhase = TWI_IDLE ;
+static bool g_twiOwner = FALSE ;
+static uint8 g_twiNextStatus ;
+static uint64 g_twiDoneAt = HOST_NEVER ;
+static uint64 g_twiAt = 0 ;
+static const HOST_TwiDeviceType *g_twiDevices[HOST_TWI_DEVICES_NUM] ;
+static const HOST_TwiDeviceType *g_twiSlave = NULL_PTR ;
+
+/* GPIO */
+static HOST_PinHook g_pinHooks[HOST_PORTS_NUM] ;
+static HOST_PortHook g_portHooks[HOST_PORTS_NUM] ;
+
+/* Interrupt Vectors , not defined in the firmware => NULL */
+#define HOST_VECTOR(n)	extern void __vector_##n(void) __attribute__((weak))
+HOST_VECTOR(3); HOST_VECTOR(4); HOST_VECTOR(6); HOST_VECTOR(7); HOST_VECTOR(8);
+HOST_VECTOR(9); HOST_VECTOR(11); HOST_VECTOR(12); HOST_VECTOR(13); HOST_VECTOR(17);
+HOST_VECTOR(19);
+
+static const char *const g_vectorNames[_VECTORS_SIZE] =
+{
+	[3] = "TIMER2_COMP", [4] = "TIMER2_OVF", [6] = "TIMER1_COMPA", [7] = "TIMER1_COMPB",
+	[8] = "TIMER1_OVF", [9] = "TIMER0_OVF", [11] = "USART_RXC", [12] = "USART_UDRE",
+	[13] = "USART_TXC", [17] = "TWI", [19] = "TIMER0_COMP"
+};
+static uint32 g_vectorCount[_VECTORS_SIZE] ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void HOST_advance(uint64 cycles);
+static void HOST_update(void);
+static void HOST_serve(void);
+static uint8 HOST_pendingVector(void);
+static uint64 HOST_eventCycle(uint8 vector);
+static uint64 HOST_nextEvent(void);
+static void HOST_sync(void);
+static void HOST_stop(int status);
+
+static void HOST_timerConfig(uint8 n, HOST_TimerConfigType *config);
+static void HOST_timerSync(uint8 n);
+static void HOST_timerFlag(uint8 flag, uint64 cycle);
+static uint64 HOST_timerNext(uint8 n);
+
+static void HOST_uartUpdate(void);
+static void HOST_uartShift(uint8 data, uint64 start);
+static void HOST_uartWriteData(uint8 data);
+static uint8 HOST_uartReadData(void);
+
+static void HOST_twiUpdate(void);
+static void HOST_twiControl(uint8 value);
+static uint32 HOST_twiBitCycles(void);
+
+static uint8 HOST_gpioRead(uint8 address);
+static void HOST_gpioWrite(uint8 address, uint8 value);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Model reset , before main()
+ */
+__attribute__((constructor))
+static void HOST_init(void)
+{
+	const char *env ;
+
+	env = getenv("HOST_RUN_MS");
+	if((env != NULL_PTR) && (atol(env) > 0))
+		g_stopAt = (uint64)atol(env) * (F_CPU / 1000UL) ;
+
+	env = getenv("HOST_TRACE");
+	g_trace = (env != NULL_PTR) && (env[0] == '1') ;
+
+	clock_gettime(CLOCK_MONOTONIC, &g_wallStart);
+}
+
+/*
+ * Description: Functions of the register access (HAL Macros)
+ */
+uint8 HOST_read8(uint8 address)
+{
+	HOST_advance(HOST_IO_CYCLES);
+	g_stats.s_IoAccesses++ ;
+
+	if(address == 0x0C)	/* UDR */
+		return HOST_uartReadData() ;
+	return HOST_peek(address) ;
+}
+
+/*
+ * Description: Function returns a register without side effects and
+ * 				without virtual time (devices , co-simulation)
+ */
+uint8 HOST_peek(uint8 address)
+{
+	switch(address)
+	{
+	case 0x01:	/* TWSR */
+		return (uint8)(g_twsr | (g_io[address] & 0x03)) ;
+	case 0x03:	/* TWDR */
+		return g_twdr ;
+	case 0x0B:	/* UCSRA */
+		return (uint8)(g_ucsra | ((g_rxCount > 0) ? (1<<RXC) : 0)
+				| (g_txBufferFull ? 0 : (1<<UDRE))) ;
+	case 0x0C:	/* UDR */
+		return g_rxFifo[0] ;
+	case 0x10: case 0x13: case 0x16: case 0x19:	/* PINx */
+		return HOST_gpioRead(address) ;
+	case 0x24:	/* TCNT2 */
+		return (uint8)g_timers[2].s_count ;
+	case 0x32:	/* TCNT0 */
+		return (uint8)g_timers[0].s_count ;
+	case 0x36:	/* TWCR */
+		return (uint8)(g_twcr | (g_twint ? (1<<TWINT) : 0)) ;
+	case 0x38:	/* TIFR */
+		return g_tifr ;
+	default:
+		return g_io[address & (HOST_IO_SIZE - 1)] ;
+	}
+}
+
+void HOST_write8(uint8 address, uint8 value)
+{
+	HOST_advance(HOST_IO_CYCLES);
+	g_stats.s_IoAccesses++ ;
+
+	switch(address)
+	{
+	case 0x03:	/* TWDR */
+		g_twdr = value ;
+		break;
+	case 0x0B:	/* UCSRA , TXC is cleared by writing one */
+		g_ucsra = (uint8)((g_ucsra & ((1<<TXC) | (1<<DOR) | (1<<FE)))
+				| (value & ((1<<U2X) | (1<<MPCM)))) ;
+		if(value & (1<<TXC))
+			g_ucsra &= (uint8)~(1<<TXC) ;
+		break;
+	case 0x0C:	/* UDR */
+		HOST_uartWriteData(value);
+		break;
+	case 0x11: case 0x12: case 0x14: case 0x15:
+	case 0x17: case 0x18: case 0x1A: case 0x1B:	/* DDRx , PORTx */
+		HOST_gpioWrite(address, value);
+		break;
+	case 0x20:	/* URSEL = 1 => UCSRC , else UBRRH */
+		if(value & (1<<URSEL))
+			g_ucsrc = value ;
+		else
+			g_io[address] = value ;
+		break;
+	case 0x24:	/* TCNT2 */
+		g_timers[2].s_count = value ;
+		g_timers[2].s_last = g_now ;
+		break;
+	case 0x32:	/* TCNT0 */
+		g_timers[0].s_count = value ;
+		g_timers[0].s_last = g_now ;
+		break;
+	case 0x36:	/* TWCR */
+		HOST_twiControl(value);
+		break;
+	case 0x38:	/* TIFR , flags are cleared by writing one */
+		g_tifr &= (uint8)~value ;
+		break;
+	case 0x25: case 0x2E: case 0x2F: case 0x33:	/* TCCRx , restart the prescaler */
+		g_io[address] = value ;
+		HOST_timerSync(0);
+		HOST_timerSync(1);
+		HOST_timerSync(2);
+		break;
+	default:
+		g_io[address & (HOST_IO_SIZE - 1)] = value ;
+		break;
+	}
+}
+
+uint16 HOST_read16(uint8 address)
+{
+	HOST_advance(2 * HOST_IO_CYCLES);
+	g_stats.s_IoAccesses += 2 ;
+
+	switch(address)
+	{
+	case 0x26:	return g_icr1 ;
+	case 0x28:	return g_ocr1b ;
+	case 0x2A:	return g_ocr1a ;
+	case 0x2C:	return g_timers[1].s_count ;
+	default:	return (uint16)(g_io[address] | (g_io[address + 1] << 8)) ;
+	}
+}
+
+void HOST_write16(uint8 address, uint16 value)
+{
+	HOST_advance(2 * HOST_IO_CYCLES);
+	g_stats.s_IoAccesses += 2 ;
+
+	switch(address)
+	{
+	case 0x26:	g_icr1 = value ;	break;
+	case 0x28:	g_ocr1b = value ;	break;
+	case 0x2A:	g_ocr1a = value ;	break;
+	case 0x2C:
+		g_timers[1].s_count = value ;
+		g_timers[1].s_last = g_now ;
+		break;
+	default:
+		g_io[address] = (uint8)value ;
+		g_io[address + 1] = (uint8)(value >> 8) ;
+		break;
+	}
+}
+
+/*
+ * Description: Function to advance the virtual clock (busy wait)
+ */
+void HOST_delayCycles(uint64 cycles)
+{
+	HOST_advance(cycles);
+}
+
+/*
+ * Description: sleep_cpu() , jump to the next event and serve its interrupt
+ * 				An interrupt pending before SLEEP wakes the CPU at once
+ */
+void HOST_sleep(void)
+{
+	uint64 start = g_now ;
+	uint64 next ;
+
+	HOST_update();
+	while(HOST_pendingVector() == 0)
+	{
+		next = HOST_nextEvent();
+		if(next == HOST_NEVER)
+		{
+			fprintf(stderr, "HOST: sleep with no wake up source @ %.3f ms\n",
+					(double)g_now * 1000.0 / F_CPU);
+			HOST_stop(1);
+		}
+		if(next > g_now)
+			g_now = next ;
+		if(g_now >= g_stopAt)
+			HOST_stop(0);
+		if(g_now >= g_syncAt)
+			HOST_sync();
+		HOST_update();
+	}
+
+	g_stats.s_SleepCycles += g_now - start ;
+	g_stats.s_Sleeps++ ;
+	HOST_serve();
+}
+
+/*
+ * Description: Function returns the virtual time in CPU cycles
+ */
+uint64 HOST_cycles(void)
+{
+	return g_now ;
+}
+
+/*
+ * Description: Function to copy the model statistics
+ */
+void HOST_getStats(HOST_StatsType *stats)
+{
+	*stats = g_stats ;
+	stats->s_Cycles = g_now - g_powerOnAt ;
+}
+
+/*
+ * Description: Function to print the statistics (stderr)
+ */
+void HOST_report(const char *name)
+{
+	struct timespec wall ;
+	double wallMs , simMs ;
+	uint64 cycles = g_now - g_powerOnAt ;
+	double active , estimated ;
+	uint8 i;
+
+	clock_gettime(CLOCK_MONOTONIC, &wall);
+	wallMs = (double)(wall.tv_sec - g_wallStart.tv_sec) * 1000.0
+			+ (double)(wall.tv_nsec - g_wallStart.tv_nsec) / 1000000.0 ;
+	simMs = (double)cycles * 1000.0 / F_CPU ;
+
+	fprintf(stderr, "HOST[%s]: %.3f ms simulated in %.3f ms wall (x%.0f)\n",
+			name, simMs, wallMs, (wallMs > 0.0) ? (simMs / wallMs) : 0.0);
+	fprintf(stderr, "HOST[%s]: sleep %.1f %% (%u sleeps) , ISRs %.2f %% (%u) , %llu register accesses\n",
+			name, (cycles > 0) ? (100.0 * (double)g_stats.s_SleepCycles / (double)cycles) : 0.0,
+			g_stats.s_Sleeps,
+			(cycles > 0) ? (100.0 * (double)g_stats.s_IsrCycles / (double)cycles) : 0.0,
+			g_stats.s_Isrs, (unsigned long long)g_stats.s_IoAccesses);
+
+	/* Duty cycle and mean current , model cycles (register accesses , ISR
+	 * entry / RETI , delays) and + the code of every wake up */
+	if(cycles > 0)
+	{
+		active = (double)(cycles - g_stats.s_SleepCycles) / (double)cycles ;
+		estimated = active + (double)g_stats.s_Sleeps * HOST_WAKE_CODE_CYCLES / (double)cycles ;
+		if(estimated > 1.0)
+			estimated = 1.0 ;
+		fprintf(stderr, "HOST[%s]: active %.2f %% .. %.2f %% (+ %u cycles per wake up) , "
+				"current %.2f .. %.2f mA (active %.1f mA , idle %.1f mA)\n",
+				name, 100.0 * active, 100.0 * estimated, HOST_WAKE_CODE_CYCLES,
+				HOST_IDLE_MA + active * (HOST_ACTIVE_MA - HOST_IDLE_MA),
+				HOST_IDLE_MA + estimated * (HOST_ACTIVE_MA - HOST_IDLE_MA),
+				HOST_ACTIVE_MA, HOST_IDLE_MA);
+	}
+	for(i = 0 ; i < _VECTORS_SIZE ; i++)
+	{
+		if(g_vectorCount[i] != 0)
+			fprintf(stderr, "HOST[%s]:   %-12s %u\n", name, g_vectorNames[i], g_vectorCount[i]);
+	}
+	fprintf(stderr, "HOST[%s]: USART TX %u RX %u overruns %u , TWI %u bytes\n",
+			name, g_stats.s_UartTx, g_stats.s_UartRx, g_stats.s_UartOverruns, g_stats.s_TwiBytes);
+
+	/* Firmware statistics (Profiler , ISR Statistics) */
+	for(i = 0 ; (i < HOST_REPORT_HOOKS_NUM) && (g_reportHooks[i] != NULL_PTR) ; i++)
+		(*g_reportHooks[i])(name);
+}
+
+/*
+ * Description: Function to add a Report Hook , called by HOST_report()
+ */
+void HOST_addReportHook(void (*a_hook)(const char *name))
+{
+	uint8 i;
+
+	for(i = 0 ; i < HOST_REPORT_HOOKS_NUM ; i++)
+	{
+		if((g_reportHooks[i] == NULL_PTR) || (g_reportHooks[i] == a_hook))
+		{
+			g_reportHooks[i] = a_hook ;
+			return ;
+		}
+	}
+	fprintf(stderr, "HOST: too many report hooks\n");
+}
+
+/*
+ * Description: Function returns the entry latency of the running ISR
+ */
+uint32 HOST_isrLatency(void)
+{
+	return g_isrLatency ;
+}
+
+/*
+ * Description: Function to set the USART TX Hook
+ */
+void HOST_uartSetTxHook(void (*a_hook)(uint8 data, uint64 cycle))
+{
+	g_uartTxHook = a_hook ;
+}
+
+/*
+ * Description: Function to receive a byte at a virtual time (>= now)
+ */
+bool HOST_uartReceiveAt(uint8 data, uint64 cycle)
+{
+	uint8 next = (uint8)((g_rxQueueHead + 1) % HOST_RX_QUEUE_SIZE) ;
+
+	if(next == g_rxQueueTail)
+		return FALSE ;
+
+	g_rxQueue[g_rxQueueHead] = data ;
+	g_rxQueueAt[g_rxQueueHead] = (cycle > g_now) ? cycle : g_now ;
+	g_rxQueueHead = next ;
+	return TRUE ;
+}
+
+/*
+ * Description: Function returns the cycles of one USART frame
+ */
+uint32 HOST_uartFrameCycles(void)
+{
+	uint32 ubrr = (uint32)(((g_io[0x20] & 0x0F) << 8) | g_io[0x09]) ;
+	uint32 bits = 1 + 5 + ((g_ucsrc >> UCSZ0) & 0x03) + ((g_io[0x0A] & (1<<UCSZ2)) ? 4 : 0) ;
+
+	if(bits > 10)
+		bits = 10 ;	/* 9 data bits */
+	if(g_ucsrc & (1<<UPM1))
+		bits++ ;
+	bits += (g_ucsrc & (1<<USBS)) ? 2 : 1 ;
+
+	return bits * (ubrr + 1) * ((g_ucsra & (1<<U2X)) ? 8 : 16) ;
+}
+
+/*
+ * Description: Function to attach a TWI slave device
+ */
+void HOST_twiAttach(const HOST_TwiDeviceType *device)
+{
+	uint8 i;
+
+	for(i = 0 ; i < HOST_TWI_DEVICES_NUM ; i++)
+	{
+		if(g_twiDevices[i] == NULL_PTR)
+		{
+			g_twiDevices[i] = device ;
+			return ;
+		}
+	}
+}
+
+/*
+ * Description: Function to set the Sync Hook of the co-simulation
+ */
+void HOST_setSyncHook(void (*a_hook)(void))
+{
+	g_syncHook = a_hook ;
+}
+
+/*
+ * Description: Function to set the next sync time (virtual cycle)
+ */
+void HOST_setSyncTime(uint64 cycle)
+{
+	g_syncAt = cycle ;
+}
+
+/*
+ * Description: Function to start the virtual clock at cycle , before main()
+ */
+void HOST_powerOn(uint64 cycle)
+{
+	g_now = cycle ;
+	g_powerOnAt = cycle ;
+}
+
+/*
+ * Description: Function to set the device hooks of a port
+ */
+void HOST_gpioSetHooks(uint8 port, HOST_PinHook a_pinHook, HOST_PortHook a_portHook)
+{
+	uint8 i = (uint8)(port - 'A') ;
+
+	if(i < HOST_PORTS_NUM)
+	{
+		g_pinHooks[i] = a_pinHook ;
+		g_portHooks[i] = a_portHook ;
+	}
+}
+
+/*
+ * Description: avr-libc itoa() , not in glibc (LCD_intgerToString)
+ */
+void itoa(int value, char *str, int base)
+{
+	char digits[sizeof(int) * 8 + 1] ;
+	unsigned int number = (value < 0) && (base == 10) ? (unsigned int)(-value) : (unsigned int)value ;
+	uint8 i = 0 ;
+
+	if((value < 0) && (base == 10))
+		*str++ = '-' ;
+	do
+	{
+		digits[i++] = "0123456789abcdefghijklmnopqrstuvwxyz"[number % (unsigned int)base] ;
+		number /= (unsigned int)base ;
+	}while(number != 0);
+	while(i > 0)
+		*str++ = digits[--i] ;
+	*str = '\0' ;
+}
+
+/*
+ * Description: Function to advance the virtual clock event by event ,
+ * 				the interrupts are served at every event if the I-bit is set
+ */
+static void HOST_advance(uint64 cycles)
+{
+	uint64 target = g_now + cycles ;
+	uint64 next ;
+
+	while(1)
+	{
+		next = HOST_nextEvent();
+		if(next > target)
+			next = target ;
+		if(next > g_now)
+			g_now = next ;
+		if(g_now >= g_stopAt)
+			HOST_stop(0);
+		if(g_now >= g_syncAt)
+			HOST_sync();
+
+		HOST_update();
+		HOST_serve();
+
+		if(g_now >= target)
+			break;
+	}
+}
+
+/*
+ * Description: Function to bring all peripherals to the current cycle
+ */
+static void HOST_update(void)
+{
+	HOST_timerSync(0);
+	HOST_timerSync(1);
+	HOST_timerSync(2);
+	HOST_uartUpdate();
+	HOST_twiUpdate();
+}
+
+/*
+ * Description: Function to serve the pending interrupts , highest priority
+ * 				(lowest vector) first , as the AVR the I-bit is cleared in the ISR
+ */
+static void HOST_serve(void)
+{
+	static void (*const vectors[_VECTORS_SIZE])(void) =
+	{
+		[3] = __vector_3, [4] = __vector_4, [6] = __vector_6, [7] = __vector_7,
+		[8] = __vector_8, [9] = __vector_9, [11] = __vector_11, [12] = __vector_12,
+		[13] = __vector_13, [17] = __vector_17, [19] = __vector_19
+	};
+	uint64 start ;
+	uint8 vector ;
+
+	while((HOST_sreg & (1<<SREG_I)) && ((vector = HOST_pendingVector()) != 0))
+	{
+		if(vectors[vector] == NULL_PTR)
+		{
+			/* AVR jumps to __bad_interrupt => reset */
+			fprintf(stderr, "HOST: %s interrupt without ISR\n", g_vectorNames[vector]);
+			HOST_stop(1);
+		}
+
+		start = g_now ;
+		g_isrLatency = (uint32)(start + HOST_ISR_ENTRY_CYCLES - HOST_eventCycle(vector)) ;
+
+		/* Flags cleared by the hardware when the ISR starts */
+		switch(vector)
+		{
+		case 3:  g_tifr &= (uint8)~(1<<OCF2) ;	break;
+		case 4:  g_tifr &= (uint8)~(1<<TOV2) ;	break;
+		case 6:  g_tifr &= (uint8)~(1<<OCF1A) ;	break;
+		case 7:  g_tifr &= (uint8)~(1<<OCF1B) ;	break;
+		case 8:  g_tifr &= (uint8)~(1<<TOV1) ;	break;
+		case 9:  g_tifr &= (uint8)~(1<<TOV0) ;	break;
+		case 13: g_ucsra &= (uint8)~(1<<TXC) ;	break;
+		case 19: g_tifr &= (uint8)~(1<<OCF0) ;	break;
+		default: break;
+		}
+
+		HOST_sreg &= (uint8)~(1<<SREG_I) ;
+		g_now += HOST_ISR_ENTRY_CYCLES ;
+		(*vectors[vector])();
+		g_now += HOST_RETI_CYCLES ;
+		HOST_sreg |= (uint8)(1<<SREG_I) ;
+
+		g_vectorCount[vector]++ ;
+		g_stats.s_Isrs++ ;
+		g_stats.s_IsrCycles += g_now - start ;
+		HOST_update();
+	}
+}
+
+/*
+ * Description: Function returns the highest priority pending and enabled
+ * 				interrupt vector , 0 if none
+ */
+static uint8 HOST_pendingVector(void)
+{
+	uint8 pending = g_tifr & g_io[0x39] ;
+	uint8 ucsrb = g_io[0x0A] ;
+
+	if(pending & (1<<OCF2))		return 3 ;
+	if(pending & (1<<TOV2))		return 4 ;
+	if(pending & (1<<OCF1A))	return 6 ;
+	if(pending & (1<<OCF1B))	return 7 ;
+	if(pending & (1<<TOV1))		return 8 ;
+	if(pending & (1<<TOV0))		return 9 ;
+	if((ucsrb & (1<<RXCIE)) && (g_rxCount > 0))		return 11 ;
+	if((ucsrb & (1<<UDRIE)) && !g_txBufferFull)		return 12 ;
+	if((ucsrb & (1<<TXCIE)) && (g_ucsra & (1<<TXC)))	return 13 ;
+	if(g_twint && ((g_twcr & ((1<<TWIE) | (1<<TWEN))) == ((1<<TWIE) | (1<<TWEN))))	return 17 ;
+	if(pending & (1<<OCF0))		return 19 ;
+	return 0 ;
+}
+
+/*
+ * Description: Function returns the cycle of the event that raised the
+ * 				interrupt (flag set , oldest byte of the RX FIFO , TWINT) ,
+ * 				the other vectors => now
+ */
+static uint64 HOST_eventCycle(uint8 vector)
+{
+	switch(vector)
+	{
+	case 3:  return g_tifrAt[OCF2] ;
+	case 4:  return g_tifrAt[TOV2] ;
+	case 6:  return g_tifrAt[OCF1A] ;
+	case 7:  return g_tifrAt[OCF1B] ;
+	case 8:  return g_tifrAt[TOV1] ;
+	case 9:  return g_tifrAt[TOV0] ;
+	case 11: return g_rxFifoAt[0] ;
+	case 17: return g_twiAt ;
+	case 19: return g_tifrAt[OCF0] ;
+	default: return g_now ;
+	}
+}
+
+/*
+ * Description: Function returns the cycle of the next event that changes
+ * 				a flag (enabled timer interrupts , USART , TWI)
+ */
+static uint64 HOST_nextEvent(void)
+{
+	uint64 next = HOST_NEVER ;
+	uint64 t ;
+	uint8 i;
+
+	for(i = 0 ; i < HOST_TIMERS_NUM ; i++)
+	{
+		t = HOST_timerNext(i);
+		if(t < next)
+			next = t ;
+	}
+	if(g_txDoneAt < next)
+		next = g_txDoneAt ;
+	if((g_rxQueueTail != g_rxQueueHead) && (g_rxQueueAt[g_rxQueueTail] < next))
+		next = g_rxQueueAt[g_rxQueueTail] ;
+	if(g_twiDoneAt < next)
+		next = g_twiDoneAt ;
+	if(g_syncAt < next)
+		next = g_syncAt ;
+	return next ;
+}
+
+/*
+ * Description: Function to hand over to the co-simulation at the sync time ,
+ * 				the hook returns after it set the next sync time
+ */
+static void HOST_sync(void)
+{
+	if(g_syncHook == NULL_PTR)
+	{
+		g_syncAt = HOST_NEVER ;
+		return ;
+	}
+	while(g_now >= g_syncAt)
+		(*g_syncHook)();
+}
+
+/*
+ * Description: Function to stop the simulation , print the report and exit
+ * 				status = 0 => end of HOST_RUN_MS , 1 => firmware fault
+ */
+static void HOST_stop(int status)
+{
+	HOST_report(program_invocation_short_name);
+	exit(status);
+}
+
+/*
+ * Description: Function to decode the mode , clock and compare values of a timer
+ */
+static void HOST_timerConfig(uint8 n, HOST_TimerConfigType *config)
+{
+	static const uint16 div01[8] = {0, 1, 8, 64, 256, 1024, 0, 0};
+	static const uint16 div2[8] = {0, 1, 8, 32, 64, 128, 256, 1024};
+	uint8 tccr ;
+	uint8 wgm ;
+
+	config->s_ocrB = 0xFFFF ;
+	config->s_ctc = FALSE ;
+
+	if(n == 1)
+	{
+		tccr = g_io[0x2E] ;
+		wgm = (uint8)((g_io[0x2F] & 0x03) | ((tccr >> WGM12) & 0x03) << 2) ;
+		config->s_div = div01[tccr & 0x07] ;
+		config->s_ocrA = g_ocr1a ;
+		config->s_ocrB = g_ocr1b ;
+		switch(wgm)
+		{
+		case 4:		config->s_top = g_ocr1a ;	config->s_ctc = TRUE ;	break;
+		case 12:	config->s_top = g_icr1 ;	config->s_ctc = TRUE ;	break;
+		case 14:	config->s_top = g_icr1 ;	break;
+		case 15:	config->s_top = g_ocr1a ;	break;
+		case 5:		config->s_top = 0x00FF ;	break;
+		case 6:		config->s_top = 0x01FF ;	break;
+		case 7:		config->s_top = 0x03FF ;	break;
+		default:	config->s_top = 0xFFFF ;	break;
+		}
+	}
+	else
+	{
+		tccr = (n == 0) ? g_io[0x33] : g_io[0x25] ;
+		wgm = (uint8)(((tccr >> WGM00) & 0x01) | (((tccr >> WGM01) & 0x01) << 1)) ;
+		config->s_div = (n == 0) ? div01[tccr & 0x07] : div2[tccr & 0x07] ;
+		config->s_ocrA = (n == 0) ? g_io[0x3C] : g_io[0x23] ;
+		config->s_top = 0xFF ;
+		if(wgm == 2)
+		{
+			config->s_top = config->s_ocrA ;
+			config->s_ctc = TRUE ;
+		}
+	}
+}
+
+/*
+ * Description: Function to count the timer clocks up to now and set the
+ * 				compare / overflow flags passed on the way
+ */
+static void HOST_timerSync(uint8 n)
+{
+	HOST_TimerType *t = &g_timers[n] ;
+	HOST_TimerConfigType config ;
+	uint32 period ;
+	uint64 ticks , base ;
+	uint32 distance ;
+
+	HOST_timerConfig(n, &config);
+	if(config.s_div == 0)
+	{
+		t->s_last = g_now ;
+		return ;
+	}
+
+	ticks = (g_now - t->s_last) / config.s_div ;
+	if(ticks == 0)
+		return ;
+	base = t->s_last ;
+	t->s_last += ticks * config.s_div ;
+
+	/* Counter above TOP (TOP changed) => runs to MAX first , not modelled */
+	if(t->s_count > config.s_top)
+		t->s_count = 0 ;
+	period = (uint32)config.s_top + 1 ;
+
+	/* Compare Match when TCNT == OCR , the flag is set on the next clock */
+	if(config.s_ocrA <= config.s_top)
+	{
+		distance = (config.s_ocrA + period - t->s_count) % period ;
+		if((uint64)(distance + 1) <= ticks)
+			HOST_timerFlag(t->s_ocfA, base + (uint64)(distance + 1) * config.s_div);
+	}
+	if((t->s_ocfB != 0) && (config.s_ocrB <= config.s_top))
+	{
+		distance = (config.s_ocrB + period - t->s_count) % period ;
+		if((uint64)(distance + 1) <= ticks)
+			HOST_timerFlag(t->s_ocfB, base + (uint64)(distance + 1) * config.s_div);
+	}
+
+	/* Overflow at MAX (Normal / PWM) , in CTC only if TOP = MAX */
+	distance = config.s_top - t->s_count + 1 ;
+	if((distance <= ticks) && (!config.s_ctc || (config.s_top == ((n == 1) ? 0xFFFF : 0xFF))))
+		HOST_timerFlag(t->s_tov, base + (uint64)distance * config.s_div);
+
+	t->s_count = (uint16)((t->s_count + ticks) % period) ;
+}
+
+/*
+ * Description: Function to set a TIFR flag raised at cycle , the cycle of a
+ * 				flag already set is kept (first event not served)
+ */
+static void HOST_timerFlag(uint8 flag, uint64 cycle)
+{
+	uint8 bit ;
+
+	if(g_tifr & flag)
+		return ;
+	g_tifr |= flag ;
+	for(bit = 0 ; bit < 8 ; bit++)
+	{
+		if(flag == (1<<bit))
+			g_tifrAt[bit] = cycle ;
+	}
+}
+
+/*
+ * Description: Function returns the cycle of the next enabled timer interrupt flag
+ */
+static uint64 HOST_timerNext(uint8 n)
+{
+	HOST_TimerType *t = &g_timers[n] ;
+	HOST_TimerConfigType config ;
+	uint8 enabled = g_io[0x39] & (uint8)~g_tifr ;
+	uint32 period ;
+	uint32 distance ;
+	uint64 next = HOST_NEVER ;
+	uint64 at ;
+
+	HOST_timerConfig(n, &config);
+	if(config.s_div == 0)
+		return HOST_NEVER ;
+
+	period = (uint32)config.s_top + 1 ;
+	if((enabled & t->s_ocfA) && (config.s_ocrA <= config.s_top))
+	{
+		distance = (config.s_ocrA + period - t->s_count) % period ;
+		at = t->s_last + (uint64)(distance + 1) * config.s_div ;
+		if(at < next)
+			next = at ;
+	}
+	if((enabled & t->s_ocfB) && (config.s_ocrB <= config.s_top))
+	{
+		distance = (config.s_ocrB + period - t->s_count) % period ;
+		at = t->s_last + (uint64)(distance + 1) * config.s_div ;
+		if(at < next)
+			next = at ;
+	}
+	if((enabled & t->s_tov) && !config.s_ctc)
+	{
+		at = t->s_last + (uint64)(config.s_top - t->s_count + 1) * config.s_div ;
+		if(at < next)
+			next = at ;
+	}
+	return next ;
+}
+
+/*
+ * Description: Function to finish the USART frames up to now
+ */
+static void HOST_uartUpdate(void)
+{
+	uint8 data ;
+	uint64 at ;
+
+	/* Transmitter : shift register empty => next byte from UDR buffer */
+	while(g_txShiftBusy && (g_txDoneAt <= g_now))
+	{
+		data = g_txShift ;
+		g_stats.s_UartTx++ ;
+		if(g_txBufferFull)
+		{
+			g_txBufferFull = FALSE ;
+			HOST_uartShift(g_txBuffer, g_txDoneAt);
+		}
+		else
+		{
+			g_txShiftBusy = FALSE ;
+			g_txDoneAt = HOST_NEVER ;
+			g_ucsra |= (1<<TXC) ;
+		}
+
+		if(g_trace)
+			fprintf(stderr, "HOST: %10.3f ms TX %02X\n", (double)g_now * 1000.0 / F_CPU, data);
+	}
+
+	/* Receiver : stop bit of the queued bytes */
+	while((g_rxQueueTail != g_rxQueueHead) && (g_rxQueueAt[g_rxQueueTail] <= g_now))
+	{
+		data = g_rxQueue[g_rxQueueTail] ;
+		at = g_rxQueueAt[g_rxQueueTail] ;
+		g_rxQueueTail = (uint8)((g_rxQueueTail + 1) % HOST_RX_QUEUE_SIZE) ;
+
+		if(!(g_io[0x0A] & (1<<RXEN)))
+			continue;
+		g_stats.s_UartRx++ ;
+		if(g_rxCount < 2)
+		{
+			g_rxFifoAt[g_rxCount] = at ;
+			g_rxFifo[g_rxCount++] = data ;
+		}
+		else
+		{
+			/* UDR FIFO full => Data OverRun , the byte is lost */
+			g_ucsra |= (1<<DOR) ;
+			g_stats.s_UartOverruns++ ;
+		}
+	}
+}
+
+/*
+ * Description: Function to load the shift register , the TX Hook gets the
+ * 				byte at its start bit with the cycle of its stop bit end
+ * 				(one frame of lookahead for the co-simulation)
+ */
+static void HOST_uartShift(uint8 data, uint64 start)
+{
+	g_txShift = data ;
+	g_txShiftBusy = TRUE ;
+	g_txDoneAt = start + HOST_uartFrameCycles() ;
+
+	if(g_uartTxHook != NULL_PTR)
+		(*g_uartTxHook)(data, g_txDoneAt);
+}
+
+/*
+ * Description: Function to write UDR , the byte goes to the shift register
+ * 				if it is empty (UDRE stays set) , else to the UDR buffer
+ */
+static void HOST_uartWriteData(uint8 data)
+{
+	if(!(g_io[0x0A] & (1<<TXEN)))
+		return ;
+
+	if(!g_txShiftBusy)
+	{
+		HOST_uartShift(data, g_now);
+	}
+	else if(!g_txBufferFull)
+	{
+		g_txBuffer = data ;
+		g_txBufferFull = TRUE ;
+	}
+}
+
+/*
+ * Description: Function to read UDR , next byte of the RX FIFO
+ */
+static uint8 HOST_uartReadData(void)
+{
+	uint8 data ;
+
+	if(g_rxCount == 0)
+		return g_rxFifo[0] ;
+
+	data = g_rxFifo[0] ;
+	g_rxFifo[0] = g_rxFifo[1] ;
+	g_rxFifoAt[0] = g_rxFifoAt[1] ;
+	g_rxCount-- ;
+	if(g_rxCount == 0)
+		g_ucsra &= (uint8)~(1<<DOR) ;
+	return data ;
+}
+
+/*
+ * Description: Function to finish the running TWI bus action
+ */
+static void HOST_twiUpdate(void)
+{
+	if(g_twiDoneAt <= g_now)
+	{
+		g_twiAt = g_twiDoneAt ;
+		g_twiDoneAt = HOST_NEVER ;
+		g_twsr = g_twiNextStatus ;
+		g_twint = TRUE ;
+	}
+}
+
+/*
+ * Description: Function to write TWCR , TWINT = 1 clears the flag and
+ * 				starts the bus action selected by TWSTA / TWSTO / phase
+ */
+static void HOST_twiControl(uint8 value)
+{
+	uint32 bit = HOST_twiBitCycles() ;
+	bool ack ;
+	uint8 i;
+
+	g_twcr = value & (uint8)~((1<<TWINT) | (1<<TWWC)) ;
+
+	if(!(value & (1<<TWEN)))
+	{
+		g_twint = FALSE ;
+		g_twiOwner = FALSE ;
+		g_twiPhase = TWI_IDLE ;
+		g_twiDoneAt = HOST_NEVER ;
+		return ;
+	}
+	if(!(value & (1<<TWINT)))
+		return ;
+
+	g_twint = FALSE ;
+
+	if(value & (1<<TWSTO))
+	{
+		if(g_twiOwner && (g_twiSlave != NULL_PTR) && (g_twiSlave->s_stop != NULL_PTR))
+			(*g_twiSlave->s_stop)();
+		g_twiSlave = NULL_PTR ;
+		g_twiOwner = FALSE ;
+		g_twiPhase = TWI_IDLE ;
+		g_twsr = HOST_TW_NO_INFO ;
+		g_twcr &= (uint8)~(1<<TWSTO) ;
+		if(!(value & (1<<TWSTA)))
+			return ;
+	}
+
+	if(value & (1<<TWSTA))
+	{
+		g_twiNextStatus = g_twiOwner ? HOST_TW_REP_START : HOST_TW_START ;
+		g_twiOwner = TRUE ;
+		g_twiPhase = TWI_ADDRESS ;
+		g_twiDoneAt = g_now + bit ;
+		return ;
+	}
+
+	g_stats.s_TwiBytes++ ;
+	g_twiDoneAt = g_now + (9 * bit) ;
+
+	switch(g_twiPhase)
+	{
+	case TWI_ADDRESS:
+		g_twiSlave = NULL_PTR ;
+		ack = FALSE ;
+		for(i = 0 ; (i < HOST_TWI_DEVICES_NUM) && (g_twiDevices[i] != NULL_PTR) ; i++)
+		{
+			if((g_twdr & g_twiDevices[i]->s_AddressMask) == g_twiDevices[i]->s_Address)
+			{
+				g_twiSlave = g_twiDevices[i] ;
+				ack = (*g_twiSlave->s_start)(g_twdr);
+				break;
+			}
+		}
+		if(g_twdr & 0x01)
+		{
+			g_twiNextStatus = ack ? HOST_TW_MR_SLA_ACK : HOST_TW_MR_SLA_NACK ;
+			g_twiPhase = ack ? TWI_RECEIVE : TWI_NACKED ;
+		}
+		else
+		{
+			g_twiNextStatus = ack ? HOST_TW_MT_SLA_ACK : HOST_TW_MT_SLA_NACK ;
+			g_twiPhase = ack ? TWI_TRANSMIT : TWI_NACKED ;
+		}
+		break;
+	case TWI_TRANSMIT:
+		ack = (*g_twiSlave->s_write)(g_twdr);
+		g_twiNextStatus = ack ? HOST_TW_MT_DATA_ACK : HOST_TW_MT_DATA_NACK ;
+		break;
+	case TWI_RECEIVE:
+		ack = (value & (1<<TWEA)) ? TRUE : FALSE ;
+		g_twdr = (*g_twiSlave->s_read)(ack);
+		g_twiNextStatus = ack ? HOST_TW_MR_DATA_ACK : HOST_TW_MR_DATA_NACK ;
+		break;
+	default:
+		/* Data after NACK / without Start */
+		g_twiNextStatus = HOST_TW_BUS_ERROR ;
+		break;
+	}
+}
+
+/*
+ * Description: Function returns the CPU cycles of one SCL period
+ * 				SCL = F_CPU / (16 + 2 * TWBR * 4^TWPS)
+ */
+static uint32 HOST_twiBitCycles(void)
+{
+	return 16UL + 2UL * g_io[0x00] * (1UL << (2 * (g_io[0x01] & 0x03))) ;
+}
+
+/*
+ * Description: Function to read PINx , outputs + levels of the input pins
+ * 				from the device hook , no device => internal pull-ups
+ */
+static uint8 HOST_gpioRead(uint8 address)
+{
+	uint8 i = (uint8)(3 - ((address - 0x10) / 3)) ;
+	uint8 ddr = g_io[address + 1] ;
+	uint8 out = g_io[address + 2] ;
+	uint8 in = out ;
+
+	if(g_pinHooks[i] != NULL_PTR)
+		in = (*g_pinHooks[i])((uint8)('A' + i), ddr, out);
+
+	return (uint8)((ddr & out) | (~ddr & in)) ;
+}
+
+/*
+ * Description: Function to write DDRx / PORTx and notify the device
+ */
+static void HOST_gpioWrite(uint8 address, uint8 value)
+{
+	uint8 pin = (uint8)(address - ((address - 0x10) % 3)) ;
+	uint8 i = (uint8)(3 - ((pin - 0x10) / 3)) ;
+
+	g_io[address] = value ;
+	if(g_portHooks[i] != NULL_PTR)
+		(*g_portHooks[i])((uint8)('A' + i), g_io[pin + 1], g_io[pin + 2]);
+}
@@ -0,0 +1,587 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Co-simulation
+ * File Name: 	host_scenarios.c
+ * Description: Source file of the co-simulation scenarios , a scenario is a
+ * 				table of steps : press keys , wait a LCD text / motor /
+ * 				door / buzzer state before a timeout (virtual time)
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_cosim.h"
+#include "door_lock_protocol.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* Key press and release time , > debounce (4 samples * 5 ms) */
+#define SCEN_KEY_PRESS_MS		50
+#define SCEN_KEY_RELEASE_MS		50
+
+/* Time of a debug reply (request + reply frames + task latency) */
+#define SCEN_DEBUG_REPLY_MS		200
+
+/* Time of a Control ECU reply to a request of the debug tool (TOOL , VERIFY) ,
+ * Max. difference of the CHECK_USER reply latency between the matches
+ * (Password , User) : far below one User Table page read */
+#define SCEN_TOOL_REPLY_MS		100
+#define SCEN_VERIFY_JITTER_US	50
+
+/* Door open / closed limits of the door position */
+#define SCEN_DOOR_OPEN_PCT		90.0
+#define SCEN_DOOR_CLOSED_PCT	10.0
+
+/* Steps */
+#define LCD(text, ms)			{STEP_LCD, (text), 0, (ms)}
+#define KEYS(keys)				{STEP_KEYS, (keys), 0, 0}
+#define HOLD(key, ms)			{STEP_HOLD, (key), 0, (ms)}
+#define WAIT(ms)				{STEP_WAIT, NULL_PTR, 0, (ms)}
+#define MOTOR(state, ms)		{STEP_MOTOR, NULL_PTR, (state), (ms)}
+#define DOOR_OPEN(ms)			{STEP_DOOR_OPEN, NULL_PTR, 0, (ms)}
+#define DOOR_CLOSED(ms)			{STEP_DOOR_CLOSED, NULL_PTR, 0, (ms)}
+#define BUZZER(on, ms)			{STEP_BUZZER, NULL_PTR, (on), (ms)}
+#define EEPROM_WRITTEN(address)	{STEP_EEPROM_WRITTEN, NULL_PTR, (address), 0}
+#define RESET(ecu)				{STEP_RESET, NULL_PTR, (ecu), 0}
+#define DEBUG_REQUEST(ecu, command)	{STEP_DEBUG_REQUEST, NULL_PTR, ((ecu) << 8) | (command), SCEN_DEBUG_REPLY_MS}
+#define TOOL(command, digits, reply)	{STEP_TOOL, (digits), ((command) << 8) | (reply), SCEN_TOOL_REPLY_MS}
+#define VERIFY(pin, reply)		{STEP_VERIFY, (pin), (reply), SCEN_TOOL_REPLY_MS}
+#define END()					{STEP_END, NULL_PTR, 0, 0}
+
+/* First start : no password in the EEPROM => set password 12345 */
+#define SET_PASSWORD_STEPS							\
+	LCD("Enter New PASS", 2000),					\
+	KEYS("12345"),									\
+	LCD("ReEnter PASS", 1000),						\
+	KEYS("12345"),									\
+	LCD("Confirmed", 1000),							\
+	LCD("+ : Change PASS", 3000)
+
+/* Unlock with the password , the door opens and closes again */
+#define UNLOCK_STEPS								\
+	KEYS("-"),										\
+	LCD("Enter  PASS", 1000),						\
+	KEYS("12345"),									\
+	LCD("Door Open", 2000),							\
+	DOOR_OPEN(12000),								\
+	DOOR_CLOSED(20000),								\
+	LCD("+ : Change PASS", 3000)
+
+/* Day of usage : 30 unlocks , one every 48 min (unlock + idle time) */
+#define SCEN_DAY_IDLE_MS		(48UL * 60UL * 1000UL - 30000UL)
+#define DAY_HOUR_STEPS			UNLOCK_STEPS, WAIT(SCEN_DAY_IDLE_MS)
+#define DAY_5_HOURS_STEPS		DAY_HOUR_STEPS, DAY_HOUR_STEPS, DAY_HOUR_STEPS,	\
+								DAY_HOUR_STEPS, DAY_HOUR_STEPS
+
+/* Wrong password from the main screen => lock window , back to the main
+ * screen when the window is over */
+#define WRONG_PASS_STEPS(wait, windowMs)			\
+	KEYS("-"),										\
+	LCD("Enter  PASS", 1000),						\
+	KEYS("99999"),									\
+	LCD((wait), 2000),								\
+	LCD("+ : Change PASS", (windowMs) + 2000)
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef enum
+{
+	STEP_LCD, STEP_KEYS, STEP_HOLD, STEP_WAIT, STEP_MOTOR, STEP_DOOR_OPEN,
+	STEP_DOOR_CLOSED, STEP_BUZZER, STEP_EEPROM_WRITTEN, STEP_RESET, STEP_DEBUG_REQUEST, STEP_TOOL,
+	STEP_VERIFY, STEP_END
+}SCEN_StepKind;
+
+typedef struct
+{
+	SCEN_StepKind s_Kind ;
+	const char *s_Text ;
+	uint32 s_Value ;
+	uint32 s_Ms ;
+}SCEN_StepType;
+
+typedef struct
+{
+	const char *s_Name ;
+	const SCEN_StepType *s_Steps ;
+
+	/* Long scenario , run only by its name */
+	bool s_Long ;
+}SCEN_ScenarioType;
+
+/*******************************************************************************
+ *                           Scenarios                                         *
+ *******************************************************************************/
+
+static const SCEN_StepType g_setPassword[] =
+{
+	SET_PASSWORD_STEPS,
+	/* Credential Store record */
+	EEPROM_WRITTEN(0x0100),
+	END()
+};
+
+static const SCEN_StepType g_openDoor[] =
+{
+	SET_PASSWORD_STEPS,
+	KEYS("-"),
+	LCD("Enter  PASS", 1000),
+	KEYS("12345"),
+	LCD("Door Open", 2000),
+	MOTOR(MOTOR_OPENING, 1000),
+	DOOR_OPEN(12000),
+	MOTOR(MOTOR_CLOSING, 5000),
+	LCD("Door Close", 2000),
+	DOOR_CLOSED(12000),
+	LCD("+ : Change PASS", 3000),
+	END()
+};
+
+static const SCEN_StepType g_changePassword[] =
+{
+	SET_PASSWORD_STEPS,
+	KEYS("+"),
+	LCD("Enter Old PASS", 1000),
+	KEYS("12345"),
+	LCD("Enter New PASS", 2000),
+	KEYS("54321"),
+	LCD("ReEnter PASS", 1000),
+	KEYS("54321"),
+	LCD("Confirmed", 1000),
+	LCD("+ : Change PASS", 3000),
+	/* Root Password (long =) resets the forgotten Password */
+	HOLD("=", 3500),
+	LCD("Enter Root PASS", 1000),
+	KEYS("26495"),
+	LCD("Enter New PASS", 1000),
+	KEYS("13579"),
+	LCD("ReEnter PASS", 1000),
+	KEYS("13579"),
+	LCD("Confirmed", 1000),
+	LCD("+ : Change PASS", 3000),
+	KEYS("-"),
+	LCD("Enter  PASS", 1000),
+	KEYS("13579"),
+	LCD("Door Open", 2000),
+	MOTOR(MOTOR_OPENING, 1000),
+	END()
+};
+
+/* 3 wrong passwords => 30 s lock , 10 s alarm , then the right one opens */
+static const SCEN_StepType g_lockout[] =
+{
+	SET_PASSWORD_STEPS,
+	KEYS("-"),
+	LCD("Enter  PASS", 1000),
+	KEYS("99999"),
+	WAIT(500),
+	LCD("Enter  PASS", 1000),
+	KEYS("99999"),
+	WAIT(500),
+	LCD("Enter  PASS", 1000),
+	KEYS("99999"),
+	LCD("System Blocked", 2000),
+	BUZZER(TRUE, 100),
+	LCD("Wait 00:", 100),
+	/* keys are ignored while blocked */
+	KEYS("12345"),
+	LCD("System Blocked", 100),
+	BUZZER(FALSE, 11000),
+	LCD("+ : Change PASS", 25000),
+	KEYS("-"),
+	LCD("Enter  PASS", 1000),
+	KEYS("12345"),
+	LCD("Door Open", 2000),
+	END()
+};
+
+/* Wrong passwords replayed : the window doubles from 30 s up to 1 h
+ * (30 * 2^7 s => 60:00) , a Control reset in a window locks it again
+ * without a new failure and keeps the counter (next window 04:00) .
+ * Wrong Root Passwords (long =) , Old Passwords (+) and a CHANGE_PASSWORD
+ * of a debug tool with a wrong Old Password are counted too : the 3rd
+ * failure locks */
+static const SCEN_StepType g_bruteForce[] =
+{
+	SET_PASSWORD_STEPS,
+	HOLD("=", 3500),
+	LCD("Enter Root PASS", 1000),
+	KEYS("99999"),
+	WAIT(500),
+	LCD("Enter Root PASS", 1000),
+	TOOL(CHANGE_PASSWORD, "9999954321", DONT_MATCH),
+	KEYS("88888"),
+	LCD("Wait 00:30", 2000),
+	LCD("+ : Change PASS", 32000),
+	KEYS("+"),
+	LCD("Enter Old PASS", 1000),
+	KEYS("99999"),
+	LCD("Wait 01:00", 2000),
+	LCD("+ : Change PASS", 62000),
+	KEYS("-"),
+	LCD("Enter  PASS", 1000),
+	KEYS("99999"),
+	LCD("Wait 02:00", 2000),
+	/* Power cycle 20 s in the 2 min window , the HMI keeps its count down */
+	WAIT(20000),
+	RESET(COSIM_CONTROL),
+	LCD("+ : Change PASS", 102000),
+	WRONG_PASS_STEPS("Wait 00:", 20000UL),
+	WRONG_PASS_STEPS("Wait 04:00", 240000UL),
+	WRONG_PASS_STEPS("Wait 08:00", 480000UL),
+	WRONG_PASS_STEPS("Wait 16:00", 960000UL),
+	WRONG_PASS_STEPS("Wait 32:00", 1920000UL),
+	KEYS("-"),
+	LCD("Enter  PASS", 1000),
+	KEYS("99999"),
+	LCD("Wait 60:00", 2000),
+	END()
+};
+
+/* A debug tool on the link of one ECU sends each debug request once : one
+ * reply comes back , the other ECU doesn't answer the reply (no ping-pong) ,
+ * the door still opens */
+static const SCEN_StepType g_debugFrames[] =
+{
+	SET_PASSWORD_STEPS,
+	DEBUG_REQUEST(COSIM_CONTROL, PROF_STATS),
+	DEBUG_REQUEST(COSIM_CONTROL, ISR_STATS),
+	DEBUG_REQUEST(COSIM_CONTROL, STACK_STATS),
+	DEBUG_REQUEST(COSIM_CONTROL, SCHED_STATS),
+	DEBUG_REQUEST(COSIM_CONTROL, POWER_STATS),
+	DEBUG_REQUEST(COSIM_HMI, SCHED_STATS),
+	DEBUG_REQUEST(COSIM_HMI, POWER_STATS),
+	DEBUG_REQUEST(COSIM_HMI, PROF_STATS),
+	DEBUG_REQUEST(COSIM_HMI, ISR_STATS),
+	DEBUG_REQUEST(COSIM_HMI, STACK_STATS),
+	KEYS("-"),
+	LCD("Enter  PASS", 1000),
+	KEYS("12345"),
+	LCD("Door Open", 2000),
+	END()
+};
+
+/* CHECK_USER from a debug tool on the Control link : the Password and a User
+ * are answered after the same latency (no timing leak of the Password) ,
+ * a wrong PIN is counted in the Lockout (slower , counter write) */
+static const SCEN_StepType g_verifyLatency[] =
+{
+	SET_PASSWORD_STEPS,
+	KEYS("*"),
+	LCD("Enter Admin PASS", 1000),
+	KEYS("12345"),
+	LCD("Add User PIN", 1000),
+	KEYS("24680"),
+	LCD("Done", 2000),
+	LCD("+ : Change PASS", 5000),
+	VERIFY("12345", MATCH),
+	VERIFY("24680", MATCH),
+	VERIFY("12345", MATCH),
+	VERIFY("24680", MATCH),
+	VERIFY("99999", DONT_MATCH),
+	END()
+};
+
+/* 24 h of usage for the duty cycle and current report (-p) : 30 unlocks ,
+ * a user added and revoked , idle (main screen) in between */
+static const SCEN_StepType g_day[] =
+{
+	SET_PASSWORD_STEPS,
+	DAY_5_HOURS_STEPS,
+	DAY_5_HOURS_STEPS,
+	DAY_5_HOURS_STEPS,
+	KEYS("*"),
+	LCD("Enter Admin PASS", 1000),
+	KEYS("12345"),
+	LCD("Add User PIN", 1000),
+	KEYS("24680"),
+	LCD("Done", 2000),
+	LCD("+ : Change PASS", 5000),
+	DAY_5_HOURS_STEPS,
+	DAY_5_HOURS_STEPS,
+	KEYS("/"),
+	LCD("Enter Admin PASS", 1000),
+	KEYS("12345"),
+	LCD("Revoke User PIN", 1000),
+	KEYS("24680"),
+	LCD("Done", 2000),
+	LCD("+ : Change PASS", 5000),
+	DAY_5_HOURS_STEPS,
+	END()
+};
+
+static const SCEN_ScenarioType g_scenarios[] =
+{
+	{"set_password", g_setPassword},
+	{"open_door", g_openDoor},
+	{"change_password", g_changePassword},
+	{"lockout", g_lockout},
+	{"brute_force", g_bruteForce},
+	{"debug_frames", g_debugFrames},
+	{"verify_latency", g_verifyLatency},
+	{"day", g_day, TRUE}
+};
+
+#define SCEN_NUM	(sizeof(g_scenarios) / sizeof(g_scenarios[0]))
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static bool SCEN_step(const SCEN_StepType *step);
+static bool SCEN_check(const SCEN_StepType *step);
+static bool SCEN_runMs(uint32 ms);
+static bool SCEN_debugRequest(const SCEN_StepType *step);
+static bool SCEN_toolRequest(uint8 command, const char *digits, uint32 ms, uint64 *latency);
+static bool SCEN_verify(const SCEN_StepType *step);
+static void SCEN_fail(uint16 index, const SCEN_StepType *step);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Functions return the number of scenarios and their names
+ */
+uint8 SCEN_count(void)
+{
+	return (uint8)SCEN_NUM ;
+}
+
+const char *SCEN_name(uint8 index)
+{
+	return (index < SCEN_NUM) ? g_scenarios[index].s_Name : NULL_PTR ;
+}
+
+/*
+ * Description: Function returns TRUE if the scenario is run only by its name
+ */
+bool SCEN_isLong(uint8 index)
+{
+	return (index < SCEN_NUM) && g_scenarios[index].s_Long ;
+}
+
+/*
+ * Description: Function to run a scenario , step by step
+ */
+bool SCEN_run(const char *name)
+{
+	const SCEN_StepType *steps = NULL_PTR ;
+	uint16 i;
+
+	for(i = 0 ; i < SCEN_NUM ; i++)
+	{
+		if(strcmp(g_scenarios[i].s_Name, name) == 0)
+			steps = g_scenarios[i].s_Steps ;
+	}
+	if(steps == NULL_PTR)
+	{
+		printf("COSIM: no scenario %s\n", name);
+		return FALSE ;
+	}
+
+	for(i = 0 ; steps[i].s_Kind != STEP_END ; i++)
+	{
+		if(!SCEN_step(&steps[i]))
+		{
+			SCEN_fail(i, &steps[i]);
+			return FALSE ;
+		}
+	}
+	return TRUE ;
+}
+
+/*
+ * Description: Function to run one step , the wait steps poll their
+ * 				condition every 1 ms of virtual time up to the timeout
+ */
+static bool SCEN_step(const SCEN_StepType *step)
+{
+	uint64 deadline = COSIM_now() + (uint64)step->s_Ms * COSIM_MS_CYCLES ;
+	const char *key ;
+
+	switch(step->s_Kind)
+	{
+	case STEP_KEYS:
+		for(key = step->s_Text ; *key != '\0' ; key++)
+		{
+			if(g_cosimVerbose)
+				printf("%12.3f ms KEY    %c\n", COSIM_ms(COSIM_now()), *key);
+			if(!DEV_keySet(*key, TRUE) || !SCEN_runMs(SCEN_KEY_PRESS_MS))
+				return FALSE ;
+			DEV_keySet(*key, FALSE);
+			if(!SCEN_runMs(SCEN_KEY_RELEASE_MS))
+				return FALSE ;
+		}
+		return TRUE ;
+
+	case STEP_HOLD:
+		if(g_cosimVerbose)
+			printf("%12.3f ms KEY    %c held %u ms\n", COSIM_ms(COSIM_now()), step->s_Text[0], step->s_Ms);
+		if(!DEV_keySet(step->s_Text[0], TRUE) || !SCEN_runMs(step->s_Ms))
+			return FALSE ;
+		DEV_keySet(step->s_Text[0], FALSE);
+		return SCEN_runMs(SCEN_KEY_RELEASE_MS);
+
+	case STEP_WAIT:
+		return SCEN_runMs(step->s_Ms);
+
+	case STEP_RESET:
+		COSIM_reset((uint8)step->s_Value);
+		return TRUE ;
+
+	case STEP_DEBUG_REQUEST:
+		return SCEN_debugRequest(step);
+
+	case STEP_TOOL:
+		return SCEN_toolRequest((uint8)(step->s_Value >> 8), step->s_Text, step->s_Ms, NULL_PTR) &&
+				(g_cosimEcus[COSIM_CONTROL].s_TxCommand == (uint8)step->s_Value) ;
+
+	case STEP_VERIFY:
+		return SCEN_verify(step);
+
+	default:
+		while(!SCEN_check(step))
+		{
+			if((COSIM_now() >= deadline) || !SCEN_runMs(1))
+				return FALSE ;
+		}
+		return TRUE ;
+	}
+}
+
+/*
+ * Description: Function returns TRUE if the condition of a wait step is true
+ */
+static bool SCEN_check(const SCEN_StepType *step)
+{
+	switch(step->s_Kind)
+	{
+	case STEP_LCD:
+		return DEV_lcdContains(step->s_Text);
+	case STEP_MOTOR:
+		return DEV_motorState() == (COSIM_MotorState)step->s_Value ;
+	case STEP_DOOR_OPEN:
+		return (DEV_doorPosition() >= SCEN_DOOR_OPEN_PCT) && (DEV_motorState() == MOTOR_STOPPED) ;
+	case STEP_DOOR_CLOSED:
+		return (DEV_doorPosition() <= SCEN_DOOR_CLOSED_PCT) && (DEV_motorState() == MOTOR_STOPPED) ;
+	case STEP_BUZZER:
+		return DEV_buzzerOn() == (bool)step->s_Value ;
+	case STEP_EEPROM_WRITTEN:
+		return DEV_eepromRead((uint16)step->s_Value) != 0xFF ;
+	default:
+		return TRUE ;
+	}
+}
+
+/*
+ * Description: Function to run the co-simulation for ms of virtual time
+ */
+static bool SCEN_runMs(uint32 ms)
+{
+	return COSIM_runUntil(COSIM_now() + (uint64)ms * COSIM_MS_CYCLES);
+}
+
+/*
+ * Description: Function to send a debug request to an ECU , exactly one
+ * 				frame comes back (the reply) and the peer ECU sends nothing
+ */
+static bool SCEN_debugRequest(const SCEN_StepType *step)
+{
+	COSIM_EcuType *ecu = &g_cosimEcus[step->s_Value >> 8] ;
+	COSIM_EcuType *peer = &g_cosimEcus[((step->s_Value >> 8) == COSIM_HMI) ? COSIM_CONTROL : COSIM_HMI] ;
+	uint8 command = (uint8)step->s_Value ;
+	uint32 frames = ecu->s_TxFrames ;
+	uint32 peerFrames = peer->s_TxFrames ;
+
+	COSIM_sendFrame((uint8)(step->s_Value >> 8), command, NULL_PTR, 0);
+	if(!SCEN_runMs(step->s_Ms))
+		return FALSE ;
+
+	return (ecu->s_TxFrames == frames + 1) && (ecu->s_TxCommand == (command | DEBUG_REPLY)) &&
+			(peer->s_TxFrames == peerFrames) ;
+}
+
+/*
+ * Description: Function to send a request to the Control ECU like a debug
+ * 				tool , the payload is the digits of the text , and wait the
+ * 				reply (s_TxCommand) . The latency is from the end of the
+ * 				request to the end of the reply (NULL_PTR => not returned)
+ */
+static bool SCEN_toolRequest(uint8 command, const char *digits, uint32 ms, uint64 *latency)
+{
+	COSIM_EcuType *control = &g_cosimEcus[COSIM_CONTROL] ;
+	uint64 deadline = COSIM_now() + (uint64)ms * COSIM_MS_CYCLES ;
+	uint32 frames = control->s_TxFrames ;
+	uint8 payload[FRAME_MAX_PAYLOAD] ;
+	uint8 length ;
+	uint64 sent ;
+
+	for(length = 0 ; (digits[length] != '\0') && (length < FRAME_MAX_PAYLOAD) ; length++)
+	{
+		payload[length] = (uint8)(digits[length] - '0') ;
+	}
+	sent = COSIM_sendFrame(COSIM_CONTROL, command, payload, length) ;
+
+	while(control->s_TxFrames == frames)
+	{
+		if((COSIM_now() >= deadline) || !SCEN_runMs(1))
+			return FALSE ;
+	}
+	if(latency != NULL_PTR)
+		*latency = control->s_TxCycle - sent ;
+	return TRUE ;
+}
+
+/*
+ * Description: Function to send CHECK_USER with a PIN to the Control ECU ,
+ * 				the first match of the scenario is the reference latency
+ * 				of the next ones
+ */
+static bool SCEN_verify(const SCEN_StepType *step)
+{
+	static uint64 reference = 0 ;
+	COSIM_EcuType *control = &g_cosimEcus[COSIM_CONTROL] ;
+	uint64 latency ;
+
+	if(!SCEN_toolRequest(CHECK_USER, step->s_Text, step->s_Ms, &latency))
+		return FALSE ;
+	printf("COSIM: verify %s => %02X in %8.3f ms\n", step->s_Text, control->s_TxCommand,
+			COSIM_ms(latency));
+
+	if(control->s_TxCommand != (uint8)step->s_Value)
+		return FALSE ;
+	if(step->s_Value != MATCH)
+		return TRUE ;
+
+	if(reference == 0)
+		reference = latency ;
+	return ((latency > reference) ? (latency - reference) : (reference - latency))
+			<= (uint64)SCEN_VERIFY_JITTER_US * (F_CPU / 1000000UL) ;
+}
+
+/*
+ * Description: Function to print the failed step and the devices state
+ */
+static void SCEN_fail(uint16 index, const SCEN_StepType *step)
+{
+	static const char *const kinds[] =
+	{
+		"LCD", "KEYS", "HOLD", "WAIT", "MOTOR", "DOOR_OPEN", "DOOR_CLOSED", "BUZZER", "EEPROM_WRITTEN",
+		"RESET", "DEBUG_REQUEST", "TOOL", "VERIFY"
+	};
+	static const char *const motor[] = {"stopped", "opening", "closing"};
+	char row0[17] , row1[17] ;
+
+	DEV_lcdRow(0, row0);
+	DEV_lcdRow(1, row1);
+	printf("COSIM: step %u %s(%s) failed @ %.3f ms\n", index, kinds[step->s_Kind],
+			(step->s_Text != NULL_PTR) ? step->s_Text : "", COSIM_ms(COSIM_now()));
+	printf("COSIM:   LCD |%s|%s| , motor %s , door %.1f %% , buzzer %s\n", row0, row1,
+			motor[DEV_motorState()], DEV_doorPosition(), DEV_buzzerOn() ? "on" : "off");
+}
@@ -0,0 +1,473 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test.c
+ * Description: Source file of the checks , the result , the 24C16 model and
+ * 				the HD44780 model of the host unit tests
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* LCD control pins on PORTD */
+#define TEST_LCD_RS				5
+#define TEST_LCD_RW				6
+#define TEST_LCD_E				7
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct
+{
+	/* Address counter , next byte is the word address */
+	uint16 s_Address ;
+	bool s_WordAddress ;
+
+	/* Page buffer , bytes in the order they were sent */
+	uint8 s_Data[TEST_EEPROM_PAGE_SIZE] ;
+	uint16 s_DataAddress[TEST_EEPROM_PAGE_SIZE] ;
+	uint8 s_DataLength ;
+
+	/* End of the running write cycle (no ACK until then) */
+	uint64 s_BusyUntil ;
+
+	/* Armed power cut */
+	TEST_CutType s_Cut ;
+	uint8 s_CutBytes ;
+}TEST_EepromStateType;
+
+typedef struct
+{
+	uint8 s_DataBits ;
+
+	/* Levels of PORTB / PORTD written by the firmware */
+	uint8 s_Data ;
+	uint8 s_Ctrl ;
+
+	/* 4-bit bus : next nibble is the low one , high nibble received */
+	bool s_LowNibble ;
+	uint8 s_High ;
+
+	/* End of the running instruction (Busy Flag = 1 until then) */
+	uint64 s_BusyUntil ;
+}TEST_LcdStateType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static const char *g_testName = "test" ;
+static struct timespec g_testStart ;
+
+/* Checks done and failed */
+static uint32 g_checks = 0 ;
+static uint32 g_failed = 0 ;
+
+/* Fixed seed generator state */
+static uint32 g_random = 0x2545F491UL ;
+
+/* 24C16 model */
+TEST_EepromType g_testEeprom ;
+static TEST_EepromStateType g_eepromState ;
+
+/* HD44780 model */
+TEST_LcdType g_testLcd ;
+static TEST_LcdStateType g_lcdState ;
+static TEST_LcdHook g_lcdHook = NULL_PTR ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static bool TEST_eepromStart(uint8 sla);
+static bool TEST_eepromWrite(uint8 data);
+static uint8 TEST_eepromRead(bool ack);
+static void TEST_eepromStop(void);
+
+static uint8 TEST_lcdPins(uint8 port, uint8 ddr, uint8 out);
+static void TEST_lcdData(uint8 port, uint8 ddr, uint8 out);
+static void TEST_lcdControl(uint8 port, uint8 ddr, uint8 out);
+static void TEST_lcdExecute(bool rs, uint8 data);
+
+static const HOST_TwiDeviceType g_eepromDevice =
+{
+	0xA0, 0xF0, TEST_eepromStart, TEST_eepromWrite, TEST_eepromRead, TEST_eepromStop
+};
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description: Function to start a test
+ */
+void TEST_begin(const char *name)
+{
+	g_testName = name ;
+	g_checks = 0 ;
+	g_failed = 0 ;
+	clock_gettime(CLOCK_MONOTONIC, &g_testStart);
+}
+
+/*
+ * Description: Function to count a check , prints the failed ones
+ */
+bool TEST_check(bool condition, const char *text, const char *file, int line)
+{
+	g_checks++ ;
+	if(condition)
+		return TRUE ;
+
+	if(g_failed < TEST_MAX_PRINTED)
+	{
+		printf("TEST: %s: %s:%d: %s failed @ %.3f ms\n", g_testName, file, line, text,
+				(double)HOST_cycles() * 1000.0 / F_CPU);
+	}
+	g_failed++ ;
+	return FALSE ;
+}
+
+/*
+ * Description: Function to print the result of the test
+ */
+int TEST_end(void)
+{
+	struct timespec end ;
+	double wallMs ;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	wallMs = (double)(end.tv_sec - g_testStart.tv_sec) * 1000.0
+			+ (double)(end.tv_nsec - g_testStart.tv_nsec) / 1000000.0 ;
+
+	printf("TEST: %-16s %s  %u checks , %u failed in %.1f ms wall\n", g_testName,
+			(g_failed == 0) ? "PASS" : "FAIL", g_checks, g_failed, wallMs);
+	return (g_failed == 0) ? 0 : 1 ;
+}
+
+/*
+ * Description: Function returns the next number of the fixed seed generator
+ */
+uint32 TEST_random(void)
+{
+	g_random ^= g_random << 13 ;
+	g_random ^= g_random >> 17 ;
+	g_random ^= g_random << 5 ;
+	return g_random ;
+}
+
+/*
+ * Description: Function to attach the 24C16 model to the TWI (once)
+ */
+void TEST_eepromAttach(void)
+{
+	uint16 i;
+
+	for(i = 0 ; i < TEST_EEPROM_SIZE ; i++)
+	{
+		g_testEeprom.s_Memory[i] = 0xFF ;
+	}
+	TEST_eepromPowerOn();
+	HOST_twiAttach(&g_eepromDevice);
+}
+
+/*
+ * Description: Function to cut the power in the next page write
+ */
+void TEST_eepromCut(TEST_CutType type, uint8 bytes)
+{
+	g_eepromState.s_Cut = type ;
+	g_eepromState.s_CutBytes = bytes ;
+}
+
+/*
+ * Description: Function to power the EEPROM again
+ */
+void TEST_eepromPowerOn(void)
+{
+	g_testEeprom.s_Powered = TRUE ;
+	g_eepromState.s_WordAddress = FALSE ;
+	g_eepromState.s_DataLength = 0 ;
+	g_eepromState.s_BusyUntil = 0 ;
+	g_eepromState.s_Cut = TEST_CUT_NONE ;
+}
+
+/*
+ * Description: 24C16 SLA , no ACK while it is off or in a write cycle ,
+ * 				the block A8:A10 is in the SLA
+ */
+static bool TEST_eepromStart(uint8 sla)
+{
+	if(!g_testEeprom.s_Powered)
+		return FALSE ;
+	if(HOST_cycles() < g_eepromState.s_BusyUntil)
+	{
+		g_testEeprom.s_BusyNacks++ ;
+		return FALSE ;
+	}
+
+	if(!(sla & 0x01))
+	{
+		g_eepromState.s_Address = (uint16)((sla & 0x0E) << 7) ;
+		g_eepromState.s_WordAddress = TRUE ;
+		g_eepromState.s_DataLength = 0 ;
+	}
+	else
+	{
+		g_testEeprom.s_Reads++ ;
+	}
+	g_testEeprom.s_Transfers++ ;
+	return TRUE ;
+}
+
+/*
+ * Description: 24C16 word address , then data bytes in the page buffer
+ * 				(the address rolls over in the page)
+ */
+static bool TEST_eepromWrite(uint8 data)
+{
+	TEST_EepromStateType *state = &g_eepromState ;
+
+	if(!g_testEeprom.s_Powered)
+		return FALSE ;
+
+	g_testEeprom.s_WriteBytes++ ;
+	if(state->s_WordAddress)
+	{
+		state->s_Address = (uint16)((state->s_Address & 0x700) | data) ;
+		state->s_WordAddress = FALSE ;
+		return TRUE ;
+	}
+
+	if((state->s_Cut == TEST_CUT_BUS) && (state->s_DataLength == state->s_CutBytes))
+	{
+		g_testEeprom.s_Powered = FALSE ;
+		return FALSE ;
+	}
+
+	/* More than a page isn't sent by the drivers , the extra bytes are dropped */
+	if(state->s_DataLength < TEST_EEPROM_PAGE_SIZE)
+	{
+		state->s_Data[state->s_DataLength] = data ;
+		state->s_DataAddress[state->s_DataLength] = state->s_Address ;
+		state->s_DataLength++ ;
+	}
+	state->s_Address = (uint16)((state->s_Address & ~(TEST_EEPROM_PAGE_SIZE - 1))
+			| ((state->s_Address + 1) & (TEST_EEPROM_PAGE_SIZE - 1))) ;
+	return TRUE ;
+}
+
+/*
+ * Description: 24C16 sequential read (the address rolls over the memory)
+ */
+static uint8 TEST_eepromRead(bool ack)
+{
+	uint8 data = g_testEeprom.s_Memory[g_eepromState.s_Address] ;
+	(void)ack ;
+
+	if(!g_testEeprom.s_Powered)
+		return 0xFF ;
+
+	g_testEeprom.s_ReadBytes++ ;
+	g_eepromState.s_Address = (uint16)((g_eepromState.s_Address + 1) % TEST_EEPROM_SIZE) ;
+	return data ;
+}
+
+/*
+ * Description: 24C16 Stop , data in the page buffer => write cycle ,
+ * 				a power cut keeps the page (bus) or a part of it (write cycle)
+ */
+static void TEST_eepromStop(void)
+{
+	TEST_EepromStateType *state = &g_eepromState ;
+	uint8 length = state->s_DataLength ;
+	uint8 written = length ;
+	bool erased = FALSE ;
+	uint8 i;
+
+	state->s_DataLength = 0 ;
+	if(!g_testEeprom.s_Powered || (length == 0))
+		return ;
+
+	if(state->s_Cut == TEST_CUT_BUS)
+	{
+		/* Cut after the last byte , before the Stop */
+		g_testEeprom.s_Powered = FALSE ;
+		return ;
+	}
+
+	if(state->s_Cut == TEST_CUT_WRITE)
+	{
+		g_testEeprom.s_Powered = FALSE ;
+		if(state->s_CutBytes < length)
+			written = state->s_CutBytes ;
+		erased = (bool)(TEST_random() & 1) ;
+	}
+
+	for(i = 0 ; i < length ; i++)
+	{
+		if(i < written)
+			g_testEeprom.s_Memory[state->s_DataAddress[i]] = state->s_Data[i] ;
+		else if(i == written)
+			g_testEeprom.s_Memory[state->s_DataAddress[i]] = (uint8)TEST_random() ;
+		else if(erased)
+			g_testEeprom.s_Memory[state->s_DataAddress[i]] = 0xFF ;
+	}
+	g_testEeprom.s_PageWrites[state->s_DataAddress[0] / TEST_EEPROM_PAGE_SIZE]++ ;
+	state->s_BusyUntil = HOST_cycles() + TEST_EEPROM_WRITE_CYCLES ;
+}
+
+/*
+ * Description: Function to attach the HD44780 model to the LCD pins
+ */
+void TEST_lcdAttach(uint8 dataBits)
+{
+	memset(&g_testLcd, 0, sizeof(g_testLcd));
+	memset(g_testLcd.s_Ddram, ' ', TEST_LCD_DDRAM_SIZE);
+	g_testLcd.s_Increment = TRUE ;
+	memset(&g_lcdState, 0, sizeof(g_lcdState));
+	g_lcdState.s_DataBits = dataBits ;
+	HOST_gpioSetHooks('B', TEST_lcdPins, TEST_lcdData);
+	HOST_gpioSetHooks('D', NULL_PTR, TEST_lcdControl);
+}
+
+/*
+ * Description: Function to copy the visible cells of a row
+ */
+void TEST_lcdRow(uint8 row, char *text)
+{
+	memcpy(text, &g_testLcd.s_Ddram[row ? TEST_LCD_LINE_2 : 0], TEST_LCD_COLS);
+	text[TEST_LCD_COLS] = '\0' ;
+}
+
+/*
+ * Description: Function to set the hook of the bytes written to the LCD
+ */
+void TEST_lcdSetHook(TEST_LcdHook a_hook)
+{
+	g_lcdHook = a_hook ;
+}
+
+/*
+ * Description: LCD data bus , RW = 1 and E = 1 => Busy Flag + Address Counter
+ * 				(4-bit bus : high nibble then low nibble on PB4:PB7)
+ */
+static uint8 TEST_lcdPins(uint8 port, uint8 ddr, uint8 out)
+{
+	uint8 status ;
+
+	if((g_lcdState.s_Ctrl & ((1<<TEST_LCD_RW) | (1<<TEST_LCD_E))) != ((1<<TEST_LCD_RW) | (1<<TEST_LCD_E)))
+		return 0 ;
+
+	status = (uint8)(((HOST_cycles() < g_lcdState.s_BusyUntil) ? 0x80 : 0x00) | (g_testLcd.s_Address & 0x7F)) ;
+	if(g_lcdState.s_DataBits == 8)
+		return status ;
+	return g_lcdState.s_LowNibble ? (uint8)(status << 4) : (uint8)(status & 0xF0) ;
+}
+
+static void TEST_lcdData(uint8 port, uint8 ddr, uint8 out)
+{
+	g_lcdState.s_Data = out ;
+}
+
+/*
+ * Description: LCD control pins , a write is latched on the falling edge of E ,
+ * 				a status read ends on it
+ */
+static void TEST_lcdControl(uint8 port, uint8 ddr, uint8 out)
+{
+	TEST_LcdStateType *state = &g_lcdState ;
+	bool fall = (state->s_Ctrl & (1<<TEST_LCD_E)) && !(out & (1<<TEST_LCD_E)) ;
+	bool rs = (out & (1<<TEST_LCD_RS)) ? TRUE : FALSE ;
+
+	state->s_Ctrl = out ;
+	if(!fall)
+		return ;
+
+	g_testLcd.s_Strobes++ ;
+	if(out & (1<<TEST_LCD_RW))
+	{
+		/* Status read , counted at its first nibble */
+		if((state->s_DataBits == 8) || !state->s_LowNibble)
+		{
+			g_testLcd.s_StatusReads++ ;
+			if(HOST_cycles() < state->s_BusyUntil)
+				g_testLcd.s_BusyReads++ ;
+		}
+		if(state->s_DataBits == 4)
+			state->s_LowNibble = !state->s_LowNibble ;
+		return ;
+	}
+
+	if(state->s_DataBits == 8)
+	{
+		TEST_lcdExecute(rs, state->s_Data);
+	}
+	else if(!state->s_LowNibble)
+	{
+		state->s_High = (uint8)(state->s_Data & 0xF0) ;
+		state->s_LowNibble = TRUE ;
+	}
+	else
+	{
+		state->s_LowNibble = FALSE ;
+		TEST_lcdExecute(rs, (uint8)(state->s_High | (state->s_Data >> 4)));
+	}
+}
+
+/*
+ * Description: LCD instruction (rs = FALSE) or DDRAM data (rs = TRUE) ,
+ * 				CGRAM and display shift aren't used by the driver
+ */
+static void TEST_lcdExecute(bool rs, uint8 data)
+{
+	uint64 now = HOST_cycles() ;
+
+	if(now < g_lcdState.s_BusyUntil)
+		g_testLcd.s_BusyWrites++ ;
+	g_lcdState.s_BusyUntil = now + TEST_LCD_EXEC_CYCLES ;
+	if(g_lcdHook != NULL_PTR)
+		g_lcdHook(rs, data, now);
+
+	if(rs)
+	{
+		g_testLcd.s_Characters++ ;
+		g_testLcd.s_Ddram[g_testLcd.s_Address] = data ;
+		g_testLcd.s_Address = (uint8)((g_testLcd.s_Address + (g_testLcd.s_Increment ? 1 : TEST_LCD_DDRAM_SIZE - 1))
+				% TEST_LCD_DDRAM_SIZE) ;
+		return ;
+	}
+
+	g_testLcd.s_Commands++ ;
+	if(data & 0x80)
+	{
+		/* Set DDRAM Address */
+		g_testLcd.s_CursorMoves++ ;
+		g_testLcd.s_Address = data & 0x7F ;
+	}
+	else if((data & 0xFC) == 0x04)
+	{
+		/* Entry Mode Set */
+		g_testLcd.s_Increment = (data & 0x02) ? TRUE : FALSE ;
+	}
+	else if((data & 0xFC) == 0)
+	{
+		/* Clear Display / Return Home */
+		if(data & 0x01)
+		{
+			g_testLcd.s_Clears++ ;
+			memset(g_testLcd.s_Ddram, ' ', TEST_LCD_DDRAM_SIZE);
+			g_testLcd.s_Increment = TRUE ;
+		}
+		g_testLcd.s_Address = 0 ;
+		g_lcdState.s_BusyUntil = now + TEST_LCD_CLEAR_CYCLES ;
+	}
+}
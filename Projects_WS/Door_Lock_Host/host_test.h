@@ -0,0 +1,189 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test.h
+ * Description: Header file of the host unit tests , one program per module
+ * 				(host_test_<module>.c) linked with the module , the drivers
+ * 				and the ATmega16 model (make host-test)
+ *
+ * Notes:		- A test program checks its module with TEST_CHECK() , every
+ * 				  failed check is printed (up to TEST_MAX_PRINTED) and
+ * 				  TEST_end() returns the exit status of the program
+ *
+ * 				- TEST_random() is a fixed seed generator , every run of a
+ * 				  test is the same sequence (a failure can be replayed)
+ *
+ * 				- TEST_eepromAttach() connects a 24C16 model to the TWI , the
+ * 				  page buffer is written at the Stop condition (5 ms write
+ * 				  cycle) . TEST_eepromCut() cuts the power in the next page
+ * 				  write , the memory keeps what a real 24Cxx keeps
+ *
+ * 				- TEST_lcdAttach() connects a HD44780 model to the LCD pins
+ * 				  (data PORTB , RS/RW/E PD5:PD7) , 8-bit or 4-bit (PB4:PB7)
+ * 				  bus from the power on . It counts the bus transactions ,
+ * 				  the Busy Flag reads and the writes while it is busy ,
+ * 				  TEST_lcdSetHook() gets every byte in the bus order
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef HOST_TEST_H_
+#define HOST_TEST_H_
+
+#include "hal_host.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Failed checks printed by a test , the next ones are only counted */
+#define TEST_MAX_PRINTED		10
+
+/* Check a condition , the text of the condition is printed if it is FALSE */
+#define TEST_CHECK(condition)	TEST_check((condition), #condition, __FILE__, __LINE__)
+
+/* 24C16 , 2 KB = 8 blocks of 256 bytes , 16 bytes page , 5 ms write cycle */
+#define TEST_EEPROM_SIZE			2048
+#define TEST_EEPROM_PAGE_SIZE		16
+#define TEST_EEPROM_PAGES			(TEST_EEPROM_SIZE / TEST_EEPROM_PAGE_SIZE)
+#define TEST_EEPROM_WRITE_CYCLES	((uint64)5UL * (F_CPU / 1000UL))
+
+/* HD44780 , DDRAM of 2 lines * 40 chars , line 2 at 0x40 , 37 us / 1.52 ms
+ * execution time (Clear Display / Return Home) */
+#define TEST_LCD_DDRAM_SIZE			0x80
+#define TEST_LCD_LINE_2				0x40
+#define TEST_LCD_COLS				16
+#define TEST_LCD_EXEC_CYCLES		((uint64)37UL * (F_CPU / 1000000UL))
+#define TEST_LCD_CLEAR_CYCLES		((uint64)1520UL * (F_CPU / 1000000UL))
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef enum
+{
+	TEST_CUT_NONE,
+	/* Power lost when data byte n + 1 is sent (n = 16 => before the Stop) ,
+	 * the page buffer is lost => page unchanged */
+	TEST_CUT_BUS,
+	/* Power lost in the write cycle after n bytes of the page are written ,
+	 * the next byte is garbage , the other bytes are erased (0xFF) or old */
+	TEST_CUT_WRITE
+}TEST_CutType;
+
+typedef struct
+{
+	uint8 s_Memory[TEST_EEPROM_SIZE] ;
+	bool s_Powered ;
+
+	/* Page write cycles of every page , transfers (SLA acknowledged) ,
+	 * reads (SLA+R acknowledged) , bytes read and written on the bus
+	 * (word address included) , SLA not acknowledged in a write cycle
+	 * (ACK Polling tries) */
+	uint32 s_PageWrites[TEST_EEPROM_PAGES] ;
+	uint32 s_Transfers ;
+	uint32 s_Reads ;
+	uint32 s_ReadBytes ;
+	uint32 s_WriteBytes ;
+	uint32 s_BusyNacks ;
+}TEST_EepromType;
+
+typedef struct
+{
+	uint8 s_Ddram[TEST_LCD_DDRAM_SIZE] ;
+	uint8 s_Address ;
+	bool s_Increment ;
+
+	/* Bus transactions : instructions (Clear Display , Set DDRAM Address
+	 * included) and characters written , Busy Flag reads (busy ones) ,
+	 * writes while the last instruction was executed (lost on a real LCD) */
+	uint32 s_Commands ;
+	uint32 s_Clears ;
+	uint32 s_CursorMoves ;
+	uint32 s_Characters ;
+	uint32 s_StatusReads ;
+	uint32 s_BusyReads ;
+	uint32 s_BusyWrites ;
+
+	/* E strobes (4-bit bus => 2 per byte) */
+	uint32 s_Strobes ;
+}TEST_LcdType;
+
+/* Byte written to the LCD : rs = TRUE => character , cycle = E strobe */
+typedef void (*TEST_LcdHook)(bool rs, uint8 data, uint64 cycle);
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+extern TEST_EepromType g_testEeprom ;
+extern TEST_LcdType g_testLcd ;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description: Function to start a test , name is printed in the result
+ */
+void TEST_begin(const char *name);
+
+/*
+ * Description: Function to count a check , prints the failed ones
+ *
+ * Return: condition
+ */
+bool TEST_check(bool condition, const char *text, const char *file, int line);
+
+/*
+ * Description: Function to print the result of the test
+ *
+ * Return: exit status of the test program , 0 = passed
+ */
+int TEST_end(void);
+
+/*
+ * Description: Function returns the next number of the fixed seed generator
+ * 				(xorshift32)
+ */
+uint32 TEST_random(void);
+
+/*
+ * Description: Function to attach the 24C16 model to the TWI (once) ,
+ * 				memory erased (0xFF) and powered
+ */
+void TEST_eepromAttach(void);
+
+/*
+ * Description: Function to cut the power in the next page write after
+ * 				bytes bytes (TEST_CutType) , the EEPROM doesn't answer until
+ * 				TEST_eepromPowerOn()
+ */
+void TEST_eepromCut(TEST_CutType type, uint8 bytes);
+
+/*
+ * Description: Function to power the EEPROM again , no write cycle running
+ */
+void TEST_eepromPowerOn(void);
+
+/*
+ * Description: Function to attach the HD44780 model to the LCD pins ,
+ * 				dataBits = 8 (PB0:PB7) or 4 (PB4:PB7) , DDRAM = spaces ,
+ * 				counters cleared
+ */
+void TEST_lcdAttach(uint8 dataBits);
+
+/*
+ * Description: Function to copy the TEST_LCD_COLS visible cells of a row
+ * 				(text gets TEST_LCD_COLS + 1 bytes)
+ */
+void TEST_lcdRow(uint8 row, char *text);
+
+/*
+ * Description: Function to set the hook of the bytes written to the LCD
+ * 				(NULL_PTR => none) , kept by TEST_lcdAttach()
+ */
+void TEST_lcdSetHook(TEST_LcdHook a_hook);
+
+#endif /* HOST_TEST_H_ */
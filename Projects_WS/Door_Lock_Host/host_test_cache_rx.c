@@ -0,0 +1,263 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test_cache_rx.c
+ * Description: UART RX of the Control ECU while the EEPROM Cache writes
+ * 				(eeprom_cache.c) : command frames back to back on the RX line ,
+ * 				the main loop reads them between EEPROM accesses
+ *
+ * Notes:		- Main loop : FRAME_poll() , then one EEPROM access in turn :
+ * 				  CACHE_write() of the cached page (waits the running write
+ * 				  and its read-back) , CACHE_read() outside the window (waits
+ * 				  the write , ACK Polling , Sequential Read)
+ *
+ * 				- At CONTROL_UART_BAUD_RATE no byte is dropped
+ * 				  (UART_getRxDropCount()) , every frame is received once in
+ * 				  order , every write is read back , the longest main loop
+ * 				  gap between two FRAME_poll() is shorter than the time to
+ * 				  fill the RX Ring Buffer
+ *
+ * 				- The same stream at BR115200 is reported : the ring covers
+ * 				  UART_RX_BUFFER_SIZE bytes of the line , a longer gap drops
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "uart.h"
+#include "frame.h"
+#include "eeprom_cache.h"
+#include <avr/interrupt.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+#define TEST_FRAMES				200
+#define TEST_PAYLOAD			8
+#define TEST_STREAM_SIZE		(TEST_FRAMES * (TEST_PAYLOAD + FRAME_OVERHEAD))
+
+/* Bytes queued ahead in the USART model (HOST_RX_QUEUE_SIZE = 64) */
+#define TEST_RX_AHEAD			48
+
+/* Read outside the cached window (miss) */
+#define TEST_MISS_ADDRESS		0x0400
+
+#define TEST_MS_CYCLES			(F_CPU / 1000UL)
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint32 s_Frames ;
+	uint32 s_OutOfOrder ;
+	uint16 s_Drops ;
+	uint32 s_Writes ;
+	uint32 s_WriteErrors ;
+	uint32 s_Reads ;
+	uint64 s_MaxGap ;
+	uint64 s_RingCycles ;
+}TEST_ResultType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static uint8 g_stream[TEST_STREAM_SIZE] ;
+static uint16 g_streamLength ;
+
+static FRAME_DecoderType g_decoder ;
+
+/* Data of the running CACHE_write() , kept until its Call Back */
+static uint8 g_writeData[2][CACHE_SIZE] ;
+static const uint8 *g_lastWrite ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void TEST_makeStream(void);
+static void TEST_checkFrame(TEST_ResultType *result);
+static void TEST_eepromAccess(TEST_ResultType *result, uint32 turn);
+static void TEST_run(UART_BaudRate baudRate, TEST_ResultType *result);
+static void TEST_print(const char *name, const TEST_ResultType *result);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	TEST_ResultType control , fast ;
+
+	TEST_begin("cache_rx");
+
+	TEST_eepromAttach();
+	EEPROM_init();
+	sei();
+	TEST_CHECK(CACHE_init() == SUCCESS);
+	TEST_makeStream();
+
+	TEST_run(CONTROL_UART_BAUD_RATE, &control);
+	TEST_CHECK(control.s_Drops == 0);
+	TEST_CHECK(control.s_Frames == TEST_FRAMES);
+	TEST_CHECK(control.s_OutOfOrder == 0);
+	TEST_CHECK(control.s_WriteErrors == 0);
+	TEST_CHECK(control.s_MaxGap < control.s_RingCycles);
+	TEST_print("control", &control);
+
+	/* Ring shorter than the longest gap : drops reported , the writes succeed */
+	TEST_run(BR115200, &fast);
+	TEST_CHECK(fast.s_WriteErrors == 0);
+	TEST_CHECK((fast.s_Drops == 0) == (fast.s_MaxGap < fast.s_RingCycles));
+	TEST_print("BR115200", &fast);
+	return TEST_end();
+}
+
+/*
+ * Description: Function to encode the command frames , frame n has the
+ * 				command n and the payload n , n + 1 , ...
+ */
+static void TEST_makeStream(void)
+{
+	uint8 payload[TEST_PAYLOAD] ;
+	uint16 frame ;
+	uint8 i;
+
+	g_streamLength = 0 ;
+	for(frame = 0 ; frame < TEST_FRAMES ; frame++)
+	{
+		for(i = 0 ; i < TEST_PAYLOAD ; i++)
+		{
+			payload[i] = (uint8)(frame + i) ;
+		}
+		g_streamLength += FRAME_encode((uint8)frame, payload, TEST_PAYLOAD, &g_stream[g_streamLength]);
+	}
+}
+
+/*
+ * Description: Function to check the received frame is the next one
+ */
+static void TEST_checkFrame(TEST_ResultType *result)
+{
+	const FRAME_Type *frame = &g_decoder.s_Frame ;
+	bool inOrder = (frame->s_Command == (uint8)result->s_Frames) && (frame->s_Length == TEST_PAYLOAD) ;
+	uint8 i;
+
+	for(i = 0 ; inOrder && (i < TEST_PAYLOAD) ; i++)
+	{
+		inOrder = (frame->s_Payload[i] == (uint8)(result->s_Frames + i)) ;
+	}
+	if(!inOrder)
+		result->s_OutOfOrder++ ;
+	result->s_Frames++ ;
+}
+
+/*
+ * Description: Function to do one EEPROM access of the main loop ,
+ * 				two writes then one read (miss)
+ */
+static void TEST_eepromAccess(TEST_ResultType *result, uint32 turn)
+{
+	uint8 data[CACHE_SIZE] ;
+	uint8 *write = g_writeData[turn & 1] ;
+	uint8 i;
+
+	if(turn % 3 == 2)
+	{
+		if(CACHE_read(TEST_MISS_ADDRESS, data, CACHE_SIZE) == SUCCESS)
+			result->s_Reads++ ;
+		return ;
+	}
+
+	/* The write before the previous one is finished (CACHE_write() waits it) */
+	if((result->s_Writes != 0) && (CACHE_getWriteStatus() == TWI_ERROR))
+		result->s_WriteErrors++ ;
+	for(i = 0 ; i < CACHE_SIZE ; i++)
+	{
+		write[i] = (uint8)TEST_random() ;
+	}
+	if(CACHE_write(CACHE_ADDRESS, write, CACHE_SIZE, NULL_PTR) != SUCCESS)
+		result->s_WriteErrors++ ;
+	g_lastWrite = write ;
+	result->s_Writes++ ;
+}
+
+/*
+ * Description: Function to stream the frames at baudRate , the main loop
+ * 				polls the frames between the EEPROM accesses
+ */
+static void TEST_run(UART_BaudRate baudRate, TEST_ResultType *result)
+{
+	UART_ConfigType config = {.s_RxInterruptEnable = ENABLE_INT ,
+			.s_DataRegEmptyInterruptEnable = ENABLE_INT ,
+			.s_BaudRate = baudRate , .s_NULL_Terminator = '#' };
+	uint16 drops ;
+	uint64 start , last , now , frameCycles , end ;
+	uint32 turn = 0 ;
+	uint16 fed = 0 ;
+	uint8 read[CACHE_SIZE] ;
+
+	memset(result, 0, sizeof(*result));
+	UART_init(&config);
+	FRAME_decoderInit(&g_decoder);
+	drops = UART_getRxDropCount() ;
+	frameCycles = HOST_uartFrameCycles() ;
+	result->s_RingCycles = (uint64)UART_RX_BUFFER_SIZE * frameCycles ;
+
+	start = HOST_cycles() ;
+	end = start + (uint64)(g_streamLength + 1) * frameCycles ;
+	last = start ;
+	do
+	{
+		/* Line : the bytes back to back , fed ahead of the main loop */
+		now = HOST_cycles() ;
+		while((fed < g_streamLength) && (fed < (now - start) / frameCycles + TEST_RX_AHEAD))
+		{
+			HOST_uartReceiveAt(g_stream[fed], start + (uint64)(fed + 1) * frameCycles);
+			fed++ ;
+		}
+
+		if(now - last > result->s_MaxGap)
+			result->s_MaxGap = now - last ;
+		last = now ;
+		while(FRAME_poll(&g_decoder))
+		{
+			TEST_checkFrame(result);
+		}
+
+		TEST_eepromAccess(result, turn);
+		turn++ ;
+	}while(HOST_cycles() < end);
+
+	/* Last frames and last write */
+	while(FRAME_poll(&g_decoder))
+	{
+		TEST_checkFrame(result);
+	}
+	while(CACHE_getWriteStatus() == TWI_PENDING)
+	{
+		HOST_delayCycles(TEST_MS_CYCLES);
+	}
+	if(CACHE_getWriteStatus() != TWI_SUCCESS)
+		result->s_WriteErrors++ ;
+	TEST_CHECK(CACHE_read(CACHE_ADDRESS, read, CACHE_SIZE) == SUCCESS);
+	TEST_CHECK(memcmp(read, g_lastWrite, CACHE_SIZE) == 0);
+	TEST_CHECK(memcmp(&g_testEeprom.s_Memory[CACHE_ADDRESS], read, CACHE_SIZE) == 0);
+
+	result->s_Drops = (uint16)(UART_getRxDropCount() - drops) ;
+}
+
+static void TEST_print(const char *name, const TEST_ResultType *result)
+{
+	printf("TEST: cache_rx         %-8s %3u frames , %u writes , %u reads , main loop gap max %5.2f ms ,"
+			" ring %5.2f ms , %u dropped\n",
+			name, result->s_Frames, result->s_Writes, result->s_Reads,
+			(double)result->s_MaxGap / TEST_MS_CYCLES, (double)result->s_RingCycles / TEST_MS_CYCLES,
+			result->s_Drops);
+}
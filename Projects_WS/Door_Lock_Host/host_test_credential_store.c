@@ -0,0 +1,310 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test_credential_store.c
+ * Description: Power loss test of the Credential Store (credential_store.c)
+ * 				on the 24C16 model
+ *
+ * Notes:		- Every record write is cut at every byte : on the bus (the
+ * 				  page is unchanged) and in the write cycle (a part of the
+ * 				  page is written , one byte is garbage , the rest is erased
+ * 				  or old) . After the cut the ECU reboots (EEPROM_init ,
+ * 				  CACHE_init , STORE_init) and reads the newest record , then
+ * 				  writes a new record without cut
+ *
+ * 				- After a cut the newest record is the old one or the new one .
+ * 				  A torn page passes the CRC-8 by chance (false accept) with
+ * 				  probability 2^-8 at most , the test counts them and checks
+ * 				  TEST_MAX_FALSE_ACCEPT_RATE
+ *
+ * 				- The first rounds start from an erased store , the next ones
+ * 				  from a store seeded near the end of the sequence numbers ,
+ * 				  the writes go over 0xFFFF => 0 and many rounds of the slots
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "credential_store.h"
+#include "eeprom_cache.h"
+#include "frame.h"
+#include <avr/interrupt.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* Rounds of cuts at every byte of the record (bus and write cycle) */
+#define TEST_ROUNDS					40
+
+/* Sequence of the newest seeded record , the writes go over 0xFFFF */
+#define TEST_SEED_SEQUENCE			0xFFE0
+#define TEST_SEED_NEWEST			5
+
+/* False accepts allowed per torn write (CRC-8 => 1 / 256) , x2 margin */
+#define TEST_MAX_FALSE_ACCEPT_RATE	(2.0 / 256.0)
+
+/* Virtual time step while a write is running */
+#define TEST_STEP_CYCLES			((uint32)(F_CPU / 10000UL))
+
+#define TEST_SLOT_PAGE(slot)		((STORE_ADDRESS / TEST_EEPROM_PAGE_SIZE) + (slot))
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint8 s_Data[STORE_DATA_SIZE] ;
+	uint8 s_Length ;
+}TEST_RecordType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Newest record expected in the store */
+static TEST_RecordType g_newest ;
+
+/* Writes cut in the write cycle and torn pages accepted by the CRC */
+static uint32 g_tornWrites = 0 ;
+static uint32 g_falseAccepts = 0 ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void TEST_reboot(void);
+static void TEST_newRecord(TEST_RecordType *record);
+static bool TEST_isStored(const TEST_RecordType *record);
+static TWI_Status TEST_write(const TEST_RecordType *record);
+static void TEST_cutWrite(TEST_CutType type, uint8 bytes);
+static void TEST_seed(void);
+static void TEST_checkWear(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	TEST_CutType type ;
+	uint16 round ;
+	uint8 bytes ;
+
+	TEST_begin("credential_store");
+
+	TEST_eepromAttach();
+	sei();
+
+	/* Power loss in the first record of an erased store */
+	for(type = TEST_CUT_BUS ; type <= TEST_CUT_WRITE ; type++)
+	{
+		for(bytes = 0 ; bytes <= STORE_RECORD_SIZE ; bytes++)
+		{
+			memset(g_testEeprom.s_Memory, 0xFF, TEST_EEPROM_SIZE);
+			g_newest.s_Length = 0 ;
+			TEST_reboot();
+			TEST_CHECK(STORE_read(g_newest.s_Data) == 0);
+			TEST_cutWrite(type, bytes);
+		}
+	}
+
+	/* Power loss in every byte of the records , over the sequence wraparound */
+	TEST_seed();
+	memset(g_testEeprom.s_PageWrites, 0, sizeof(g_testEeprom.s_PageWrites));
+	for(round = 0 ; round < TEST_ROUNDS ; round++)
+	{
+		for(type = TEST_CUT_BUS ; type <= TEST_CUT_WRITE ; type++)
+		{
+			for(bytes = 0 ; bytes <= STORE_RECORD_SIZE ; bytes++)
+			{
+				TEST_cutWrite(type, bytes);
+			}
+		}
+	}
+	TEST_checkWear();
+
+	TEST_CHECK(g_falseAccepts <= g_tornWrites * TEST_MAX_FALSE_ACCEPT_RATE);
+	printf("TEST: credential_store %u torn writes , %u passed the CRC-8 (%.2f%% , max %.2f%%)\n",
+			g_tornWrites, g_falseAccepts, 100.0 * g_falseAccepts / g_tornWrites,
+			100.0 * TEST_MAX_FALSE_ACCEPT_RATE);
+	return TEST_end();
+}
+
+/*
+ * Description: Function to restart the store after a power cut , like the
+ * 				Control ECU boot
+ */
+static void TEST_reboot(void)
+{
+	TEST_eepromPowerOn();
+	EEPROM_init();
+	TEST_CHECK(CACHE_init() == SUCCESS);
+	TEST_CHECK(STORE_init() == SUCCESS);
+}
+
+/*
+ * Description: Function to make a record with random data and length
+ */
+static void TEST_newRecord(TEST_RecordType *record)
+{
+	uint8 i;
+
+	record->s_Length = (uint8)(TEST_random() % (STORE_DATA_SIZE + 1)) ;
+	for(i = 0 ; i < record->s_Length ; i++)
+	{
+		record->s_Data[i] = (uint8)TEST_random() ;
+	}
+}
+
+/*
+ * Description: Function returns TRUE if the newest record of the store is
+ * 				equal to record
+ */
+static bool TEST_isStored(const TEST_RecordType *record)
+{
+	uint8 data[STORE_DATA_SIZE] ;
+
+	return (STORE_read(data) == record->s_Length) &&
+			(memcmp(data, record->s_Data, record->s_Length) == 0) ;
+}
+
+/*
+ * Description: Function to write a record and wait the end of the write
+ */
+static TWI_Status TEST_write(const TEST_RecordType *record)
+{
+	if(STORE_write(record->s_Data, record->s_Length, NULL_PTR) != SUCCESS)
+		return TWI_ERROR ;
+
+	while(STORE_getWriteStatus() == TWI_PENDING)
+	{
+		HOST_delayCycles(TEST_STEP_CYCLES);
+	}
+	return STORE_getWriteStatus() ;
+}
+
+/*
+ * Description: Function to cut the power in a record write , reboot and
+ * 				check the newest record , then write a record without cut
+ */
+static void TEST_cutWrite(TEST_CutType type, uint8 bytes)
+{
+	TEST_RecordType record ;
+	uint8 data[STORE_DATA_SIZE] ;
+
+	TEST_newRecord(&record);
+	TEST_eepromCut(type, bytes);
+	TEST_CHECK(TEST_write(&record) == TWI_ERROR);
+	TEST_reboot();
+
+	/* Old record => the torn page is ignored */
+	if(!TEST_isStored(&g_newest))
+	{
+		/* A bus cut never changes the page */
+		TEST_CHECK(type == TEST_CUT_WRITE);
+		if(!TEST_isStored(&record))
+		{
+			/* Torn page with a good CRC */
+			g_falseAccepts++ ;
+		}
+		g_newest.s_Length = STORE_read(data) ;
+		memcpy(g_newest.s_Data, data, g_newest.s_Length);
+	}
+	if(type == TEST_CUT_WRITE)
+	{
+		g_tornWrites++ ;
+	}
+
+	/* The next write goes over the torn page */
+	TEST_newRecord(&record);
+	TEST_CHECK(TEST_write(&record) == TWI_SUCCESS);
+	TEST_reboot();
+	TEST_CHECK(TEST_isStored(&record));
+	g_newest = record ;
+}
+
+/*
+ * Description: Function to fill all slots with records , the newest one in
+ * 				slot TEST_SEED_NEWEST with sequence TEST_SEED_SEQUENCE
+ */
+static void TEST_seed(void)
+{
+	TEST_RecordType seeded ;
+	uint8 *page ;
+	uint16 sequence ;
+	uint8 slot , i , crc ;
+
+	for(slot = 0 ; slot < STORE_SLOTS ; slot++)
+	{
+		page = &g_testEeprom.s_Memory[STORE_ADDRESS + slot * STORE_RECORD_SIZE] ;
+		sequence = (uint16)(TEST_SEED_SEQUENCE + slot - TEST_SEED_NEWEST
+				- ((slot > TEST_SEED_NEWEST) ? STORE_SLOTS : 0)) ;
+		TEST_newRecord(&g_newest);
+
+		page[0] = (uint8)sequence ;
+		page[1] = (uint8)(sequence >> 8) ;
+		page[2] = g_newest.s_Length ;
+		for(i = 0 ; i < STORE_DATA_SIZE ; i++)
+		{
+			page[3 + i] = (i < g_newest.s_Length) ? g_newest.s_Data[i] : 0xFF ;
+		}
+		crc = 0 ;
+		for(i = 0 ; i < STORE_RECORD_SIZE - 1 ; i++)
+		{
+			crc = FRAME_crc8(crc, page[i]) ;
+		}
+		page[STORE_RECORD_SIZE - 1] = crc ;
+
+		if(slot == TEST_SEED_NEWEST)
+			seeded = g_newest ;
+	}
+	g_newest = seeded ;
+
+	TEST_reboot();
+	TEST_CHECK(TEST_isStored(&g_newest));
+}
+
+/*
+ * Description: Function to check the sequence wraparound and the wear of
+ * 				the slots : only the store pages are written , the writes
+ * 				are spread over all slots (torn pages are written again)
+ */
+static void TEST_checkWear(void)
+{
+	uint32 minWrites = 0xFFFFFFFFUL ;
+	uint32 maxWrites = 0 ;
+	uint32 writes ;
+	uint16 page ;
+	uint16 sequence ;
+	uint8 slot ;
+
+	for(page = 0 ; page < TEST_EEPROM_PAGES ; page++)
+	{
+		if((page < TEST_SLOT_PAGE(0)) || (page >= TEST_SLOT_PAGE(STORE_SLOTS)))
+		{
+			TEST_CHECK(g_testEeprom.s_PageWrites[page] == 0);
+		}
+	}
+
+	for(slot = 0 ; slot < STORE_SLOTS ; slot++)
+	{
+		writes = g_testEeprom.s_PageWrites[TEST_SLOT_PAGE(slot)] ;
+		if(writes < minWrites)
+			minWrites = writes ;
+		if(writes > maxWrites)
+			maxWrites = writes ;
+
+		/* Every slot written after 0xFFFF => 0 */
+		sequence = (uint16)(g_testEeprom.s_Memory[STORE_ADDRESS + slot * STORE_RECORD_SIZE]
+				| (g_testEeprom.s_Memory[STORE_ADDRESS + slot * STORE_RECORD_SIZE + 1] << 8)) ;
+		TEST_CHECK(sequence < TEST_SEED_SEQUENCE - STORE_SLOTS);
+	}
+	TEST_CHECK(maxWrites <= 2 * minWrites);
+
+	printf("TEST: credential_store page writes per slot %u .. %u\n", minWrites, maxWrites);
+}
@@ -0,0 +1,374 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test_door.c
+ * Description: Door Actuator (door_actuator.c) ramps on the PWM output and
+ * 				latency of the Control ECU commands while the door moves
+ *
+ * Notes:		- door_lock_control.c is compiled in this file (its main() is
+ * 				  renamed) , the harness starts the ECU like main() does , the
+ * 				  commands are frames on the UART RX line
+ *
+ * 				- Ramp : OPEN_DOOR , then OCR0 and the direction pins PD6 /
+ * 				  PD7 are sampled in the middle of every DOOR_STEP_MS step ,
+ * 				  they must follow the reference profile of this file
+ * 				  (opening , hold , closing) . The OCR0 changes are at
+ * 				  DOOR_STEP_MS steps from the door start , TIMER0 is stopped
+ * 				  when the door is closed
+ *
+ * 				- Commands : READY and CHECK_PASSWORD sent in the middle of
+ * 				  the opening ramp , the latency (end of the command frame ->
+ * 				  start of the response) is compared with the same command
+ * 				  sent while the door is closed
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include <stdio.h>
+#include <string.h>
+
+/* The Control application without its main() , CONTROL_main() never returns */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wreturn-type"
+#define main CONTROL_main
+#include "door_lock_control.c"
+#undef main
+#pragma GCC diagnostic pop
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* Steps of a full cycle : opening , hold , closing */
+#define TEST_CLOSING_STEP		(DOOR_MOVE_STEPS + DOOR_HOLD_STEPS)
+#define TEST_CYCLE_STEPS		(TEST_CLOSING_STEP + DOOR_MOVE_STEPS)
+
+/* Commands sent in the opening ramp , at these steps */
+#define TEST_READY_STEP			(DOOR_RAMP_STEPS / 2)
+#define TEST_CHECK_STEP			(DOOR_RAMP_STEPS / 2 + 10)
+
+/* Max. duty change of one ramp step */
+#define TEST_MAX_DELTA			((DOOR_PWM_MAX + DOOR_RAMP_STEPS - 1) / DOOR_RAMP_STEPS)
+
+/* Max. step time error : Software Timer tick (start in a tick) + Door Task latency */
+#define TEST_MAX_JITTER_MS		2
+
+/* Max. extra latency of a command while the door moves */
+#define TEST_MAX_EXTRA_MS		1
+
+/* Virtual time after a command sent while the door is closed */
+#define TEST_SETTLE_MS			30
+
+#define TEST_MS_CYCLES			(F_CPU / 1000UL)
+#define TEST_STEP_CYCLES		((uint64)DOOR_STEP_MS * TEST_MS_CYCLES)
+
+/* The Door Task is added first (DOOR_init() after SCHED_init()) */
+#define TEST_DOOR_TASK			0
+
+#define TEST_PIN_A				(1<<MOTOR_PIN_A)
+#define TEST_PIN_B				(1<<MOTOR_PIN_B)
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint8 s_Command ;
+	uint8 s_Response ;
+	uint64 s_End ;
+	uint64 s_Latency ;
+	bool s_Done ;
+}TEST_RequestType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Responses of Control ECU (TX Hook) */
+static FRAME_DecoderType g_txDecoder ;
+static TEST_RequestType *g_request = NULL_PTR ;
+static uint64 g_responseStart = 0 ;
+
+/* OCR0 changes , step time error from the door start */
+static uint8 g_lastOcr ;
+static uint16 g_edges ;
+static int64_t g_minJitter ;
+static int64_t g_maxJitter ;
+static uint64 g_doorStart ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void TEST_init(void);
+static void TEST_send(TEST_RequestType *request, uint8 command, const uint8 *payload, uint8 length);
+static void TEST_runUntil(uint64 cycle);
+static void TEST_wait(TEST_RequestType *request);
+static void TEST_txHook(uint8 data, uint64 cycle);
+static uint8 TEST_expectedDuty(uint16 step);
+static uint8 TEST_expectedPins(uint16 step);
+static void TEST_ramp(TEST_RequestType *ready, TEST_RequestType *check);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	static const uint8 wrongPassword[PASS_SIZE] = {9, 9, 9, 9, 9} ;
+	TEST_RequestType closedReady , closedCheck , ready , check ;
+	SCHED_StatsType stats ;
+
+	TEST_begin("door");
+
+	TEST_eepromAttach();
+	TEST_init();
+	TEST_CHECK(g_eepromTask == TEST_DOOR_TASK + 1);
+
+	/* Door closed : latency of the commands without the Door Task */
+	TEST_send(&closedReady, READY, NULL_PTR, 0);
+	TEST_wait(&closedReady);
+	TEST_send(&closedCheck, CHECK_PASSWORD, wrongPassword, PASS_SIZE);
+	TEST_wait(&closedCheck);
+	TEST_CHECK(closedReady.s_Response == PASS_NOT_FOUND);
+	TEST_CHECK(closedCheck.s_Response == DONT_MATCH);
+
+	SCHED_resetStats();
+	TEST_ramp(&ready, &check);
+
+	/* Same responses , the door steps don't delay the commands */
+	TEST_CHECK(ready.s_Done && check.s_Done);
+	TEST_CHECK(ready.s_Response == PASS_NOT_FOUND);
+	TEST_CHECK(check.s_Response == DONT_MATCH);
+	TEST_CHECK(ready.s_Latency <= closedReady.s_Latency + TEST_MAX_EXTRA_MS * TEST_MS_CYCLES);
+	TEST_CHECK(check.s_Latency <= closedCheck.s_Latency + TEST_MAX_EXTRA_MS * TEST_MS_CYCLES);
+	TEST_CHECK(UART_getRxDropCount() == 0);
+
+	SCHED_getStats(TEST_DOOR_TASK, &stats);
+	TEST_CHECK(stats.s_Runs >= TEST_CYCLE_STEPS);
+
+	printf("TEST: door             %u steps , %u OCR0 changes timed , step error %+.2f .. %+.2f ms\n",
+			TEST_CYCLE_STEPS, g_edges, (double)g_minJitter / TEST_MS_CYCLES,
+			(double)g_maxJitter / TEST_MS_CYCLES);
+	printf("TEST: door             task %5u runs , run max %4u us , latency max %5u us\n",
+			stats.s_Runs, stats.s_MaxRunTime, stats.s_MaxLatency);
+	printf("TEST: door             READY latency %6.3f ms closed , %6.3f ms moving\n",
+			(double)closedReady.s_Latency / TEST_MS_CYCLES, (double)ready.s_Latency / TEST_MS_CYCLES);
+	printf("TEST: door             CHECK_PASSWORD latency %6.3f ms closed , %6.3f ms moving\n",
+			(double)closedCheck.s_Latency / TEST_MS_CYCLES, (double)check.s_Latency / TEST_MS_CYCLES);
+	return TEST_end();
+}
+
+/*
+ * Description: Function to start the Control ECU like its main()
+ */
+static void TEST_init(void)
+{
+	UART_ConfigType config = {.s_RxInterruptEnable = ENABLE_INT ,
+			.s_DataRegEmptyInterruptEnable = ENABLE_INT ,
+			.s_BaudRate = CONTROL_UART_BAUD_RATE , .s_NULL_Terminator = '#' };
+
+	sei();
+	UART_init(&config);
+	HOST_uartSetTxHook(TEST_txHook);
+	FRAME_decoderInit(&g_txDecoder);
+	EEPROM_init();
+	CACHE_init();
+	STORE_init();
+	USERS_init();
+	SoftTimer_init();
+	PROF_INIT();
+	ISR_STATS_INIT();
+	SCHED_init();
+	POWER_init();
+	SCHED_setIdleHook(POWER_idle);
+	LOCK_init();
+	DOOR_init();
+	FRAME_decoderInit(&g_rxFrame);
+	g_eepromTask = SCHED_addTask(EEPROM_task, CONTROL_EEPROM_TASK_PRIORITY);
+	g_commandTask = SCHED_addTask(Command_task, CONTROL_COMMAND_TASK_PRIORITY);
+	UART_RXC_setCallBack(UART_CallBack);
+	SCHED_setEvent(g_commandTask, EV_RX_BYTE);
+	TEST_runUntil(HOST_cycles() + (uint64)TEST_SETTLE_MS * TEST_MS_CYCLES);
+}
+
+/*
+ * Description: Function to send a command frame on the RX line from now ,
+ * 				the response is the next frame of the TX Hook
+ */
+static void TEST_send(TEST_RequestType *request, uint8 command, const uint8 *payload, uint8 length)
+{
+	uint8 frame[FRAME_MAX_PAYLOAD + FRAME_OVERHEAD] ;
+	uint8 size = FRAME_encode(command, payload, length, frame) ;
+	uint64 start = HOST_cycles() ;
+	uint8 i;
+
+	for(i = 0 ; i < size ; i++)
+	{
+		HOST_uartReceiveAt(frame[i], start + (uint64)(i + 1) * HOST_uartFrameCycles());
+	}
+	memset(request, 0, sizeof(*request));
+	request->s_Command = command ;
+	request->s_End = start + (uint64)size * HOST_uartFrameCycles() ;
+	g_responseStart = 0 ;
+	g_request = request ;
+}
+
+/*
+ * Description: Function to run the scheduler until cycle , the Idle Hook
+ * 				sleeps until the next interrupt . Every OCR0 change is
+ * 				timed from the door start
+ */
+static void TEST_runUntil(uint64 cycle)
+{
+	uint64 elapsed ;
+	int64_t jitter ;
+	uint8 ocr ;
+
+	while(HOST_cycles() < cycle)
+	{
+		SCHED_runOnce();
+		ocr = HOST_peek(OCR0) ;
+		if(ocr == g_lastOcr)
+			continue;
+
+		/* Error to the nearest step time */
+		g_lastOcr = ocr ;
+		elapsed = HOST_cycles() - g_doorStart ;
+		jitter = (int64_t)elapsed - (int64_t)(((elapsed + TEST_STEP_CYCLES / 2) / TEST_STEP_CYCLES)
+				* TEST_STEP_CYCLES) ;
+		if(jitter < g_minJitter)
+			g_minJitter = jitter ;
+		if(jitter > g_maxJitter)
+			g_maxJitter = jitter ;
+		g_edges++ ;
+	}
+}
+
+/*
+ * Description: Function to run until the response of the request
+ */
+static void TEST_wait(TEST_RequestType *request)
+{
+	uint64 deadline = HOST_cycles() + (uint64)TEST_SETTLE_MS * TEST_MS_CYCLES ;
+
+	while(!request->s_Done && (HOST_cycles() < deadline))
+	{
+		TEST_runUntil(HOST_cycles() + TEST_MS_CYCLES);
+	}
+	TEST_CHECK(request->s_Done);
+}
+
+/*
+ * Description: TX Hook , the response frames of Control ECU (cycle = end of
+ * 				the byte) , latency to the start of the first byte
+ */
+static void TEST_txHook(uint8 data, uint64 cycle)
+{
+	if(g_responseStart == 0)
+		g_responseStart = cycle - HOST_uartFrameCycles() ;
+	if(!FRAME_decodeByte(&g_txDecoder, data))
+		return ;
+
+	if((g_request != NULL_PTR) && !g_request->s_Done)
+	{
+		g_request->s_Response = g_txDecoder.s_Frame.s_Command ;
+		g_request->s_Latency = g_responseStart - g_request->s_End ;
+		g_request->s_Done = TRUE ;
+	}
+	g_responseStart = 0 ;
+}
+
+/*
+ * Description: Reference duty cycle after the step of the cycle (from 1) :
+ * 				ramp up , full , ramp down , hold (0) , same move closing
+ */
+static uint8 TEST_expectedDuty(uint16 step)
+{
+	if(step >= TEST_CLOSING_STEP)
+		step -= TEST_CLOSING_STEP ;
+	else if(step >= DOOR_MOVE_STEPS)
+		return 0 ;
+
+	if((step == 0) || (step >= DOOR_MOVE_STEPS))
+		return 0 ;
+	if(step < DOOR_RAMP_STEPS)
+		return (uint8)((DOOR_PWM_MAX * step) / DOOR_RAMP_STEPS) ;
+	if(step > DOOR_MOVE_STEPS - DOOR_RAMP_STEPS)
+		return (uint8)((DOOR_PWM_MAX * (DOOR_MOVE_STEPS - step)) / DOOR_RAMP_STEPS) ;
+	return DOOR_PWM_MAX ;
+}
+
+/*
+ * Description: Reference direction pins , both LOW at duty 0
+ */
+static uint8 TEST_expectedPins(uint16 step)
+{
+	if(TEST_expectedDuty(step) == 0)
+		return 0 ;
+	return (step < TEST_CLOSING_STEP) ? TEST_PIN_A : TEST_PIN_B ;
+}
+
+/*
+ * Description: Function to open the door and sample every step of the
+ * 				cycle , the commands are sent in the opening ramp
+ */
+static void TEST_ramp(TEST_RequestType *ready, TEST_RequestType *check)
+{
+	static const uint8 wrongPassword[PASS_SIZE] = {8, 8, 8, 8, 8} ;
+	TEST_RequestType open ;
+	uint32 wrongSteps = 0 , wrongPins = 0 ;
+	uint8 duty , lastDuty = 0 , maxDelta = 0 ;
+	uint16 step ;
+
+	TEST_send(&open, OPEN_DOOR, NULL_PTR, 0);
+	TEST_wait(&open);
+	TEST_CHECK(open.s_Response == READY);
+	TEST_CHECK(DOOR_getState() == DOOR_OPENING);
+
+	/* READY is sent before DOOR_open() , the steps are timed from it */
+	g_doorStart = open.s_End + open.s_Latency ;
+	g_lastOcr = HOST_peek(OCR0) ;
+	g_edges = 0 ;
+	g_minJitter = 0 ;
+	g_maxJitter = 0 ;
+
+	for(step = 1 ; step <= TEST_CYCLE_STEPS ; step++)
+	{
+		if(step == TEST_READY_STEP)
+			TEST_send(ready, READY, NULL_PTR, 0);
+		else if(step == TEST_CHECK_STEP)
+			TEST_send(check, CHECK_PASSWORD, wrongPassword, PASS_SIZE);
+
+		/* Middle of the step */
+		TEST_runUntil(g_doorStart + step * TEST_STEP_CYCLES + TEST_STEP_CYCLES / 2);
+
+		duty = HOST_peek(OCR0) ;
+		if((duty != TEST_expectedDuty(step)) || (DOOR_getDuty() != duty))
+			wrongSteps++ ;
+		if((HOST_peek(PORTD) & (TEST_PIN_A | TEST_PIN_B)) != TEST_expectedPins(step))
+			wrongPins++ ;
+		if(duty > lastDuty + maxDelta)
+			maxDelta = duty - lastDuty ;
+		else if(lastDuty > duty + maxDelta)
+			maxDelta = lastDuty - duty ;
+		lastDuty = duty ;
+	}
+
+	TEST_CHECK(wrongSteps == 0);
+	TEST_CHECK(wrongPins == 0);
+	TEST_CHECK(maxDelta <= TEST_MAX_DELTA);
+	TEST_CHECK(DOOR_getState() == DOOR_CLOSED);
+	TEST_CHECK((HOST_peek(TCCR0) & 0x07) == 0);
+
+	/* 2 ramps per move , every ramp step changes OCR0 */
+	TEST_CHECK(g_edges >= 4 * (DOOR_RAMP_STEPS - 1));
+	TEST_CHECK(g_minJitter > -(int64_t)TEST_MAX_JITTER_MS * TEST_MS_CYCLES);
+	TEST_CHECK(g_maxJitter < (int64_t)TEST_MAX_JITTER_MS * TEST_MS_CYCLES);
+
+	printf("TEST: door             OCR0 max step %u (ramp %u steps) , %u wrong steps , %u wrong pins\n",
+			maxDelta, DOOR_RAMP_STEPS, wrongSteps, wrongPins);
+}
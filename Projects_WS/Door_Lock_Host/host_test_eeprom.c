@@ -0,0 +1,270 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test_eeprom.c
+ * Description: Benchmark of the External EEPROM page writes (external_eeprom.c)
+ * 				on the TWI transactions engine (i2c.c TWI_submit()) and on
+ * 				the blocking path , 24C16 model at 400 Khz
+ *
+ * Notes:		- Blocking : EEPROM_writePage() of TEST_PAGES pages , the
+ * 				  main loop sends every page and waits the write cycle of
+ * 				  the previous one by ACK Polling (Start + SLA+W until ACK)
+ *
+ * 				- Transactions : EEPROM_writePageAsync() of the first page ,
+ * 				  the callback submits the next one from TWI ISR , ACK
+ * 				  Polling runs in TWI ISR (s_Polls) . The main loop only
+ * 				  submits the first page
+ *
+ * 				- Both : the pages are written in the EEPROM , one write
+ * 				  cycle per page , the ACK Polling tries per page and the
+ * 				  CPU time of the main loop / of TWI ISR are reported
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "external_eeprom.h"
+#include <avr/interrupt.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* Pages written by each path , from TEST_START_ADDRESS */
+#define TEST_PAGES				32
+#define TEST_START_ADDRESS		0x200
+#define TEST_BYTES				(TEST_PAGES * EEPROM_PAGE_SIZE)
+
+/* Main loop work slice while the transactions run */
+#define TEST_SLICE_CYCLES		((uint64)100UL * (F_CPU / 1000000UL))
+
+/* Max. main loop time of the transactions path (submit of the 1st page) */
+#define TEST_MAX_BLOCKED_PCT	1.0
+
+#define TEST_MS_CYCLES			(F_CPU / 1000UL)
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint64 s_Cycles ;
+	uint64 s_Blocked ;
+	uint64 s_IsrCycles ;
+	uint32 s_Polls ;
+}TEST_ResultType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static uint8 g_data[TEST_BYTES] ;
+
+/* Transactions path : two descriptors (the callback can't submit its own) */
+static TWI_TransactionType g_pages[2] ;
+static volatile uint8 g_nextPage ;
+static volatile bool g_done ;
+static volatile bool g_error ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void TEST_newData(void);
+static void TEST_waitWriteCycle(void);
+static void TEST_measureStart(TEST_ResultType *result, HOST_StatsType *stats);
+static void TEST_measureStop(TEST_ResultType *result, const HOST_StatsType *stats);
+static void TEST_checkPages(void);
+static void TEST_blocking(TEST_ResultType *result);
+static void TEST_pageDone(void);
+static void TEST_transactions(TEST_ResultType *result);
+static void TEST_print(const char *name, const TEST_ResultType *result);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	TEST_ResultType blocking , transactions ;
+
+	TEST_begin("eeprom");
+
+	TEST_eepromAttach();
+	EEPROM_init();
+	sei();
+
+	TEST_blocking(&blocking);
+	TEST_transactions(&transactions);
+
+	/* Same bus and write cycles , the main loop is free */
+	TEST_CHECK(transactions.s_Cycles <= blocking.s_Cycles + blocking.s_Cycles / 10);
+	TEST_CHECK(transactions.s_Blocked * 100.0 < transactions.s_Cycles * TEST_MAX_BLOCKED_PCT);
+
+	TEST_print("blocking", &blocking);
+	TEST_print("transactions", &transactions);
+	printf("TEST: eeprom           write cycle %.1f ms , main loop free %.1f ms of %.1f ms\n",
+			(double)TEST_EEPROM_WRITE_CYCLES / TEST_MS_CYCLES,
+			(double)(transactions.s_Cycles - transactions.s_Blocked - transactions.s_IsrCycles) / TEST_MS_CYCLES,
+			(double)transactions.s_Cycles / TEST_MS_CYCLES);
+	return TEST_end();
+}
+
+static void TEST_newData(void)
+{
+	uint16 i;
+
+	for(i = 0 ; i < TEST_BYTES ; i++)
+	{
+		g_data[i] = (uint8)TEST_random() ;
+	}
+	memset(g_testEeprom.s_PageWrites, 0, sizeof(g_testEeprom.s_PageWrites));
+}
+
+/*
+ * Description: Function to wait the end of the last write cycle
+ */
+static void TEST_waitWriteCycle(void)
+{
+	HOST_delayCycles(TEST_EEPROM_WRITE_CYCLES);
+}
+
+static void TEST_measureStart(TEST_ResultType *result, HOST_StatsType *stats)
+{
+	memset(result, 0, sizeof(*result));
+	result->s_Cycles = HOST_cycles() ;
+	result->s_Polls = g_testEeprom.s_BusyNacks ;
+	HOST_getStats(stats);
+}
+
+/*
+ * Description: Function to end a measure , the write cycle of the last
+ * 				page is counted (ended when the EEPROM ACKs again)
+ */
+static void TEST_measureStop(TEST_ResultType *result, const HOST_StatsType *stats)
+{
+	HOST_StatsType after ;
+
+	result->s_Cycles = HOST_cycles() - result->s_Cycles ;
+	HOST_getStats(&after);
+	result->s_IsrCycles = after.s_IsrCycles - stats->s_IsrCycles ;
+	result->s_Polls = g_testEeprom.s_BusyNacks - result->s_Polls ;
+}
+
+/*
+ * Description: The pages are in the EEPROM , one write cycle per page
+ */
+static void TEST_checkPages(void)
+{
+	uint16 page;
+
+	TEST_CHECK(memcmp(&g_testEeprom.s_Memory[TEST_START_ADDRESS], g_data, TEST_BYTES) == 0);
+	for(page = 0 ; page < TEST_EEPROM_PAGES ; page++)
+	{
+		bool written = (page >= TEST_START_ADDRESS / EEPROM_PAGE_SIZE) &&
+				(page < TEST_START_ADDRESS / EEPROM_PAGE_SIZE + TEST_PAGES) ;
+		TEST_CHECK(g_testEeprom.s_PageWrites[page] == (written ? 1 : 0));
+	}
+}
+
+/*
+ * Description: Function to write the pages by EEPROM_writePage() , the
+ * 				main loop is blocked until the last page is sent
+ */
+static void TEST_blocking(TEST_ResultType *result)
+{
+	HOST_StatsType stats ;
+	uint8 status ;
+
+	TEST_newData();
+	TEST_measureStart(result, &stats);
+	status = EEPROM_writePage(TEST_START_ADDRESS, g_data, TEST_BYTES) ;
+	result->s_Blocked = HOST_cycles() - result->s_Cycles ;
+	TEST_waitWriteCycle();
+	TEST_measureStop(result, &stats);
+
+	TEST_CHECK(status == SUCCESS);
+	TEST_checkPages();
+
+	/* The write cycle of every page but the last one is polled */
+	TEST_CHECK(result->s_Polls >= TEST_PAGES - 1);
+	TEST_CHECK(result->s_Polls <= (uint32)(TEST_PAGES - 1) * EEPROM_ACK_POLLS);
+}
+
+/*
+ * Description: Call Back of a page (TWI ISR) , submits the next page in
+ * 				the other descriptor
+ */
+static void TEST_pageDone(void)
+{
+	TWI_TransactionType *done = &g_pages[(g_nextPage - 1) & 1] ;
+	uint8 page = g_nextPage ;
+
+	if(done->s_Status != TWI_SUCCESS)
+	{
+		g_error = TRUE ;
+		g_done = TRUE ;
+		return ;
+	}
+	if(page == TEST_PAGES)
+	{
+		g_done = TRUE ;
+		return ;
+	}
+	g_nextPage = page + 1 ;
+	if(EEPROM_writePageAsync(&g_pages[page & 1], TEST_START_ADDRESS + page * EEPROM_PAGE_SIZE,
+			&g_data[page * EEPROM_PAGE_SIZE], EEPROM_PAGE_SIZE, TEST_pageDone) != SUCCESS)
+	{
+		g_error = TRUE ;
+		g_done = TRUE ;
+	}
+}
+
+/*
+ * Description: Function to write the pages by the transactions engine ,
+ * 				the main loop runs work slices until the last page is sent
+ */
+static void TEST_transactions(TEST_ResultType *result)
+{
+	HOST_StatsType stats ;
+	uint64 start ;
+	uint8 status ;
+
+	TEST_newData();
+	g_nextPage = 1 ;
+	g_done = FALSE ;
+	g_error = FALSE ;
+
+	TEST_measureStart(result, &stats);
+	start = HOST_cycles() ;
+	status = EEPROM_writePageAsync(&g_pages[0], TEST_START_ADDRESS, g_data,
+			EEPROM_PAGE_SIZE, TEST_pageDone) ;
+	result->s_Blocked = HOST_cycles() - start ;
+	while(!g_done)
+	{
+		HOST_delayCycles(TEST_SLICE_CYCLES);
+	}
+	TEST_waitWriteCycle();
+	TEST_measureStop(result, &stats);
+
+	TEST_CHECK(status == SUCCESS);
+	TEST_CHECK(!g_error);
+	TEST_CHECK(!TWI_isBusy());
+	TEST_checkPages();
+	TEST_CHECK(result->s_Polls >= TEST_PAGES - 1);
+	TEST_CHECK(result->s_Polls <= (uint32)(TEST_PAGES - 1) * EEPROM_ACK_POLLS);
+}
+
+static void TEST_print(const char *name, const TEST_ResultType *result)
+{
+	printf("TEST: eeprom           %-12s %u pages %6.1f ms (%.2f ms / page) , main loop %6.1f ms ,"
+			" ISR %5.1f ms , %4.1f ACK polls / page\n",
+			name, TEST_PAGES, (double)result->s_Cycles / TEST_MS_CYCLES,
+			(double)result->s_Cycles / TEST_PAGES / TEST_MS_CYCLES,
+			(double)result->s_Blocked / TEST_MS_CYCLES, (double)result->s_IsrCycles / TEST_MS_CYCLES,
+			(double)result->s_Polls / TEST_PAGES);
+}
@@ -0,0 +1,364 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test_frame.c
+ * Description: Loopback test of the Framed Messages Protocol (frame.c) on the
+ * 				USART model , TX wired to RX , and latency benchmark of a
+ * 				Password check against the old READY handshake
+ *
+ * Notes:		- Round trips : random frames of every length (0 ..
+ * 				  FRAME_MAX_PAYLOAD) are sent by FRAME_send() and decoded by
+ * 				  FRAME_poll() , the frame that comes back is the one sent
+ *
+ * 				- Bad CRC : one bit of a frame is flipped on the wire . A
+ * 				  flip in the command , payload or CRC is never accepted
+ * 				  (CRC-8 finds every 1 bit error) , a flip in the start or
+ * 				  length byte can swallow the next frame . Line noise
+ * 				  between frames too . The next frames are counted until
+ * 				  the decoder is in sync again
+ *
+ * 				- Latency : CHECK_PASSWORD + 5 digits and its response as two
+ * 				  frames , against the byte protocol of the first version
+ * 				  (READY before every digit , one EEPROM byte read and a
+ * 				  10 ms delay per digit) replayed on the same wire
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "frame.h"
+#include "external_eeprom.h"
+#include "door_lock_protocol.h"
+#include <avr/interrupt.h>
+#include <stdio.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+#define TEST_ROUND_TRIPS		2000
+#define TEST_CORRUPTIONS		2000
+#define TEST_NOISE_BURSTS		500
+#define TEST_MAX_NOISE			32
+
+/* Full frames sent after a corruption , the last one must be received */
+#define TEST_RESYNC_FRAMES		4
+
+/* Old byte protocol : 10 ms delay after the EEPROM byte read of a digit */
+#define TEST_OLD_DIGIT_DELAY_MS	10
+
+#define TEST_MS_CYCLES			(F_CPU / 1000UL)
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint32 s_Cases ;
+	uint32 s_FalseAccepts ;
+	uint32 s_Lost[TEST_RESYNC_FRAMES + 1] ;
+}TEST_ResyncType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static FRAME_DecoderType g_decoder ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void TEST_loopback(uint8 data, uint64 cycle);
+static void TEST_randomFrame(FRAME_Type *frame, uint8 length);
+static bool TEST_receive(FRAME_Type *frame, uint32 timeoutBytes);
+static bool TEST_same(const FRAME_Type *a, const FRAME_Type *b);
+static void TEST_roundTrips(void);
+static void TEST_corruptions(void);
+static void TEST_noise(void);
+static void TEST_resync(TEST_ResyncType *result);
+static void TEST_printResync(const char *name, const TEST_ResyncType *result);
+static void TEST_latency(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	UART_ConfigType config = {.s_RxInterruptEnable = ENABLE_INT ,
+			.s_DataRegEmptyInterruptEnable = ENABLE_INT ,
+			.s_BaudRate = BR115200 , .s_NULL_Terminator = '#' };
+
+	TEST_begin("frame");
+
+	UART_init(&config);
+	HOST_uartSetTxHook(TEST_loopback);
+	TEST_eepromAttach();
+	EEPROM_init();
+	FRAME_decoderInit(&g_decoder);
+	sei();
+
+	TEST_roundTrips();
+	TEST_corruptions();
+	TEST_noise();
+	TEST_latency();
+
+	/* The wire is read in time , the losses above are the decoder's */
+	TEST_CHECK(UART_getRxDropCount() == 0);
+	return TEST_end();
+}
+
+/*
+ * Description: TX Hook , TX wired to RX : the byte arrives at its stop bit
+ */
+static void TEST_loopback(uint8 data, uint64 cycle)
+{
+	HOST_uartReceiveAt(data, cycle);
+}
+
+static void TEST_randomFrame(FRAME_Type *frame, uint8 length)
+{
+	uint8 i;
+
+	frame->s_Command = (uint8)TEST_random() ;
+	frame->s_Length = length ;
+	for(i = 0 ; i < length ; i++)
+	{
+		frame->s_Payload[i] = (uint8)TEST_random() ;
+	}
+}
+
+/*
+ * Description: Function to wait a frame up to timeoutBytes byte times
+ *
+ * Return: TRUE if a frame is decoded , copied to frame
+ */
+static bool TEST_receive(FRAME_Type *frame, uint32 timeoutBytes)
+{
+	uint64 deadline = HOST_cycles() + (uint64)timeoutBytes * HOST_uartFrameCycles() ;
+
+	while(!FRAME_poll(&g_decoder))
+	{
+		if(HOST_cycles() >= deadline)
+			return FALSE ;
+		HOST_delayCycles(HOST_uartFrameCycles() / 4);
+	}
+	*frame = g_decoder.s_Frame ;
+	return TRUE ;
+}
+
+static bool TEST_same(const FRAME_Type *a, const FRAME_Type *b)
+{
+	uint8 i;
+
+	if((a->s_Command != b->s_Command) || (a->s_Length != b->s_Length))
+		return FALSE ;
+	for(i = 0 ; i < a->s_Length ; i++)
+	{
+		if(a->s_Payload[i] != b->s_Payload[i])
+			return FALSE ;
+	}
+	return TRUE ;
+}
+
+/*
+ * Description: Function to send random frames of every length and check
+ * 				the decoded frames , a too long payload isn't encoded
+ */
+static void TEST_roundTrips(void)
+{
+	uint8 buffer[FRAME_MAX_PAYLOAD + 1 + FRAME_OVERHEAD] ;
+	FRAME_Type sent , received ;
+	uint32 bad = 0 ;
+	uint64 start = HOST_cycles() ;
+	uint32 bytes = 0 ;
+	uint32 i;
+
+	for(i = 0 ; i < TEST_ROUND_TRIPS ; i++)
+	{
+		TEST_randomFrame(&sent, (uint8)(i % (FRAME_MAX_PAYLOAD + 1)));
+		FRAME_send(sent.s_Command, sent.s_Payload, sent.s_Length);
+		bytes += sent.s_Length + FRAME_OVERHEAD ;
+		if(!TEST_receive(&received, sent.s_Length + FRAME_OVERHEAD + 2) || !TEST_same(&sent, &received))
+			bad++ ;
+	}
+	TEST_CHECK(bad == 0);
+	TEST_CHECK(FRAME_encode(0x01, sent.s_Payload, FRAME_MAX_PAYLOAD + 1, buffer) == 0);
+
+	printf("TEST: frame            round trips %5u frames , %6u bytes , %u bad , %.1f us / frame\n",
+			TEST_ROUND_TRIPS, bytes, bad,
+			(double)(HOST_cycles() - start) * 1000.0 / TEST_MS_CYCLES / TEST_ROUND_TRIPS);
+}
+
+/*
+ * Description: Function to flip one bit of a frame on the wire , then send
+ * 				full frames until the decoder is in sync again
+ */
+static void TEST_corruptions(void)
+{
+	uint8 buffer[FRAME_MAX_PAYLOAD + FRAME_OVERHEAD] ;
+	TEST_ResyncType checked = {0} , framing = {0} ;
+	TEST_ResyncType *result ;
+	FRAME_Type sent , received ;
+	uint8 size , byte ;
+	uint32 i;
+	uint8 j;
+
+	for(i = 0 ; i < TEST_CORRUPTIONS ; i++)
+	{
+		TEST_randomFrame(&sent, (uint8)(TEST_random() % (FRAME_MAX_PAYLOAD + 1)));
+		size = FRAME_encode(sent.s_Command, sent.s_Payload, sent.s_Length, buffer) ;
+		byte = (uint8)(TEST_random() % size) ;
+		buffer[byte] ^= (uint8)(1 << (TEST_random() % 8)) ;
+
+		/* Start and length bytes => framing , the others are under the CRC */
+		result = ((byte == 0) || (byte == 2)) ? &framing : &checked ;
+		for(j = 0 ; j < size ; j++)
+		{
+			UART_sendByte(buffer[j]);
+		}
+		if(TEST_receive(&received, size + 2))
+			result->s_FalseAccepts++ ;
+		TEST_resync(result);
+	}
+
+	/* Length over FRAME_MAX_PAYLOAD is dropped at once , nothing is lost */
+	UART_sendByte(FRAME_START_BYTE);
+	UART_sendByte(0x01);
+	UART_sendByte(FRAME_MAX_PAYLOAD + 1);
+	TEST_randomFrame(&sent, 0);
+	FRAME_send(sent.s_Command, sent.s_Payload, 0);
+	TEST_CHECK(TEST_receive(&received, FRAME_OVERHEAD + 5) && TEST_same(&sent, &received));
+
+	TEST_CHECK(checked.s_FalseAccepts == 0);
+	TEST_CHECK(checked.s_Lost[0] == checked.s_Cases);
+	TEST_CHECK(framing.s_Lost[TEST_RESYNC_FRAMES] == 0);
+	TEST_CHECK(framing.s_FalseAccepts * 100 < framing.s_Cases);
+	TEST_printResync("bit flip (CRC)", &checked);
+	TEST_printResync("bit flip (framing)", &framing);
+}
+
+/*
+ * Description: Function to send random noise bytes between frames
+ */
+static void TEST_noise(void)
+{
+	TEST_ResyncType noise = {0} ;
+	FRAME_Type received ;
+	uint8 length ;
+	uint32 i;
+	uint8 j;
+
+	for(i = 0 ; i < TEST_NOISE_BURSTS ; i++)
+	{
+		length = (uint8)(1 + TEST_random() % TEST_MAX_NOISE) ;
+		for(j = 0 ; j < length ; j++)
+		{
+			UART_sendByte((uint8)TEST_random());
+		}
+		/* Read before the frames , a frame found in the noise is accepted */
+		while(TEST_receive(&received, length + 2))
+		{
+			noise.s_FalseAccepts++ ;
+		}
+		TEST_resync(&noise);
+	}
+	TEST_CHECK(noise.s_Lost[TEST_RESYNC_FRAMES] == 0);
+	TEST_printResync("noise", &noise);
+}
+
+/*
+ * Description: Function to send TEST_RESYNC_FRAMES full frames after a
+ * 				corruption , each one read before the next (RX Ring Buffer) .
+ * 				The frames before the first one received are lost , a
+ * 				received frame that wasn't sent is a false accept (no byte
+ * 				stuffing => a frame spliced from two can pass the CRC-8)
+ */
+static void TEST_resync(TEST_ResyncType *result)
+{
+	FRAME_Type sent , received ;
+	uint8 lost = TEST_RESYNC_FRAMES ;
+	uint8 i;
+
+	for(i = 0 ; i < TEST_RESYNC_FRAMES ; i++)
+	{
+		TEST_randomFrame(&sent, FRAME_MAX_PAYLOAD);
+		FRAME_send(sent.s_Command, sent.s_Payload, FRAME_MAX_PAYLOAD);
+		while(TEST_receive(&received, FRAME_MAX_PAYLOAD + FRAME_OVERHEAD + 2))
+		{
+			if(!TEST_same(&sent, &received))
+				result->s_FalseAccepts++ ;
+			else if(lost == TEST_RESYNC_FRAMES)
+				lost = i ;
+		}
+	}
+	result->s_Cases++ ;
+	result->s_Lost[lost]++ ;
+
+	/* In sync for the next case */
+	FRAME_decoderInit(&g_decoder);
+}
+
+static void TEST_printResync(const char *name, const TEST_ResyncType *result)
+{
+	printf("TEST: frame            %-18s %5u cases , frames lost 0/1/2/3: %u/%u/%u/%u , never synced %u , false accepts %u\n",
+			name, result->s_Cases, result->s_Lost[0], result->s_Lost[1], result->s_Lost[2],
+			result->s_Lost[3], result->s_Lost[TEST_RESYNC_FRAMES], result->s_FalseAccepts);
+}
+
+/*
+ * Description: Function to time a Password check , frames against the old
+ * 				byte protocol . The wire plays both ECUs : every byte comes
+ * 				back one byte time later , as the byte of the peer would
+ */
+static void TEST_latency(void)
+{
+	const uint8 pin[PASS_SIZE] = {1, 2, 3, 4, 5} ;
+	FRAME_Type received ;
+	uint64 start , frames , bytes ;
+	uint32 eepromBytes = g_testEeprom.s_ReadBytes + g_testEeprom.s_WriteBytes ;
+	uint8 data ;
+	uint8 i;
+
+	/* Frames : request + response , Password from the RAM copy */
+	start = HOST_cycles() ;
+	FRAME_send(CHECK_PASSWORD, pin, PASS_SIZE);
+	TEST_CHECK(TEST_receive(&received, PASS_SIZE + FRAME_OVERHEAD + 2) &&
+			(received.s_Command == CHECK_PASSWORD));
+	FRAME_send(MATCH, NULL_PTR, 0);
+	TEST_CHECK(TEST_receive(&received, FRAME_OVERHEAD + 2) && (received.s_Command == MATCH));
+	frames = HOST_cycles() - start ;
+
+	/* Old byte protocol : READY / READY / CHECK_PASSWORD , then READY +
+	 * digit + EEPROM byte + 10 ms per digit , then MATCH */
+	start = HOST_cycles() ;
+	UART_sendByte(READY);
+	TEST_CHECK(UART_receiveByte() == READY);
+	UART_sendByte(READY);
+	TEST_CHECK(UART_receiveByte() == READY);
+	UART_sendByte(CHECK_PASSWORD);
+	TEST_CHECK(UART_receiveByte() == CHECK_PASSWORD);
+	for(i = 0 ; i < PASS_SIZE ; i++)
+	{
+		UART_sendByte(READY);
+		TEST_CHECK(UART_receiveByte() == READY);
+		UART_sendByte(pin[i]);
+		TEST_CHECK(UART_receiveByte() == pin[i]);
+		TEST_CHECK(EEPROM_readByte((uint16)i, &data) == SUCCESS);
+		HOST_delayCycles((uint64)TEST_OLD_DIGIT_DELAY_MS * TEST_MS_CYCLES);
+	}
+	UART_sendByte(MATCH);
+	TEST_CHECK(UART_receiveByte() == MATCH);
+	bytes = HOST_cycles() - start ;
+
+	TEST_CHECK(frames * 10 < bytes);
+	printf("TEST: frame            CHECK_PASSWORD frames %2u bytes , 2 frames                 %8.3f ms\n",
+			2 * FRAME_OVERHEAD + PASS_SIZE, (double)frames / TEST_MS_CYCLES);
+	printf("TEST: frame            CHECK_PASSWORD READY  %2u bytes , %u I2C bytes , %2u ms delay %8.3f ms => x%.0f\n",
+			4 + 2 * PASS_SIZE, g_testEeprom.s_ReadBytes + g_testEeprom.s_WriteBytes - eepromBytes,
+			PASS_SIZE * TEST_OLD_DIGIT_DELAY_MS, (double)bytes / TEST_MS_CYCLES,
+			(double)bytes / (double)frames);
+}
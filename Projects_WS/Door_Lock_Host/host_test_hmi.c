@@ -0,0 +1,484 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test_hmi.c
+ * Description: Harness of the HMI State Machine (door_lock_hmi.c) and of the
+ * 				Scheduler : scripted key / response / timeout event streams ,
+ * 				stack depth and dispatch time of every event
+ *
+ * Notes:		- door_lock_hmi.c is compiled in this file (its main() is
+ * 				  renamed) , the harness starts the ECU like main() does . Key
+ * 				  events come from a script task at the Keypad Task priority ,
+ * 				  the responses of the Control ECU are frames on the UART RX
+ * 				  line , timeouts are the State Timer in virtual time
+ *
+ * 				- Every step checks the state after the event and the command
+ * 				  sent to Control ECU . The scripts start and end in HMI_MAIN
+ * 				  and run TEST_LOOPS times
+ *
+ * 				- The steps run on a painted stack (ucontext) : the depth of
+ * 				  a step is from the step runner down to the lowest byte
+ * 				  written (tasks , ISRs served in the step) . A state machine
+ * 				  without recursion has the same max depth in every loop
+ *
+ * 				- Dispatch time = run time of the task of the event
+ * 				  (SCHED_getStats) , the model counts the register accesses
+ * 				  only , the CPU time is the PROF_ZONE_DISPATCH zone of a
+ * 				  make PROF=1 build
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "stack_monitor.h"
+#include <stdio.h>
+#include <string.h>
+#include <ucontext.h>
+
+/* The HMI application without its main() , HMI_main() never returns */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wreturn-type"
+#define main HMI_main
+#include "door_lock_hmi.c"
+#undef main
+#pragma GCC diagnostic pop
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+#define TEST_LOOPS				20
+
+/* Host stack of the steps , painted before every step */
+#define TEST_STACK_SIZE			(64 * 1024)
+
+/* Bytes under the step runner frame that are not painted (red zone) */
+#define TEST_STACK_GUARD		512
+
+/* Virtual time after an event : TX frame at BR9600 , LCD queue */
+#define TEST_SETTLE_MS			30
+
+/* Max. virtual time waiting a State Timer event */
+#define TEST_MAX_WAIT_MS		20000
+
+#define TEST_MS_CYCLES			(F_CPU / 1000UL)
+
+/* No command sent to Control ECU in the step */
+#define TEST_NO_REQUEST			0xFF
+
+/* 5 digits , the last one sends request and moves to next */
+#define TEST_DIGITS(state, d, request, next)	\
+	{TEST_KEY, d, TEST_NO_REQUEST, state} , {TEST_KEY, d, TEST_NO_REQUEST, state} , \
+	{TEST_KEY, d, TEST_NO_REQUEST, state} , {TEST_KEY, d, TEST_NO_REQUEST, state} , \
+	{TEST_KEY, d, request, next}
+
+#define TEST_SCRIPT(steps)		{ #steps, steps, sizeof(steps) / sizeof(steps[0]) }
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef enum
+{
+	TEST_KEY,			/* EV_KEY , s_Data = key */
+	TEST_LONG,			/* EV_KEY_LONG , s_Data = key */
+	TEST_RESPONSE,		/* Response frame , s_Data = command */
+	TEST_LOCKED,		/* LOCKED response , s_Data = seconds */
+	TEST_TIMEOUT,		/* State Timer expired */
+	TEST_KINDS_NUM
+}TEST_StepKind;
+
+typedef struct
+{
+	TEST_StepKind s_Kind ;
+	uint8 s_Data ;
+	/* Command sent to Control ECU in the step , or TEST_NO_REQUEST */
+	uint8 s_Request ;
+	/* State after the step */
+	HMI_State s_State ;
+}TEST_StepType;
+
+typedef struct
+{
+	const char *s_Name ;
+	const TEST_StepType *s_Steps ;
+	uint8 s_Count ;
+}TEST_ScriptType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* First start : no password , startup timeout , new password */
+static const TEST_StepType g_firstStart[] =
+{
+	{TEST_TIMEOUT, 0, READY, HMI_STARTUP},
+	{TEST_RESPONSE, PASS_NOT_FOUND, TEST_NO_REQUEST, HMI_NEW_PASS},
+	TEST_DIGITS(HMI_NEW_PASS, 1, TEST_NO_REQUEST, HMI_RE_PASS),
+	TEST_DIGITS(HMI_RE_PASS, 1, CHANGE_PASSWORD, HMI_CONFIRMED),
+	{TEST_TIMEOUT, 0, TEST_NO_REQUEST, HMI_MAIN},
+};
+
+/* Open the door , the door closes */
+static const TEST_StepType g_openDoor[] =
+{
+	{TEST_KEY, '-', TEST_NO_REQUEST, HMI_OPEN_PASS},
+	TEST_DIGITS(HMI_OPEN_PASS, 1, CHECK_USER, HMI_VERIFY),
+	{TEST_RESPONSE, MATCH, OPEN_DOOR, HMI_DOOR_OPEN},
+	{TEST_KEY, 7, TEST_NO_REQUEST, HMI_DOOR_OPEN},
+	{TEST_TIMEOUT, 0, TEST_NO_REQUEST, HMI_DOOR_CLOSE},
+	{TEST_TIMEOUT, 0, TEST_NO_REQUEST, HMI_MAIN},
+};
+
+/* Wrong Passwords , checks locked 3 seconds , count down */
+static const TEST_StepType g_lockout[] =
+{
+	{TEST_KEY, '-', TEST_NO_REQUEST, HMI_OPEN_PASS},
+	TEST_DIGITS(HMI_OPEN_PASS, 2, CHECK_USER, HMI_VERIFY),
+	{TEST_RESPONSE, DONT_MATCH, TEST_NO_REQUEST, HMI_OPEN_PASS},
+	TEST_DIGITS(HMI_OPEN_PASS, 3, CHECK_USER, HMI_VERIFY),
+	{TEST_LOCKED, 3, TEST_NO_REQUEST, HMI_BLOCKED},
+	{TEST_KEY, '-', TEST_NO_REQUEST, HMI_BLOCKED},
+	{TEST_TIMEOUT, 0, TEST_NO_REQUEST, HMI_BLOCKED},
+	{TEST_TIMEOUT, 0, TEST_NO_REQUEST, HMI_BLOCKED},
+	{TEST_TIMEOUT, 0, TEST_NO_REQUEST, HMI_MAIN},
+};
+
+/* Change the Password , the new Passwords don't match once */
+static const TEST_StepType g_changePass[] =
+{
+	{TEST_KEY, '+', TEST_NO_REQUEST, HMI_OLD_PASS},
+	{TEST_KEY, '=', TEST_NO_REQUEST, HMI_OLD_PASS},
+	TEST_DIGITS(HMI_OLD_PASS, 1, CHECK_PASSWORD, HMI_VERIFY),
+	{TEST_RESPONSE, MATCH, TEST_NO_REQUEST, HMI_NEW_PASS},
+	TEST_DIGITS(HMI_NEW_PASS, 4, TEST_NO_REQUEST, HMI_RE_PASS),
+	TEST_DIGITS(HMI_RE_PASS, 5, TEST_NO_REQUEST, HMI_NOT_MATCHED),
+	{TEST_TIMEOUT, 0, TEST_NO_REQUEST, HMI_NEW_PASS},
+	TEST_DIGITS(HMI_NEW_PASS, 1, TEST_NO_REQUEST, HMI_RE_PASS),
+	TEST_DIGITS(HMI_RE_PASS, 1, CHANGE_PASSWORD, HMI_CONFIRMED),
+	{TEST_RESPONSE, DONT_MATCH, TEST_NO_REQUEST, HMI_CONFIRMED},
+	{TEST_TIMEOUT, 0, TEST_NO_REQUEST, HMI_MAIN},
+};
+
+/* Root Password (hidden long press) , then no digit => entry timeout */
+static const TEST_StepType g_rootPass[] =
+{
+	{TEST_LONG, '=', TEST_NO_REQUEST, HMI_ROOT_PASS},
+	TEST_DIGITS(HMI_ROOT_PASS, 6, CHECK_ROOT, HMI_VERIFY),
+	{TEST_RESPONSE, MATCH, TEST_NO_REQUEST, HMI_NEW_PASS},
+	{TEST_KEY, 1, TEST_NO_REQUEST, HMI_NEW_PASS},
+	{TEST_TIMEOUT, 0, READY, HMI_STARTUP},
+	{TEST_RESPONSE, PASS_FOUND, TEST_NO_REQUEST, HMI_MAIN},
+};
+
+/* Add a user , revoke it , no response => timeout */
+static const TEST_StepType g_users[] =
+{
+	{TEST_KEY, '*', TEST_NO_REQUEST, HMI_ADMIN_PASS},
+	TEST_DIGITS(HMI_ADMIN_PASS, 1, TEST_NO_REQUEST, HMI_USER_PIN),
+	TEST_DIGITS(HMI_USER_PIN, 8, ADD_USER, HMI_USER_RESULT),
+	{TEST_RESPONSE, READY, TEST_NO_REQUEST, HMI_USER_RESULT},
+	{TEST_TIMEOUT, 0, TEST_NO_REQUEST, HMI_MAIN},
+	{TEST_KEY, '/', TEST_NO_REQUEST, HMI_ADMIN_PASS},
+	TEST_DIGITS(HMI_ADMIN_PASS, 1, TEST_NO_REQUEST, HMI_USER_PIN),
+	TEST_DIGITS(HMI_USER_PIN, 8, REVOKE_USER, HMI_USER_RESULT),
+	{TEST_TIMEOUT, 0, TEST_NO_REQUEST, HMI_MAIN},
+	{TEST_KEY, '-', TEST_NO_REQUEST, HMI_OPEN_PASS},
+	{TEST_TIMEOUT, 0, TEST_NO_REQUEST, HMI_MAIN},
+};
+
+static const TEST_ScriptType g_firstStartScript = TEST_SCRIPT(g_firstStart) ;
+
+/* Scripts of every loop , from HMI_MAIN to HMI_MAIN */
+static const TEST_ScriptType g_scripts[] =
+{
+	TEST_SCRIPT(g_openDoor), TEST_SCRIPT(g_lockout), TEST_SCRIPT(g_changePass),
+	TEST_SCRIPT(g_rootPass), TEST_SCRIPT(g_users),
+};
+
+static const char *const g_kindNames[TEST_KINDS_NUM] =
+{
+	"key", "long key", "response", "locked", "timeout"
+};
+
+/* Painted stack of the steps and the contexts */
+static uint8 g_stack[TEST_STACK_SIZE] ;
+static ucontext_t g_mainContext , g_stepContext ;
+
+/* Script task , the key event of the step */
+static uint8 g_scriptTask = SCHED_NO_TASK ;
+static HMI_Event g_keyEvent ;
+
+/* Commands sent to Control ECU (TX Hook) */
+static FRAME_DecoderType g_txDecoder ;
+static uint8 g_request = TEST_NO_REQUEST ;
+static uint8 g_requests = 0 ;
+
+/* Deepest step of every kind , of the first loop and of all loops */
+static uint32 g_kindDepth[TEST_KINDS_NUM] ;
+static uint32 g_kindSteps[TEST_KINDS_NUM] ;
+static uint32 g_firstLoopDepth = 0 ;
+static uint32 g_maxDepth = 0 ;
+static uint32 g_wrongSteps = 0 ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void TEST_init(void);
+static void TEST_run(void);
+static void TEST_script(const TEST_ScriptType *script, bool firstLoop);
+static void TEST_step(const TEST_StepType *step, bool firstLoop);
+static void TEST_event(const TEST_StepType *step);
+static void TEST_runFor(uint64 cycles);
+static void Script_task(uint8 events);
+static void TEST_txHook(uint8 data, uint64 cycle);
+static void TEST_printTask(const char *name, uint8 task);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	TEST_StepKind kind ;
+
+	TEST_begin("hmi");
+
+	/* The script runs on the painted stack , back here at the end */
+	getcontext(&g_stepContext);
+	g_stepContext.uc_stack.ss_sp = g_stack ;
+	g_stepContext.uc_stack.ss_size = sizeof(g_stack) ;
+	g_stepContext.uc_link = &g_mainContext ;
+	makecontext(&g_stepContext, TEST_run, 0);
+	swapcontext(&g_mainContext, &g_stepContext);
+
+	TEST_CHECK(g_wrongSteps == 0);
+	TEST_CHECK(g_maxDepth > 0);
+	TEST_CHECK(g_maxDepth == g_firstLoopDepth);
+	TEST_CHECK(g_maxDepth < TEST_STACK_SIZE / 4);
+	TEST_CHECK(UART_getRxDropCount() == 0);
+
+	printf("TEST: hmi              %u loops , %u requests , stack max %u bytes (first loop %u)\n",
+			TEST_LOOPS, g_requests, g_maxDepth, g_firstLoopDepth);
+	for(kind = TEST_KEY ; kind < TEST_KINDS_NUM ; kind++)
+	{
+		printf("TEST: hmi              step %-9s %5u steps , stack max %4u bytes\n",
+				g_kindNames[kind], g_kindSteps[kind], g_kindDepth[kind]);
+	}
+	TEST_printTask("keys", g_scriptTask);
+	TEST_printTask("frame", g_frameTask);
+	TEST_printTask("timeout", g_timeoutTask);
+	TEST_printTask("lcd", g_lcdTask);
+	return TEST_end();
+}
+
+/*
+ * Description: Function to start the HMI like its main() , the script task
+ * 				takes the place of the Keypad Task
+ */
+static void TEST_init(void)
+{
+	UART_ConfigType config = {.s_RxInterruptEnable = ENABLE_INT ,
+			.s_DataRegEmptyInterruptEnable = ENABLE_INT ,
+			.s_BaudRate = HMI_UART_BAUD_RATE , .s_NULL_Terminator = '#' };
+
+	sei();
+	LCD_init();
+	LCD_clearScreen();
+	UART_init(&config);
+	HOST_uartSetTxHook(TEST_txHook);
+	FRAME_decoderInit(&g_txDecoder);
+	SoftTimer_init();
+	PROF_INIT();
+	ISR_STATS_INIT();
+	FRAME_decoderInit(&g_rxFrame);
+
+	SCHED_init();
+	POWER_init();
+	SCHED_setIdleHook(POWER_idle);
+	g_scriptTask = SCHED_addTask(Script_task, HMI_KEYPAD_TASK_PRIORITY);
+	g_frameTask = SCHED_addTask(Frame_task, HMI_FRAME_TASK_PRIORITY);
+	g_timeoutTask = SCHED_addTask(Timeout_task, HMI_TIMEOUT_TASK_PRIORITY);
+	g_lcdTask = SCHED_addTask(Lcd_task, HMI_LCD_TASK_PRIORITY);
+	UART_RXC_setCallBack(UART_CallBack);
+
+	g_state = HMI_STARTUP ;
+	g_stateTable[g_state].s_enter();
+	SCHED_setEvent(g_lcdTask, HMI_EV_FLUSH);
+	TEST_runFor((uint64)TEST_SETTLE_MS * TEST_MS_CYCLES);
+}
+
+/*
+ * Description: Steps context , first start then TEST_LOOPS loops of the
+ * 				scripts , the statistics are from the loops
+ */
+static void TEST_run(void)
+{
+	uint8 loop , i ;
+
+	TEST_init();
+	TEST_CHECK(g_request == READY);
+
+	TEST_script(&g_firstStartScript, FALSE);
+	SCHED_resetStats();
+	for(loop = 0 ; loop < TEST_LOOPS ; loop++)
+	{
+		for(i = 0 ; i < sizeof(g_scripts) / sizeof(g_scripts[0]) ; i++)
+		{
+			TEST_script(&g_scripts[i], loop == 0);
+		}
+	}
+}
+
+static void TEST_script(const TEST_ScriptType *script, bool firstLoop)
+{
+	uint8 i;
+
+	for(i = 0 ; i < script->s_Count ; i++)
+	{
+		TEST_step(&script->s_Steps[i], firstLoop);
+		if((g_state != script->s_Steps[i].s_State) ||
+				(g_request != script->s_Steps[i].s_Request))
+		{
+			if(g_wrongSteps++ < TEST_MAX_PRINTED)
+			{
+				printf("TEST: hmi              %s step %u : state %u request 0x%02X , expected %u 0x%02X\n",
+						script->s_Name, i, g_state, g_request,
+						script->s_Steps[i].s_State, script->s_Steps[i].s_Request);
+			}
+		}
+	}
+}
+
+/*
+ * Description: Function to paint the stack under the runner , run one
+ * 				step and measure the depth
+ */
+static void TEST_step(const TEST_StepType *step, bool firstLoop)
+{
+	uint8 *top = (uint8 *)__builtin_frame_address(0) ;
+	uint8 *painted = top - TEST_STACK_GUARD ;
+	uint8 *lowest = g_stack ;
+	uint32 depth ;
+
+	memset(g_stack, STACK_CANARY, (size_t)(painted - g_stack));
+	TEST_event(step);
+	while((lowest < painted) && (*lowest == STACK_CANARY))
+	{
+		lowest++ ;
+	}
+	depth = (uint32)(top - lowest) ;
+
+	g_kindSteps[step->s_Kind]++ ;
+	if(depth > g_kindDepth[step->s_Kind])
+		g_kindDepth[step->s_Kind] = depth ;
+	if(depth > g_maxDepth)
+		g_maxDepth = depth ;
+	if(firstLoop && (depth > g_firstLoopDepth))
+		g_firstLoopDepth = depth ;
+}
+
+/*
+ * Description: Function to make the event of a step and run the ECU until
+ * 				it is handled and the LCD / TX are done
+ */
+static void TEST_event(const TEST_StepType *step)
+{
+	uint8 frame[FRAME_MAX_PAYLOAD + FRAME_OVERHEAD] ;
+	uint8 payload[2] = { step->s_Data, 0 } ;
+	uint64 start = HOST_cycles() ;
+	uint64 deadline ;
+	uint16 runs ;
+	SCHED_StatsType stats ;
+	uint8 size , i ;
+
+	g_request = TEST_NO_REQUEST ;
+	switch(step->s_Kind)
+	{
+	case TEST_KEY:
+	case TEST_LONG:
+		g_keyEvent.s_Type = (step->s_Kind == TEST_KEY) ? EV_KEY : EV_KEY_LONG ;
+		g_keyEvent.s_Data = step->s_Data ;
+		SCHED_setEvent(g_scriptTask, HMI_EV_KEYPAD);
+		break;
+
+	case TEST_RESPONSE:
+	case TEST_LOCKED:
+		/* Control ECU frame on the line , byte after byte */
+		if(step->s_Kind == TEST_LOCKED)
+			size = FRAME_encode(LOCKED, payload, 2, frame) ;
+		else
+			size = FRAME_encode(step->s_Data, NULL_PTR, 0, frame) ;
+		for(i = 0 ; i < size ; i++)
+		{
+			HOST_uartReceiveAt(frame[i], start + (uint64)(i + 1) * HOST_uartFrameCycles());
+		}
+		start += (uint64)size * HOST_uartFrameCycles() ;
+		break;
+
+	case TEST_TIMEOUT:
+	default:
+		/* Run until the Timeout Task handled the State Timer */
+		SCHED_getStats(g_timeoutTask, &stats);
+		runs = stats.s_Runs ;
+		deadline = start + (uint64)TEST_MAX_WAIT_MS * TEST_MS_CYCLES ;
+		while((stats.s_Runs == runs) && (HOST_cycles() < deadline))
+		{
+			SCHED_runOnce();
+			SCHED_getStats(g_timeoutTask, &stats);
+		}
+		start = HOST_cycles() ;
+		break;
+	}
+	TEST_runFor(start + (uint64)TEST_SETTLE_MS * TEST_MS_CYCLES - HOST_cycles());
+}
+
+/*
+ * Description: Function to run the scheduler for cycles , the Idle Hook
+ * 				sleeps until the next interrupt
+ */
+static void TEST_runFor(uint64 cycles)
+{
+	uint64 end = HOST_cycles() + cycles ;
+
+	while(HOST_cycles() < end)
+	{
+		SCHED_runOnce();
+	}
+	while(SCHED_isReady())
+	{
+		SCHED_runOnce();
+	}
+}
+
+/*
+ * Description: Script Task , the key event of the step (Keypad Task place)
+ */
+static void Script_task(uint8 events)
+{
+	HMI_dispatch(&g_keyEvent);
+}
+
+/*
+ * Description: TX Hook , the frames of HMI are decoded as Control ECU does
+ */
+static void TEST_txHook(uint8 data, uint64 cycle)
+{
+	if(FRAME_decodeByte(&g_txDecoder, data))
+	{
+		g_request = g_txDecoder.s_Frame.s_Command ;
+		g_requests++ ;
+	}
+}
+
+static void TEST_printTask(const char *name, uint8 task)
+{
+	SCHED_StatsType stats ;
+
+	SCHED_getStats(task, &stats);
+	printf("TEST: hmi              task %-9s %5u runs , run max %4u us mean %6.1f us , latency max %5u us\n",
+			name, stats.s_Runs, stats.s_MaxRunTime,
+			(double)stats.s_RunTime / ((stats.s_Runs > 0) ? stats.s_Runs : 1), stats.s_MaxLatency);
+}
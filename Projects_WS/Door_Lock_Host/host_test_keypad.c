@@ -0,0 +1,308 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test_keypad.c
+ * Description: Test of the Keypad driver scanner (keypad.c) with bouncing
+ * 				contacts on a 4x4 matrix model of PORTA
+ *
+ * Notes:		- The matrix model has no diodes : a pin connected through
+ * 				  pressed switches to the column driven LOW reads LOW , 3
+ * 				  pressed corners of a rectangle read the 4th one as pressed
+ *
+ * 				- Contacts are stepped every TEST_STEP_US , a bounce toggles
+ * 				  the contact at random steps before its final state
+ *
+ * 				- A press / release with bounces shorter than the debounce
+ * 				  time is reported exactly once , a glitch shorter than the
+ * 				  debounce time isn't reported , a ghost key is never reported
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "keypad.h"
+#include <avr/interrupt.h>
+#include <stdio.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* Contacts are updated every TEST_STEP_US of virtual time */
+#define TEST_STEP_US			100
+#define TEST_STEP_CYCLES		((uint32)(F_CPU / 1000000UL) * TEST_STEP_US)
+
+/* Debounce time of the driver and the longest latency of an event after
+ * the last bounce (one more scan period for the phase of the scanner) */
+#define TEST_DEBOUNCE_MS		(KEYPAD_DEBOUNCE_SAMPLES * KEYPAD_SCAN_PERIOD_MS)
+#define TEST_LATENCY_MS			(TEST_DEBOUNCE_MS + KEYPAD_SCAN_PERIOD_MS)
+
+/* Bounces are shorter than the debounce time (scanner sees them) */
+#define TEST_MAX_BOUNCE_MS		(TEST_DEBOUNCE_MS / 2)
+
+/* Glitches are too short for KEYPAD_DEBOUNCE_SAMPLES equal samples */
+#define TEST_MAX_GLITCH_MS		(TEST_DEBOUNCE_MS - KEYPAD_SCAN_PERIOD_MS - 1)
+
+#define TEST_PRESSES			300
+#define TEST_GLITCHES			300
+#define TEST_GHOSTS				100
+
+#define TEST_MAX_EVENTS			(KEYPAD_QUEUE_SIZE)
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Closed contacts , bit (row*N_col + col) like the driver */
+static uint16 g_contacts = 0 ;
+
+/* Events read from the driver */
+static KeyPad_Event g_events[TEST_MAX_EVENTS] ;
+static uint8 g_eventsNum = 0 ;
+
+/* Key value of every switch , same layout as the keypad */
+static const uint8 g_keys[KEYPAD_KEYS_NUM] =
+{
+	7,  8, 9,   '/',
+	4,  5, 6,   '*',
+	1,  2, 3,   '-',
+	13, 0, '=', '+'
+};
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint8 TEST_matrixPins(uint8 port, uint8 ddr, uint8 out);
+static void TEST_run(uint32 ms);
+static void TEST_bounce(uint8 index, bool closed, uint32 bounceMs);
+static void TEST_readEvents(void);
+static bool TEST_isEvent(uint8 i, KeyPad_EventType type, uint8 index);
+static void TEST_presses(void);
+static void TEST_glitches(void);
+static void TEST_longPress(void);
+static void TEST_ghosts(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	TEST_begin("keypad");
+
+	HOST_gpioSetHooks('A', TEST_matrixPins, NULL_PTR);
+	SoftTimer_init();
+	KeyPad_init();
+	sei();
+
+	TEST_presses();
+	TEST_glitches();
+	TEST_longPress();
+	TEST_ghosts();
+
+	TEST_CHECK(KeyPad_getDropCount() == 0);
+	return TEST_end();
+}
+
+/*
+ * Description: Pin Hook of PORTA , rows on PA0..PA3 , columns on PA4..PA7 ,
+ * 				inputs with the pull-up read HIGH unless a closed contact
+ * 				path connects them to a pin driven LOW
+ */
+static uint8 TEST_matrixPins(uint8 port, uint8 ddr, uint8 out)
+{
+	uint8 low = ddr & ~out ;
+	uint8 last = 0 ;
+	uint8 row , col ;
+	(void)port ;
+
+	/* Spread LOW through the closed contacts until nothing changes */
+	while(low != last)
+	{
+		last = low ;
+		for(row = 0 ; row < N_row ; row++)
+		{
+			for(col = 0 ; col < N_col ; col++)
+			{
+				if((g_contacts & ((uint16)1 << (row*N_col + col))) &&
+					(low & ((1 << row) | (0x10 << col))))
+				{
+					low |= (uint8)((1 << row) | (0x10 << col)) ;
+				}
+			}
+		}
+	}
+	return (uint8)(out & ~low) ;
+}
+
+/*
+ * Description: Function to run the virtual time , TIMER1 ISR scans the keypad
+ */
+static void TEST_run(uint32 ms)
+{
+	HOST_delayCycles((uint64)ms * (F_CPU / 1000UL));
+}
+
+/*
+ * Description: Function to move a contact to its final state with random
+ * 				bounces during bounceMs
+ */
+static void TEST_bounce(uint8 index, bool closed, uint32 bounceMs)
+{
+	uint16 mask = (uint16)1 << index ;
+	uint32 step ;
+
+	for(step = 0 ; step < bounceMs * (1000 / TEST_STEP_US) ; step++)
+	{
+		if((TEST_random() % 4) == 0)
+			g_contacts ^= mask ;
+		HOST_delayCycles(TEST_STEP_CYCLES);
+	}
+	if(closed)
+		g_contacts |= mask ;
+	else
+		g_contacts &= ~mask ;
+}
+
+/*
+ * Description: Function to read the queued events , the queue must not be
+ * 				full (no event dropped by the test)
+ */
+static void TEST_readEvents(void)
+{
+	g_eventsNum = 0 ;
+	while((g_eventsNum < TEST_MAX_EVENTS) && KeyPad_poll(&g_events[g_eventsNum]))
+	{
+		g_eventsNum++ ;
+	}
+}
+
+static bool TEST_isEvent(uint8 i, KeyPad_EventType type, uint8 index)
+{
+	return (i < g_eventsNum) && (g_events[i].s_Type == type) &&
+			(g_events[i].s_Key == g_keys[index]) ;
+}
+
+/*
+ * Description: Press and release of random keys with bounces , one PRESS and
+ * 				one RELEASE at most TEST_LATENCY_MS after the last bounce
+ */
+static void TEST_presses(void)
+{
+	KeyPad_Event event = {KEYPAD_LONG_PRESS, KEYPAD_NO_KEY} ;
+	uint32 stableMs ;
+	uint8 index ;
+	uint16 i ;
+
+	for(i = 0 ; i < TEST_PRESSES ; i++)
+	{
+		index = (uint8)(TEST_random() % KEYPAD_KEYS_NUM) ;
+
+		TEST_bounce(index, TRUE, TEST_random() % (TEST_MAX_BOUNCE_MS + 1));
+		stableMs = millis() ;
+		while(!KeyPad_poll(&event) && (millis() - stableMs <= TEST_LATENCY_MS))
+		{
+			HOST_delayCycles(TEST_STEP_CYCLES);
+		}
+		TEST_CHECK(millis() - stableMs <= TEST_LATENCY_MS);
+		TEST_CHECK((event.s_Type == KEYPAD_PRESS) && (event.s_Key == g_keys[index]));
+
+		TEST_run(50 + TEST_random() % 200);
+		TEST_bounce(index, FALSE, TEST_random() % (TEST_MAX_BOUNCE_MS + 1));
+		stableMs = millis() ;
+		while(!KeyPad_poll(&event) && (millis() - stableMs <= TEST_LATENCY_MS))
+		{
+			HOST_delayCycles(TEST_STEP_CYCLES);
+		}
+		TEST_CHECK(millis() - stableMs <= TEST_LATENCY_MS);
+		TEST_CHECK((event.s_Type == KEYPAD_RELEASE) && (event.s_Key == g_keys[index]));
+
+		/* Nothing else , the press was reported once */
+		TEST_run(TEST_LATENCY_MS + 20);
+		TEST_readEvents();
+		TEST_CHECK(g_eventsNum == 0);
+	}
+}
+
+/*
+ * Description: Glitches shorter than the debounce time (noise , a key
+ * 				touched) aren't reported
+ */
+static void TEST_glitches(void)
+{
+	uint8 index ;
+	uint16 i ;
+
+	for(i = 0 ; i < TEST_GLITCHES ; i++)
+	{
+		index = (uint8)(TEST_random() % KEYPAD_KEYS_NUM) ;
+		TEST_bounce(index, FALSE, 1 + TEST_random() % TEST_MAX_GLITCH_MS);
+		TEST_run(TEST_LATENCY_MS + TEST_random() % 20);
+	}
+	TEST_readEvents();
+	TEST_CHECK(g_eventsNum == 0);
+}
+
+/*
+ * Description: A held key is reported PRESS , LONG_PRESS once , RELEASE
+ */
+static void TEST_longPress(void)
+{
+	uint8 index = 12 ;	/* Enter */
+
+	TEST_bounce(index, TRUE, TEST_MAX_BOUNCE_MS);
+	TEST_run(KEYPAD_LONG_PRESS_MS + 1000);
+	TEST_bounce(index, FALSE, TEST_MAX_BOUNCE_MS);
+	TEST_run(TEST_LATENCY_MS);
+
+	TEST_readEvents();
+	TEST_CHECK(g_eventsNum == 3);
+	TEST_CHECK(TEST_isEvent(0, KEYPAD_PRESS, index));
+	TEST_CHECK(TEST_isEvent(1, KEYPAD_LONG_PRESS, index));
+	TEST_CHECK(TEST_isEvent(2, KEYPAD_RELEASE, index));
+}
+
+/*
+ * Description: 3 corners of a random rectangle pressed one by one , the
+ * 				3rd key reads the 4th corner as pressed : the 2 first keys
+ * 				are reported , the 3rd and the ghost key aren't
+ */
+static void TEST_ghosts(void)
+{
+	uint8 row1 , row2 , col1 , col2 ;
+	uint8 first , second , third ;
+	uint16 i ;
+
+	for(i = 0 ; i < TEST_GHOSTS ; i++)
+	{
+		row1 = (uint8)(TEST_random() % N_row) ;
+		row2 = (uint8)((row1 + 1 + TEST_random() % (N_row - 1)) % N_row) ;
+		col1 = (uint8)(TEST_random() % N_col) ;
+		col2 = (uint8)((col1 + 1 + TEST_random() % (N_col - 1)) % N_col) ;
+		first = row1*N_col + col1 ;
+		second = row1*N_col + col2 ;
+		third = row2*N_col + col2 ;
+
+		TEST_bounce(first, TRUE, TEST_random() % (TEST_MAX_BOUNCE_MS + 1));
+		TEST_run(TEST_LATENCY_MS);
+		TEST_bounce(second, TRUE, TEST_random() % (TEST_MAX_BOUNCE_MS + 1));
+		TEST_run(TEST_LATENCY_MS);
+		TEST_bounce(third, TRUE, TEST_random() % (TEST_MAX_BOUNCE_MS + 1));
+		TEST_run(200);
+		TEST_bounce(third, FALSE, TEST_random() % (TEST_MAX_BOUNCE_MS + 1));
+		TEST_run(TEST_LATENCY_MS);
+		TEST_bounce(second, FALSE, TEST_random() % (TEST_MAX_BOUNCE_MS + 1));
+		TEST_run(TEST_LATENCY_MS);
+		TEST_bounce(first, FALSE, TEST_random() % (TEST_MAX_BOUNCE_MS + 1));
+		TEST_run(TEST_LATENCY_MS);
+
+		TEST_readEvents();
+		TEST_CHECK(g_eventsNum == 4);
+		TEST_CHECK(TEST_isEvent(0, KEYPAD_PRESS, first));
+		TEST_CHECK(TEST_isEvent(1, KEYPAD_PRESS, second));
+		TEST_CHECK(TEST_isEvent(2, KEYPAD_RELEASE, second));
+		TEST_CHECK(TEST_isEvent(3, KEYPAD_RELEASE, first));
+	}
+}
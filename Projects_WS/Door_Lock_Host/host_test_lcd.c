@@ -0,0 +1,325 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test_lcd.c
+ * Description: Bus transactions of the LCD driver (lcd.c) frame buffer flush ,
+ * 				LCD_flush() / LCD_flushCells() on the HD44780 model
+ *
+ * Notes:		- Typical screen changes of the HMI : the transactions
+ * 				  returned by LCD_flush() are the ones on the bus , the LCD
+ * 				  shows the frame buffer and no write is sent while busy
+ *
+ * 				- Diff or clear : a mostly blank new screen is drawn after
+ * 				  CLEAR_COMMAND , a small change by the changed cells only
+ *
+ * 				- Gap rewrite : a gap of LCD_FLUSH_MAX_GAP unchanged cells is
+ * 				  rewritten instead of a SET_CURSOR_LOCATION , a longer gap
+ * 				  moves the cursor
+ *
+ * 				- Random screens : the cost is the cheaper of the diff and
+ * 				  the clear (reference count in this file) , a screen larger
+ * 				  than the queue is sent by the next flushes (one more cursor
+ * 				  move per flush)
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "lcd.h"
+#include <avr/interrupt.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+#define TEST_RANDOM_SCREENS		500
+
+/* Max. flushes of one screen (queue full => the next flush sends the rest) */
+#define TEST_MAX_FLUSHES		8
+
+#define TEST_US_CYCLES			(F_CPU / 1000000UL)
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef char TEST_ScreenType[LCD_ROWS][LCD_COLS + 1] ;
+
+typedef struct
+{
+	uint32 s_Transactions ;
+	uint32 s_Flushes ;
+	uint32 s_CursorMoves ;
+	uint32 s_Clears ;
+	uint32 s_Characters ;
+}TEST_FlushType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Screen shown by the LCD , for the reference count */
+static TEST_ScreenType g_shown ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void TEST_draw(const char *row0, const char *row1);
+static void TEST_flush(TEST_FlushType *result);
+static void TEST_drain(void);
+static bool TEST_shows(const char *row0, const char *row1);
+static uint8 TEST_diffCost(const TEST_ScreenType from, const TEST_ScreenType to);
+static void TEST_screen(const char *name, const char *row0, const char *row1,
+		uint32 transactions, uint32 moves, uint32 clears);
+static void TEST_randomScreens(void);
+static void TEST_queueLimit(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	TEST_begin("lcd");
+
+	sei();
+	TEST_lcdAttach(8);
+	LCD_init();
+	TEST_drain();
+	TEST_CHECK(TEST_shows("", ""));
+
+	/* Screens of the HMI : boot , Main , Enter PASS , digits , count down , door */
+	TEST_screen("main screen", "+ : Change PASS", "- : Open Door", 30, 2, 0);
+	TEST_screen("no change", "+ : Change PASS", "- : Open Door", 0, 0, 0);
+	TEST_screen("enter pass", "Enter  PASS", "", 12, 2, 1);
+	TEST_screen("1st digit", "Enter  PASS", "*", 2, 1, 0);
+	TEST_screen("2nd digit", "Enter  PASS", "**", 2, 1, 0);
+	TEST_screen("blocked", "System Blocked", "Wait 00:10", 26, 2, 0);
+	TEST_screen("count down", "System Blocked", "Wait 00:09", 3, 1, 0);
+	TEST_screen("door open", "Door Open", "", 11, 1, 1);
+	TEST_screen("door close", "Door Close", "", 6, 1, 0);
+
+	/* Gap rewrite : 1 unchanged cell is rewritten , 2 cells move the cursor */
+	TEST_screen("clear", "", "", 1, 0, 1);
+	TEST_screen("gap 1", "", "* *", 4, 1, 0);
+	TEST_screen("clear", "", "", 1, 0, 1);
+	TEST_screen("gap 2", "", "*  *", 4, 2, 0);
+	TEST_screen("gap 1 , 2", "", "* *  *", 5, 1, 0);
+
+	TEST_randomScreens();
+	TEST_queueLimit();
+	TEST_CHECK(g_testLcd.s_BusyWrites == 0);
+	return TEST_end();
+}
+
+/*
+ * Description: Function to draw two rows in the frame buffer
+ */
+static void TEST_draw(const char *row0, const char *row1)
+{
+	LCD_bufferClear();
+	LCD_bufferStringRowColumn(0, 0, row0);
+	LCD_bufferStringRowColumn(1, 0, row1);
+}
+
+/*
+ * Description: Function to flush until nothing is changed , the queue is
+ * 				written between the flushes
+ */
+static void TEST_flush(TEST_FlushType *result)
+{
+	TEST_LcdType before = g_testLcd ;
+	uint8 transactions ;
+
+	memset(result, 0, sizeof(*result));
+	do
+	{
+		transactions = LCD_flush() ;
+		result->s_Transactions += transactions ;
+		result->s_Flushes++ ;
+		TEST_drain();
+	}while((transactions != 0) && (result->s_Flushes < TEST_MAX_FLUSHES));
+
+	result->s_CursorMoves = g_testLcd.s_CursorMoves - before.s_CursorMoves ;
+	result->s_Clears = g_testLcd.s_Clears - before.s_Clears ;
+	result->s_Characters = g_testLcd.s_Characters - before.s_Characters ;
+
+	/* Returned count = bus transactions */
+	TEST_CHECK(result->s_Transactions == (g_testLcd.s_Commands - before.s_Commands) + result->s_Characters);
+	TEST_CHECK(transactions == 0);
+}
+
+/*
+ * Description: Function to wait until the queue is written and the last
+ * 				instruction is executed
+ */
+static void TEST_drain(void)
+{
+	while(LCD_isQueueBusy())
+	{
+		HOST_delayCycles((uint64)LCD_ASYNC_TICK_US * TEST_US_CYCLES);
+	}
+	HOST_delayCycles(TEST_LCD_CLEAR_CYCLES);
+}
+
+static bool TEST_shows(const char *row0, const char *row1)
+{
+	char text[TEST_LCD_COLS + 1] ;
+	char expected[TEST_LCD_COLS + 1] ;
+	const char *rows[LCD_ROWS] = { row0, row1 } ;
+	uint8 row;
+
+	for(row = 0 ; row < LCD_ROWS ; row++)
+	{
+		snprintf(expected, sizeof(expected), "%-16s", rows[row]);
+		TEST_lcdRow(row, text);
+		if(strcmp(text, expected) != 0)
+			return FALSE ;
+		memcpy(g_shown[row], expected, sizeof(expected));
+	}
+	return TRUE ;
+}
+
+/*
+ * Description: Reference count of the diff : a move at the start of a run ,
+ * 				one character per changed cell , gaps up to
+ * 				LCD_FLUSH_MAX_GAP rewritten
+ */
+static uint8 TEST_diffCost(const TEST_ScreenType from, const TEST_ScreenType to)
+{
+	uint8 cost = 0 ;
+	uint8 row , col , cursor ;
+
+	for(row = 0 ; row < LCD_ROWS ; row++)
+	{
+		cursor = LCD_COLS ;
+		for(col = 0 ; col < LCD_COLS ; col++)
+		{
+			if(from[row][col] == to[row][col])
+				continue;
+			if((cursor < col) && ((col - cursor) <= LCD_FLUSH_MAX_GAP))
+				cost += col - cursor ;
+			else if(cursor != col)
+				cost++ ;
+			cost++ ;
+			cursor = col + 1 ;
+		}
+	}
+	return cost ;
+}
+
+/*
+ * Description: Function to flush one screen and check the transactions ,
+ * 				the cursor moves and the clears
+ */
+static void TEST_screen(const char *name, const char *row0, const char *row1,
+		uint32 transactions, uint32 moves, uint32 clears)
+{
+	TEST_FlushType result ;
+
+	TEST_draw(row0, row1);
+	TEST_flush(&result);
+	TEST_CHECK(TEST_shows(row0, row1));
+	TEST_CHECK(result.s_Transactions == transactions);
+	TEST_CHECK(result.s_CursorMoves == moves);
+	TEST_CHECK(result.s_Clears == clears);
+
+	printf("TEST: lcd              %-12s %2u transactions : %u moves , %u clear , %2u chars\n",
+			name, result.s_Transactions, result.s_CursorMoves, result.s_Clears, result.s_Characters);
+}
+
+/*
+ * Description: Function to flush random screens (words and spaces) , the
+ * 				cost is the cheaper of the diff and of the clear + redraw
+ */
+static void TEST_randomScreens(void)
+{
+	static const char *const words[] = { "Door", "PASS", "**", "Wait", "00:10", ":", "Enter", "*" } ;
+	TEST_ScreenType next , blank ;
+	TEST_FlushType result ;
+	uint32 transactions = 0 , expected = 0 , clears = 0 , extra = 0 ;
+	uint8 diffCost , clearCost ;
+	uint8 row , length ;
+	uint32 i;
+
+	memset(blank, ' ', sizeof(blank));
+	for(i = 0 ; i < TEST_RANDOM_SCREENS ; i++)
+	{
+		for(row = 0 ; row < LCD_ROWS ; row++)
+		{
+			/* Random words at random columns , or the row unchanged */
+			if(TEST_random() % 4 == 0)
+			{
+				memcpy(next[row], g_shown[row], sizeof(next[row]));
+				continue;
+			}
+			memset(next[row], ' ', LCD_COLS);
+			next[row][LCD_COLS] = '\0' ;
+			length = (uint8)(TEST_random() % LCD_COLS) ;
+			while(length < LCD_COLS)
+			{
+				const char *word = words[TEST_random() % (sizeof(words) / sizeof(words[0]))] ;
+				uint8 size = (uint8)strlen(word) ;
+				if(length + size > LCD_COLS)
+					break;
+				memcpy(&next[row][length], word, size);
+				length = (uint8)(length + size + 1 + TEST_random() % 3) ;
+			}
+		}
+
+		diffCost = TEST_diffCost(g_shown, next) ;
+		clearCost = (uint8)(1 + TEST_diffCost(blank, next)) ;
+
+		TEST_draw(next[0], next[1]);
+		TEST_flush(&result);
+		TEST_CHECK(TEST_shows(next[0], next[1]));
+
+		/* One flush => the cheaper one , else the queue stopped the flush */
+		if(result.s_Flushes <= 2)
+		{
+			TEST_CHECK(result.s_Transactions == ((clearCost < diffCost) ? clearCost : diffCost));
+			TEST_CHECK(result.s_Clears == ((clearCost < diffCost) ? 1 : 0));
+			expected += (clearCost < diffCost) ? clearCost : diffCost ;
+		}
+		else
+		{
+			extra++ ;
+			expected += result.s_Transactions ;
+		}
+		transactions += result.s_Transactions ;
+		clears += result.s_Clears ;
+	}
+	TEST_CHECK(transactions == expected);
+
+	printf("TEST: lcd              random %u screens : %.1f transactions / screen , %u cleared , %u over the queue\n",
+			TEST_RANDOM_SCREENS, (double)transactions / TEST_RANDOM_SCREENS, clears, extra);
+}
+
+/*
+ * Description: Function to redraw a full screen larger than the queue ,
+ * 				the first flush stops when the queue is full , the next
+ * 				ones send the rest
+ */
+static void TEST_queueLimit(void)
+{
+	TEST_FlushType result ;
+
+	TEST_draw("0123456789ABCDEF", "FEDCBA9876543210");
+	TEST_flush(&result);
+	LCD_invalidate();
+	TEST_flush(&result);
+
+	TEST_CHECK(TEST_shows("0123456789ABCDEF", "FEDCBA9876543210"));
+	TEST_CHECK(result.s_Flushes > 2);
+	TEST_CHECK(result.s_Clears == 0);
+
+	/* 2 rows of moves + cells , a flush stopped in a row moves again */
+	TEST_CHECK(result.s_Transactions == 2 + 2 * LCD_COLS + (result.s_Flushes - 2));
+
+	printf("TEST: lcd              redraw %2u transactions in %u flushes (queue %u)\n",
+			result.s_Transactions, result.s_Flushes - 1, LCD_QUEUE_SIZE);
+}
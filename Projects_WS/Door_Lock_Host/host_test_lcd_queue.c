@@ -0,0 +1,306 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test_lcd_queue.c
+ * Description: Asynchronous Mode of the LCD driver (lcd.c) , the queue
+ * 				(LCD_enqueue()) written by TIMER0 Compare ISR (LCD_asyncTick())
+ * 				on the HD44780 model
+ *
+ * Notes:		- Fill : LCD_QUEUE_SIZE bytes are queued without waiting ,
+ * 				  the next one waits one tick . Drain : one byte per tick ,
+ * 				  TIMER0 is stopped when the queue is empty
+ *
+ * 				- Wrap : TEST_STREAM_BYTES commands / characters back to back
+ * 				  (head and tail wrap many times) , every byte is on the bus
+ * 				  once in the queued order , no write while busy
+ *
+ * 				- Main loop latency : longest LCD_sendCommand() /
+ * 				  LCD_displayCharacter() call (queue full behind a Clear
+ * 				  Display) , LCD_flush() never waits the queue
+ *
+ * 				- LCD not connected (Busy Flag always 1) : a byte is written
+ * 				  after LCD_ASYNC_MAX_BUSY_TICKS ticks , the queue drains
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "lcd.h"
+#include <avr/interrupt.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* Bytes of the wrap stream (> 256 => uint8 head / tail wrap) , one Clear
+ * Display every TEST_CLEAR_EVERY bytes */
+#define TEST_STREAM_BYTES		2000
+#define TEST_CLEAR_EVERY		200
+
+#define TEST_MAX_BYTES			(TEST_STREAM_BYTES + 64)
+
+#define TEST_US_CYCLES			(F_CPU / 1000000UL)
+#define TEST_TICK_CYCLES		((uint64)LCD_ASYNC_TICK_US * TEST_US_CYCLES)
+
+/* Queue entry , RS in bit 8 (as lcd.c) */
+#define TEST_RS					0x0100
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Bytes queued by the test and seen on the bus */
+static uint16 g_sent[TEST_MAX_BYTES] ;
+static uint32 g_sentCount ;
+static uint16 g_bus[TEST_MAX_BYTES] ;
+static uint32 g_busCount ;
+static uint64 g_busLast ;
+
+/* Longest LCD call of the main loop */
+static uint64 g_maxLatency ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void TEST_busHook(bool rs, uint8 data, uint64 cycle);
+static uint64 TEST_send(uint16 entry);
+static uint32 TEST_drain(void);
+static void TEST_checkBus(void);
+static void TEST_fill(void);
+static void TEST_wrap(void);
+static void TEST_flushLatency(void);
+static uint8 TEST_floatingBus(uint8 port, uint8 ddr, uint8 out);
+static void TEST_notConnected(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	TEST_begin("lcd_queue");
+
+	sei();
+	TEST_lcdAttach(8);
+	LCD_init();
+	TEST_drain();
+	TEST_lcdSetHook(TEST_busHook);
+
+	TEST_fill();
+	TEST_wrap();
+	TEST_flushLatency();
+	TEST_CHECK(g_testLcd.s_BusyWrites == 0);
+	TEST_notConnected();
+	return TEST_end();
+}
+
+static void TEST_busHook(bool rs, uint8 data, uint64 cycle)
+{
+	if(g_busCount < TEST_MAX_BYTES)
+		g_bus[g_busCount] = (uint16)((rs ? TEST_RS : 0) | data) ;
+	g_busCount++ ;
+	g_busLast = cycle ;
+}
+
+/*
+ * Description: Function to queue one entry , returns the main loop time
+ * 				of the call
+ */
+static uint64 TEST_send(uint16 entry)
+{
+	uint64 start = HOST_cycles() ;
+	uint64 latency ;
+
+	if(entry & TEST_RS)
+		LCD_displayCharacter((uint8)entry);
+	else
+		LCD_sendCommand((uint8)entry);
+
+	latency = HOST_cycles() - start ;
+	if(latency > g_maxLatency)
+		g_maxLatency = latency ;
+	if(g_sentCount < TEST_MAX_BYTES)
+		g_sent[g_sentCount] = entry ;
+	g_sentCount++ ;
+	return latency ;
+}
+
+/*
+ * Description: Function to wait until the queue is written , returns the
+ * 				ticks waited
+ */
+static uint32 TEST_drain(void)
+{
+	uint32 ticks = 0 ;
+
+	while(LCD_isQueueBusy())
+	{
+		HOST_delayCycles(TEST_TICK_CYCLES);
+		ticks++ ;
+	}
+	HOST_delayCycles(TEST_LCD_CLEAR_CYCLES);
+	return ticks ;
+}
+
+/*
+ * Description: Every queued byte on the bus once , in the queued order
+ */
+static void TEST_checkBus(void)
+{
+	TEST_CHECK(g_busCount == g_sentCount);
+	TEST_CHECK(memcmp(g_bus, g_sent, g_sentCount * sizeof(g_sent[0])) == 0);
+	g_busCount = 0 ;
+	g_sentCount = 0 ;
+}
+
+/*
+ * Description: Function to fill the queue from idle , the byte after a
+ * 				full queue waits the first tick , drain at one byte per tick
+ */
+static void TEST_fill(void)
+{
+	HOST_StatsType before , after ;
+	uint64 fillLatency = 0 , fullLatency ;
+	uint32 ticks ;
+	uint8 i;
+
+	LCD_goToRowColumn(0, 0);
+	TEST_drain();
+	g_busCount = 0 ;
+
+	for(i = 0 ; i < LCD_QUEUE_SIZE ; i++)
+	{
+		uint64 latency = TEST_send((uint16)(TEST_RS | ('A' + i % 26))) ;
+		if(latency > fillLatency)
+			fillLatency = latency ;
+	}
+	TEST_CHECK(fillLatency < TEST_TICK_CYCLES);
+	TEST_CHECK(g_busCount == 0);
+
+	/* Queue full => waits the first byte written */
+	fullLatency = TEST_send(TEST_RS | 'z') ;
+	TEST_CHECK(fullLatency > fillLatency);
+	TEST_CHECK(fullLatency <= 2 * TEST_TICK_CYCLES);
+
+	ticks = TEST_drain() ;
+	TEST_CHECK(ticks <= LCD_QUEUE_SIZE + 2);
+	TEST_checkBus();
+
+	/* Queue empty => TIMER0 stopped , no more tick */
+	HOST_getStats(&before);
+	HOST_delayCycles(100 * TEST_TICK_CYCLES);
+	HOST_getStats(&after);
+	TEST_CHECK(after.s_Isrs == before.s_Isrs);
+
+	printf("TEST: lcd_queue        fill %u bytes max %5.1f us , full %5.1f us , drain %u ticks\n",
+			LCD_QUEUE_SIZE, (double)fillLatency / TEST_US_CYCLES,
+			(double)fullLatency / TEST_US_CYCLES, ticks);
+}
+
+/*
+ * Description: Function to stream random commands / characters back to
+ * 				back , the main loop waits the queue
+ */
+static void TEST_wrap(void)
+{
+	uint64 start ;
+	uint32 i;
+
+	g_maxLatency = 0 ;
+	start = HOST_cycles() ;
+	for(i = 0 ; i < TEST_STREAM_BYTES ; i++)
+	{
+		if(i % TEST_CLEAR_EVERY == TEST_CLEAR_EVERY - 1)
+			TEST_send(CLEAR_COMMAND);
+		else if(TEST_random() % 8 == 0)
+			TEST_send((uint16)(SET_CURSOR_LOCATION | ((TEST_random() % 2) ? TEST_LCD_LINE_2 : 0)
+					| (TEST_random() % TEST_LCD_COLS)));
+		else
+			TEST_send((uint16)(TEST_RS | (' ' + TEST_random() % 95)));
+	}
+	TEST_drain();
+	TEST_checkBus();
+
+	/* Worst case : queue full behind a Clear Display , the ticks poll the
+	 * Busy Flag until the end of its execution */
+	TEST_CHECK(g_maxLatency >= TEST_LCD_CLEAR_CYCLES);
+	TEST_CHECK(g_maxLatency <= (LCD_ASYNC_MAX_BUSY_TICKS + 2) * TEST_TICK_CYCLES);
+
+	printf("TEST: lcd_queue        stream %u bytes in %.1f ms (%.1f us / byte) , main loop max %.1f us\n",
+			TEST_STREAM_BYTES, (double)(g_busLast - start) / (TEST_US_CYCLES * 1000.0),
+			(double)(g_busLast - start) / TEST_STREAM_BYTES / TEST_US_CYCLES,
+			(double)g_maxLatency / TEST_US_CYCLES);
+}
+
+/*
+ * Description: Function to flush full screens , LCD_flush() stops at the
+ * 				free bytes of the queue and never waits
+ */
+static void TEST_flushLatency(void)
+{
+	uint64 start , latency , maxLatency = 0 ;
+	char text[TEST_LCD_COLS + 1] ;
+	uint8 transactions ;
+	uint8 flushes = 0 ;
+
+	LCD_bufferClear();
+	LCD_bufferStringRowColumn(0, 0, "0123456789ABCDEF");
+	LCD_bufferStringRowColumn(1, 0, "FEDCBA9876543210");
+	LCD_invalidate();
+	do
+	{
+		start = HOST_cycles() ;
+		transactions = LCD_flush() ;
+		latency = HOST_cycles() - start ;
+		if(latency > maxLatency)
+			maxLatency = latency ;
+		flushes++ ;
+		HOST_delayCycles(10 * TEST_TICK_CYCLES);
+	}while(transactions != 0);
+
+	TEST_drain();
+	TEST_lcdRow(0, text);
+	TEST_CHECK(strcmp(text, "0123456789ABCDEF") == 0);
+	TEST_lcdRow(1, text);
+	TEST_CHECK(strcmp(text, "FEDCBA9876543210") == 0);
+	TEST_CHECK(maxLatency < TEST_TICK_CYCLES);
+	g_busCount = 0 ;
+
+	printf("TEST: lcd_queue        flush full screen max %5.1f us (%u flushes)\n",
+			(double)maxLatency / TEST_US_CYCLES, flushes);
+}
+
+/*
+ * Description: Data pins pulled high , the Busy Flag is always read as 1
+ */
+static uint8 TEST_floatingBus(uint8 port, uint8 ddr, uint8 out)
+{
+	return 0xFF ;
+}
+
+/*
+ * Description: Function to queue bytes without LCD , each one is written
+ * 				after LCD_ASYNC_MAX_BUSY_TICKS ticks
+ */
+static void TEST_notConnected(void)
+{
+	uint32 ticks ;
+	uint8 i;
+
+	HOST_gpioSetHooks('B', TEST_floatingBus, NULL_PTR);
+	for(i = 0 ; i < 4 ; i++)
+	{
+		LCD_displayCharacter('x');
+	}
+	ticks = TEST_drain() ;
+	TEST_lcdAttach(8);
+
+	TEST_CHECK(ticks >= 4 * LCD_ASYNC_MAX_BUSY_TICKS);
+	TEST_CHECK(ticks <= 4 * (LCD_ASYNC_MAX_BUSY_TICKS + 2));
+
+	printf("TEST: lcd_queue        not connected 4 bytes in %u ticks\n", ticks);
+}
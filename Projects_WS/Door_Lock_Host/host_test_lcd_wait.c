@@ -0,0 +1,303 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test_lcd_wait.c
+ * Description: Cycle benchmark of the LCD driver (lcd.c) wait for ready ,
+ * 				LCD_waitReady() / LCD_isBusy() on the HD44780 model
+ *
+ * Notes:		- lcd.c is compiled in this file (static functions) , the
+ * 				  Makefile builds one binary per data bus width (8 , 4 upper
+ * 				  pins) and timing mode (Busy Flag , us delays) with
+ * 				  LCD_ASYNC = FALSE , the main loop waits the LCD
+ *
+ * 				- LCD_isBusy() : cycles and register accesses of one Busy
+ * 				  Flag read , LCD_waitReady() : cycles and reads after a
+ * 				  character and after CLEAR_COMMAND
+ *
+ * 				- Character : from the E strobe of a character to the E
+ * 				  strobe of the next one , Screen : LCD_flush() of a full
+ * 				  screen from a blank LCD . No write is sent while busy
+ *
+ * 				- LCD not connected (Busy Flag always 1) : LCD_waitReady()
+ * 				  gives up after LCD_BUSY_MAX_POLLS reads , longer than the
+ * 				  Clear Display execution time
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include <avr/interrupt.h>
+#include <stdio.h>
+#include <string.h>
+
+/* The LCD driver with its static functions */
+#include "lcd.c"
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+#if (DATA_BITS_MODE == 4)
+#define TEST_BUS				"4"
+#else
+#define TEST_BUS				"8"
+#endif
+
+#if (LCD_TIMING_MODE == LCD_TIMING_BUSY_FLAG)
+#define TEST_TIMING				"busy"
+#else
+#define TEST_TIMING				"us"
+#endif
+
+#define TEST_NAME				"lcd_wait_" TEST_BUS "_" TEST_TIMING
+
+#define TEST_US_CYCLES			(F_CPU / 1000000UL)
+
+/* Max. time of one E strobe of a write (setup , pulse , hold delays) */
+#define TEST_STROBE_MAX_US		4
+#define TEST_STROBES			(8 / DATA_BITS_MODE)
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint64 s_Cycles ;
+	uint64 s_IoAccesses ;
+	uint32 s_StatusReads ;
+}TEST_CostType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static uint64 g_startCycles ;
+static HOST_StatsType g_startStats ;
+static uint32 g_startReads ;
+
+#if (LCD_TIMING_MODE == LCD_TIMING_BUSY_FLAG)
+/* Cycles of one LCD_isBusy() */
+static uint64 g_pollCycles ;
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void TEST_start(void);
+static void TEST_stop(TEST_CostType *cost);
+static void TEST_waitCost(const char *name, uint8 command);
+static void TEST_characters(void);
+static void TEST_screen(void);
+#if (LCD_TIMING_MODE == LCD_TIMING_BUSY_FLAG)
+static void TEST_isBusy(void);
+static uint8 TEST_floatingBus(uint8 port, uint8 ddr, uint8 out);
+static void TEST_notConnected(void);
+#endif
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	TEST_begin(TEST_NAME);
+
+	sei();
+	TEST_lcdAttach(DATA_BITS_MODE);
+	LCD_init();
+	TEST_CHECK(g_testLcd.s_Clears == 1);
+
+#if (LCD_TIMING_MODE == LCD_TIMING_BUSY_FLAG)
+	TEST_isBusy();
+#endif
+	TEST_waitCost("char", 'A');
+	TEST_waitCost("clear", CLEAR_COMMAND);
+	TEST_characters();
+	TEST_screen();
+	TEST_CHECK(g_testLcd.s_BusyWrites == 0);
+#if (LCD_TIMING_MODE == LCD_TIMING_BUSY_FLAG)
+	TEST_notConnected();
+#else
+	/* No Busy Flag read in us delays mode */
+	TEST_CHECK(g_testLcd.s_StatusReads == 0);
+#endif
+	return TEST_end();
+}
+
+static void TEST_start(void)
+{
+	g_startCycles = HOST_cycles() ;
+	HOST_getStats(&g_startStats);
+	g_startReads = g_testLcd.s_StatusReads ;
+}
+
+static void TEST_stop(TEST_CostType *cost)
+{
+	HOST_StatsType stats ;
+
+	cost->s_Cycles = HOST_cycles() - g_startCycles ;
+	HOST_getStats(&stats);
+	cost->s_IoAccesses = stats.s_IoAccesses - g_startStats.s_IoAccesses ;
+	cost->s_StatusReads = g_testLcd.s_StatusReads - g_startReads ;
+}
+
+/*
+ * Description: Function to measure LCD_waitReady() after a character
+ * 				(command = 'A') or after a command , the next write must
+ * 				be accepted
+ */
+static void TEST_waitCost(const char *name, uint8 command)
+{
+	TEST_CostType cost ;
+	uint32 busyWrites = g_testLcd.s_BusyWrites ;
+
+	LCD_waitReady();
+	if(command == CLEAR_COMMAND)
+		LCD_sendCommand(command);
+	else
+		LCD_displayCharacter(command);
+
+	TEST_start();
+	LCD_waitReady();
+	TEST_stop(&cost);
+
+	LCD_displayCharacter('B');
+	TEST_CHECK(g_testLcd.s_BusyWrites == busyWrites);
+
+#if (LCD_TIMING_MODE == LCD_TIMING_BUSY_FLAG)
+	/* Polled until ready , the last read is not busy */
+	TEST_CHECK(cost.s_StatusReads >= 1);
+	TEST_CHECK(cost.s_StatusReads < LCD_BUSY_MAX_POLLS);
+#else
+	/* The delay is in the write flow , nothing to wait */
+	TEST_CHECK(cost.s_Cycles == 0);
+#endif
+
+	printf("TEST: %-16s waitReady after %-5s %7.1f us , %3u Busy Flag reads\n",
+			TEST_NAME, name, (double)cost.s_Cycles / TEST_US_CYCLES, cost.s_StatusReads);
+}
+
+/*
+ * Description: Function to measure the time of a character written by
+ * 				LCD_displayCharacter() , from one to the next one
+ */
+static void TEST_characters(void)
+{
+	TEST_CostType cost ;
+	uint32 characters = g_testLcd.s_Characters ;
+	uint8 i;
+
+	LCD_goToRowColumn(0, 0);
+	LCD_displayCharacter('0');
+	TEST_start();
+	for(i = 1 ; i <= LCD_COLS ; i++)
+	{
+		LCD_displayCharacter((uint8)('0' + i % 10));
+	}
+	TEST_stop(&cost);
+
+	TEST_CHECK(g_testLcd.s_Characters - characters == LCD_COLS + 1);
+
+#if (LCD_TIMING_MODE == LCD_TIMING_BUSY_FLAG)
+	/* Execution time of the model + the read in progress and the last one
+	 * + the write strobe(s) */
+	TEST_CHECK(cost.s_Cycles / LCD_COLS >= TEST_LCD_EXEC_CYCLES);
+	TEST_CHECK(cost.s_Cycles / LCD_COLS < TEST_LCD_EXEC_CYCLES + 2 * g_pollCycles
+			+ TEST_STROBES * TEST_STROBE_MAX_US * TEST_US_CYCLES);
+#else
+	/* Datasheet time after every character */
+	TEST_CHECK(cost.s_Cycles / LCD_COLS >= LCD_EXEC_US * TEST_US_CYCLES);
+#endif
+
+	printf("TEST: %-16s character %7.1f us , %4.1f register accesses\n", TEST_NAME,
+			(double)cost.s_Cycles / LCD_COLS / TEST_US_CYCLES, (double)cost.s_IoAccesses / LCD_COLS);
+}
+
+/*
+ * Description: Function to measure the main loop time of a full screen
+ * 				flush from a blank LCD
+ */
+static void TEST_screen(void)
+{
+	TEST_CostType cost ;
+	char text[TEST_LCD_COLS + 1] ;
+	uint8 transactions ;
+
+	LCD_clearScreen();
+	LCD_bufferClear();
+	LCD_waitReady();
+
+	LCD_bufferStringRowColumn(0, 0, "+ : Change PASS");
+	LCD_bufferStringRowColumn(1, 0, "- : Open Door");
+	TEST_start();
+	transactions = LCD_flush() ;
+	TEST_stop(&cost);
+
+	TEST_lcdRow(0, text);
+	TEST_CHECK(strcmp(text, "+ : Change PASS ") == 0);
+	TEST_lcdRow(1, text);
+	TEST_CHECK(strcmp(text, "- : Open Door   ") == 0);
+
+	printf("TEST: %-16s screen %2u transactions %7.1f us\n", TEST_NAME,
+			transactions, (double)cost.s_Cycles / TEST_US_CYCLES);
+}
+
+#if (LCD_TIMING_MODE == LCD_TIMING_BUSY_FLAG)
+/*
+ * Description: Function to measure one Busy Flag read , LCD ready and
+ * 				LCD busy after a character
+ */
+static void TEST_isBusy(void)
+{
+	TEST_CostType cost ;
+	bool busy ;
+
+	LCD_waitReady();
+	TEST_start();
+	busy = LCD_isBusy() ;
+	TEST_stop(&cost);
+	g_pollCycles = cost.s_Cycles ;
+
+	TEST_CHECK(busy == FALSE);
+	TEST_CHECK(cost.s_StatusReads == 1);
+
+	LCD_displayCharacter(' ');
+	TEST_CHECK(LCD_isBusy() == TRUE);
+
+	printf("TEST: %-16s isBusy %7.1f us , %u register accesses\n", TEST_NAME,
+			(double)cost.s_Cycles / TEST_US_CYCLES, (unsigned)cost.s_IoAccesses);
+}
+
+/*
+ * Description: Data pins pulled high , the Busy Flag is always read as 1
+ */
+static uint8 TEST_floatingBus(uint8 port, uint8 ddr, uint8 out)
+{
+	return 0xFF ;
+}
+
+/*
+ * Description: Function to measure LCD_waitReady() without LCD , bounded
+ * 				by LCD_BUSY_MAX_POLLS
+ */
+static void TEST_notConnected(void)
+{
+	uint64 start ;
+	uint64 cycles ;
+
+	HOST_gpioSetHooks('B', TEST_floatingBus, NULL_PTR);
+	start = HOST_cycles() ;
+	LCD_waitReady();
+	cycles = HOST_cycles() - start ;
+	TEST_lcdAttach(DATA_BITS_MODE);
+
+	TEST_CHECK(cycles >= (uint64)LCD_CLEAR_EXEC_US * TEST_US_CYCLES);
+	TEST_CHECK(cycles < (uint64)LCD_BUSY_MAX_POLLS * 10 * TEST_US_CYCLES);
+
+	printf("TEST: %-16s not connected waitReady %7.1f us (%u reads)\n", TEST_NAME,
+			(double)cycles / TEST_US_CYCLES, LCD_BUSY_MAX_POLLS);
+}
+#endif
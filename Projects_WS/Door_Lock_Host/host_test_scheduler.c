@@ -0,0 +1,360 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test_scheduler.c
+ * Description: Synthetic load benchmark of the Cooperative Run-To-Completion
+ * 				Scheduler (scheduler.c) on the TIMER1 model
+ *
+ * Notes:		- TEST_TASKS tasks , each one woken by a periodic Software
+ * 				  Timer (TIMER1 ISR => SCHED_setEvent()) and busy for its work
+ * 				  time (the interrupts are served during the work) , the idle
+ * 				  hook sleeps until the next interrupt (POWER_idle())
+ *
+ * 				- Order : a task never starts while a task with a higher
+ * 				  priority (or the same priority , added before) has events .
+ * 				  Events of a task set again before its run are one run
+ *
+ * 				- Accounting : runs , total / max run time and max latency
+ * 				  of SCHED_getStats() match the ones measured in this file
+ * 				  (micros() resolution) , the dispatch overhead is the
+ * 				  SCHED_runOnce() time out of the tasks
+ *
+ * 				- Nominal load , then the same tasks with TEST_OVERLOAD times
+ * 				  the work (CPU > 100 %) : a task with a period shorter than
+ * 				  the longest run of another task loses events (merged) , the
+ * 				  highest one still waits at most one run of another task
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "scheduler.h"
+#include "soft_timer.h"
+#include "power.h"
+#include <avr/interrupt.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+#define TEST_TASKS				4
+
+/* Virtual time of each load */
+#define TEST_RUN_MS				2000
+
+/* Work multiplier of the overload */
+#define TEST_OVERLOAD			2.5
+
+/* micros() resolution , per measure */
+#define TEST_US_TOLERANCE		2
+
+#define TEST_US_CYCLES			(F_CPU / 1000000UL)
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct
+{
+	const char *s_Name ;
+	uint8 s_Priority ;
+	uint16 s_PeriodMs ;
+	uint16 s_WorkUs ;
+}TEST_TaskConfigType;
+
+typedef struct
+{
+	uint8 s_Id ;
+	SoftTimer_Type s_Timer ;
+	uint64 s_Work ;
+
+	/* Events set (TIMER1 ISR) , set again before the run , pending since */
+	uint32 s_Posts ;
+	uint32 s_Merged ;
+	bool s_Pending ;
+	uint64 s_PostCycle ;
+
+	/* Measured by the test */
+	uint32 s_Runs ;
+	uint64 s_RunCycles ;
+	uint64 s_MaxRunCycles ;
+	uint64 s_MaxLatency ;
+}TEST_TaskType;
+
+typedef struct
+{
+	uint64 s_Cycles ;
+	uint64 s_Idle ;
+	uint64 s_Overhead ;
+	uint32 s_Dispatches ;
+	uint32 s_OrderErrors ;
+}TEST_LoadType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Two tasks with the same priority , the first one added runs first */
+static const TEST_TaskConfigType g_config[TEST_TASKS] =
+{
+	{"fast",   0,  2,  150},
+	{"medium", 1,  5,  400},
+	{"slow",   2, 10, 1500},
+	{"bulk",   2, 20, 3000},
+};
+
+static TEST_TaskType g_tasks[TEST_TASKS] ;
+static TEST_LoadType g_load ;
+
+/* Cycles of the last task run */
+static uint64 g_runCycles ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void TEST_tick0(void);
+static void TEST_tick1(void);
+static void TEST_tick2(void);
+static void TEST_tick3(void);
+static void TEST_post(uint8 index);
+static void TEST_task(uint8 index);
+static void Fast_task(uint8 events);
+static void Medium_task(uint8 events);
+static void Slow_task(uint8 events);
+static void Bulk_task(uint8 events);
+static void TEST_run(const char *name, double workScale);
+static void TEST_checkStats(const TEST_TaskType *task, const SCHED_StatsType *stats);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	TEST_begin("scheduler");
+
+	sei();
+	SoftTimer_init();
+	POWER_init();
+
+	TEST_run("nominal", 1.0);
+	TEST_run("overload", TEST_OVERLOAD);
+	return TEST_end();
+}
+
+/*
+ * Description: Call Backs of the Software Timers (TIMER1 ISR)
+ */
+static void TEST_tick0(void)
+{
+	TEST_post(0);
+}
+
+static void TEST_tick1(void)
+{
+	TEST_post(1);
+}
+
+static void TEST_tick2(void)
+{
+	TEST_post(2);
+}
+
+static void TEST_tick3(void)
+{
+	TEST_post(3);
+}
+
+/*
+ * Description: Function to wake a task , events set again before its run
+ * 				are merged in one run
+ */
+static void TEST_post(uint8 index)
+{
+	TEST_TaskType *task = &g_tasks[index] ;
+
+	task->s_Posts++ ;
+	if(task->s_Pending)
+	{
+		task->s_Merged++ ;
+	}
+	else
+	{
+		task->s_Pending = TRUE ;
+		task->s_PostCycle = HOST_cycles() ;
+	}
+	SCHED_setEvent(task->s_Id, 0x01);
+}
+
+/*
+ * Description: Synthetic task , checks the order then works s_Work cycles
+ * 				(the interrupts are served during the work)
+ */
+static void TEST_task(uint8 index)
+{
+	TEST_TaskType *task = &g_tasks[index] ;
+	uint64 start = HOST_cycles() ;
+	uint8 i;
+
+	/* Higher priority first , same priority in the order of SCHED_addTask() */
+	for(i = 0 ; i < TEST_TASKS ; i++)
+	{
+		if((i != index) && g_tasks[i].s_Pending && ((g_config[i].s_Priority < g_config[index].s_Priority) ||
+				((g_config[i].s_Priority == g_config[index].s_Priority) && (i < index))))
+			g_load.s_OrderErrors++ ;
+	}
+
+	if(start - task->s_PostCycle > task->s_MaxLatency)
+		task->s_MaxLatency = start - task->s_PostCycle ;
+	task->s_Pending = FALSE ;
+
+	HOST_delayCycles(task->s_Work);
+
+	g_runCycles = HOST_cycles() - start ;
+	task->s_Runs++ ;
+	task->s_RunCycles += g_runCycles ;
+	if(g_runCycles > task->s_MaxRunCycles)
+		task->s_MaxRunCycles = g_runCycles ;
+}
+
+static void Fast_task(uint8 events)
+{
+	TEST_task(0);
+}
+
+static void Medium_task(uint8 events)
+{
+	TEST_task(1);
+}
+
+static void Slow_task(uint8 events)
+{
+	TEST_task(2);
+}
+
+static void Bulk_task(uint8 events)
+{
+	TEST_task(3);
+}
+
+/*
+ * Description: Function to run the tasks for TEST_RUN_MS with their work
+ * 				times x workScale , then check and print the statistics
+ */
+static void TEST_run(const char *name, double workScale)
+{
+	static const SCHED_TaskFunction functions[TEST_TASKS] = { Fast_task, Medium_task, Slow_task, Bulk_task } ;
+	static void (*const ticks[TEST_TASKS])(void) = { TEST_tick0, TEST_tick1, TEST_tick2, TEST_tick3 } ;
+	SCHED_StatsType stats[TEST_TASKS] ;
+	uint64 start , before , end , maxOther = 0 ;
+	uint64 busy = 0 ;
+	uint8 i;
+
+	memset(g_tasks, 0, sizeof(g_tasks));
+	memset(&g_load, 0, sizeof(g_load));
+	SCHED_init();
+	SCHED_setIdleHook(POWER_idle);
+	for(i = 0 ; i < TEST_TASKS ; i++)
+	{
+		g_tasks[i].s_Id = SCHED_addTask(functions[i], g_config[i].s_Priority) ;
+		g_tasks[i].s_Work = (uint64)(g_config[i].s_WorkUs * workScale) * TEST_US_CYCLES ;
+		TEST_CHECK(g_tasks[i].s_Id == i);
+	}
+	for(i = 0 ; i < TEST_TASKS ; i++)
+	{
+		SoftTimer_start(&g_tasks[i].s_Timer, g_config[i].s_PeriodMs, g_config[i].s_PeriodMs, ticks[i]);
+	}
+
+	start = HOST_cycles() ;
+	end = start + (uint64)TEST_RUN_MS * (F_CPU / 1000UL) ;
+	while(HOST_cycles() < end)
+	{
+		before = HOST_cycles() ;
+		if(SCHED_runOnce())
+		{
+			g_load.s_Overhead += HOST_cycles() - before - g_runCycles ;
+			g_load.s_Dispatches++ ;
+		}
+		else
+		{
+			g_load.s_Idle += HOST_cycles() - before ;
+		}
+	}
+	g_load.s_Cycles = HOST_cycles() - start ;
+
+	/* Last events , the run is over */
+	for(i = 0 ; i < TEST_TASKS ; i++)
+	{
+		SoftTimer_stop(&g_tasks[i].s_Timer);
+	}
+	while(SCHED_isReady())
+	{
+		SCHED_runOnce();
+	}
+
+	TEST_CHECK(g_load.s_OrderErrors == 0);
+	for(i = 0 ; i < TEST_TASKS ; i++)
+	{
+		TEST_CHECK(SCHED_getStats(g_tasks[i].s_Id, &stats[i]));
+		TEST_checkStats(&g_tasks[i], &stats[i]);
+		busy += g_tasks[i].s_RunCycles ;
+		if((i != 0) && (g_tasks[i].s_MaxRunCycles > maxOther))
+			maxOther = g_tasks[i].s_MaxRunCycles ;
+	}
+
+	/* Run to completion : the highest task waits at most one run of another task */
+	TEST_CHECK(g_tasks[0].s_MaxLatency <= maxOther + g_load.s_Overhead / g_load.s_Dispatches
+			+ TEST_US_TOLERANCE * TEST_US_CYCLES);
+
+	/* Nominal : every event is served before the next one of the task */
+	if(workScale == 1.0)
+	{
+		for(i = 0 ; i < TEST_TASKS ; i++)
+		{
+			TEST_CHECK(g_tasks[i].s_Merged == 0);
+		}
+		TEST_CHECK(g_load.s_Idle > 0);
+	}
+	else
+	{
+		/* Period of the highest task < longest run of the others */
+		TEST_CHECK(g_tasks[0].s_Merged > 0);
+	}
+
+	printf("TEST: scheduler        %-8s CPU %5.1f %% , idle %5.1f %% , %u dispatches , overhead %.1f cycles / dispatch\n",
+			name, 100.0 * busy / g_load.s_Cycles, 100.0 * g_load.s_Idle / g_load.s_Cycles,
+			g_load.s_Dispatches, (double)g_load.s_Overhead / g_load.s_Dispatches);
+	for(i = 0 ; i < TEST_TASKS ; i++)
+	{
+		printf("TEST: scheduler        %-8s task %-6s prio %u every %2u ms : %4u runs , %3u merged ,"
+				" run mean %6.1f us max %5u us , latency max %5u us\n",
+				name, g_config[i].s_Name, g_config[i].s_Priority, g_config[i].s_PeriodMs, stats[i].s_Runs,
+				g_tasks[i].s_Merged, (double)stats[i].s_RunTime / ((stats[i].s_Runs > 0) ? stats[i].s_Runs : 1),
+				stats[i].s_MaxRunTime, stats[i].s_MaxLatency);
+	}
+}
+
+/*
+ * Description: The statistics of the scheduler are the measured ones ,
+ * 				one micros() step per measure
+ */
+static void TEST_checkStats(const TEST_TaskType *task, const SCHED_StatsType *stats)
+{
+	uint64 runTime = task->s_RunCycles / TEST_US_CYCLES ;
+	uint64 maxRun = task->s_MaxRunCycles / TEST_US_CYCLES ;
+	uint64 latency = task->s_MaxLatency / TEST_US_CYCLES ;
+
+	TEST_CHECK(task->s_Runs > 0);
+	TEST_CHECK(stats->s_Runs == task->s_Runs);
+	TEST_CHECK(task->s_Runs + task->s_Merged == task->s_Posts);
+	TEST_CHECK(stats->s_RunTime + (uint64)TEST_US_TOLERANCE * task->s_Runs >= runTime);
+	TEST_CHECK(stats->s_RunTime <= runTime + (uint64)TEST_US_TOLERANCE * task->s_Runs);
+	TEST_CHECK(stats->s_MaxRunTime + TEST_US_TOLERANCE >= maxRun);
+	TEST_CHECK(stats->s_MaxRunTime <= maxRun + TEST_US_TOLERANCE);
+	TEST_CHECK(stats->s_MaxLatency + TEST_US_TOLERANCE >= latency);
+	TEST_CHECK(stats->s_MaxLatency <= latency + TEST_US_TOLERANCE);
+}
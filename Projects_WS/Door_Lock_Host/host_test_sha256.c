@@ -0,0 +1,242 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test_sha256.c
+ * Description: Test of the SHA-256 Hash (sha256.c) and benchmark of a PIN
+ * 				check (PasswordMatch , USERS_find) against the 50 ms budget
+ *
+ * Notes:		- FIPS 180-4 test vectors , the same messages split in random
+ * 				  updates , SHA256_compare() at every difference position
+ *
+ * 				- The ATmega16 model has no cost for the computation (only
+ * 				  for the registers) , the PIN check is measured in SHA-256
+ * 				  compressions (from the context , padding of FIPS 180-4) and
+ * 				  the target time is compressions * TEST_BLOCK_CYCLES . The
+ * 				  time on the target is the PROF_ZONE_PASSWORD_MATCH zone
+ * 				  (make PROF=1 , PROF_STATS frame)
+ *
+ * 				- TEST_BLOCK_CYCLES : one compression is about 2,200 32-bit
+ * 				  operations (12 rotations per round) and 450 word moves ,
+ * 				  4 .. 20 AVR cycles each , 60,000 cycles is an upper figure
+ * 				  (~25 cycles per operation) , not a measurement
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "sha256.h"
+#include "door_lock_protocol.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* PIN check budget on the 8 MHz target */
+#define TEST_BUDGET_MS			50
+#define TEST_BUDGET_CYCLES		((uint32)TEST_BUDGET_MS * (F_CPU / 1000UL))
+
+/* AVR cycles of one compression (upper figure , see the notes) */
+#define TEST_BLOCK_CYCLES		60000UL
+
+/* PIN hashes timed on the host */
+#define TEST_HASHES				100000UL
+
+/* Random splits of every test vector */
+#define TEST_SPLITS				20
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct
+{
+	const char *s_Message ;
+	uint32 s_Repeat ;
+	const char *s_Digest ;
+}TEST_VectorType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* FIPS 180-4 (NIST CSRC examples) , message repeated s_Repeat times */
+static const TEST_VectorType g_vectors[] =
+{
+	{ "abc", 1,
+	  "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+	{ "", 1,
+	  "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+	{ "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1,
+	  "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+	{ "a", 1000000UL,
+	  "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" }
+};
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void TEST_vector(const TEST_VectorType *vector);
+static void TEST_compare(void);
+static uint8 TEST_compressions(uint16 saltLength, uint16 dataLength);
+static void TEST_benchmark(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	uint8 i;
+
+	TEST_begin("sha256");
+
+	for(i = 0 ; i < sizeof(g_vectors) / sizeof(g_vectors[0]) ; i++)
+	{
+		TEST_vector(&g_vectors[i]);
+	}
+	TEST_compare();
+	TEST_benchmark();
+
+	return TEST_end();
+}
+
+/*
+ * Description: Function to hash a test vector in one update , in random
+ * 				splits and compare the digest
+ */
+static void TEST_vector(const TEST_VectorType *vector)
+{
+	SHA256_ContextType context ;
+	uint8 digest[SHA256_DIGEST_SIZE] ;
+	char text[2 * SHA256_DIGEST_SIZE + 1] ;
+	uint16 length = (uint16)strlen(vector->s_Message) ;
+	uint16 offset , part ;
+	uint32 repeat ;
+	uint8 split , i ;
+
+	for(split = 0 ; split <= TEST_SPLITS ; split++)
+	{
+		SHA256_init(&context);
+		for(repeat = 0 ; repeat < vector->s_Repeat ; repeat++)
+		{
+			/* split 0 => one update per message */
+			for(offset = 0 ; offset < length ; offset += part)
+			{
+				part = (split == 0) ? length : (uint16)(1 + TEST_random() % length) ;
+				if(part > length - offset)
+					part = length - offset ;
+				SHA256_update(&context, (const uint8 *)vector->s_Message + offset, part);
+			}
+		}
+		SHA256_final(&context, digest, SHA256_DIGEST_SIZE);
+
+		for(i = 0 ; i < SHA256_DIGEST_SIZE ; i++)
+		{
+			sprintf(&text[2 * i], "%02x", digest[i]);
+		}
+		TEST_CHECK(strcmp(text, vector->s_Digest) == 0);
+
+		/* Long message is hashed once */
+		if(vector->s_Repeat > 1)
+			break ;
+	}
+}
+
+/*
+ * Description: Equal buffers are equal , a difference in any byte and any
+ * 				bit is found
+ */
+static void TEST_compare(void)
+{
+	uint8 a[PASS_HASH_SIZE] ;
+	uint8 b[PASS_HASH_SIZE] ;
+	uint8 i , bit ;
+
+	for(i = 0 ; i < PASS_HASH_SIZE ; i++)
+	{
+		a[i] = b[i] = (uint8)TEST_random() ;
+	}
+	TEST_CHECK(SHA256_compare(a, b, PASS_HASH_SIZE));
+
+	for(i = 0 ; i < PASS_HASH_SIZE ; i++)
+	{
+		for(bit = 0 ; bit < 8 ; bit++)
+		{
+			b[i] ^= (uint8)(1 << bit) ;
+			TEST_CHECK(!SHA256_compare(a, b, PASS_HASH_SIZE));
+			b[i] ^= (uint8)(1 << bit) ;
+		}
+	}
+}
+
+/*
+ * Description: Function returns the compressions of a salted hash , the
+ * 				full blocks of the updates and one or two blocks of the
+ * 				padding (0x80 + 64-bit length) in SHA256_final()
+ */
+static uint8 TEST_compressions(uint16 saltLength, uint16 dataLength)
+{
+	SHA256_ContextType context ;
+	uint8 salt[SHA256_BLOCK_SIZE] = {0} ;
+	uint8 data[SHA256_BLOCK_SIZE] = {0} ;
+
+	SHA256_init(&context);
+	SHA256_update(&context, salt, saltLength);
+	SHA256_update(&context, data, dataLength);
+
+	return (uint8)(((context.s_Length - context.s_Fill) / SHA256_BLOCK_SIZE) +
+			((context.s_Fill + 1 + 8 > SHA256_BLOCK_SIZE) ? 2 : 1)) ;
+}
+
+/*
+ * Description: Function to time the PIN hash on the host and check the
+ * 				target estimate against the budget
+ */
+static void TEST_benchmark(void)
+{
+	uint8 salt[PASS_SALT_SIZE] ;
+	uint8 pin[PASS_SIZE] ;
+	uint8 hash[PASS_HASH_SIZE] ;
+	uint8 blocks = TEST_compressions(PASS_SALT_SIZE, PASS_SIZE) ;
+	uint32 cycles = blocks * TEST_BLOCK_CYCLES ;
+	struct timespec start , end ;
+	double hostNs ;
+	uint32 i ;
+	uint8 j ;
+
+	/* 56 bytes or more => the length goes in a second block */
+	TEST_CHECK(TEST_compressions(PASS_SALT_SIZE, SHA256_BLOCK_SIZE - 8 - PASS_SALT_SIZE) == 2);
+
+	/* PasswordMatch / USERS_find : one compression per PIN */
+	TEST_CHECK(blocks == 1);
+	TEST_CHECK(cycles <= TEST_BUDGET_CYCLES);
+
+	for(j = 0 ; j < PASS_SALT_SIZE ; j++)
+	{
+		salt[j] = (uint8)TEST_random() ;
+	}
+	for(j = 0 ; j < PASS_SIZE ; j++)
+	{
+		pin[j] = (uint8)(TEST_random() % 10) ;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(i = 0 ; i < TEST_HASHES ; i++)
+	{
+		SHA256_saltedHash(salt, PASS_SALT_SIZE, pin, PASS_SIZE, hash, PASS_HASH_SIZE);
+		pin[i % PASS_SIZE] = hash[0] % 10 ;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	hostNs = ((double)(end.tv_sec - start.tv_sec) * 1e9 +
+			(double)(end.tv_nsec - start.tv_nsec)) / TEST_HASHES ;
+
+	printf("TEST: sha256           PIN check %u compression(s) , target <= %u cycles"
+			" (%.1f ms @ %lu MHz , budget %u ms) , host %.0f ns\n",
+			blocks, cycles, (double)cycles * 1000.0 / F_CPU, F_CPU / 1000000UL,
+			TEST_BUDGET_MS, hostNs);
+}
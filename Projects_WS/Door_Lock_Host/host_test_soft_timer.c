@@ -0,0 +1,200 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test_soft_timer.c
+ * Description: Test of the Software Timers Service (soft_timer.c) with
+ * 				thousands of timers on the TIMER1 model
+ *
+ * Notes:		- TEST_TIMERS one-shot and periodic timers , delays and periods
+ * 				  much longer than the wheel (many wheel rounds per slot) ,
+ * 				  some of them are stopped or restarted every ms
+ *
+ * 				- After every tick each timer is compared with its expected
+ * 				  expiry : a one-shot timer fires exactly at its expiry tick ,
+ * 				  a periodic timer moves by its period at every expiry , a
+ * 				  timer never fires before its expiry and never stays
+ * 				  running after it (late)
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "soft_timer.h"
+#include <avr/interrupt.h>
+#include <stdio.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+#define TEST_TIMERS				4096
+
+/* Virtual time of the test */
+#define TEST_RUN_MS				6000
+
+/* One timer in TEST_PERIODIC_RATIO is periodic */
+#define TEST_PERIODIC_RATIO		4
+
+#define TEST_MAX_DELAY_MS		3000
+#define TEST_MAX_PERIOD_MS		500
+
+/* Timers stopped / restarted every ms */
+#define TEST_CHANGES_PER_MS		8
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static SoftTimer_Type g_timers[TEST_TIMERS] ;
+
+/* Expected state of each timer */
+static bool g_running[TEST_TIMERS] ;
+static uint32 g_expiry[TEST_TIMERS] ;
+static uint32 g_period[TEST_TIMERS] ;
+
+/* Call Backs and expiries seen by the test */
+static uint32 g_fired = 0 ;
+static uint32 g_expected = 0 ;
+static uint32 g_lastFiredTick = 0 ;
+static bool g_orderError = FALSE ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void TEST_callBack(void);
+static void TEST_start(uint16 index);
+static void TEST_change(void);
+static void TEST_checkTick(uint32 now);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	uint32 now ;
+	uint16 i;
+
+	TEST_begin("soft_timer");
+
+	SoftTimer_init();
+	sei();
+
+	for(i = 0 ; i < TEST_TIMERS ; i++)
+	{
+		TEST_start(i);
+	}
+
+	for(now = 1 ; now <= TEST_RUN_MS ; now++)
+	{
+		/* One tick , TIMER1 Compare Match ISR */
+		HOST_delayCycles(SOFT_TIMER_TICK_CYCLES);
+		TEST_CHECK(millis() == now);
+
+		TEST_checkTick(now);
+		TEST_change();
+	}
+
+	/* Ticks are served in order , one call back per expiry */
+	TEST_CHECK(!g_orderError);
+	TEST_CHECK(g_fired == g_expected);
+
+	printf("TEST: soft_timer       %u timers , %u expiries in %u ms (%.1f per tick)\n",
+			TEST_TIMERS, g_fired, TEST_RUN_MS, (double)g_fired / TEST_RUN_MS);
+	return TEST_end();
+}
+
+/*
+ * Description: Call Back of all timers (TIMER1 ISR)
+ */
+static void TEST_callBack(void)
+{
+	uint32 now = millis() ;
+
+	if(now < g_lastFiredTick)
+		g_orderError = TRUE ;
+	g_lastFiredTick = now ;
+	g_fired++ ;
+}
+
+/*
+ * Description: Function to start a timer with a random delay (and period)
+ */
+static void TEST_start(uint16 index)
+{
+	uint32 delay = 1 + (TEST_random() % TEST_MAX_DELAY_MS) ;
+	uint32 period = 0 ;
+
+	if((TEST_random() % TEST_PERIODIC_RATIO) == 0)
+	{
+		period = 1 + (TEST_random() % TEST_MAX_PERIOD_MS) ;
+		delay = 1 + (delay % TEST_MAX_PERIOD_MS) ;
+	}
+
+	SoftTimer_start(&g_timers[index], delay, period, TEST_callBack);
+	g_running[index] = TRUE ;
+	g_expiry[index] = millis() + delay ;
+	g_period[index] = period ;
+}
+
+/*
+ * Description: Function to stop or restart random timers (from the main
+ * 				loop like a task of the firmware)
+ */
+static void TEST_change(void)
+{
+	uint16 index ;
+	uint8 i;
+
+	for(i = 0 ; i < TEST_CHANGES_PER_MS ; i++)
+	{
+		index = (uint16)(TEST_random() % TEST_TIMERS) ;
+		if(TEST_random() & 1)
+		{
+			SoftTimer_stop(&g_timers[index]);
+			g_running[index] = FALSE ;
+			TEST_CHECK(!SoftTimer_isRunning(&g_timers[index]));
+		}
+		else
+		{
+			TEST_start(index);
+		}
+	}
+}
+
+/*
+ * Description: Function to compare every timer with its expected state
+ * 				after the tick now
+ */
+static void TEST_checkTick(uint32 now)
+{
+	uint16 i;
+
+	for(i = 0 ; i < TEST_TIMERS ; i++)
+	{
+		if(!g_running[i])
+		{
+			TEST_CHECK(!SoftTimer_isRunning(&g_timers[i]));
+			continue;
+		}
+
+		if(g_expiry[i] == now)
+		{
+			/* Expired at this tick => fired once */
+			g_expected++ ;
+			if(g_period[i] == 0)
+			{
+				g_running[i] = FALSE ;
+				TEST_CHECK(!SoftTimer_isRunning(&g_timers[i]));
+				continue;
+			}
+			g_expiry[i] += g_period[i] ;
+		}
+
+		/* Running with the expected expiry , not fired early or late */
+		TEST_CHECK(SoftTimer_isRunning(&g_timers[i]));
+		TEST_CHECK(g_timers[i].s_expiry == g_expiry[i]);
+	}
+}
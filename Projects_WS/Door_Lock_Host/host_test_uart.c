@@ -0,0 +1,270 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test_uart.c
+ * Description: Throughput and latency benchmark of the UART driver (uart.c)
+ * 				RX / TX Ring Buffers on the USART model at BR115200
+ *
+ * Notes:		- TX : the main loop queues TEST_BYTES bytes by UART_write()
+ * 				  between work slices , the UDRE ISR keeps the shift register
+ * 				  busy => the line rate , the CPU left to the main loop is
+ * 				  compared with the blocking UART_sendByte() (no DRE Interrupt)
+ *
+ * 				- RX : TEST_BYTES bytes back to back at the line rate , the
+ * 				  main loop reads them by UART_read() between work slices
+ * 				  (g_rxWorkUs) . Every byte is read in order , no drop while
+ * 				  the slice is shorter than the RX Ring Buffer time , the
+ * 				  latency is from the stop bit of a byte to its UART_read()
+ *
+ * 				- A slice longer than the RX Ring Buffer time drops bytes ,
+ * 				  they are counted by UART_getRxDropCount()
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "uart.h"
+#include <avr/interrupt.h>
+#include <stdio.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+#define TEST_BYTES				4096
+
+/* Main loop work slice between two UART_write() / UART_read() rounds */
+#define TEST_US_CYCLES			(F_CPU / 1000000UL)
+#define TEST_TX_WORK_US			500
+
+/* Bytes queued ahead in the USART model (HOST_RX_QUEUE_SIZE = 64) */
+#define TEST_RX_AHEAD			48
+
+/* Throughput allowed below the line rate */
+#define TEST_MIN_LINE_PCT		99.0
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint32 s_Bytes ;
+	uint32 s_Errors ;
+	uint64 s_First ;
+	uint64 s_Last ;
+}TEST_TxType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static uint8 g_data[TEST_BYTES] ;
+
+/* Bytes seen on the TX line (TX Hook) */
+static TEST_TxType g_tx ;
+
+/* RX work slices , the last one is longer than the RX Ring Buffer time */
+static const uint32 g_rxWorkUs[] = { 100, 1000, 2000, 4000 } ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void TEST_init(bool buffered);
+static void TEST_txHook(uint8 data, uint64 cycle);
+static void TEST_tx(bool buffered);
+static void TEST_rx(uint32 workUs);
+static double TEST_lineRate(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	uint16 i;
+
+	TEST_begin("uart");
+
+	for(i = 0 ; i < TEST_BYTES ; i++)
+	{
+		g_data[i] = (uint8)TEST_random() ;
+	}
+	HOST_uartSetTxHook(TEST_txHook);
+	sei();
+
+	TEST_init(TRUE);
+	printf("TEST: uart             BR115200 => UBRR %u U2X , %.0f baud (%+.1f %%) , %.1f us / byte\n",
+			HOST_peek(0x09), TEST_lineRate() * 10.0, (TEST_lineRate() * 10.0 / 115200.0 - 1.0) * 100.0,
+			(double)HOST_uartFrameCycles() / TEST_US_CYCLES);
+
+	TEST_tx(TRUE);
+	TEST_tx(FALSE);
+
+	TEST_init(TRUE);
+	for(i = 0 ; i < sizeof(g_rxWorkUs) / sizeof(g_rxWorkUs[0]) ; i++)
+	{
+		TEST_rx(g_rxWorkUs[i]);
+	}
+	return TEST_end();
+}
+
+/*
+ * Description: Function to configure the UART like the ECUs , RX Interrupt
+ * 				always , DRE Interrupt (TX Ring Buffer) if buffered
+ */
+static void TEST_init(bool buffered)
+{
+	UART_ConfigType config = {.s_RxInterruptEnable = ENABLE_INT ,
+			.s_DataRegEmptyInterruptEnable = buffered ? ENABLE_INT : DISABLE_INT ,
+			.s_BaudRate = BR115200 , .s_NULL_Terminator = '#' };
+
+	UART_init(&config);
+}
+
+/*
+ * Description: TX Hook , the bytes must leave in the order they were queued
+ */
+static void TEST_txHook(uint8 data, uint64 cycle)
+{
+	if(g_tx.s_Bytes == 0)
+		g_tx.s_First = cycle - HOST_uartFrameCycles() ;
+	if((g_tx.s_Bytes >= TEST_BYTES) || (data != g_data[g_tx.s_Bytes]))
+		g_tx.s_Errors++ ;
+	g_tx.s_Bytes++ ;
+	g_tx.s_Last = cycle ;
+}
+
+/*
+ * Description: Function to send TEST_BYTES bytes , buffered => UART_write()
+ * 				between work slices , else UART_sendByte() (busy wait)
+ */
+static void TEST_tx(bool buffered)
+{
+	HOST_StatsType before , after ;
+	uint64 work = 0 ;
+	uint64 elapsed ;
+	uint32 sent = 0 ;
+	double rate ;
+
+	TEST_init(buffered);
+	g_tx.s_Bytes = 0 ;
+	g_tx.s_Errors = 0 ;
+	HOST_getStats(&before);
+
+	while(sent < TEST_BYTES)
+	{
+		if(buffered)
+		{
+			while((sent < TEST_BYTES) && UART_write(g_data[sent]))
+			{
+				sent++ ;
+			}
+			HOST_delayCycles((uint64)TEST_TX_WORK_US * TEST_US_CYCLES);
+			work += (uint64)TEST_TX_WORK_US * TEST_US_CYCLES ;
+		}
+		else
+		{
+			UART_sendByte(g_data[sent++]);
+		}
+	}
+	while(g_tx.s_Bytes < TEST_BYTES)
+	{
+		HOST_delayCycles(HOST_uartFrameCycles());
+	}
+	HOST_getStats(&after);
+
+	elapsed = g_tx.s_Last - g_tx.s_First ;
+	rate = (double)g_tx.s_Bytes * F_CPU / (double)elapsed ;
+	TEST_CHECK(g_tx.s_Bytes == TEST_BYTES);
+	TEST_CHECK(g_tx.s_Errors == 0);
+	TEST_CHECK(rate >= TEST_lineRate() * TEST_MIN_LINE_PCT / 100.0);
+
+	/* Work slices after the last byte queued aren't in the transfer ,
+	 * the ISRs served in the slices aren't main loop work */
+	if(work > elapsed)
+		work = elapsed ;
+	work -= after.s_IsrCycles - before.s_IsrCycles ;
+	printf("TEST: uart             TX %-9s %5u bytes %8.0f bytes/s (%5.1f %% line) , ISRs %5.1f %% CPU , main loop %5.1f %% CPU\n",
+			buffered ? "ring" : "blocking", g_tx.s_Bytes, rate, rate * 100.0 / TEST_lineRate(),
+			(double)(after.s_IsrCycles - before.s_IsrCycles) * 100.0 / (double)elapsed,
+			(double)work * 100.0 / (double)elapsed);
+}
+
+/*
+ * Description: Function to receive TEST_BYTES bytes back to back , the main
+ * 				loop reads them every workUs
+ */
+static void TEST_rx(uint32 workUs)
+{
+	HOST_StatsType before , after ;
+	uint32 frame = HOST_uartFrameCycles() ;
+	uint64 start = HOST_cycles() ;
+	uint64 latency , maxLatency = 0 , sumLatency = 0 ;
+	uint32 fed = 0 , received = 0 , errors = 0 ;
+	uint16 drops = UART_getRxDropCount() ;
+	uint8 data ;
+	bool fits = ((uint64)workUs * TEST_US_CYCLES < (uint64)UART_RX_BUFFER_SIZE * frame) ;
+
+	HOST_getStats(&before);
+	while((received < TEST_BYTES) &&
+			(HOST_cycles() - start < (uint64)(TEST_BYTES + TEST_RX_AHEAD) * frame + (uint64)workUs * TEST_US_CYCLES))
+	{
+		/* Line back to back , byte n ends at start + (n + 1) frames */
+		while((fed < TEST_BYTES) && (fed < (HOST_cycles() - start) / frame + TEST_RX_AHEAD))
+		{
+			HOST_uartReceiveAt(g_data[fed], start + (uint64)(fed + 1) * frame);
+			fed++ ;
+		}
+
+		while(UART_read(&data))
+		{
+			/* In order , the dropped bytes are skipped */
+			while((received < TEST_BYTES) && (data != g_data[received]) && !fits)
+			{
+				received++ ;
+			}
+			if((received >= TEST_BYTES) || (data != g_data[received]))
+				errors++ ;
+
+			latency = HOST_cycles() - (start + (uint64)(received + 1) * frame) ;
+			sumLatency += latency ;
+			if(latency > maxLatency)
+				maxLatency = latency ;
+			received++ ;
+		}
+		HOST_delayCycles((uint64)workUs * TEST_US_CYCLES);
+	}
+	HOST_getStats(&after);
+	drops = (uint16)(UART_getRxDropCount() - drops) ;
+
+	if(fits)
+	{
+		TEST_CHECK(received == TEST_BYTES);
+		TEST_CHECK(errors == 0);
+		TEST_CHECK(drops == 0);
+		TEST_CHECK(after.s_UartOverruns == before.s_UartOverruns);
+		TEST_CHECK(maxLatency <= (uint64)workUs * TEST_US_CYCLES + frame);
+	}
+	else
+	{
+		/* Slice longer than the RX Ring Buffer => bytes dropped and counted */
+		TEST_CHECK(drops > 0);
+		TEST_CHECK(errors == 0);
+	}
+
+	printf("TEST: uart             RX work %4u us : %5u bytes , %4u drops , %u overruns , latency mean %7.1f us max %7.1f us\n",
+			workUs, TEST_BYTES - drops, drops, after.s_UartOverruns - before.s_UartOverruns,
+			(double)sumLatency / TEST_US_CYCLES / ((received > 0) ? received : 1),
+			(double)maxLatency / TEST_US_CYCLES);
+}
+
+/*
+ * Description: Function returns the line rate in bytes / s
+ */
+static double TEST_lineRate(void)
+{
+	return (double)F_CPU / HOST_uartFrameCycles() ;
+}
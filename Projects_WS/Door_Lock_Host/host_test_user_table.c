@@ -0,0 +1,293 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - Unit Tests
+ * File Name: 	host_test_user_table.c
+ * Description: Test and lookup benchmark of the Users PINs Table
+ * 				(user_table.c) on the 24C16 model
+ *
+ * Notes:		- Tables of 10 , 100 and USERS_CAPACITY users (the 24C16 has
+ * 				  room for USERS_CAPACITY entries only) , every user is found
+ * 				  after a reboot , random PINs that aren't users aren't found
+ *
+ * 				- A lookup is measured in EEPROM page reads , I2C bytes and
+ * 				  virtual time (the SHA-256 isn't in the virtual time) , a
+ * 				  miss walks the probe chain to the first Empty entry : in a
+ * 				  full table it reads every page
+ *
+ * 				- Half of the users are revoked : the probe chains go over
+ * 				  the tombstones (the other users are still found) , the new
+ * 				  users take the tombstones (a full table stays full)
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "user_table.h"
+#include "eeprom_cache.h"
+#include <avr/interrupt.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros(Private)                           *
+ *******************************************************************************/
+
+/* Lookups of PINs that aren't users per table */
+#define TEST_MISSES				50
+
+/* Mean page reads of a lookup allowed below 60 % load (10 and 100 users) */
+#define TEST_MAX_HIT_READS		1.5
+#define TEST_MAX_MISS_READS		2.5
+
+/* A lookup reads every page once at most (+ 1 if it wraps in a page) */
+#define TEST_TABLE_PAGES		((USERS_CAPACITY * USERS_ENTRY_SIZE + TEST_EEPROM_PAGE_SIZE - 1) / TEST_EEPROM_PAGE_SIZE)
+
+/* Virtual time step while a write is running */
+#define TEST_STEP_CYCLES		((uint32)(F_CPU / 10000UL))
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint32 s_Lookups ;
+	uint32 s_Reads ;
+	uint32 s_MaxReads ;
+	uint32 s_Bytes ;
+	uint64 s_Cycles ;
+}TEST_CostType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* PINs of the users of the table */
+static uint8 g_pins[USERS_CAPACITY][PASS_SIZE] ;
+
+/* Table sizes of the test */
+static const uint16 g_sizes[] = { 10, 100, USERS_CAPACITY } ;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void TEST_table(uint16 users);
+static void TEST_reboot(void);
+static void TEST_newPin(uint8 *pin, uint16 users);
+static TWI_Status TEST_wait(uint8 status);
+static bool TEST_find(const uint8 *pin, TEST_CostType *cost);
+static uint16 TEST_activeEntries(void);
+static void TEST_print(uint16 users, const char *name, const TEST_CostType *cost);
+static double TEST_meanReads(const TEST_CostType *cost);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	uint8 i;
+
+	TEST_begin("user_table");
+
+	TEST_eepromAttach();
+	sei();
+
+	for(i = 0 ; i < sizeof(g_sizes) / sizeof(g_sizes[0]) ; i++)
+	{
+		TEST_table(g_sizes[i]);
+	}
+	return TEST_end();
+}
+
+/*
+ * Description: Function to fill a table with users , measure the lookups ,
+ * 				revoke half of the users and add new ones
+ */
+static void TEST_table(uint16 users)
+{
+	TEST_CostType hit = {0} , miss = {0} , tombstone = {0} ;
+	uint8 salt[PASS_SALT_SIZE] ;
+	uint8 pin[PASS_SIZE] ;
+	uint16 i ;
+
+	memset(g_testEeprom.s_Memory, 0xFF, TEST_EEPROM_SIZE);
+	TEST_reboot();
+	TEST_CHECK(!USERS_isSalted());
+
+	for(i = 0 ; i < PASS_SALT_SIZE ; i++)
+	{
+		salt[i] = (uint8)TEST_random() ;
+	}
+	TEST_CHECK(USERS_setSalt(salt) == SUCCESS);
+
+	for(i = 0 ; i < users ; i++)
+	{
+		TEST_newPin(g_pins[i], i);
+		TEST_CHECK(TEST_wait(USERS_add(g_pins[i], NULL_PTR)) == TWI_SUCCESS);
+	}
+	TEST_CHECK(USERS_add(g_pins[0], NULL_PTR) == ERROR);
+	if(users == USERS_CAPACITY)
+	{
+		/* Full table */
+		TEST_newPin(pin, users);
+		TEST_CHECK(USERS_add(pin, NULL_PTR) == ERROR);
+	}
+
+	/* Users are in the EEPROM after a reboot */
+	TEST_reboot();
+	TEST_CHECK(USERS_isSalted());
+	for(i = 0 ; i < users ; i++)
+	{
+		TEST_CHECK(TEST_find(g_pins[i], &hit));
+	}
+	for(i = 0 ; i < TEST_MISSES ; i++)
+	{
+		TEST_newPin(pin, users);
+		TEST_CHECK(!TEST_find(pin, &miss));
+	}
+
+	/* Revoke the odd users , twice is an error */
+	for(i = 1 ; i < users ; i += 2)
+	{
+		TEST_CHECK(TEST_wait(USERS_revoke(g_pins[i], NULL_PTR)) == TWI_SUCCESS);
+		TEST_CHECK(USERS_revoke(g_pins[i], NULL_PTR) == ERROR);
+	}
+	for(i = 0 ; i < users ; i++)
+	{
+		TEST_CHECK(TEST_find(g_pins[i], ((i % 2) == 0) ? &tombstone : NULL_PTR) == ((i % 2) == 0));
+	}
+
+	/* New users in place of the odd ones (the first one comes back) */
+	for(i = 1 ; i < users ; i += 2)
+	{
+		if(i != 1)
+		{
+			TEST_newPin(pin, users);
+			memcpy(g_pins[i], pin, PASS_SIZE);
+		}
+		TEST_CHECK(TEST_wait(USERS_add(g_pins[i], NULL_PTR)) == TWI_SUCCESS);
+	}
+	for(i = 0 ; i < users ; i++)
+	{
+		TEST_CHECK(TEST_find(g_pins[i], NULL_PTR));
+	}
+	TEST_CHECK(TEST_activeEntries() == users);
+
+	TEST_print(users, "hit", &hit);
+	TEST_print(users, "miss", &miss);
+	TEST_print(users, "hit (revoked)", &tombstone);
+	TEST_CHECK(miss.s_MaxReads <= TEST_TABLE_PAGES + 1);
+	if(users * 10 < USERS_CAPACITY * 6)
+	{
+		TEST_CHECK(TEST_meanReads(&hit) <= TEST_MAX_HIT_READS);
+		TEST_CHECK(TEST_meanReads(&miss) <= TEST_MAX_MISS_READS);
+	}
+}
+
+/*
+ * Description: Function to restart the table like the Control ECU boot
+ */
+static void TEST_reboot(void)
+{
+	EEPROM_init();
+	TEST_CHECK(CACHE_init() == SUCCESS);
+	USERS_init();
+}
+
+/*
+ * Description: Function to make a random PIN that isn't one of the first
+ * 				users PINs of g_pins
+ */
+static void TEST_newPin(uint8 *pin, uint16 users)
+{
+	uint16 i ;
+	uint8 digit ;
+
+	do
+	{
+		for(digit = 0 ; digit < PASS_SIZE ; digit++)
+		{
+			pin[digit] = (uint8)(TEST_random() % 10) ;
+		}
+		for(i = 0 ; (i < users) && (memcmp(pin, g_pins[i], PASS_SIZE) != 0) ; i++)
+		{
+		}
+	}while(i < users);
+}
+
+/*
+ * Description: Function to wait the end of a table write
+ */
+static TWI_Status TEST_wait(uint8 status)
+{
+	if(status != SUCCESS)
+		return TWI_ERROR ;
+
+	while(CACHE_getWriteStatus() == TWI_PENDING)
+	{
+		HOST_delayCycles(TEST_STEP_CYCLES);
+	}
+	return CACHE_getWriteStatus() ;
+}
+
+/*
+ * Description: Function to look a PIN up , the cost is added to cost
+ * 				(NULL_PTR => not measured)
+ */
+static bool TEST_find(const uint8 *pin, TEST_CostType *cost)
+{
+	uint32 reads = g_testEeprom.s_Reads ;
+	uint32 bytes = g_testEeprom.s_ReadBytes + g_testEeprom.s_WriteBytes ;
+	uint64 start = HOST_cycles() ;
+	bool found = USERS_find(pin) ;
+
+	if(cost != NULL_PTR)
+	{
+		reads = g_testEeprom.s_Reads - reads ;
+		cost->s_Lookups++ ;
+		cost->s_Reads += reads ;
+		if(reads > cost->s_MaxReads)
+			cost->s_MaxReads = reads ;
+		cost->s_Bytes += g_testEeprom.s_ReadBytes + g_testEeprom.s_WriteBytes - bytes ;
+		cost->s_Cycles += HOST_cycles() - start ;
+	}
+	return found ;
+}
+
+/*
+ * Description: Function returns the number of active entries in the EEPROM
+ */
+static uint16 TEST_activeEntries(void)
+{
+	uint16 active = 0 ;
+	uint16 i ;
+
+	for(i = 0 ; i < USERS_CAPACITY ; i++)
+	{
+		if(g_testEeprom.s_Memory[USERS_ADDRESS + i * USERS_ENTRY_SIZE] == USERS_ACTIVE)
+			active++ ;
+	}
+	return active ;
+}
+
+static double TEST_meanReads(const TEST_CostType *cost)
+{
+	return (cost->s_Lookups == 0) ? 0.0 : (double)cost->s_Reads / cost->s_Lookups ;
+}
+
+/*
+ * Description: Function to print the mean cost of a lookup
+ */
+static void TEST_print(uint16 users, const char *name, const TEST_CostType *cost)
+{
+	if(cost->s_Lookups == 0)
+		return ;
+
+	printf("TEST: user_table       %3u users , %-13s %5.2f page reads (max %3u) %6.1f I2C bytes %7.1f us\n",
+			users, name, TEST_meanReads(cost), cost->s_MaxReads,
+			(double)cost->s_Bytes / cost->s_Lookups,
+			(double)cost->s_Cycles * 1000000.0 / F_CPU / cost->s_Lookups);
+}
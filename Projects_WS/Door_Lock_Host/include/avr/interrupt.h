@@ -0,0 +1,32 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - ATmega16 Model
+ * File Name: 	avr/interrupt.h
+ * Description: ISR() , sei() and cli() for the Linux build (HOST_BUILD)
+ *
+ * Notes:		- An ISR is a plain function __vector_N , host_mcu.c calls it
+ * 				  when its flag and enable bit are set and the I-bit is set
+ *
+ * 				- sei() only sets the I-bit , the pending interrupts are served
+ * 				  at the next register access / sleep / delay (as on AVR the
+ * 				  instruction after SEI is executed first)
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef HOST_AVR_INTERRUPT_H_
+#define HOST_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+#define ISR_BLOCK
+#define ISR_NOBLOCK
+#define ISR_NAKED
+
+#define ISR(vector, ...) 	void vector(void); void vector(void)
+
+#define sei()				(HOST_sreg |= (uint8_t)(1 << SREG_I))
+#define cli()				(HOST_sreg &= (uint8_t)~(1 << SREG_I))
+
+#endif /* HOST_AVR_INTERRUPT_H_ */
@@ -0,0 +1,32 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - ATmega16 Model
+ * File Name: 	avr/pgmspace.h
+ * Description: Program Memory Macros for the Linux build (HOST_BUILD)
+ *
+ * Notes:		- One address space on the host , PROGMEM data is a plain
+ * 				  const object and pgm_read_*() is a plain read
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef HOST_AVR_PGMSPACE_H_
+#define HOST_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P					const char *
+#define PSTR(s)					(s)
+
+#define pgm_read_byte(addr)		(*(const uint8_t *)(addr))
+#define pgm_read_word(addr)		(*(const uint16_t *)(addr))
+#define pgm_read_dword(addr)	(*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr)		(*(void * const *)(addr))
+
+#define memcpy_P				memcpy
+#define strlen_P				strlen
+
+#endif /* HOST_AVR_PGMSPACE_H_ */
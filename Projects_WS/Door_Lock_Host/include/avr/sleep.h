@@ -0,0 +1,32 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - ATmega16 Model
+ * File Name: 	avr/sleep.h
+ * Description: Sleep Mode Macros for the Linux build (HOST_BUILD)
+ *
+ * Notes:		- sleep_cpu() jumps the virtual clock to the next
+ * 				  timer / USART / TWI event and serves its interrupt
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef HOST_AVR_SLEEP_H_
+#define HOST_AVR_SLEEP_H_
+
+#include <avr/io.h>
+
+#define SLEEP_MODE_IDLE			0
+#define SLEEP_MODE_ADC			1
+#define SLEEP_MODE_PWR_DOWN		2
+#define SLEEP_MODE_PWR_SAVE		3
+#define SLEEP_MODE_STANDBY		6
+
+void HOST_sleep(void);
+
+#define set_sleep_mode(mode)	((void)(mode))
+#define sleep_enable()			((void)0)
+#define sleep_disable()			((void)0)
+#define sleep_cpu()				HOST_sleep()
+
+#endif /* HOST_AVR_SLEEP_H_ */
@@ -0,0 +1,29 @@
+ /******************************************************************************
+ *
+ * Module: 		Host - ATmega16 Model
+ * File Name: 	util/delay.h
+ * Description: Busy-wait delays for the Linux build (HOST_BUILD)
+ *
+ * Notes:		- The delay advances the virtual clock by the same number of
+ * 				  CPU cycles as the avr-libc loop , the interrupts in the
+ * 				  delay are served (as on AVR)
+ *
+ * Author: 		Mohsen Moawad
+ *
+ *******************************************************************************/
+
+#ifndef HOST_UTIL_DELAY_H_
+#define HOST_UTIL_DELAY_H_
+
+#include <stdint.h>
+
+#ifndef F_CPU
+#error "F_CPU must be defined before util/delay.h"
+#endif
+
+void HOST_delayCycles(uint64_t cycles);
+
+#define _delay_ms(ms)	HOST_delayCycles((uint64_t)((double)(ms) * ((double)(F_CPU) / 1000.0)))
+#define _delay_us(us)	HOST_delayCycles((uint64_t)((double)(us) * ((double)(F_CPU) / 1000000.0)))
+
+#endif /* HOST_UTIL_DELAY_H_ */
@@ -0,0 +1,25 @@
+#!/bin/sh
+################################################################################
+# Print .text/.data/.bss sizes of a firmware image compared with a reference
+# image , both taken from the linker .map files.
+#
+# Usage: size_report.sh <reference.map> <current.map>
+################################################################################
+
+REF_MAP=$1
+CUR_MAP=$2
+
+# Size (hex) of an output section from the "Linker script and memory map" part
+section_size()
+{
+	tr -d '\r' < "$1" | awk -v sec="$2" '$1 == sec && $3 ~ /^0x/ { print $3 ; exit }'
+}
+
+echo "$(basename "$CUR_MAP" .map) : $REF_MAP -> $CUR_MAP"
+printf "  %-6s %10s %10s %10s\n" section before after delta
+for SEC in .text .data .bss
+do
+	BEFORE=$(printf "%d" "$(section_size "$REF_MAP" $SEC)" 2>/dev/null || echo 0)
+	AFTER=$(printf "%d" "$(section_size "$CUR_MAP" $SEC)" 2>/dev/null || echo 0)
+	printf "  %-6s %10d %10d %+10d\n" $SEC "$BEFORE" "$AFTER" $((AFTER - BEFORE))
+done
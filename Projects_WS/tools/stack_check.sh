@@ -0,0 +1,314 @@
+#!/bin/sh
+################################################################################
+# Static worst-case stack of a firmware image , fails if it exceeds the budget.
+#
+#   frames   : -fstack-usage (<object>.su next to each object , bytes incl.
+#              the pushed registers and the return address)
+#   calls    : relocations of the objects (avr-objdump -r) , call / rcall /
+#              jmp / rjmp => direct edge , gs() / pm() of a function => its
+#              address is taken
+#   icall    : disassembly (avr-objdump -d) , a callback is called by the
+#              module it is registered with => an icall / ijmp of a module
+#              may call the functions passed to a function of the module
+#              (the next call after the gs() : SCHED_addTask() ,
+#              Timer1_setCallBack() ...) , or whose address the module
+#              stores itself (tables , assignments)
+#   linked   : .text.* input sections kept in the .map (--gc-sections) ,
+#              .data / .bss / .noinit sizes => RAM left for the stack
+#
+# Call trees : main and each ISR (__vector_N) , worst case = main + the
+# deepest ISR (no nested interrupts). Recursion or unbounded dynamic frames
+# fail the check , calls out of the objects (libgcc / libc) count the return
+# address only.
+#
+# Usage: stack_check.sh <objdump> <image.map> <ram bytes> <budget> <objects...>
+#        budget 0 => RAM left after .data/.bss/.noinit
+################################################################################
+
+OBJDUMP=$1
+MAP=$2
+RAM=$3
+BUDGET=$4
+shift 4
+
+TMP=${TMPDIR:-/tmp}/stack_check.$$
+trap 'rm -f "$TMP".*' EXIT
+
+SU_FILES=""
+for OBJ in "$@"
+do
+	SU_FILES="$SU_FILES ${OBJ%.o}.su"
+done
+
+tr -d '\r' < "$MAP" > "$TMP.map"
+"$OBJDUMP" -r "$@" > "$TMP.rel" || exit 1
+"$OBJDUMP" -d "$@" > "$TMP.dis" || exit 1
+
+awk -v image="$(basename "$MAP" .map)" -v ram="$RAM" -v budget="$BUDGET" '
+# Function of a symbol / section name , GCC clones (foo.constprop.0 ,
+# foo.isra.0 , foo.part.0) are merged with foo
+function canon(name)
+{
+	sub(/[+-]0x[0-9a-fA-F]+$/, "", name)
+	sub(/^\.text\./, "", name)
+	sub(/^(startup|unlikely|hot|exit)\./, "", name)
+	if(name !~ /^\./)
+		sub(/\..*$/, "", name)
+	return name
+}
+
+function hex(value,   i, n, digit)
+{
+	n = 0
+	value = tolower(value)
+	sub(/^0x/, "", value)
+	for(i = 1 ; i <= length(value) ; i++)
+	{
+		digit = index("0123456789abcdef", substr(value, i, 1)) - 1
+		n = n * 16 + digit
+	}
+	return n
+}
+
+function addEdge(caller, callee)
+{
+	if((caller, callee) in edge)
+		return
+	edge[caller, callee] = 1
+	callees[caller] = callees[caller] " " callee
+}
+
+# Addresses taken by the code of a section and not passed to a call =>
+# stored by the module itself
+function flushPending(   list, n, i)
+{
+	n = split(pending, list, " ")
+	for(i = 1 ; i <= n ; i++)
+		addTarget(object, list[i])
+	pending = ""
+}
+
+function addTarget(owner, target)
+{
+	if((owner, target) in taken)
+		return
+	taken[owner, target] = 1
+	targets[owner] = targets[owner] " " target
+}
+
+function frameOf(name)
+{
+	if(name in frame)
+		return frame[name]
+	if(!(name in external))
+	{
+		external[name] = 1
+		externals = externals " " name
+	}
+	return 2
+}
+
+# Worst-case stack of the call tree of f (bytes) , deepest callee in next[]
+function worst(f,   list, n, i, c, w, best, bestCallee, cycle)
+{
+	if(f in depth)
+		return depth[f]
+	if(f in onPath)
+	{
+		cycle = f
+		for(i = pathLen ; (i > 0) && (path[i] != f) ; i--)
+			cycle = path[i] " > " cycle
+		cycle = f " > " cycle
+		if(!(cycle in cycles))
+		{
+			cycles[cycle] = 1
+			printf "  recursion : %s\n", cycle
+			failed = 1
+		}
+		return 0
+	}
+	onPath[f] = 1
+	path[++pathLen] = f
+
+	best = 0
+	bestCallee = ""
+	n = split(callees[f], list, " ")
+	for(i = 1 ; i <= n ; i++)
+	{
+		w = worst(list[i])
+		if(w > best)
+		{
+			best = w
+			bestCallee = " > " list[i]
+		}
+	}
+	if(f in indirect)
+	{
+		n = split(targets[module[f]], list, " ")
+		for(i = 1 ; i <= n ; i++)
+		{
+			c = list[i]
+			if(!(c in linked))
+				continue
+			w = worst(c)
+			if(w > best)
+			{
+				best = w
+				bestCallee = " >* " c
+			}
+		}
+	}
+
+	pathLen--
+	delete onPath[f]
+	next_[f] = bestCallee
+	depth[f] = frameOf(f) + best
+	return depth[f]
+}
+
+function chain(f,   text)
+{
+	text = f
+	while(next_[f] != "")
+	{
+		text = text next_[f]
+		f = next_[f]
+		sub(/^ >\*? /, "", f)
+	}
+	return text
+}
+
+# -fstack-usage : "file.c:line:column:function<TAB>bytes<TAB>qualifier"
+part == "su" {
+	split($0, field, "\t")
+	name = field[1]
+	sub(/^.*:/, "", name)
+	name = canon(name)
+	if(!(name in frame) || (field[2] + 0 > frame[name]))
+		frame[name] = field[2] + 0
+	if((field[3] ~ /dynamic/) && (field[3] !~ /bounded/))
+	{
+		printf "  unbounded dynamic frame : %s\n", name
+		failed = 1
+	}
+	next
+}
+
+part == "map" && /^Linker script and memory map/ { memoryMap = 1 ; next }
+part == "map" && memoryMap && /^ \.text\.[^ ]/ { linked[canon($1)] = 1 ; next }
+part == "map" && memoryMap && ($1 == ".data" || $1 == ".bss" || $1 == ".noinit") && ($3 ~ /^0x/) {
+	if(!($1 in ramSection))
+		ramSection[$1] = hex($3)
+	next
+}
+part == "map" { next }
+
+# Objects , module of a function = its object
+part == "rel" && /file format/ { flushPending() }
+(part == "rel" || part == "dis") && /file format/ { object = $1 ; sub(/:$/, "", object) ; next }
+
+part == "rel" && /^RELOCATION RECORDS FOR \[/ {
+	section = $0
+	sub(/^RELOCATION RECORDS FOR \[/, "", section)
+	sub(/\]:.*$/, "", section)
+	flushPending()
+	caller = (section ~ /^\.text\./) ? canon(section) : ""
+	next
+}
+part == "rel" && ($2 ~ /^R_AVR_/) {
+	# Offset inside a function (jump table , local label) => not a call / address
+	if($3 ~ /[+-]0x0*[1-9a-fA-F]/)
+		next
+	target = canon($3)
+	if(($2 == "R_AVR_CALL") || ($2 == "R_AVR_13_PCREL"))
+	{
+		if(caller == "")
+			next
+		addEdge(caller, target)
+		if(pending != "")
+		{
+			passed[target] = passed[target] pending
+			pending = ""
+		}
+	}
+	else if($2 ~ /_(PM|GS)/)
+	{
+		if(caller != "")
+			pending = pending " " target
+		else
+			addTarget(object, target)
+	}
+	next
+}
+part == "rel" { next }
+
+part == "dis" && !disassembly { flushPending() ; disassembly = 1 }
+part == "dis" && /^Disassembly of section \.text/ {
+	caller = $4
+	sub(/:$/, "", caller)
+	caller = canon(caller)
+	module[caller] = object
+	next
+}
+part == "dis" && /\t(e?icall|e?ijmp)/ { indirect[caller] = 1 ; next }
+
+END {
+	# Callbacks registered with a module
+	for(f in passed)
+	{
+		if(!(f in module))
+			continue
+		n = split(passed[f], list, " ")
+		for(i = 1 ; i <= n ; i++)
+			addTarget(module[f], list[i])
+	}
+
+	free = ram - ramSection[".data"] - ramSection[".bss"] - ramSection[".noinit"]
+	if(budget == 0)
+		budget = free
+
+	printf "%s stack : RAM %d - .data %d - .bss %d - .noinit %d = %d bytes free , budget %d\n", image, ram,
+		ramSection[".data"], ramSection[".bss"], ramSection[".noinit"], free, budget
+
+	if(!("main" in linked))
+	{
+		printf "  main() not found in the map\n"
+		exit 1
+	}
+
+	mainDepth = worst("main")
+	printf "  %-14s %5d  %s\n", "main", mainDepth, chain("main")
+
+	isrDepth = 0
+	isr = ""
+	for(f in linked)
+	{
+		if(f !~ /^__vector_[0-9]+$/)
+			continue
+		w = worst(f)
+		printf "  %-14s %5d  %s\n", f, w, chain(f)
+		if(w > isrDepth)
+		{
+			isrDepth = w
+			isr = f
+		}
+	}
+
+	if(externals != "")
+		printf "  outside the objects (return address only) :%s\n", externals
+
+	total = mainDepth + isrDepth
+	printf "  %-14s %5d  main%s : ", "worst case", total, (isr != "") ? " + " isr : ""
+	if(failed)
+		printf "FAILED\n"
+	else if(total > budget)
+	{
+		printf "FAILED (%d bytes over budget)\n", total - budget
+		failed = 1
+	}
+	else
+		printf "OK (%d bytes left)\n", budget - total
+
+	exit failed
+}
+' part=su $SU_FILES part=map "$TMP.map" part=rel "$TMP.rel" part=dis "$TMP.dis"